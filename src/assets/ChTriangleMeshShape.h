@@ -51,6 +51,10 @@ protected:
 	bool wireframe;
 	bool backface_cull;
 
+	bool dirty;
+	bool topology_dirty;
+	bool dirty_tracking;
+
 	std::string name;
 	ChVector<> scale;
 
@@ -63,6 +67,9 @@ public:
 			{ 
 				wireframe = false; 
 				backface_cull = false;
+				dirty = true;
+				topology_dirty = true;
+				dirty_tracking = false;
 			};
 
 	virtual ~ChTriangleMeshShape () {};
@@ -72,8 +79,27 @@ public:
 				//
 
 
+				/// Access the triangle mesh. If you modify it after it has been
+				/// shown, call SetDirty() so that the visualization systems refresh it.
 	geometry::ChTriangleMeshConnected& GetMesh()  {return trimesh;}
-	void SetMesh(const geometry::ChTriangleMeshConnected & mesh) {trimesh = mesh;}
+	void SetMesh(const geometry::ChTriangleMeshConnected & mesh) {trimesh = mesh; dirty = true; topology_dirty = true;}
+
+				/// Flags the vertexes, normals or colors as modified (and also the
+				/// faces, if mtopology=true). Visualization systems that convert the
+				/// mesh into their own buffers can skip the conversion when the mesh
+				/// is not dirty, and clear the flags with ClearDirty() after it.
+				/// The flags are used only if dirty tracking is enabled.
+	void SetDirty(bool mtopology = false) {dirty = true; if (mtopology) topology_dirty = true;}
+	bool IsDirty() {return dirty;}
+	bool IsTopologyDirty() {return topology_dirty;}
+	void ClearDirty() {dirty = false; topology_dirty = false;}
+
+				/// Enable the dirty tracking: visualization systems refresh the mesh
+				/// only when flagged with SetDirty(). Enable it only if all the code
+				/// that changes the mesh calls SetDirty(), as ChVisualizationFEMmesh does.
+				/// Default: false, the mesh is converted at each refresh.
+	void SetDirtyTracking(bool mtrack) {dirty_tracking = mtrack;}
+	bool IsDirtyTracking() {return dirty_tracking;}
 
 	bool IsWireframe() {return wireframe;}
 	void SetWireframe(bool mw) {wireframe = mw;}
@@ -21,6 +21,7 @@
     
   
 #include "ChCCollisionModel.h"
+#include "ChCConvexDecomposition.h"
 #include "physics/ChBody.h"
  
 
@@ -119,6 +120,26 @@ bool ChCollisionModel::AddConvexHullsFromFile(ChStreamInAscii&    mstream,
 }
 
 
+bool ChCollisionModel::AddConvexHullsFromFile(ChStreamInBinary&   mstream,
+                                              const ChVector<>&   pos,
+                                              const ChMatrix33<>& rot)
+{
+	unsigned int hash;
+	std::vector< std::vector< ChVector<double> > > hulls;
+	std::vector< std::vector< ChVector<int> > > hull_triangles;
+
+	if (!ChConvexDecomposition::ParseBinaryHulls(mstream, hash, hulls, hull_triangles))
+		return false;
+
+	for (unsigned int ih = 0; ih < hulls.size(); ih++)
+	{
+		if (hulls[ih].size())
+			this->AddConvexHull(hulls[ih],pos,rot);
+	}
+	return true;
+}
+
+
 
 
 void ChCollisionModel::StreamIN(ChStreamInBinary& mstream)
@@ -229,6 +229,15 @@ public:
                                       const ChVector<>&   pos = ChVector<>(),
                                       const ChMatrix33<>& rot = ChMatrix33<>(1));
 
+	/// Add a cluster of convex hulls from a binary file, as saved by 
+	/// ChConvexDecomposition::WriteConvexHullsAsBinaryFile() (or as cached by 
+	/// ChConvexDecomposition::ComputeConvexDecompositionCached()). This is much faster 
+	/// to load than the '.chulls' ascii format. 
+	/// As in the ascii case, this base implementation calls AddConvexHull() n times.
+  virtual bool AddConvexHullsFromFile(ChStreamInBinary&   mstream,
+                                      const ChVector<>&   pos = ChVector<>(),
+                                      const ChMatrix33<>& rot = ChMatrix33<>(1));
+
 
   // OTHER FUNCTIONS
   //
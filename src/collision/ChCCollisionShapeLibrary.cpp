@@ -0,0 +1,191 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+//////////////////////////////////////////////////
+//
+//   ChCCollisionShapeLibrary.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "ChCCollisionShapeLibrary.h"
+#include "ChCConvexDecomposition.h"
+
+
+namespace chrono
+{
+namespace collision
+{
+
+
+smartptrshapes ChCollisionShapeLibrary::Find(const ChShapeKey& mkey)
+{
+	std::map<ChShapeKey, smartptrshapes>::iterator it = shapes.find(mkey);
+	if (it == shapes.end())
+		return smartptrshapes();
+	return it->second;
+}
+
+void ChCollisionShapeLibrary::Insert(const ChShapeKey& mkey, smartptrshapes mshape)
+{
+	shapes[mkey] = mshape;
+}
+
+
+void ChCollisionShapeLibrary::HashBytes(ChShapeKey& mkey, const void* data, size_t n)
+{
+	// Two unrelated hashes: FNV-1a and SDBM
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < n; ++i)
+	{
+		mkey.hashA ^= bytes[i];
+		mkey.hashA *= 16777619u;
+		mkey.hashB = bytes[i] + (mkey.hashB << 6) + (mkey.hashB << 16) - mkey.hashB;
+	}
+}
+
+void ChCollisionShapeLibrary::HashVector(ChShapeKey& mkey, const ChVector<>& v)
+{
+	double coords[3] = {v.x, v.y, v.z};
+	HashBytes(mkey, coords, sizeof(coords));
+}
+
+
+ChCollisionShapeLibrary::ChShapeKey ChCollisionShapeLibrary::KeyConvexHull(const std::vector< ChVector<double> >& pointlist, double margin)
+{
+	ChShapeKey mkey;
+	mkey.kind  = KIND_CONVEXHULL;
+	mkey.ndata = (unsigned int)pointlist.size();
+	mkey.hashA = 2166136261u;
+	mkey.hashB = 0;
+
+	HashBytes(mkey, &margin, sizeof(double));
+	for (unsigned int i = 0; i < pointlist.size(); ++i)
+		HashVector(mkey, pointlist[i]);
+
+	return mkey;
+}
+
+ChCollisionShapeLibrary::ChShapeKey ChCollisionShapeLibrary::KeyTriangleMesh(const geometry::ChTriangleMesh& trimesh, eChShapeKind mkind, double margin)
+{
+	ChShapeKey mkey;
+	mkey.kind  = mkind;
+	mkey.ndata = (unsigned int)trimesh.getNumTriangles();
+	mkey.hashA = 2166136261u;
+	mkey.hashB = 0;
+
+	HashBytes(mkey, &margin, sizeof(double));
+	for (int i = 0; i < trimesh.getNumTriangles(); ++i)
+	{
+		geometry::ChTriangle mtri = trimesh.getTriangle(i);
+		HashVector(mkey, mtri.p1);
+		HashVector(mkey, mtri.p2);
+		HashVector(mkey, mtri.p3);
+	}
+
+	return mkey;
+}
+
+ChCollisionShapeLibrary::ChShapeKey ChCollisionShapeLibrary::KeyConvexDecomposition(ChConvexDecomposition& mdecomposition, double margin)
+{
+	ChShapeKey mkey;
+	mkey.kind  = KIND_DECOMPOSITION;
+	mkey.ndata = mdecomposition.GetHullCount();
+	mkey.hashA = 2166136261u;
+	mkey.hashB = 0;
+
+	HashBytes(mkey, &margin, sizeof(double));
+
+	// hash the resulting hulls, not the input mesh: this way the same
+	// hulls share the same compound, whatever the decomposition algorithm
+	for (unsigned int j = 0; j < mdecomposition.GetHullCount(); ++j)
+	{
+		std::vector< ChVector<double> > ptlist;
+		mdecomposition.GetConvexHullResult(j, ptlist);
+		for (unsigned int i = 0; i < ptlist.size(); ++i)
+			HashVector(mkey, ptlist[i]);
+	}
+
+	return mkey;
+}
+
+
+ChSmartPtr<geometry::ChTriangleMeshConnected> ChCollisionShapeLibrary::LoadWavefrontMesh(const std::string& filename, bool load_normals, bool load_uv)
+{
+	std::string mname = filename;
+	mname += load_normals ? "|n" : "|-";
+	mname += load_uv ? "|uv" : "|-";
+
+	std::map<std::string, ChSmartPtr<geometry::ChTriangleMeshConnected> >::iterator it = meshes.find(mname);
+	if (it != meshes.end())
+		return it->second;
+
+	ChSmartPtr<geometry::ChTriangleMeshConnected> mmesh(new geometry::ChTriangleMeshConnected);
+	mmesh->LoadWavefrontMesh(filename, load_normals, load_uv);
+
+	meshes[mname] = mmesh;
+
+	return mmesh;
+}
+
+
+int ChCollisionShapeLibrary::Purge()
+{
+	int npurged = 0;
+
+	// repeat, because removing a compound may release its children
+	int npass;
+	do
+	{
+		npass = 0;
+		std::map<ChShapeKey, smartptrshapes>::iterator its = shapes.begin();
+		while (its != shapes.end())
+		{
+			if (its->second.ReferenceCounter() <= 1)
+			{
+				shapes.erase(its++);
+				++npass;
+			}
+			else
+				++its;
+		}
+		npurged += npass;
+	}
+	while (npass);
+
+	std::map<std::string, ChSmartPtr<geometry::ChTriangleMeshConnected> >::iterator itm = meshes.begin();
+	while (itm != meshes.end())
+	{
+		if (itm->second.ReferenceCounter() <= 1)
+		{
+			meshes.erase(itm++);
+			++npurged;
+		}
+		else
+			++itm;
+	}
+
+	return npurged;
+}
+
+void ChCollisionShapeLibrary::Clear()
+{
+	shapes.clear();
+	meshes.clear();
+}
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
@@ -0,0 +1,152 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHC_COLLISIONSHAPELIBRARY_H
+#define CHC_COLLISIONSHAPELIBRARY_H
+
+//////////////////////////////////////////////////
+//
+//   ChCCollisionShapeLibrary.h
+//
+//   A library of immutable collision shapes, that
+//   can be shared (instanced) by many Bullet
+//   collision models.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include <map>
+#include <string>
+#include "core/ChSmartpointers.h"
+#include "core/ChVector.h"
+#include "geometry/ChCTriangleMesh.h"
+#include "geometry/ChCTriangleMeshConnected.h"
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+
+
+namespace chrono
+{
+
+typedef ChSmartPtr<btCollisionShape> smartptrshapes;
+
+namespace collision
+{
+
+class ChConvexDecomposition;
+
+
+///  A library of reference-counted collision shapes, keyed by
+///  the geometry that generated them. Shapes in the library are
+///  immutable: many ChModelBullet models can reference the same
+///  convex hull, compound or triangle mesh, each with its own
+///  position, rotation and scaling (see ChModelBullet::AddShapeInstance()
+///  and ChModelBullet::SetShapeLibrary() ).
+///  This saves memory and setup time when thousands of bodies
+///  share the same few CAD shapes.
+///  Shapes are deleted when no longer referenced by models nor by
+///  the library, see Purge().
+
+class ChApi ChCollisionShapeLibrary
+{
+public:
+		/// Type of the geometry that generated a shape, part of the key
+	enum eChShapeKind
+	{
+		KIND_CONVEXHULL = 0,
+		KIND_TRIMESH_STATIC,
+		KIND_TRIMESH_CONVEX,
+		KIND_TRIMESH_DECOMPOSED,
+		KIND_TRIMESH_CONCAVE,
+		KIND_DECOMPOSITION
+	};
+
+		/// Key of a shape in the library: two independent hashes of the
+		/// geometric data, plus kind and amount of data, to make
+		/// collisions practically impossible.
+	struct ChShapeKey
+	{
+		unsigned int kind;
+		unsigned int ndata;
+		unsigned int hashA;
+		unsigned int hashB;
+
+		bool operator<(const ChShapeKey& other) const
+		{
+			if (kind  != other.kind)  return kind  < other.kind;
+			if (ndata != other.ndata) return ndata < other.ndata;
+			if (hashA != other.hashA) return hashA < other.hashA;
+			return hashB < other.hashB;
+		}
+	};
+
+	ChCollisionShapeLibrary() {};
+	virtual ~ChCollisionShapeLibrary() {};
+
+		/// Returns the shape with the given key, or an empty pointer if none.
+	smartptrshapes Find(const ChShapeKey& mkey);
+
+		/// Stores a shape in the library, with the given key. The library
+		/// keeps a reference to the shape, so it stays alive until Purge()
+		/// or Clear(), even if not used by any model.
+	void Insert(const ChShapeKey& mkey, smartptrshapes mshape);
+
+		/// Key for a convex hull made with the given points and margin.
+	static ChShapeKey KeyConvexHull(const std::vector< ChVector<double> >& pointlist, double margin);
+
+		/// Key for a shape made from a triangle mesh, of the given kind, and margin.
+	static ChShapeKey KeyTriangleMesh(const geometry::ChTriangleMesh& trimesh, eChShapeKind mkind, double margin);
+
+		/// Key for a compound made from the results of a convex decomposition.
+	static ChShapeKey KeyConvexDecomposition(ChConvexDecomposition& mdecomposition, double margin);
+
+		/// Load a triangle mesh from a Wavefront .obj file, or return the
+		/// already loaded mesh if the same file was loaded before: the mesh
+		/// is interned, so all callers share the same vertex data.
+	ChSmartPtr<geometry::ChTriangleMeshConnected> LoadWavefrontMesh(const std::string& filename,
+																	  bool load_normals = true,
+																	  bool load_uv = false);
+
+		/// Removes from the library all shapes and meshes that are not
+		/// referenced by anything else. Returns the number of removed items.
+	int Purge();
+
+		/// Removes all shapes and meshes from the library. Shapes still
+		/// used by models will be deleted when those models release them.
+	void Clear();
+
+		/// Number of shapes in the library
+	int GetNshapes() {return (int)shapes.size();}
+
+		/// Number of interned meshes in the library
+	int GetNmeshes() {return (int)meshes.size();}
+
+private:
+	static void HashBytes(ChShapeKey& mkey, const void* data, size_t n);
+	static void HashVector(ChShapeKey& mkey, const ChVector<>& v);
+
+	std::map<ChShapeKey, smartptrshapes> shapes;
+	std::map<std::string, ChSmartPtr<geometry::ChTriangleMeshConnected> > meshes;
+};
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
+
+#endif
@@ -28,7 +28,9 @@
 // ------------------------------------------------
 ///////////////////////////////////////////////////
 
+#include <vector>
 #include "collision/ChCCollisionInfo.h"
+#include "collision/ChCPeriodicDomain.h"
 #include "core/ChFrame.h"
 #include "core/ChApiCE.h"
 
@@ -117,10 +119,28 @@ class ChApi ChCollisionSystem
 					/// engine (custom data may be allocated).
     virtual void Add(ChCollisionModel* model) = 0;
 
+					/// Adds many collision models to the collision engine at once.
+					/// By default it just calls Add() for each model, but children
+					/// classes can override it with faster batch insertion.
+	virtual void AddBatch(std::vector<ChCollisionModel*>& models)
+				{
+					for (unsigned int i = 0; i < models.size(); i++)
+						Add(models[i]);
+				}
+
 					/// Removes a collision model from the collision
 					/// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model) = 0;
 
+					/// Removes many collision models from the collision engine at once.
+					/// By default it just calls Remove() for each model, but children
+					/// classes can override it with faster batch removal.
+	virtual void RemoveBatch(std::vector<ChCollisionModel*>& models)
+				{
+					for (unsigned int i = 0; i < models.size(); i++)
+						Remove(models[i]);
+				}
+
 					/// Removes all collision models from the collision
 					/// engine (custom data may be deallocated).
     //virtual void RemoveAll() = 0;
@@ -168,6 +188,16 @@ class ChApi ChCollisionSystem
 					/// to report the contacts found during the Run()
 					/// execution. It will be executed for each contact point.
 	void SetNarrowPhaseCallback(ChNarrowPhaseCallback* mcallback) {narrow_callback = mcallback;}
+
+					/// Set the box domain with periodic boundaries: collision models near
+					/// a periodic face also collide with the models near the opposite face
+					/// (contacts are reported with the points of the model that is far from
+					/// the face shifted by the length of the box). Models that are larger than
+					/// half the box along a periodic axis, such as ground planes, are not
+					/// periodic. The default implementation just stores the domain: only
+					/// collision systems that support periodic boundaries override it.
+	virtual void SetPeriodicDomain(const ChPeriodicDomain& mdomain) {periodic_domain = mdomain;}
+	const ChPeriodicDomain& GetPeriodicDomain() const {return periodic_domain;}
 					
 
 					/// This will be used to recover results from RayHit() raycasting
@@ -187,6 +217,8 @@ protected:
 
 	ChBroadPhaseCallback*  broad_callback;	// user callback for each near-enough pair of shapes 
 	ChNarrowPhaseCallback* narrow_callback;	// user callback for each contact	
+
+	ChPeriodicDomain periodic_domain;
 };
 
 
@@ -19,15 +19,25 @@
 ///////////////////////////////////////////////////
    
  
+#include <algorithm>
+
 #include "collision/ChCCollisionSystemBullet.h"
 #include "collision/ChCModelBullet.h"
+#include "collision/ChCModelBulletBody.h"
 #include "collision/gimpact/GIMPACT/Bullet/btGImpactCollisionAlgorithm.h"
 #include "physics/ChBody.h"
+#include "physics/ChSystem.h"
 #include "physics/ChContactContainerBase.h"
 #include "physics/ChProximityContainerBase.h"
 #include "LinearMath/btPoolAllocator.h"
 #include "BulletCollision/CollisionShapes/btSphereShape.h"
 #include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btPointCollector.h"
+#include "LinearMath/btAabbUtil2.h"
 
 
 extern btScalar gContactBreakingThreshold;
@@ -40,6 +50,287 @@ namespace collision
 
 
 
+// Utility class that adds to the 32 bit sweep and prune broadphase of Bullet
+// the insertion of many proxies at once. Inserting proxies one by one costs
+// a linear time each, because the new edges are moved along the three axes
+// by swaps; here the new edges are sorted and merged into the axes in a single
+// pass, then a single sweep along the first axis finds the overlaps of
+// the new proxies, so adding k proxies to n costs about O(n + k log(k)).
+// Also, many proxies can be removed with a single pass over the pairs and
+// the axes, instead of a pass per proxy.
+class ChAxisSweep3Batch : public bt32BitAxisSweep3
+{
+public:
+	ChAxisSweep3Batch(const btVector3& worldAabbMin, const btVector3& worldAabbMax, unsigned int maxHandles)
+		: bt32BitAxisSweep3(worldAabbMin, worldAabbMax, maxHandles, 0, true) // true for disabling raycast accelerator
+	{
+		flags.resize(maxHandles, 0);
+	}
+
+	void createProxies(int nproxies,
+					   const btVector3* aabbMin, const btVector3* aabbMax,
+					   btCollisionObject** objects,
+					   const short int* groups, const short int* masks)
+	{
+		if (nproxies <= 0)
+			return;
+		btAssert(m_numHandles + nproxies < m_maxHandles);
+
+		unsigned int oldlimit = m_numHandles * 2;
+
+		std::vector<unsigned int> newhandles(nproxies);
+		std::vector<Edge> newedges[3];
+		for (int axis = 0; axis < 3; axis++)
+			newedges[axis].resize(2*nproxies);
+
+		for (int i = 0; i < nproxies; i++)
+		{
+			unsigned int min[3], max[3];
+			quantize(min, aabbMin[i], 0);
+			quantize(max, aabbMax[i], 1);
+
+			unsigned int handle = allocHandle();
+			Handle* pHandle = getHandle(handle);
+			pHandle->m_uniqueId = static_cast<int>(handle);
+			pHandle->m_clientObject = objects[i];
+			pHandle->m_collisionFilterGroup = groups[i];
+			pHandle->m_collisionFilterMask = masks[i];
+			pHandle->m_multiSapParentProxy = 0;
+			pHandle->m_dbvtProxy = 0;
+			// as in createProxy(): read by getAabb() and by the periodic images
+			pHandle->m_aabbMin = aabbMin[i];
+			pHandle->m_aabbMax = aabbMax[i];
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				newedges[axis][2*i].m_pos = min[axis];
+				newedges[axis][2*i].m_handle = handle;
+				newedges[axis][2*i+1].m_pos = max[axis];
+				newedges[axis][2*i+1].m_handle = handle;
+			}
+
+			newhandles[i] = handle;
+			objects[i]->setBroadphaseHandle(pHandle);
+		}
+
+		unsigned int newlimit = m_numHandles * 2;
+
+		// Merge the sorted new edges into the axes. As in sortMinDown() and
+		// sortMaxDown(), new edges go after old edges with the same position.
+		std::vector<Edge> merged(newlimit);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			std::stable_sort(newedges[axis].begin(), newedges[axis].end(), EdgeLess);
+			std::merge(m_pEdges[axis] + 1, m_pEdges[axis] + 1 + oldlimit,
+					   newedges[axis].begin(), newedges[axis].end(),
+					   merged.begin(), EdgeLess);
+
+			Edge sentinel = m_pEdges[axis][oldlimit + 1];
+			for (unsigned int e = 1; e <= newlimit; e++)
+			{
+				Edge& edge = m_pEdges[axis][e];
+				edge = merged[e-1];
+				if (edge.IsMax())
+					getHandle(edge.m_handle)->m_maxEdges[axis] = e;
+				else
+					getHandle(edge.m_handle)->m_minEdges[axis] = e;
+			}
+			m_pEdges[axis][newlimit + 1] = sentinel;
+			m_pHandles[0].m_maxEdges[axis] = newlimit + 1;
+		}
+
+		// Sweep along the first axis, keeping the lists of the open intervals
+		// (all, and only new ones). Closed intervals are removed lazily.
+		for (int i = 0; i < nproxies; i++)
+			flags[newhandles[i]] |= FLAG_NEW;
+
+		std::vector<unsigned int> active;
+		std::vector<unsigned int> activenew;
+		Edge* edges = m_pEdges[0];
+		for (unsigned int e = 1; e <= newlimit; e++)
+		{
+			unsigned int handle = edges[e].m_handle;
+			if (edges[e].IsMax())
+			{
+				flags[handle] &= ~FLAG_OPEN;
+				continue;
+			}
+
+			bool isnew = (flags[handle] & FLAG_NEW) != 0;
+			std::vector<unsigned int>& candidates = isnew ? active : activenew;
+			Handle* pHandle = getHandle(handle);
+			for (unsigned int j = 0; j < candidates.size(); )
+			{
+				unsigned int other = candidates[j];
+				if (!(flags[other] & FLAG_OPEN))
+				{
+					candidates[j] = candidates.back();
+					candidates.pop_back();
+					continue;
+				}
+				Handle* pOther = getHandle(other);
+				if (testOverlap2D(pHandle, pOther, 1, 2))
+				{
+					m_pairCache->addOverlappingPair(pHandle, pOther);
+					if (m_userPairCallback)
+						m_userPairCallback->addOverlappingPair(pHandle, pOther);
+				}
+				++j;
+			}
+
+			flags[handle] |= FLAG_OPEN;
+			active.push_back(handle);
+			if (isnew)
+				activenew.push_back(handle);
+		}
+
+		for (int i = 0; i < nproxies; i++)
+			flags[newhandles[i]] = 0;
+	}
+
+	void destroyProxies(int nproxies, btBroadphaseProxy** proxies, btDispatcher* dispatcher)
+	{
+		if (nproxies <= 0)
+			return;
+
+		for (int i = 0; i < nproxies; i++)
+			flags[proxies[i]->m_uniqueId] |= FLAG_REMOVED;
+
+		// Remove the pairs of all the removed proxies (this also deletes
+		// their collision algorithms and manifolds) in one pass.
+		RemovedPairsCallback callback(flags);
+		m_pairCache->processAllOverlappingPairs(&callback, dispatcher);
+
+		// Compact the axes, keeping the order of the remaining edges.
+		unsigned int oldlimit = m_numHandles * 2;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			Edge* edges = m_pEdges[axis];
+			unsigned int enew = 1;
+			for (unsigned int e = 1; e <= oldlimit; e++)
+			{
+				if (flags[edges[e].m_handle] & FLAG_REMOVED)
+					continue;
+				if (enew != e)
+				{
+					edges[enew] = edges[e];
+					if (edges[enew].IsMax())
+						getHandle(edges[enew].m_handle)->m_maxEdges[axis] = enew;
+					else
+						getHandle(edges[enew].m_handle)->m_minEdges[axis] = enew;
+				}
+				enew++;
+			}
+			edges[enew] = edges[oldlimit + 1];
+			m_pHandles[0].m_maxEdges[axis] = enew;
+		}
+
+		for (int i = 0; i < nproxies; i++)
+		{
+			unsigned int handle = proxies[i]->m_uniqueId;
+			flags[handle] = 0;
+			freeHandle(handle);
+		}
+	}
+
+private:
+	enum { FLAG_NEW = 1, FLAG_OPEN = 2, FLAG_REMOVED = 4 };
+
+	class RemovedPairsCallback : public btOverlapCallback
+	{
+	public:
+		RemovedPairsCallback(const std::vector<unsigned char>& mflags) : rflags(mflags) {}
+
+		virtual bool processOverlap(btBroadphasePair& pair)
+		{
+			return ((rflags[pair.m_pProxy0->m_uniqueId] | rflags[pair.m_pProxy1->m_uniqueId]) & FLAG_REMOVED) != 0;
+		}
+
+		const std::vector<unsigned char>& rflags;
+	};
+
+	static bool EdgeLess(const Edge& a, const Edge& b) {return a.m_pos < b.m_pos;}
+
+	std::vector<unsigned char> flags;
+};
+
+
+// Periodic image of a collision object: a copy with the same shape and the
+// same collision model, shifted by the length of the periodic domain along
+// one or more axes, so that it collides with the objects near the opposite
+// face. Contacts with the image are reported as contacts with the model of
+// the original object, with the contact points shifted back.
+class ChPeriodicImage : public btCollisionObject
+{
+public:
+	ChPeriodicImage(btCollisionObject* mowner, int mshift) : owner(mowner), shift(mshift), offset(0,0,0)
+	{
+		m_internalType = CO_USER_TYPE;
+		setUserPointer(owner->getUserPointer());
+		setCollisionShape(owner->getCollisionShape());
+	}
+
+	static bool IsImage(const btCollisionObject* obj) {return obj->getInternalType() == CO_USER_TYPE;}
+
+	static btVector3 GetOffset(const btCollisionObject* obj)
+	{
+		return IsImage(obj) ? static_cast<const ChPeriodicImage*>(obj)->offset : btVector3(0,0,0);
+	}
+
+	// Code of a shift by kx,ky,kz lengths of the domain (each -1, 0 or 1)
+	static int ShiftCode(int kx, int ky, int kz) {return (kx+1) + 3*(ky+1) + 9*(kz+1);}
+	int GetShift(int axis) const {return (axis == 0 ? shift : (axis == 1 ? shift/3 : shift/9)) % 3 - 1;}
+
+	static bool OwnerLess(const ChPeriodicImage* a, const btCollisionObject* mowner) {return a->owner < mowner;}
+
+	btCollisionObject* owner;
+	int shift;				// see ShiftCode()
+	btVector3 offset;		// translation from the owner to the image
+};
+
+
+// Filter for the broadphase pairs, that also applies to periodic images:
+// images do not collide with other images or with their own object, and
+// collide only with objects that are smaller than half the periodic domain
+// (larger objects, like the ground, are not periodic).
+class ChPeriodicFilterCallback : public btOverlapFilterCallback
+{
+public:
+	ChPeriodicFilterCallback() : half_length(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT) {}
+
+	virtual bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const
+	{
+		// same test of the default filter
+		if (!(proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) ||
+			!(proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask))
+			return false;
+
+		const btCollisionObject* obj0 = static_cast<const btCollisionObject*>(proxy0->m_clientObject);
+		const btCollisionObject* obj1 = static_cast<const btCollisionObject*>(proxy1->m_clientObject);
+		bool image0 = ChPeriodicImage::IsImage(obj0);
+		bool image1 = ChPeriodicImage::IsImage(obj1);
+		if (!image0 && !image1)
+			return true;
+		if (image0 && image1)
+			return false;
+
+		const ChPeriodicImage* image = static_cast<const ChPeriodicImage*>(image0 ? obj0 : obj1);
+		const btBroadphaseProxy* other = image0 ? proxy1 : proxy0;
+		if (image->owner == other->m_clientObject)
+			return false;
+		return IsPeriodicSize(other->m_aabbMin, other->m_aabbMax);
+	}
+
+	bool IsPeriodicSize(const btVector3& aabbMin, const btVector3& aabbMax) const
+	{
+		btVector3 size = aabbMax - aabbMin;
+		return size.x() < half_length.x() && size.y() < half_length.y() && size.z() < half_length.z();
+	}
+
+	btVector3 half_length;	// half the length of the domain, or a large value along non periodic axes
+};
+
+
 // Utility class that we use to override the default cylinder-sphere collision
 // case, because the default behavior in Bullet was using the GJK algorithm, that 
 // gives not 100% precise results if the cylinder is much larger than the sphere:
@@ -197,22 +488,39 @@ public:
 
 
 
-ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size)
+ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size, eCh_broadphase broadphase)
 {
+	speculative_contacts = false;
+	speculative_factor = 1.0;
+
+	verlet_lists = false;
+	verlet_skin = 0.01;
+	verlet_rebuild = true;
+	verlet_nrebuilds = 0;
+
+	periodic_filter = new ChPeriodicFilterCallback;
+
 	// btDefaultCollisionConstructionInfo conf_info(...); ***TODO***
 	bt_collision_configuration = new btDefaultCollisionConfiguration(); 
 	
 	bt_dispatcher = new btCollisionDispatcher(bt_collision_configuration);  
 	
-	  //***OLD***
-	
-	btScalar sscene_size = (btScalar)scene_size;
-	 btVector3	worldAabbMin(-sscene_size,-sscene_size,-sscene_size);
-	 btVector3	worldAabbMax(sscene_size,sscene_size,sscene_size);
-	bt_broadphase = new bt32BitAxisSweep3(worldAabbMin,worldAabbMax, max_objects, 0, true); // true for disabling raycast accelerator
-	
-	  //***NEW***
-	//bt_broadphase = new btDbvtBroadphase();
+	if (broadphase == BROADPHASE_DEFAULT)
+		broadphase = BROADPHASE_SAP;
+	broadphase_type = broadphase;
+
+	if (broadphase_type == BROADPHASE_DBVT)
+	{
+		bt_broadphase = new btDbvtBroadphase();
+		SetDbvtParameters();
+	}
+	else
+	{
+		btScalar sscene_size = (btScalar)scene_size;
+		 btVector3	worldAabbMin(-sscene_size,-sscene_size,-sscene_size);
+		 btVector3	worldAabbMax(sscene_size,sscene_size,sscene_size);
+		bt_broadphase = new ChAxisSweep3Batch(worldAabbMin,worldAabbMax, max_objects);
+	}
 
 
 	bt_collision_world = new btCollisionWorld(bt_dispatcher, bt_broadphase, bt_collision_configuration);
@@ -235,6 +543,21 @@ ChCollisionSystemBullet::~ChCollisionSystemBullet()
 	if(bt_broadphase) delete bt_broadphase;
 	if(bt_dispatcher) delete bt_dispatcher; 
 	if(bt_collision_configuration) delete bt_collision_configuration;
+	// images are deleted after the world, that removes their proxies
+	for (unsigned int i = 0; i < periodic_images.size(); i++)
+		delete periodic_images[i];
+	delete periodic_filter;
+}
+
+void ChCollisionSystemBullet::SetDbvtParameters(double fat_margin, double velocity_prediction, int optimize_percent)
+{
+	if (broadphase_type != BROADPHASE_DBVT)
+		return;
+
+	btDbvtBroadphase* mdbvt = (btDbvtBroadphase*)bt_broadphase;
+	mdbvt->setFatMargin((btScalar)fat_margin);
+	mdbvt->setVelocityPrediction((btScalar)velocity_prediction);
+	mdbvt->m_dupdates = optimize_percent;
 }
 
 void ChCollisionSystemBullet::Clear(void)
@@ -257,15 +580,334 @@ void ChCollisionSystemBullet::Add(ChCollisionModel* model)
 		bt_collision_world->addCollisionObject(((ChModelBullet*)model)->GetBulletModel(),
 			((ChModelBullet*)model)->GetFamilyGroup(),
 			((ChModelBullet*)model)->GetFamilyMask());
+		verlet_rebuild = true;
 	}
 }
 		 		
+void ChCollisionSystemBullet::AddBatch(std::vector<ChCollisionModel*>& models)
+{
+	if (broadphase_type != BROADPHASE_SAP)
+	{
+		ChCollisionSystem::AddBatch(models);
+		return;
+	}
+
+	btAlignedObjectArray<btCollisionObject*> objects;
+	btAlignedObjectArray<btVector3> aabbMin;
+	btAlignedObjectArray<btVector3> aabbMax;
+	btAlignedObjectArray<short int> groups;
+	btAlignedObjectArray<short int> masks;
+
+	for (unsigned int i = 0; i < models.size(); i++)
+	{
+		ChModelBullet* model = (ChModelBullet*)models[i];
+		btCollisionObject* object = model->GetBulletModel();
+		if (!object->getCollisionShape())
+			continue;
+
+		model->SyncPosition();
+
+		btVector3 minAabb, maxAabb;
+		object->getCollisionShape()->getAabb(object->getWorldTransform(), minAabb, maxAabb);
+
+		objects.push_back(object);
+		aabbMin.push_back(minAabb);
+		aabbMax.push_back(maxAabb);
+		groups.push_back(model->GetFamilyGroup());
+		masks.push_back(model->GetFamilyMask());
+
+		bt_collision_world->getCollisionObjectArray().push_back(object);
+	}
+
+	if (objects.size() == 0)
+		return;
+
+	((ChAxisSweep3Batch*)bt_broadphase)->createProxies(objects.size(), 
+			&aabbMin[0], &aabbMax[0], &objects[0], &groups[0], &masks[0]);
+
+	verlet_rebuild = true;
+}
+
 void ChCollisionSystemBullet::Remove(ChCollisionModel* model)
 {
 	if (((ChModelBullet*)model)->GetBulletModel()->getCollisionShape())
 	{
-		bt_collision_world->removeCollisionObject(((ChModelBullet*)model)->GetBulletModel());
+		btCollisionObject* object = ((ChModelBullet*)model)->GetBulletModel();
+		bt_collision_world->removeCollisionObject(object);
+
+		// remove also its periodic images
+		std::vector<ChPeriodicImage*>::iterator first = std::lower_bound(periodic_images.begin(), periodic_images.end(), object, ChPeriodicImage::OwnerLess);
+		std::vector<ChPeriodicImage*>::iterator last = first;
+		while (last != periodic_images.end() && (*last)->owner == object)
+		{
+			bt_collision_world->removeCollisionObject(*last);
+			delete *last;
+			++last;
+		}
+		periodic_images.erase(first, last);
+
+		verlet_rebuild = true;
+	}
+}
+
+void ChCollisionSystemBullet::RemoveBatch(std::vector<ChCollisionModel*>& models)
+{
+	if (broadphase_type != BROADPHASE_SAP)
+	{
+		ChCollisionSystem::RemoveBatch(models);
+		return;
+	}
+
+	std::vector<btCollisionObject*> objects;
+	objects.reserve(models.size());
+	for (unsigned int i = 0; i < models.size(); i++)
+	{
+		btCollisionObject* object = ((ChModelBullet*)models[i])->GetBulletModel();
+		if (object->getCollisionShape())
+			objects.push_back(object);
+	}
+
+	if (objects.empty())
+		return;
+
+	// sorted, so that duplicates are ignored and objects can be searched fast
+	std::sort(objects.begin(), objects.end());
+	objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+	// remove also their periodic images
+	std::vector<ChPeriodicImage*> removed_images;
+	if (!periodic_images.empty())
+	{
+		unsigned int nkept = 0;
+		for (unsigned int i = 0; i < periodic_images.size(); i++)
+		{
+			if (std::binary_search(objects.begin(), objects.end(), periodic_images[i]->owner))
+				removed_images.push_back(periodic_images[i]);
+			else
+				periodic_images[nkept++] = periodic_images[i];
+		}
+		periodic_images.resize(nkept);
+
+		if (!removed_images.empty())
+		{
+			objects.insert(objects.end(), removed_images.begin(), removed_images.end());
+			std::sort(objects.begin(), objects.end());
+		}
+	}
+
+	RemoveObjectsBatch(objects);
+
+	for (unsigned int i = 0; i < removed_images.size(); i++)
+		delete removed_images[i];
+
+	verlet_rebuild = true;
+}
+
+void ChCollisionSystemBullet::RemoveObjectsBatch(const std::vector<btCollisionObject*>& sorted_objects)
+{
+	btAlignedObjectArray<btBroadphaseProxy*> proxies;
+	for (unsigned int i = 0; i < sorted_objects.size(); i++)
+	{
+		if (sorted_objects[i]->getBroadphaseHandle())
+		{
+			proxies.push_back(sorted_objects[i]->getBroadphaseHandle());
+			sorted_objects[i]->setBroadphaseHandle(0);
+		}
+	}
+
+	if (proxies.size())
+		((ChAxisSweep3Batch*)bt_broadphase)->destroyProxies(proxies.size(), 
+				&proxies[0], bt_collision_world->getDispatcher());
+
+	btCollisionObjectArray& worldobjects = bt_collision_world->getCollisionObjectArray();
+	int nkept = 0;
+	for (int i = 0; i < worldobjects.size(); i++)
+	{
+		if (!std::binary_search(sorted_objects.begin(), sorted_objects.end(), worldobjects[i]))
+			worldobjects[nkept++] = worldobjects[i];
 	}
+	worldobjects.resize(nkept);
+}
+
+
+void ChCollisionSystemBullet::SetPeriodicDomain(const ChPeriodicDomain& mdomain)
+{
+	ChCollisionSystem::SetPeriodicDomain(mdomain);
+
+	for (int axis = 0; axis < 3; axis++)
+		periodic_filter->half_length[axis] = mdomain.IsPeriodic(axis) ? (btScalar)(0.5 * mdomain.GetLength(axis)) : BT_LARGE_FLOAT;
+
+	if (mdomain.IsActive())
+		bt_broadphase->getOverlappingPairCache()->setOverlapFilterCallback(periodic_filter);
+
+	verlet_rebuild = true;
+}
+
+
+void ChCollisionSystemBullet::UpdatePeriodicImages()
+{
+	btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+
+	// The bounding boxes of the objects, as seen by the broadphase (enlarged by
+	// the Verlet skin or by the speculative margin, if used), and their range.
+	// Objects larger than half the domain are not periodic, and have no images.
+	btScalar extra = (verlet_lists && !speculative_contacts) ? (btScalar)(0.5 * verlet_skin) : 0;
+	std::vector<btCollisionObject*> candidates;
+	btAlignedObjectArray<btVector3> aabbMin;
+	btAlignedObjectArray<btVector3> aabbMax;
+	btVector3 rangeMin( BT_LARGE_FLOAT,  BT_LARGE_FLOAT,  BT_LARGE_FLOAT);
+	btVector3 rangeMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+
+	if (periodic_domain.IsActive())
+	{
+		for (int i = 0; i < objects.size(); i++)
+		{
+			btCollisionObject* obj = objects[i];
+			if (ChPeriodicImage::IsImage(obj) || !obj->getBroadphaseHandle())
+				continue;
+
+			btVector3 minAabb, maxAabb;
+			obj->getCollisionShape()->getAabb(obj->getWorldTransform(), minAabb, maxAabb);
+			btScalar margin = extra;
+			if (speculative_contacts)
+				margin += (btScalar)ComputeSpeculativeMargin((ChCollisionModel*)obj->getUserPointer());
+			btVector3 inflate(margin, margin, margin);
+			minAabb -= inflate;
+			maxAabb += inflate;
+			if (!periodic_filter->IsPeriodicSize(minAabb, maxAabb))
+				continue;
+
+			candidates.push_back(obj);
+			aabbMin.push_back(minAabb);
+			aabbMax.push_back(maxAabb);
+			rangeMin.setMin(minAabb);
+			rangeMax.setMax(maxAabb);
+		}
+	}
+
+	// An object needs an image shifted by +L (or -L) along an axis if, once
+	// shifted, it can overlap some other object. A pair of objects near opposite
+	// faces needs only one image, otherwise its contacts would be found twice:
+	// only images whose first nonzero shift is positive are used.
+	std::vector< std::pair<btCollisionObject*, int> > needed;
+	for (unsigned int c = 0; c < candidates.size(); c++)
+	{
+		int kmin[3] = {0, 0, 0};
+		int kmax[3] = {0, 0, 0};
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (!periodic_domain.IsPeriodic(axis))
+				continue;
+			btScalar length = (btScalar)periodic_domain.GetLength(axis);
+			if (aabbMin[c][axis] + length < rangeMax[axis])
+				kmax[axis] = 1;
+			if (aabbMax[c][axis] - length > rangeMin[axis])
+				kmin[axis] = -1;
+		}
+		for (int kx = kmin[0]; kx <= kmax[0]; kx++)
+			for (int ky = kmin[1]; ky <= kmax[1]; ky++)
+				for (int kz = kmin[2]; kz <= kmax[2]; kz++)
+				{
+					int first = kx ? kx : (ky ? ky : kz);
+					if (first > 0)
+						needed.push_back(std::make_pair(candidates[c], ChPeriodicImage::ShiftCode(kx, ky, kz)));
+				}
+	}
+	std::sort(needed.begin(), needed.end());
+
+	// Keep the existing images that are still needed, create the missing ones
+	std::vector<ChPeriodicImage*> images;
+	std::vector<btCollisionObject*> removed;
+	btAlignedObjectArray<btCollisionObject*> created;
+	images.reserve(needed.size());
+	unsigned int ie = 0;
+	for (unsigned int n = 0; n < needed.size(); n++)
+	{
+		while (ie < periodic_images.size() &&
+			   (periodic_images[ie]->owner < needed[n].first ||
+			   (periodic_images[ie]->owner == needed[n].first && periodic_images[ie]->shift < needed[n].second)))
+			removed.push_back(periodic_images[ie++]);
+
+		ChPeriodicImage* image;
+		if (ie < periodic_images.size() && periodic_images[ie]->owner == needed[n].first && periodic_images[ie]->shift == needed[n].second)
+			image = periodic_images[ie++];
+		else
+		{
+			image = new ChPeriodicImage(needed[n].first, needed[n].second);
+			created.push_back(image);
+		}
+
+		// follow the owner
+		for (int axis = 0; axis < 3; axis++)
+			image->offset[axis] = (btScalar)(image->GetShift(axis) * periodic_domain.GetLength(axis));
+		btTransform trans = image->owner->getWorldTransform();
+		trans.getOrigin() += image->offset;
+		image->setWorldTransform(trans);
+		if (image->getCollisionShape() != image->owner->getCollisionShape())
+			image->setCollisionShape(image->owner->getCollisionShape());
+		if (image->getBroadphaseHandle())
+		{
+			image->getBroadphaseHandle()->m_collisionFilterGroup = image->owner->getBroadphaseHandle()->m_collisionFilterGroup;
+			image->getBroadphaseHandle()->m_collisionFilterMask  = image->owner->getBroadphaseHandle()->m_collisionFilterMask;
+		}
+
+		images.push_back(image);
+	}
+	while (ie < periodic_images.size())
+		removed.push_back(periodic_images[ie++]);
+
+	periodic_images.swap(images);
+
+	if (removed.empty() && created.size() == 0)
+		return;
+
+	// Delete the images that are not needed anymore
+	if (broadphase_type == BROADPHASE_SAP)
+	{
+		std::sort(removed.begin(), removed.end());
+		RemoveObjectsBatch(removed);
+	}
+	else
+	{
+		for (unsigned int i = 0; i < removed.size(); i++)
+			bt_collision_world->removeCollisionObject(removed[i]);
+	}
+	for (unsigned int i = 0; i < removed.size(); i++)
+		delete removed[i];
+
+	// Add the new images, with the collision families of their owners
+	if (broadphase_type == BROADPHASE_SAP && created.size())
+	{
+		btAlignedObjectArray<btVector3> minAabbs;
+		btAlignedObjectArray<btVector3> maxAabbs;
+		btAlignedObjectArray<short int> groups;
+		btAlignedObjectArray<short int> masks;
+		for (int i = 0; i < created.size(); i++)
+		{
+			ChPeriodicImage* image = (ChPeriodicImage*)created[i];
+			btVector3 minAabb, maxAabb;
+			image->getCollisionShape()->getAabb(image->getWorldTransform(), minAabb, maxAabb);
+			minAabbs.push_back(minAabb);
+			maxAabbs.push_back(maxAabb);
+			groups.push_back(image->owner->getBroadphaseHandle()->m_collisionFilterGroup);
+			masks.push_back(image->owner->getBroadphaseHandle()->m_collisionFilterMask);
+			objects.push_back(image);
+		}
+		((ChAxisSweep3Batch*)bt_broadphase)->createProxies(created.size(), 
+				&minAabbs[0], &maxAabbs[0], &created[0], &groups[0], &masks[0]);
+	}
+	else
+	{
+		for (int i = 0; i < created.size(); i++)
+		{
+			ChPeriodicImage* image = (ChPeriodicImage*)created[i];
+			bt_collision_world->addCollisionObject(image,
+				image->owner->getBroadphaseHandle()->m_collisionFilterGroup,
+				image->owner->getBroadphaseHandle()->m_collisionFilterMask);
+		}
+	}
+
+	verlet_rebuild = true;
 }
 
 
@@ -273,7 +915,167 @@ void ChCollisionSystemBullet::Run()
 {
 	if (bt_collision_world)
 	{
-		bt_collision_world->performDiscreteCollisionDetection(); 
+		if (periodic_domain.IsActive() || !periodic_images.empty())
+			UpdatePeriodicImages();
+
+		if (verlet_lists && !speculative_contacts)
+		{
+			// Broadphase only if needed, otherwise the narrow phase runs
+			// on the pairs of the last rebuild.
+			if (verlet_rebuild || VerletNeedsRebuild())
+				VerletRebuild();
+			bt_dispatcher->dispatchAllCollisionPairs(bt_broadphase->getOverlappingPairCache(),
+													 bt_collision_world->getDispatchInfo(),
+													 bt_dispatcher);
+			return;
+		}
+
+		if (!speculative_contacts)
+		{
+			bt_collision_world->performDiscreteCollisionDetection(); 
+			return;
+		}
+
+		// Same as performDiscreteCollisionDetection(), but with AABBs 
+		// swept along the motion of the bodies, before finding pairs.
+		bt_collision_world->updateAabbs();
+		SweepAabbs();
+		bt_broadphase->calculateOverlappingPairs(bt_dispatcher);
+		bt_dispatcher->dispatchAllCollisionPairs(bt_broadphase->getOverlappingPairCache(),
+												 bt_collision_world->getDispatchInfo(),
+												 bt_dispatcher);
+	}
+}
+
+
+bool ChCollisionSystemBullet::VerletNeedsRebuild()
+{
+	btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+
+	if (objects.size() != verlet_transforms.size())
+		return true;
+
+	btScalar half_skin = (btScalar)(0.5 * verlet_skin);
+
+	for (int i=0; i<objects.size(); i++)
+	{
+		const btTransform& trans = objects[i]->getWorldTransform();
+		const btTransform& old_trans = verlet_transforms[i];
+
+		btScalar displ = (trans.getOrigin() - old_trans.getOrigin()).length();
+		if (verlet_arms[i] > 0)
+		{
+			btQuaternion rel_rot = old_trans.getRotation().inverse() * trans.getRotation();
+			btScalar angle = rel_rot.getAngle();
+			if (angle > SIMD_PI)
+				angle = SIMD_2_PI - angle;
+			displ += angle * verlet_arms[i];
+		}
+		if (displ > half_skin)
+			return true;
+	}
+	return false;
+}
+
+
+void ChCollisionSystemBullet::VerletRebuild()
+{
+	btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+
+	bt_collision_world->updateAabbs();
+
+	btScalar half_skin = (btScalar)(0.5 * verlet_skin);
+	btVector3 inflate(half_skin, half_skin, half_skin);
+
+	verlet_transforms.resize(objects.size());
+	verlet_arms.resize(objects.size());
+
+	for (int i=0; i<objects.size(); i++)
+	{
+		btCollisionObject* obj = objects[i];
+		verlet_transforms[i] = obj->getWorldTransform();
+
+		// spheres centered in the origin are not affected by rotations
+		const btCollisionShape* shape = obj->getCollisionShape();
+		if (shape->getShapeType() == SPHERE_SHAPE_PROXYTYPE)
+			verlet_arms[i] = 0;
+		else
+		{
+			btVector3 center;
+			btScalar  radius;
+			shape->getBoundingSphere(center, radius);
+			verlet_arms[i] = center.length() + radius;
+		}
+
+		if (!obj->getBroadphaseHandle())
+			continue;
+		btVector3 minAabb, maxAabb;
+		shape->getAabb(obj->getWorldTransform(), minAabb, maxAabb);
+		minAabb -= inflate;
+		maxAabb += inflate;
+		bt_broadphase->setAabb(obj->getBroadphaseHandle(), minAabb, maxAabb, bt_dispatcher);
+	}
+
+	bt_broadphase->calculateOverlappingPairs(bt_dispatcher);
+
+	verlet_rebuild = false;
+	++verlet_nrebuilds;
+}
+
+
+double ChCollisionSystemBullet::ComputeSpeculativeMargin(ChCollisionModel* model)
+{
+	ChModelBulletBody* bodymodel = dynamic_cast<ChModelBulletBody*>(model);
+	if (!bodymodel)
+		return 0;
+	ChBody* mbody = bodymodel->GetBody();
+	if (!mbody || !mbody->GetSystem() || mbody->GetBodyFixed() || mbody->GetSleeping())
+		return 0;
+
+	double dt = mbody->GetSystem()->GetStep() * speculative_factor;
+
+	// translation of the reference, plus max displacement caused by rotation
+	btVector3 center;
+	btScalar  radius;
+	bodymodel->GetBulletModel()->getCollisionShape()->getBoundingSphere(center, radius);
+	double rot_arm = center.length() + radius;
+
+	return dt * (mbody->GetPos_dt().Length() + mbody->GetWvel_par().Length() * rot_arm);
+}
+
+
+void ChCollisionSystemBullet::SweepAabbs()
+{
+	btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+
+	for (int i=0; i<objects.size(); i++)
+	{
+		btCollisionObject* obj = objects[i];
+		ChModelBulletBody* bodymodel = dynamic_cast<ChModelBulletBody*>((ChCollisionModel*)obj->getUserPointer());
+		if (!bodymodel || !obj->getBroadphaseHandle())
+			continue;
+		double margin = ComputeSpeculativeMargin(bodymodel);
+		if (margin == 0)
+			continue;
+
+		ChBody* mbody = bodymodel->GetBody();
+		ChVector<> displ = mbody->GetPos_dt() * (mbody->GetSystem()->GetStep() * speculative_factor);
+		btVector3 bt_displ((btScalar)displ.x, (btScalar)displ.y, (btScalar)displ.z);
+		btScalar  rot_margin = (btScalar)(margin - displ.Length());
+
+		btVector3 minAabb, maxAabb;
+		obj->getCollisionShape()->getAabb(obj->getWorldTransform(), minAabb, maxAabb);
+		// union of the current AABB and the AABB displaced by v*dt
+		btVector3 minAabbNext = minAabb + bt_displ;
+		btVector3 maxAabbNext = maxAabb + bt_displ;
+		minAabb.setMin(minAabbNext);
+		maxAabb.setMax(maxAabbNext);
+		// rotations are taken into account by inflating it
+		btVector3 rot_inflate(rot_margin, rot_margin, rot_margin);
+		minAabb -= rot_inflate;
+		maxAabb += rot_inflate;
+
+		bt_broadphase->setAabb(obj->getBroadphaseHandle(), minAabb, maxAabb, bt_dispatcher);
 	}
 }
 
@@ -296,6 +1098,10 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainerBase* mcontactcon
 		icontact.modelA = (ChCollisionModel*)obA->getUserPointer();
 		icontact.modelB = (ChCollisionModel*)obB->getUserPointer();
 
+		// contact points on periodic images are moved back to their models
+		btVector3 offsetA = ChPeriodicImage::GetOffset(obA);
+		btVector3 offsetB = ChPeriodicImage::GetOffset(obB);
+
 		double envelopeA = icontact.modelA->GetEnvelope();
 		double envelopeB = icontact.modelB->GetEnvelope();
 		
@@ -317,8 +1123,8 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainerBase* mcontactcon
 
 				if (pt.getDistance() < marginA+marginB) // to discard "too far" constraints (the Bullet engine also has its threshold)
 				{
-					btVector3 ptA = pt.getPositionWorldOnA();
-					btVector3 ptB = pt.getPositionWorldOnB(); 
+					btVector3 ptA = pt.getPositionWorldOnA() - offsetA;
+					btVector3 ptB = pt.getPositionWorldOnB() - offsetB; 
 					
 					icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
 					icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
@@ -350,10 +1156,149 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainerBase* mcontactcon
 		//you can un-comment out this line, and then all points are removed
 		//contactManifold->clearManifold();	
 	}
+
+	if (speculative_contacts && mcontactcontainer->AcceptsSpeculativeContacts())
+		ReportSpeculativeContacts(mcontactcontainer);
+
 	mcontactcontainer->EndAddContact();
 }
 
 
+void ChCollisionSystemBullet::ReportSpeculativeContacts(ChContactContainerBase* mcontactcontainer)
+{
+	ChCollisionInfo icontact;
+	btManifoldArray manifolds;
+
+	btBroadphasePairArray& pairs = bt_broadphase->getOverlappingPairCache()->getOverlappingPairArray();
+
+	for (int i=0; i<pairs.size(); i++)
+	{
+		btBroadphasePair& mpair = pairs[i];
+		btCollisionObject* obA = static_cast<btCollisionObject*>(mpair.m_pProxy0->m_clientObject);
+		btCollisionObject* obB = static_cast<btCollisionObject*>(mpair.m_pProxy1->m_clientObject);
+
+		icontact.modelA = (ChCollisionModel*)obA->getUserPointer();
+		icontact.modelB = (ChCollisionModel*)obB->getUserPointer();
+
+		double max_dist = ComputeSpeculativeMargin(icontact.modelA) + ComputeSpeculativeMargin(icontact.modelB);
+		if (max_dist == 0)
+			continue;
+
+		// Pairs already in contact are managed by the persistent manifolds, as usual
+		bool has_contacts = false;
+		if (mpair.m_algorithm)
+		{
+			manifolds.resize(0);
+			mpair.m_algorithm->getAllContactManifolds(manifolds);
+			for (int j=0; j<manifolds.size(); j++)
+				if (manifolds[j]->getNumContacts())
+					has_contacts = true;
+		}
+		if (has_contacts)
+			continue;
+
+		if (!bt_dispatcher->needsCollision(obA,obB))
+			continue;
+
+		// Execute custom broadphase callback, if any
+		if (this->broad_callback)
+			if (!this->broad_callback->BroadCallback(icontact.modelA, icontact.modelB))
+				continue;
+
+		ReportSpeculativeShapePair(obA->getCollisionShape(), obA->getWorldTransform(),
+								   obB->getCollisionShape(), obB->getWorldTransform(),
+								   ChPeriodicImage::GetOffset(obA), ChPeriodicImage::GetOffset(obB),
+								   max_dist, icontact, mcontactcontainer);
+	}
+}
+
+
+void ChCollisionSystemBullet::ReportSpeculativeShapePair(const btCollisionShape* shapeA, const btTransform& transA,
+														  const btCollisionShape* shapeB, const btTransform& transB,
+														  const btVector3& offsetA, const btVector3& offsetB,
+														  double max_dist,
+														  ChCollisionInfo& icontact,
+														  ChContactContainerBase* mcontactcontainer)
+{
+	// Skip sub shapes whose AABBs are too far
+	btVector3 minA, maxA, minB, maxB;
+	shapeA->getAabb(transA, minA, maxA);
+	shapeB->getAabb(transB, minB, maxB);
+	btVector3 inflate((btScalar)max_dist, (btScalar)max_dist, (btScalar)max_dist);
+	minA -= inflate;
+	maxA += inflate;
+	if (!TestAabbAgainstAabb2(minA, maxA, minB, maxB))
+		return;
+
+	// Recurse in compounds
+	if (shapeA->isCompound())
+	{
+		const btCompoundShape* compound = static_cast<const btCompoundShape*>(shapeA);
+		for (int i=0; i<compound->getNumChildShapes(); i++)
+			ReportSpeculativeShapePair(compound->getChildShape(i), transA*compound->getChildTransform(i),
+									   shapeB, transB, offsetA, offsetB, max_dist, icontact, mcontactcontainer);
+		return;
+	}
+	if (shapeB->isCompound())
+	{
+		const btCompoundShape* compound = static_cast<const btCompoundShape*>(shapeB);
+		for (int i=0; i<compound->getNumChildShapes(); i++)
+			ReportSpeculativeShapePair(shapeA, transA,
+									   compound->getChildShape(i), transB*compound->getChildTransform(i),
+									   offsetA, offsetB, max_dist, icontact, mcontactcontainer);
+		return;
+	}
+
+	// Concave shapes are not supported
+	if (!shapeA->isConvex() || !shapeB->isConvex())
+		return;
+
+	// Closest points between the two convex shapes, as in the GJK narrow phase
+	// of Bullet, but without limiting the search within the margins.
+	btVoronoiSimplexSolver simplex_solver;
+	btGjkEpaPenetrationDepthSolver penetration_solver;
+	btGjkPairDetector gjk((const btConvexShape*)shapeA, (const btConvexShape*)shapeB, &simplex_solver, &penetration_solver);
+
+	btGjkPairDetector::ClosestPointInput input;
+	input.m_transformA = transA;
+	input.m_transformB = transB;
+	btPointCollector result;
+	gjk.getClosestPoints(input, result, 0);
+
+	if (!result.m_hasResult || result.m_distance >= max_dist)
+		return;
+
+	double envelopeA = icontact.modelA->GetEnvelope();
+	double envelopeB = icontact.modelB->GetEnvelope();
+
+	btVector3 ptB = result.m_pointInWorld;
+	btVector3 ptA = ptB + result.m_normalOnBInWorld * result.m_distance - offsetA;
+	ptB -= offsetB;
+
+	icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
+	icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
+
+	icontact.vN.Set( -result.m_normalOnBInWorld.getX(), 
+					 -result.m_normalOnBInWorld.getY(),
+					 -result.m_normalOnBInWorld.getZ());
+	icontact.vN.Normalize(); 
+
+	icontact.vpA = icontact.vpA - icontact.vN*envelopeA;
+	icontact.vpB = icontact.vpB + icontact.vN*envelopeB;
+	icontact.distance = result.m_distance + envelopeA + envelopeB;
+
+	// not persistent, so no warm starting
+	icontact.reaction_cache = 0;
+
+	// Execute some user custom callback, if any
+	if (this->narrow_callback)
+		this->narrow_callback->NarrowCallback(icontact);
+
+	// Add to contact container
+	mcontactcontainer->AddContact(icontact); 
+}
+
+
 void ChCollisionSystemBullet::ReportProximities(ChProximityContainerBase* mproximitycontainer)
 {
 	mproximitycontainer->BeginAddProximities();
@@ -38,6 +38,8 @@ namespace chrono
 namespace collision 
 {
 
+class ChPeriodicImage;
+class ChPeriodicFilterCallback;
 
 ///
 /// Class for collision engine based on the 'Bullet' library.
@@ -48,8 +50,18 @@ namespace collision
 class ChApi ChCollisionSystemBullet : public ChCollisionSystem
 {
   public:
+					/// Available broadphase algorithms.
+	enum eCh_broadphase{
+		 BROADPHASE_DEFAULT = 0,	///< currently same as BROADPHASE_SAP
+		 BROADPHASE_SAP,			///< sweep and prune (32 bit axis sweep) in a fixed box of size 'scene_size'
+		 BROADPHASE_DBVT,			///< dynamic AABB tree: unbounded scenes, fat AABBs, incremental optimization
+	};
 
-	ChCollisionSystemBullet(unsigned int max_objects = 16000, double scene_size = 500);
+					/// Create the collision system. The broadphase can be chosen by 'broadphase': 
+					/// the SAP broadphase works best for bodies inside a box of 
+					/// half-size 'scene_size' and up to 'max_objects' models (both ignored by DBVT);
+					/// the DBVT broadphase is better for very large or sparse scenes.
+	ChCollisionSystemBullet(unsigned int max_objects = 16000, double scene_size = 500, eCh_broadphase broadphase = BROADPHASE_DEFAULT);
 	virtual ~ChCollisionSystemBullet();
 
 					/// Clears all data instanced by this algorithm
@@ -60,10 +72,24 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem
 					/// engine (custom data may be allocated).
     virtual void Add(ChCollisionModel* model);
 
+					/// Adds many collision models at once. With the SAP broadphase,
+					/// the new bounding boxes are sorted and merged into the axes in a
+					/// single pass, and their overlapping pairs are found with a single
+					/// sweep, instead of inserting them one by one, that costs a
+					/// linear time per model; this is much faster when adding hundreds
+					/// of models to a scene with many objects.
+	virtual void AddBatch(std::vector<ChCollisionModel*>& models);
+
 					/// Removes a collision model from the collision
 					/// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model);
 
+					/// Removes many collision models at once. With the SAP broadphase,
+					/// the pairs of all removed models are deleted with a single pass
+					/// over the pair cache and the axes are compacted once, instead
+					/// of scanning all pairs and all edges for each removed model.
+	virtual void RemoveBatch(std::vector<ChCollisionModel*>& models);
+
 					/// Removes all collision models from the collision
 					/// engine (custom data may be deallocated).
     //virtual void RemoveAll();
@@ -102,12 +128,121 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem
 					// Call it only once, before running the simulation.
 	static void SetContactBreakingThreshold(double threshold);
 
+					/// Get the type of broadphase used by this collision system.
+	eCh_broadphase GetBroadphaseType() {return broadphase_type;}
+
+					/// Tweak the DBVT broadphase (no effect with other broadphases):
+					/// - fat_margin: AABBs in the tree are enlarged by this amount when
+					///   objects move, so small motions do not need tree updates. Note that
+					///   proximity containers will receive pairs within this distance, too.
+					///   It is a length, in the units of the scene: the default is 0, as
+					///   the envelopes of the collision models already enlarge the AABBs,
+					///   and a good value is a fraction of the typical envelope.
+					/// - velocity_prediction: AABBs are also extended in the direction of motion
+					///   by this fraction of their size.
+					/// - optimize_percent: percent of the tree leaves that are re-inserted 
+					///   at each step, for incremental optimization of the tree.
+	void SetDbvtParameters(double fat_margin = 0, double velocity_prediction = 0, int optimize_percent = 1);
+
+					/// Turn on/off speculative contacts. If on, the broadphase AABB of 
+					/// each moving ChBody is swept along its motion over the next time step, 
+					/// and contacts are generated also for shapes whose distance is less than 
+					/// the relative displacement |v|*dt (scaled by 'factor'), rather than only 
+					/// within the collision envelopes. These contacts have positive distance,
+					/// so they act as unilateral constraints that avoid tunneling of fast
+					/// bodies (projectiles, wheels) even with larger time steps.
+					/// Note: only convex shapes (and compounds of convex shapes) are processed.
+					/// Note: not used by ChSystemDEM, whose penalty contacts act only where the
+					/// shapes overlap; with its contact container the option is ignored.
+	void SetSpeculativeContacts(bool mon, double factor = 1.0) {speculative_contacts = mon; speculative_factor = factor;}
+	bool GetSpeculativeContacts() {return speculative_contacts;}
+
+					/// Turn on/off Verlet lists. If on, the broadphase AABBs are enlarged
+					/// by half the 'skin' distance, so that the broadphase finds all the
+					/// pairs whose distance is less than the envelopes plus the skin; this
+					/// list of pairs is kept, and only the narrow phase is run on it at the
+					/// next steps, until some collision model has moved (or rotated) more
+					/// than half the skin since the last rebuild. Adding or removing models
+					/// also forces a rebuild. With small time steps, as in DEM and SPH, the
+					/// pairs are rebuilt only every few steps, saving most of the broadphase
+					/// time; a larger skin means less rebuilds, but more pairs in the
+					/// narrow phase. Not used when speculative contacts are on.
+	void SetVerletLists(bool mon, double skin = 0.01) {verlet_lists = mon; verlet_skin = skin; verlet_rebuild = true;}
+	bool GetVerletLists() {return verlet_lists;}
+	double GetVerletSkin() {return verlet_skin;}
+
+					/// Force the rebuild of the Verlet lists at the next Run()
+	void ResetVerletLists() {verlet_rebuild = true;}
+
+					/// Number of times the Verlet lists were rebuilt, for statistics.
+	int GetNverletRebuilds() {return verlet_nrebuilds;}
+
+					/// Set the box domain with periodic boundaries. Collision models
+					/// near a periodic face get periodic images, i.e. copies shifted by
+					/// the length of the box, that collide with the models near the
+					/// opposite face: contacts with an image are reported as contacts
+					/// with its model, with the contact point shifted back. Images are
+					/// created and deleted automatically at each Run().
+	virtual void SetPeriodicDomain(const ChPeriodicDomain& mdomain);
+
+					/// Number of periodic images at the last Run(), for statistics.
+	int GetNperiodicImages() {return (int)periodic_images.size();}
+
 private:
+					// Create, move and delete the periodic images, so that there is an
+					// image for each collision model that can touch a model near the
+					// opposite face of the periodic domain.
+	void UpdatePeriodicImages();
+
+					// Remove objects from the broadphase and from the collision world.
+					// The objects must be sorted (SAP broadphase only).
+	void RemoveObjectsBatch(const std::vector<btCollisionObject*>& sorted_objects);
+
+					// Returns true if some collision model moved more than half
+					// the skin since the last rebuild of the Verlet lists.
+	bool VerletNeedsRebuild();
+
+					// Run the broadphase with AABBs enlarged by half the skin,
+					// and store the transforms of the collision models.
+	void VerletRebuild();
+
+					// Returns the speculative margin of a model, i.e. the max displacement of
+					// its shapes in the next time step (zero if not a moving ChBody).
+	double ComputeSpeculativeMargin(ChCollisionModel* model);
+
+					// Enlarge the AABBs of moving objects so that they contain the swept volume.
+	void SweepAabbs();
+
+					// Add contacts with positive distance for pairs that have no contact 
+					// in their persistent manifolds, but may touch within the next time step.
+	void ReportSpeculativeContacts(ChContactContainerBase* mcontactcontainer);
+
+	void ReportSpeculativeShapePair(const btCollisionShape* shapeA, const btTransform& transA,
+									const btCollisionShape* shapeB, const btTransform& transB,
+									const btVector3& offsetA, const btVector3& offsetB,
+									double max_dist,
+									ChCollisionInfo& icontact,
+									ChContactContainerBase* mcontactcontainer);
+
 	btCollisionConfiguration* bt_collision_configuration;
 	btCollisionDispatcher*  bt_dispatcher;
 	btBroadphaseInterface*	bt_broadphase;
 	btCollisionWorld*		bt_collision_world; 
 
+	bool   speculative_contacts;
+	double speculative_factor;
+
+	eCh_broadphase broadphase_type;
+
+	bool   verlet_lists;
+	double verlet_skin;
+	bool   verlet_rebuild;
+	int    verlet_nrebuilds;
+	btAlignedObjectArray<btTransform> verlet_transforms;	// transforms of the collision objects at the last rebuild
+	btAlignedObjectArray<btScalar>	  verlet_arms;			// max distance of the shapes from the origins, for rotations
+
+	std::vector<ChPeriodicImage*> periodic_images;			// sorted by model and shift
+	ChPeriodicFilterCallback* periodic_filter;
 };
 
 
@@ -19,6 +19,8 @@
 ///////////////////////////////////////////////////
    
  
+#include <fstream>
+
 #include "collision/ChCConvexDecomposition.h"
 #include "collision/convexdecomposition/HACDv2/wavefront.h"
 
@@ -49,6 +51,17 @@ int GetIndex(ChVector<double> vertex, std::vector< ChVector<double> >& vertexOUT
 	return (vertexOUT.size()-1);
 }
 
+// Index of a vertex in a list, by exact comparison, or -1 if not found
+int FindVertex(const ChVector<double>& vertex, const std::vector< ChVector<double> >& vertexes)
+{
+	for (unsigned int iv = 0; iv < vertexes.size(); iv++)
+	{
+		if ( vertex.Equals(vertexes[iv]) )
+			return iv;
+	}
+	return -1;
+}
+
 void FuseMesh(std::vector< ChVector<double> >& vertexIN,  std::vector< ChVector<int> >& triangleIN,
 			  std::vector< ChVector<double> >& vertexOUT,  std::vector< ChVector<int> >& triangleOUT, 
 			  double tol=0.0)
@@ -75,6 +88,8 @@ void FuseMesh(std::vector< ChVector<double> >& vertexIN,  std::vector< ChVector<
 	/// Basic constructor
 ChConvexDecomposition::ChConvexDecomposition()	
 		{
+			input_hash = 2166136261u;
+			use_loaded = false;
 		}
 
 	/// Destructor
@@ -116,6 +131,211 @@ bool ChConvexDecomposition::WriteConvexHullsAsChullsFile(ChStreamOutAscii& mstre
 			return true;
 		}
 
+bool ChConvexDecomposition::WriteConvexHullsAsBinaryFile(ChStreamOutBinary& mstream)
+		{
+			std::string tag("chulls_binary");
+			mstream << tag;
+			mstream.VersionWrite(1);
+			mstream << this->GetInputHash();
+			mstream << this->GetHullCount();
+
+			for (unsigned int ih = 0; ih < this->GetHullCount(); ih++)
+			{
+				std::vector< ChVector<double> > aconvexhull;
+				if (!this->GetConvexHullResult(ih, aconvexhull)) return false;
+
+				// triangles as indexes in the vertex list (vertexes of the 
+				// triangle soup are the same of the hull, exact match is enough)
+				geometry::ChTriangleMeshSoup atrimesh;
+				if (!this->GetConvexHullResult(ih, atrimesh)) return false;
+				std::vector< ChVector<int> > atriangles;
+				for (int it = 0; it < atrimesh.getNumTriangles(); it++)
+				{
+					geometry::ChTriangle tri = atrimesh.getTriangle(it);
+					ChVector<int> atriangle( FindVertex(tri.p1, aconvexhull),
+											 FindVertex(tri.p2, aconvexhull),
+											 FindVertex(tri.p3, aconvexhull) );
+					if (atriangle.x < 0 || atriangle.y < 0 || atriangle.z < 0)
+						return false;
+					atriangles.push_back(atriangle);
+				}
+
+				mstream << (unsigned int)aconvexhull.size();
+				for (unsigned int i=0; i<aconvexhull.size(); i++)
+					mstream << aconvexhull[i].x << aconvexhull[i].y << aconvexhull[i].z;
+
+				mstream << (unsigned int)atriangles.size();
+				for (unsigned int i=0; i<atriangles.size(); i++)
+					mstream << atriangles[i].x << atriangles[i].y << atriangles[i].z;
+			}
+			return true;
+		}
+
+bool ChConvexDecomposition::ParseBinaryHulls(ChStreamInBinary& mstream, 
+											 unsigned int& hash,
+											 std::vector< std::vector< ChVector<double> > >& hulls,
+											 std::vector< std::vector< ChVector<int> > >& hull_triangles)
+		{
+			std::string tag;
+			mstream >> tag;
+			if (tag != "chulls_binary") 
+				return false;
+			int version = mstream.VersionRead();
+			if (version != 1)
+				return false;
+
+			mstream >> hash;
+			unsigned int nhulls;
+			mstream >> nhulls;
+
+			hulls.resize(nhulls);
+			hull_triangles.resize(nhulls);
+			for (unsigned int ih = 0; ih < nhulls; ih++)
+			{
+				unsigned int npoints;
+				mstream >> npoints;
+				hulls[ih].resize(npoints);
+				for (unsigned int i=0; i<npoints; i++)
+					mstream >> hulls[ih][i].x >> hulls[ih][i].y >> hulls[ih][i].z;
+
+				unsigned int ntriangles;
+				mstream >> ntriangles;
+				hull_triangles[ih].resize(ntriangles);
+				for (unsigned int i=0; i<ntriangles; i++)
+				{
+					ChVector<int>& tri = hull_triangles[ih][i];
+					mstream >> tri.x >> tri.y >> tri.z;
+					// reject corrupted files, that would index out of the vertexes
+					if (tri.x < 0 || tri.y < 0 || tri.z < 0 ||
+						tri.x >= (int)npoints || tri.y >= (int)npoints || tri.z >= (int)npoints)
+						return false;
+				}
+			}
+			return true;
+		}
+
+bool ChConvexDecomposition::ReadConvexHullsFromBinaryFile(ChStreamInBinary& mstream, bool check_hash)
+		{
+			unsigned int hash;
+			std::vector< std::vector< ChVector<double> > > hulls;
+			std::vector< std::vector< ChVector<int> > > hull_triangles;
+
+			if (!ParseBinaryHulls(mstream, hash, hulls, hull_triangles))
+				return false;
+			if (check_hash && (hash != this->GetInputHash()))
+				return false;
+
+			this->loaded_hulls.swap(hulls);
+			this->loaded_hull_triangles.swap(hull_triangles);
+			this->use_loaded = true;
+			return true;
+		}
+
+int ChConvexDecomposition::ComputeConvexDecompositionCached(const char* filename)
+		{
+			// Try to load from the cache file, if already existing
+			if (std::ifstream(filename).good())
+			{
+				try
+				{
+					ChStreamInBinaryFile mstream(filename);
+					if (this->ReadConvexHullsFromBinaryFile(mstream, true))
+						return this->GetHullCount();
+				}
+				catch (const ChException&)
+				{
+					GetLog() << "Cannot load convex hulls from " << filename << ", recomputing them.\n";
+				}
+			}
+
+			// Not in cache, or outdated: compute and store
+			this->use_loaded = false;
+			int nhulls = this->ComputeConvexDecomposition();
+
+			try
+			{
+				ChStreamOutBinaryFile mstream(filename);
+				this->WriteConvexHullsAsBinaryFile(mstream);
+			}
+			catch (const ChException&)
+			{
+				GetLog() << "Cannot save convex hulls into " << filename << "\n";
+			}
+
+			return nhulls;
+		}
+
+unsigned int ChConvexDecomposition::HashData(unsigned int hash, const void* data, size_t n)
+		{
+			const unsigned char* bytes = (const unsigned char*)data;
+			for (size_t i = 0; i < n; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+void ChConvexDecomposition::HashTriangle(const ChVector<>& v1,const ChVector<>& v2,const ChVector<>& v3)
+		{
+			double coords[9] = {v1.x, v1.y, v1.z, v2.x, v2.y, v2.z, v3.x, v3.y, v3.z};
+			this->input_hash = HashData(this->input_hash, coords, sizeof(coords));
+		}
+
+void ChConvexDecomposition::ResetLoaded()
+		{
+			this->input_hash = 2166136261u;
+			this->use_loaded = false;
+			this->loaded_hulls.clear();
+			this->loaded_hull_triangles.clear();
+		}
+
+bool ChConvexDecomposition::GetLoadedHullResult(unsigned int hullIndex, std::vector< ChVector<double> >& convexhull)
+		{
+			if (hullIndex >= this->loaded_hulls.size()) 
+				return false;
+			convexhull = this->loaded_hulls[hullIndex];
+			return true;
+		}
+
+bool ChConvexDecomposition::GetLoadedHullResult(unsigned int hullIndex, geometry::ChTriangleMesh& convextrimesh)
+		{
+			if (hullIndex >= this->loaded_hulls.size()) 
+				return false;
+			std::vector< ChVector<double> >& points = this->loaded_hulls[hullIndex];
+			std::vector< ChVector<int> >& triangles = this->loaded_hull_triangles[hullIndex];
+			for (unsigned int i=0; i<triangles.size(); i++)
+			{
+				convextrimesh.addTriangle(points[triangles[i].x], points[triangles[i].y], points[triangles[i].z]);
+			}
+			return true;
+		}
+
+void ChConvexDecomposition::WriteLoadedHullsAsWavefrontObj(ChStreamOutAscii& mstream)
+		{
+			mstream << "# Convex hulls obtained with Chrono::Engine \n# convex decomposition \n\n";
+			unsigned int vcount_base = 1;
+			char buffer[200];
+			for (unsigned int hullIndex=0; hullIndex< this->loaded_hulls.size(); hullIndex++)
+			{
+				mstream << "g hull_" << hullIndex << "\n";
+
+				std::vector< ChVector<double> >& points = this->loaded_hulls[hullIndex];
+				std::vector< ChVector<int> >& triangles = this->loaded_hull_triangles[hullIndex];
+				for (unsigned int i=0; i<points.size(); i++)
+				{
+					sprintf(buffer,"v %0.9f %0.9f %0.9f\r\n", points[i].x, points[i].y, points[i].z );
+					mstream << buffer;
+				}
+				for (unsigned int i=0; i<triangles.size(); i++)
+				{
+					sprintf(buffer,"f %d %d %d\r\n", triangles[i].x+vcount_base, triangles[i].y+vcount_base, triangles[i].z+vcount_base );
+					mstream << buffer;
+				}
+				vcount_base+=points.size();
+			}
+		}
+
 
 
 
@@ -146,6 +366,7 @@ void ChConvexDecompositionHACD::Reset(void)
 			myHACD = HACD::CreateHACD();
 			this->points.clear();
 			this->triangles.clear();
+			this->ResetLoaded();
 		}
 
 bool ChConvexDecompositionHACD::AddTriangle(const ChVector<>& v1,const ChVector<>& v2,const ChVector<>& v3)
@@ -159,6 +380,7 @@ bool ChConvexDecompositionHACD::AddTriangle(const ChVector<>& v1,const ChVector<
 			this->points.push_back(vertex3);
 			HACD::Vec3<long> newtri(lastpoint,lastpoint+1,lastpoint+2);
 			this->triangles.push_back(newtri);
+			this->HashTriangle(v1,v2,v3);
 			return true;
 		}
 
@@ -196,8 +418,24 @@ void ChConvexDecompositionHACD::SetParameters(
 			myHACD->SetNVerticesPerCH(nVerticesPerCH);
 		}
 
+unsigned int ChConvexDecompositionHACD::GetInputHash()
+		{
+			double params[10] = {(double)myHACD->GetNMinClusters(),
+								 (double)myHACD->GetTargetNTrianglesDecimatedMesh(),
+								 myHACD->GetSmallClusterThreshold(),
+								 (double)myHACD->GetAddFacesPoints(),
+								 (double)myHACD->GetAddExtraDistPoints(),
+								 myHACD->GetConcavity(),
+								 myHACD->GetConnectDist(),
+								 myHACD->GetVolumeWeight(),
+								 myHACD->GetCompacityWeight(),
+								 (double)myHACD->GetNVerticesPerCH()};
+			return HashData(this->input_hash, params, sizeof(params));
+		}
+
 int ChConvexDecompositionHACD::ComputeConvexDecomposition()
 		{
+			this->use_loaded = false;
 			myHACD->SetPoints(&this->points[0]);
 			myHACD->SetNPoints(points.size());
 			myHACD->SetTriangles(&this->triangles[0]);
@@ -211,12 +449,17 @@ int ChConvexDecompositionHACD::ComputeConvexDecomposition()
 	/// Get the number of computed hulls after the convex decomposition
 unsigned int ChConvexDecompositionHACD::GetHullCount() 
 		{ 
+			if (this->use_loaded)
+				return this->GetLoadedHullCount();
 			return this->myHACD->GetNClusters(); 
 		}
 
 
 bool ChConvexDecompositionHACD::GetConvexHullResult(unsigned int hullIndex, std::vector< ChVector<double> >& convexhull)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convexhull);
+
 			if (hullIndex > myHACD->GetNClusters()) 
 				return false;
 
@@ -248,6 +491,9 @@ bool ChConvexDecompositionHACD::GetConvexHullResult(unsigned int hullIndex, std:
 	/// that is passed as a parameter.
 bool ChConvexDecompositionHACD::GetConvexHullResult(unsigned int hullIndex, geometry::ChTriangleMesh& convextrimesh)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convextrimesh);
+
 			if (hullIndex > myHACD->GetNClusters()) 
 				return false;
 
@@ -286,6 +532,12 @@ bool ChConvexDecompositionHACD::GetConvexHullResult(unsigned int hullIndex, geom
 
 void ChConvexDecompositionHACD::WriteConvexHullsAsWavefrontObj(ChStreamOutAscii& mstream)
 		{
+			if (this->use_loaded)
+			{
+				this->WriteLoadedHullsAsWavefrontObj(mstream);
+				return;
+			}
+
 			mstream << "# Convex hulls obtained with Chrono::Engine \n# convex decomposition \n\n";
 			NxU32 vcount_base = 1;
 			NxU32 vcount_total = 0;
@@ -360,6 +612,7 @@ ChConvexDecompositionJR::~ChConvexDecompositionJR()
 void ChConvexDecompositionJR::Reset(void) 
 		{ 
 			this->mydecomposition->reset();
+			this->ResetLoaded();
 		}
 
 bool ChConvexDecompositionJR::AddTriangle(const ChVector<>& v1,const ChVector<>& v2,const ChVector<>& v3)
@@ -367,6 +620,7 @@ bool ChConvexDecompositionJR::AddTriangle(const ChVector<>& v1,const ChVector<>&
 			NxF32 p1[3]; p1[0]=(float)v1.x; p1[1]=(float)v1.y; p1[2]=(float)v1.z;
 			NxF32 p2[3]; p2[0]=(float)v2.x; p2[1]=(float)v2.y; p2[2]=(float)v2.z;
 			NxF32 p3[3]; p3[0]=(float)v3.x; p3[1]=(float)v3.y; p3[2]=(float)v3.z;
+			this->HashTriangle(v1,v2,v3);
 			return this->mydecomposition->addTriangle(p1,p2,p3); 
 		}
 
@@ -400,8 +654,22 @@ void ChConvexDecompositionJR::SetParameters(
 			useIslandGeneration=museIslandGeneration;
 		}
 
+unsigned int ChConvexDecompositionJR::GetInputHash()
+		{
+			double params[8] = {skinWidth,
+								(double)decompositionDepth,
+								(double)maxHullVertices,
+								concavityThresholdPercent,
+								mergeThresholdPercent,
+								volumeSplitThresholdPercent,
+								(double)useInitialIslandGeneration,
+								(double)useIslandGeneration};
+			return HashData(this->input_hash, params, sizeof(params));
+		}
+
 int ChConvexDecompositionJR::ComputeConvexDecomposition()
 		{
+			this->use_loaded = false;
 			return this->mydecomposition->computeConvexDecomposition(skinWidth,
 										 decompositionDepth, 
 										 maxHullVertices,
@@ -414,13 +682,21 @@ int ChConvexDecompositionJR::ComputeConvexDecomposition()
 		}
 
 	/// Get the number of computed hulls after the convex decomposition
-unsigned int ChConvexDecompositionJR::GetHullCount() { return this->mydecomposition->getHullCount(); }
+unsigned int ChConvexDecompositionJR::GetHullCount() 
+		{ 
+			if (this->use_loaded)
+				return this->GetLoadedHullCount();
+			return this->mydecomposition->getHullCount(); 
+		}
 
 
 	/// Get the n-th computed convex hull, by filling a ChTriangleMesh object
 	/// that is passed as a parameter.
 bool ChConvexDecompositionJR::GetConvexHullResult(unsigned int hullIndex, geometry::ChTriangleMesh& convextrimesh)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convextrimesh);
+
 			CONVEX_DECOMPOSITION::ConvexHullResult result;
 			if (!this->mydecomposition->getConvexHullResult(hullIndex, result)) return false;
 			
@@ -439,6 +715,9 @@ bool ChConvexDecompositionJR::GetConvexHullResult(unsigned int hullIndex, geomet
 
 bool ChConvexDecompositionJR::GetConvexHullResult(unsigned int hullIndex, std::vector< ChVector<double> >& convexhull)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convexhull);
+
 			CONVEX_DECOMPOSITION::ConvexHullResult result;
 			if (!this->mydecomposition->getConvexHullResult(hullIndex, result)) return false;
 			
@@ -462,6 +741,12 @@ bool ChConvexDecompositionJR::GetConvexHullResult(unsigned int hullIndex, std::v
 	/// May throw exceptions if file locked etc.
 void ChConvexDecompositionJR::WriteConvexHullsAsWavefrontObj(ChStreamOutAscii& mstream)
 		{
+			if (this->use_loaded)
+			{
+				this->WriteLoadedHullsAsWavefrontObj(mstream);
+				return;
+			}
+
 			mstream << "# Convex hulls obtained with Chrono::Engine \n# convex decomposition \n\n";
 			NxU32 vcount_base = 1;
 			NxU32 vcount_total = 0;
@@ -529,6 +814,7 @@ void ChConvexDecompositionHACDv2::Reset(void)
 
 			this->points.clear();
 			this->triangles.clear();
+			this->ResetLoaded();
 		}
 
 bool ChConvexDecompositionHACDv2::AddTriangle(const ChVector<>& v1,const ChVector<>& v2,const ChVector<>& v3)
@@ -542,6 +828,7 @@ bool ChConvexDecompositionHACDv2::AddTriangle(const ChVector<>& v1,const ChVecto
 			this->points.push_back(vertex3);
 			ChVector<int> newtri(lastpoint,lastpoint+1,lastpoint+2);
 			this->triangles.push_back(newtri);
+			this->HashTriangle(v1,v2,v3);
 			return true;
 		}
 
@@ -589,8 +876,21 @@ public:
 };
 
 
+unsigned int ChConvexDecompositionHACDv2::GetInputHash()
+		{
+			double params[6] = {(double)descriptor.mMaxHullCount,
+								(double)descriptor.mMaxMergeHullCount,
+								(double)descriptor.mMaxHullVertices,
+								descriptor.mConcavity,
+								descriptor.mSmallClusterThreshold,
+								fuse_tol};
+			return HashData(this->input_hash, params, sizeof(params));
+		}
+
 int ChConvexDecompositionHACDv2::ComputeConvexDecomposition()
 		{
+			this->use_loaded = false;
+
 			if (!gHACD) 
 				return 0;
 
@@ -638,6 +938,8 @@ int ChConvexDecompositionHACDv2::ComputeConvexDecomposition()
 	/// Get the number of computed hulls after the convex decomposition
 unsigned int ChConvexDecompositionHACDv2::GetHullCount() 
 		{ 
+			if (this->use_loaded)
+				return this->GetLoadedHullCount();
 			return this->gHACD->getHullCount();
 		}
 
@@ -645,6 +947,9 @@ unsigned int ChConvexDecompositionHACDv2::GetHullCount()
 
 bool ChConvexDecompositionHACDv2::GetConvexHullResult(unsigned int hullIndex, std::vector< ChVector<double> >& convexhull)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convexhull);
+
 			if (hullIndex > this->gHACD->getHullCount()) 
 				return false;
 
@@ -666,6 +971,9 @@ bool ChConvexDecompositionHACDv2::GetConvexHullResult(unsigned int hullIndex, st
 	/// that is passed as a parameter.
 bool ChConvexDecompositionHACDv2::GetConvexHullResult(unsigned int hullIndex, geometry::ChTriangleMesh& convextrimesh)
 		{
+			if (this->use_loaded)
+				return this->GetLoadedHullResult(hullIndex, convextrimesh);
+
 			if (hullIndex > this->gHACD->getHullCount()) 
 				return false;
 
@@ -695,6 +1003,12 @@ bool ChConvexDecompositionHACDv2::GetConvexHullResult(unsigned int hullIndex, ge
 
 void ChConvexDecompositionHACDv2::WriteConvexHullsAsWavefrontObj(ChStreamOutAscii& mstream)
 		{
+			if (this->use_loaded)
+			{
+				this->WriteLoadedHullsAsWavefrontObj(mstream);
+				return;
+			}
+
 			mstream << "# Convex hulls obtained with Chrono::Engine \n# convex decomposition \n\n";
 
 			char buffer[200];
@@ -111,13 +111,77 @@ public:
 		/// May throw exceptions if file locked etc.
 	virtual void WriteConvexHullsAsWavefrontObj(ChStreamOutAscii& mstream) =0;
 
+		/// Write the convex decomposition to a compact binary file, that stores 
+		/// the vertexes and the triangles of each hull, plus the hash of the input 
+		/// mesh and parameters (see GetInputHash()). This is also the file format of
+		/// the cache used by ComputeConvexDecompositionCached(). 
+		/// It can be loaded into collision models using ChCollisionModel::AddConvexHullsFromFile().
+		/// Can throw exceptions.
+	virtual bool WriteConvexHullsAsBinaryFile(ChStreamOutBinary& mstream);
+
+		/// Load the hulls from a binary file written by WriteConvexHullsAsBinaryFile(); 
+		/// after this, GetHullCount(), GetConvexHullResult() etc. will return the loaded hulls
+		/// (until Reset() is called) as if ComputeConvexDecomposition() was executed. 
+		/// If check_hash is true and the file was created from a different input mesh or 
+		/// with different parameters, nothing is loaded and false is returned.
+		/// Can throw exceptions.
+	virtual bool ReadConvexHullsFromBinaryFile(ChStreamInBinary& mstream, bool check_hash = true);
+
+		/// Utility to parse the binary hull file format of WriteConvexHullsAsBinaryFile(). 
+		/// Returns false if the file is not in this format, has a different version, 
+		/// or has triangles that index out of the vertexes of their hull.
+		/// Can throw exceptions.
+	static bool ParseBinaryHulls(ChStreamInBinary& mstream, 
+								 unsigned int& hash,
+								 std::vector< std::vector< ChVector<double> > >& hulls,
+								 std::vector< std::vector< ChVector<int> > >& hull_triangles);
 
 	//
-	// DATA
+	// CACHING
 	//
 
-private:
+		/// Returns a hash of the input mesh and of the parameters of the decomposition,
+		/// so that it can be used as a key to identify cached decompositions.
+		/// Children classes should add their parameters to the hash of the mesh.
+	virtual unsigned int GetInputHash() {return input_hash;}
+
+		/// Perform the convex decomposition, unless a binary hull file obtained from 
+		/// the same input mesh with the same parameters is found at 'filename': in such a case
+		/// the hulls are just loaded from the file. Otherwise, the decomposition is 
+		/// computed and saved into 'filename', so that the next run will be faster.
+		/// Returns the number of hulls.
+	virtual int ComputeConvexDecompositionCached(const char* filename);
+
+		/// Returns true if the current hulls were loaded from a binary file, rather
+		/// than computed.
+	bool IsLoadedFromFile() {return use_loaded;}
+
+protected:
+		// Updates the input hash with a new triangle. Children classes
+		// must call this in AddTriangle().
+	void HashTriangle(const ChVector<>& v1,const ChVector<>& v2,const ChVector<>& v3);
+
+		// Updates a hash with n bytes of data (FNV-1a)
+	static unsigned int HashData(unsigned int hash, const void* data, size_t n);
+
+		// Discard the loaded hulls, if any, and reset input hash.
+	void ResetLoaded();
+
+		// Access hulls loaded by ReadConvexHullsFromBinaryFile(): children 
+		// classes use these when IsLoadedFromFile() is true.
+	unsigned int GetLoadedHullCount() {return (unsigned int)loaded_hulls.size();}
+	bool GetLoadedHullResult(unsigned int hullIndex, geometry::ChTriangleMesh& convextrimesh);
+	bool GetLoadedHullResult(unsigned int hullIndex, std::vector< ChVector<double> >& convexhull);
+	void WriteLoadedHullsAsWavefrontObj(ChStreamOutAscii& mstream);
 
+	//
+	// DATA
+	//
+
+	unsigned int input_hash;
+	bool use_loaded;
+	std::vector< std::vector< ChVector<double> > > loaded_hulls;
+	std::vector< std::vector< ChVector<int> > > loaded_hull_triangles;
 };
 
 
@@ -185,6 +249,9 @@ public:
 		/// or with gaps/holes, may give wrong results.
 	virtual int ComputeConvexDecomposition();
 
+		/// Returns a hash of the input mesh and of the decomposition parameters.
+	virtual unsigned int GetInputHash();
+
 
 		/// Get the number of computed hulls after the convex decomposition
 	virtual unsigned int GetHullCount();
@@ -280,6 +347,9 @@ public:
 		/// or with gaps/holes, may give wrong results.
 	virtual int ComputeConvexDecomposition();
 
+		/// Returns a hash of the input mesh and of the decomposition parameters.
+	virtual unsigned int GetInputHash();
+
 		/// Get the number of computed hulls after the convex decomposition
 	virtual unsigned int GetHullCount();
 
@@ -375,6 +445,9 @@ public:
 		/// or with gaps/holes, may give wrong results.
 	virtual int ComputeConvexDecomposition();
 
+		/// Returns a hash of the input mesh and of the decomposition parameters.
+	virtual unsigned int GetInputHash();
+
 
 		/// Get the number of computed hulls after the convex decomposition
 	virtual unsigned int GetHullCount();
@@ -30,6 +30,7 @@
 #include "collision/ChCCollisionSystemBullet.h"
 #include "BulletWorldImporter/btBulletWorldImporter.h"
 #include "collision/ChCConvexDecomposition.h"
+#include "BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h"
 
 
 namespace chrono 
@@ -51,6 +52,8 @@ ChModelBullet::ChModelBullet()
 	this->family_group = 1;
 	this->family_mask  = 0xFF;
 
+	this->shape_library = 0;
+
 	shapes.clear();
 
 
@@ -134,6 +137,11 @@ static void ChCoordsToBullet(const ChCoordsys<>& mcoords, btTransform& mtrasform
 }
 
 void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot, btCollisionShape* mshape)
+{
+	_injectShape(pos, rot, smartptrshapes(mshape));
+}
+
+void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot, smartptrshapes mshape)
 {
 	bool centered = (pos.IsNull() && rot.IsIdentity());
 
@@ -142,8 +150,8 @@ void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot,
 	{
 		if (centered)
 		{
-			shapes.push_back(ChSmartPtr<btCollisionShape>(mshape)); 
-			bt_collision_object->setCollisionShape(mshape);
+			shapes.push_back(mshape); 
+			bt_collision_object->setCollisionShape(mshape.get_ptr());
 			// end_vector=  | centered shape | 
 			return;
 		}
@@ -151,11 +159,11 @@ void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot,
 		{
 			btCompoundShape* mcompound = new btCompoundShape(true);
 			shapes.push_back(ChSmartPtr<btCollisionShape>(mcompound)); 
-			shapes.push_back(ChSmartPtr<btCollisionShape>(mshape)); 
+			shapes.push_back(mshape); 
 			bt_collision_object->setCollisionShape(mcompound);
 			btTransform mtrasform;
 			ChPosMatrToBullet(pos, rot, mtrasform);
-			mcompound->addChildShape(mtrasform, mshape);
+			mcompound->addChildShape(mtrasform, mshape.get_ptr());
 			// vector=  | compound | not centered shape |
 			return;
 		}
@@ -165,7 +173,7 @@ void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot,
 	{
 		btTransform mtrasform;
 		shapes.push_back(shapes[0]);
-		shapes.push_back(ChSmartPtr<btCollisionShape>(mshape));
+		shapes.push_back(mshape);
 		btCompoundShape* mcompound = new btCompoundShape(true);
 		shapes[0] = ChSmartPtr<btCollisionShape>(mcompound); 
 		bt_collision_object->setCollisionShape(mcompound);
@@ -180,10 +188,10 @@ void ChModelBullet::_injectShape(const ChVector<>& pos, const ChMatrix33<>& rot,
 	if (shapes.size()>1)
 	{
 		btTransform mtrasform;
-		shapes.push_back(ChSmartPtr<btCollisionShape>(mshape)); 
+		shapes.push_back(mshape); 
 		ChPosMatrToBullet(pos, rot, mtrasform);
 		btCollisionShape* mcom = shapes[0].get_ptr(); 
-		((btCompoundShape*)mcom)->addChildShape(mtrasform, mshape); 
+		((btCompoundShape*)mcom)->addChildShape(mtrasform, mshape.get_ptr()); 
 		// vector=  | compound | old | old.. | new shape | ...
 		return;
 	}
@@ -306,6 +314,20 @@ bool ChModelBullet::AddConvexHull (std::vector< ChVector<double> >& pointlist,
 	// adjust default inward margin (if object too thin)
 	//this->SetSafeMargin((btScalar)ChMin(this->GetSafeMargin(), ... );
 
+	// reuse an identical hull, if available in the shape library
+	ChCollisionShapeLibrary::ChShapeKey mkey;
+	if (this->shape_library)
+	{
+		mkey = ChCollisionShapeLibrary::KeyConvexHull(pointlist, this->GetSuggestedFullMargin());
+		smartptrshapes mshared = this->shape_library->Find(mkey);
+		if (!mshared.IsNull())
+		{
+			_injectShape(pos, rot, mshared);
+			model_type=CONVEXHULL;
+			return true;
+		}
+	}
+
 	btConvexHullShape* mshape = new btConvexHullShape;
 	
 	mshape->setMargin((btScalar)this->GetSuggestedFullMargin());
@@ -329,7 +351,11 @@ bool ChModelBullet::AddConvexHull (std::vector< ChVector<double> >& pointlist,
 	GetLog() << "\nAAABB min  " << (double)mmin.getX() << "   "  << (double)mmin.getY() << "   " << (double)mmin.getZ() << "\n" ;
 	GetLog() << "AAABB max  " << (double)mmax.getX() << "   "  << (double)mmax.getY() << "   " << (double)mmax.getZ() << "\n" ;
 	*/
-	_injectShape(pos, rot, mshape);
+	smartptrshapes mshapeptr(mshape);
+	if (this->shape_library)
+		this->shape_library->Insert(mkey, mshapeptr);
+
+	_injectShape(pos, rot, mshapeptr);
 
 	model_type=CONVEXHULL;
 	return true;
@@ -407,6 +433,78 @@ public:
 };
 
 
+// These classes are used for instancing shapes that are shared among models, for
+// example through a ChCollisionShapeLibrary: they hold shared pointers to their
+// children shapes, so the children live as long as some instance or compound uses them.
+
+class btCompoundShape_handlechildren : public btCompoundShape
+{
+	std::vector<smartptrshapes> children;
+public:
+	btCompoundShape_handlechildren() : btCompoundShape(true) {};
+
+	void addSharedChildShape(const btTransform& localTransform, smartptrshapes mshape)
+	{
+		children.push_back(mshape);
+		addChildShape(localTransform, mshape.get_ptr());
+	}
+
+	smartptrshapes getSharedChildShape(int index) {return children[index];}
+};
+
+// The btUniformScalingShape scales also the margin of the child, so the
+// envelope would become scaling*envelope, but the contacts are reported
+// subtracting the envelope of the model: the margin is corrected so that
+// the scaled shape is enlarged exactly by the envelope.
+class btUniformScalingShape_handleshape : public btUniformScalingShape
+{
+	smartptrshapes mchild;
+	btScalar mmargin;
+public:
+	btUniformScalingShape_handleshape(smartptrshapes mconvex, btScalar scaling, btScalar envelope) :
+			btUniformScalingShape((btConvexShape*)mconvex.get_ptr(), scaling),
+			mchild(mconvex)
+		{
+			mmargin = ((btConvexShape*)mconvex.get_ptr())->getMargin() * scaling - (scaling - 1) * envelope;
+		};
+
+	virtual btScalar getMargin() const {return mmargin;}
+	virtual void setMargin(btScalar margin) {mmargin = margin;}	// never change the shared child
+
+	virtual btVector3 localGetSupportingVertex(const btVector3& vec) const
+		{
+			btVector3 vecnorm = vec;
+			if (vecnorm.length2() < (SIMD_EPSILON*SIMD_EPSILON))
+				vecnorm.setValue(btScalar(-1.),btScalar(-1.),btScalar(-1.));
+			vecnorm.normalize();
+			return localGetSupportingVertexWithoutMargin(vec) + mmargin * vecnorm;
+		}
+
+	virtual void getAabb(const btTransform& t, btVector3& aabbMin, btVector3& aabbMax) const
+		{
+			btUniformScalingShape::getAabb(t, aabbMin, aabbMax);
+			btScalar mdelta = mmargin - getChildShape()->getMargin() * getUniformScalingFactor();
+			btVector3 mextra(mdelta, mdelta, mdelta);
+			aabbMin -= mextra;
+			aabbMax += mextra;
+		}
+};
+
+// The btScaledBvhTriangleMeshShape has no margin of its own: use the
+// (not scaled) margin of the mesh, as for the not scaled instances.
+class btScaledBvhTriangleMeshShape_handleshape : public btScaledBvhTriangleMeshShape
+{
+	smartptrshapes mchild;
+public:
+	btScaledBvhTriangleMeshShape_handleshape(smartptrshapes mmesh, btScalar scaling) :
+			btScaledBvhTriangleMeshShape((btBvhTriangleMeshShape*)mmesh.get_ptr(), btVector3(scaling,scaling,scaling)),
+			mchild(mmesh)
+		{
+			setMargin(mmesh->getMargin());
+		};
+};
+
+
 /// Add a triangle mesh to this model
 bool ChModelBullet::AddTriangleMesh (const geometry::ChTriangleMesh& trimesh,
                                      bool                            is_static,
@@ -417,6 +515,26 @@ bool ChModelBullet::AddTriangleMesh (const geometry::ChTriangleMesh& trimesh,
 	if (!trimesh.getNumTriangles()) 
 		return false;
 
+	// reuse an identical shape, if available in the shape library
+	ChCollisionShapeLibrary::ChShapeKey mkey;
+	if (this->shape_library)
+	{
+		ChCollisionShapeLibrary::eChShapeKind mkind = ChCollisionShapeLibrary::KIND_TRIMESH_STATIC;
+		if (!is_static)
+			mkind = is_convex ? ChCollisionShapeLibrary::KIND_TRIMESH_CONVEX : ChCollisionShapeLibrary::KIND_TRIMESH_DECOMPOSED;
+		double mmargin = is_static ? this->GetSafeMargin() : this->GetEnvelope();
+		mkey = ChCollisionShapeLibrary::KeyTriangleMesh(trimesh, mkind, mmargin);
+		smartptrshapes mshared = this->shape_library->Find(mkey);
+		if (!mshared.IsNull())
+		{
+			if (mkind == ChCollisionShapeLibrary::KIND_TRIMESH_DECOMPOSED)
+				this->SetSafeMargin(0);
+			_injectShape(pos, rot, mshared);
+			model_type=TRIANGLEMESH;
+			return true;
+		}
+	}
+
 	btTriangleMesh* bulletMesh = new btTriangleMesh;
 	for (int i=0; i<trimesh.getNumTriangles(); i++)
 	{
@@ -437,7 +555,10 @@ bool ChModelBullet::AddTriangleMesh (const geometry::ChTriangleMesh& trimesh,
 		//btCollisionShape* pShape = new btGImpactMeshShape_handlemesh(bulletMesh);
 		//pShape->setMargin((btScalar) this->GetSafeMargin() );
 		//((btGImpactMeshShape_handlemesh*)pShape)->updateBound();
-		_injectShape(pos, rot, pShape);
+		smartptrshapes mshapeptr(pShape);
+		if (this->shape_library)
+			this->shape_library->Insert(mkey, mshapeptr);
+		_injectShape(pos, rot, mshapeptr);
 	}
 	else
 	{
@@ -445,7 +566,10 @@ bool ChModelBullet::AddTriangleMesh (const geometry::ChTriangleMesh& trimesh,
 		{
 			btCollisionShape* pShape = (btConvexTriangleMeshShape*) new btConvexTriangleMeshShape_handlemesh(bulletMesh);
 			pShape->setMargin( (btScalar) this->GetEnvelope() );
-			_injectShape(pos, rot, pShape);
+			smartptrshapes mshapeptr(pShape);
+			if (this->shape_library)
+				this->shape_library->Insert(mkey, mshapeptr);
+			_injectShape(pos, rot, mshapeptr);
 		} 
 		else
 		{
@@ -470,7 +594,15 @@ bool ChModelBullet::AddTriangleMesh (const geometry::ChTriangleMesh& trimesh,
 			                                 );
 			mydecompositionJR.ComputeConvexDecomposition();
 			GetLog() << " found n.hulls=" << mydecompositionJR.GetHullCount() << "\n";
-			this->AddTriangleMeshConcaveDecomposed(mydecompositionJR, pos, rot);
+			if (this->shape_library)
+			{
+				this->SetSafeMargin(0);
+				smartptrshapes mcompound = _createDecomposedCompound(mydecompositionJR);
+				this->shape_library->Insert(mkey, mcompound);
+				_injectShape(pos, rot, mcompound);
+			}
+			else
+				this->AddTriangleMeshConcaveDecomposed(mydecompositionJR, pos, rot);
 
 			/*
 			// ----- ..or use this? (using the HACD convex decomposition) : 
@@ -506,6 +638,20 @@ bool ChModelBullet::AddTriangleMeshConcave(const geometry::ChTriangleMesh& trime
 	if (!trimesh.getNumTriangles()) 
 		return false;
 
+	// reuse an identical shape, if available in the shape library
+	ChCollisionShapeLibrary::ChShapeKey mkey;
+	if (this->shape_library)
+	{
+		mkey = ChCollisionShapeLibrary::KeyTriangleMesh(trimesh, ChCollisionShapeLibrary::KIND_TRIMESH_CONCAVE, this->GetEnvelope());
+		smartptrshapes mshared = this->shape_library->Find(mkey);
+		if (!mshared.IsNull())
+		{
+			this->SetSafeMargin(0);
+			_injectShape(pos, rot, mshared);
+			return true;
+		}
+	}
+
 	btTriangleMesh* bulletMesh = new btTriangleMesh;
 	for (int i=0; i<trimesh.getNumTriangles(); i++)
 	{
@@ -523,7 +669,10 @@ bool ChModelBullet::AddTriangleMeshConcave(const geometry::ChTriangleMesh& trime
 	this->SetSafeMargin(0);
 
 	((btGImpactMeshShape_handlemesh*)pShape)->updateBound();
-	_injectShape(pos, rot, pShape);
+	smartptrshapes mshapeptr(pShape);
+	if (this->shape_library)
+		this->shape_library->Insert(mkey, mshapeptr);
+	_injectShape(pos, rot, mshapeptr);
 
 	return true;
 }
@@ -535,6 +684,21 @@ bool ChModelBullet::AddTriangleMeshConcaveDecomposed(ChConvexDecomposition& myde
 	// note: since the convex hulls are ot shrunk, the safe margin will be set to zero (must be set before adding them)
 	this->SetSafeMargin(0);
 
+	// with a shape library, share the whole compound of hulls
+	if (this->shape_library)
+	{
+		ChCollisionShapeLibrary::ChShapeKey mkey = 
+			ChCollisionShapeLibrary::KeyConvexDecomposition(mydecomposition, this->GetSuggestedFullMargin());
+		smartptrshapes mcompound = this->shape_library->Find(mkey);
+		if (mcompound.IsNull())
+		{
+			mcompound = _createDecomposedCompound(mydecomposition);
+			this->shape_library->Insert(mkey, mcompound);
+		}
+		_injectShape(pos, rot, mcompound);
+		return true;
+	}
+
 	for (unsigned int j = 0; j< mydecomposition.GetHullCount(); j++)
 	{
 		std::vector< ChVector<double> > ptlist;
@@ -547,6 +711,90 @@ bool ChModelBullet::AddTriangleMeshConcaveDecomposed(ChConvexDecomposition& myde
 	return true;
 }
 
+smartptrshapes ChModelBullet::_createDecomposedCompound(ChConvexDecomposition& mydecomposition)
+{
+	btCompoundShape_handlechildren* mcompound = new btCompoundShape_handlechildren;
+	btTransform mtrasform;
+	mtrasform.setIdentity();
+
+	for (unsigned int j = 0; j< mydecomposition.GetHullCount(); j++)
+	{
+		std::vector< ChVector<double> > ptlist;
+		mydecomposition.GetConvexHullResult(j, ptlist);
+
+		if (!ptlist.size())
+			continue;
+
+		btConvexHullShape* mhull = new btConvexHullShape;
+		for (unsigned int i = 0; i < ptlist.size(); i++)
+			mhull->addPoint( ChVectToBullet(ptlist[i]) );
+		mhull->setMargin((btScalar)this->GetSuggestedFullMargin() );
+		mhull->recalcLocalAabb();
+
+		mcompound->addSharedChildShape(mtrasform, smartptrshapes(mhull));
+	}
+
+	return smartptrshapes(mcompound);
+}
+
+bool ChModelBullet::AddShapeInstance (smartptrshapes      mshape,
+                                      const ChVector<>&   pos,
+                                      const ChMatrix33<>& rot,
+                                      double              scale)
+{
+	if (mshape.IsNull())
+		return false;
+
+	if (scale == 1.0)
+	{
+		_injectShape(pos, rot, mshape);
+		return true;
+	}
+
+	// Scaled instances: wrap the shared shape, never modify it.
+	btCollisionShape* mbtshape = mshape.get_ptr();
+
+	if (mbtshape->isConvex())
+	{
+		_injectShape(pos, rot, smartptrshapes(new btUniformScalingShape_handleshape(mshape, (btScalar)scale, (btScalar)this->GetEnvelope())));
+		return true;
+	}
+
+	if (mbtshape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+	{
+		_injectShape(pos, rot, smartptrshapes(new btScaledBvhTriangleMeshShape_handleshape(mshape, (btScalar)scale)));
+		return true;
+	}
+
+	// Compounds of shared shapes: add scaled instances of the children
+	btCompoundShape_handlechildren* mcompound = dynamic_cast<btCompoundShape_handlechildren*>(mbtshape);
+	if (mcompound)
+	{
+		for (int i = 0; i < mcompound->getNumChildShapes(); i++)
+		{
+			const btTransform& mchildframe = mcompound->getChildTransform(i);
+			const btVector3&   mchildpos   = mchildframe.getOrigin();
+			const btMatrix3x3& mchildrot   = mchildframe.getBasis();
+			ChMatrix33<> childrot;
+			for (int r = 0; r < 3; r++)
+				for (int c = 0; c < 3; c++)
+					childrot(r,c) = mchildrot[r][c];
+			ChVector<> childpos(mchildpos.x(), mchildpos.y(), mchildpos.z());
+			ChMatrix33<> absrot;
+			absrot.MatrMultiply(rot, childrot);
+			if (!this->AddShapeInstance(mcompound->getSharedChildShape(i), 
+										pos + rot.Matr_x_Vect(childpos * scale), 
+										absrot, 
+										scale))
+				return false;
+		}
+		return true;
+	}
+
+	GetLog() << "Warning: scaled instance not supported for this type of collision shape.\n";
+	return false;
+}
+
 bool ChModelBullet::AddCopyOfAnotherModel (ChCollisionModel* another)
 {
 	//this->ClearModel();
@@ -33,6 +33,7 @@
 #include "ChCCollisionModel.h" 
 #include "core/ChSmartpointers.h"
 #include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "ChCCollisionShapeLibrary.h"
 
 // forward references
 class btCollisionObject;
@@ -43,7 +44,6 @@ namespace chrono
 
 // forward references
 class ChBody;
-typedef ChSmartPtr<btCollisionShape> smartptrshapes;
 
 namespace collision 
 {
@@ -65,6 +65,9 @@ protected:
 	short int	family_group;
 	short int	family_mask;
 
+			// Optional library of shared shapes (not owned)
+	ChCollisionShapeLibrary* shape_library;
+
 public:
 
   ChModelBullet();
@@ -217,6 +220,25 @@ public:
 	/// The 'another' model must be of ChModelBullet subclass.
   virtual bool AddCopyOfAnotherModel (ChCollisionModel* another);
 
+	/// CUSTOM for this class only: add an instance of a shape that can be shared 
+	/// among many models, for example a shape from a ChCollisionShapeLibrary.
+	/// The shape is not copied; only the position, rotation and uniform scaling
+	/// are stored per instance. Scaling is supported for convex shapes, static
+	/// triangle meshes, and compounds of these.
+  virtual bool AddShapeInstance (smartptrshapes      mshape,
+                                 const ChVector<>&   pos = ChVector<>(),
+                                 const ChMatrix33<>& rot = ChMatrix33<>(1),
+                                 double              scale = 1.0);
+
+	/// CUSTOM for this class only: set a library of shared shapes. If set,
+	/// AddConvexHull(), AddTriangleMesh(), AddTriangleMeshConcave() and 
+	/// AddTriangleMeshConcaveDecomposed() look for an identical shape in the
+	/// library (same geometry and margins) and reference it instead of creating
+	/// a new one; new shapes are stored in the library. The library is not
+	/// owned by the model and must outlive the definition of the model.
+  void SetShapeLibrary(ChCollisionShapeLibrary* mlib) {shape_library = mlib;}
+  ChCollisionShapeLibrary* GetShapeLibrary() {return shape_library;}
+
 
   virtual void SetFamily(int mfamily);
   virtual int  GetFamily();
@@ -255,6 +277,8 @@ public:
 
 private:
 	void _injectShape(const ChVector<>& pos, const ChMatrix33<>& rot, btCollisionShape* mshape);
+	void _injectShape(const ChVector<>& pos, const ChMatrix33<>& rot, smartptrshapes mshape);
+	smartptrshapes _createDecomposedCompound(ChConvexDecomposition& mydecomposition);
 };
 
 
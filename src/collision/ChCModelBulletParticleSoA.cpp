@@ -0,0 +1,91 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+//////////////////////////////////////////////////
+//  
+//   ChCModelBulletParticleSoA.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com 
+// ------------------------------------------------
+///////////////////////////////////////////////////
+ 
+ 
+ 
+#include "ChCModelBulletParticleSoA.h" 
+#include "physics/ChParticlesClonesSoA.h"
+#include "collision/bullet/btBulletCollisionCommon.h"
+
+
+namespace chrono 
+{
+namespace collision 
+{
+
+
+
+ChModelBulletParticleSoA::ChModelBulletParticleSoA()
+{
+	this->particles = 0;
+	this->particle_id = 0;
+}
+
+
+ChModelBulletParticleSoA::~ChModelBulletParticleSoA()
+{
+}
+
+
+void ChModelBulletParticleSoA::SetSampleModel(ChModelBullet* msample)
+{
+	this->bt_collision_object->setCollisionShape(msample->GetBulletModel()->getCollisionShape());
+	this->SetEnvelope(msample->GetEnvelope());
+	this->SetSafeMargin(msample->GetSafeMargin());
+	this->family_group = msample->GetFamilyGroup();
+	this->family_mask  = msample->GetFamilyMask();
+}
+
+
+ChPhysicsItem* ChModelBulletParticleSoA::GetPhysicsItem()
+{
+	return particles;
+}
+
+
+void ChModelBulletParticleSoA::SyncPosition()
+{
+	assert(particles);
+
+	const ChVector<>& mpos = particles->GetParticlePos(this->particle_id);
+	const ChQuaternion<>& mrot = particles->GetParticleRot(this->particle_id);
+
+	bt_collision_object->getWorldTransform().setOrigin(btVector3(
+								(btScalar)mpos.x,
+								(btScalar)mpos.y,
+								(btScalar)mpos.z));
+	// the rotation matrix is computed in double precision, as for ChModelBulletParticle
+	// (a btQuaternion would be converted in single precision)
+	ChMatrix33<> rA(mrot);
+	btMatrix3x3 basisA( (btScalar)rA(0,0), (btScalar)rA(0,1), (btScalar)rA(0,2),
+						(btScalar)rA(1,0), (btScalar)rA(1,1), (btScalar)rA(1,2),
+						(btScalar)rA(2,0), (btScalar)rA(2,1), (btScalar)rA(2,2));
+	bt_collision_object->getWorldTransform().setBasis(basisA);
+}
+
+
+
+
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
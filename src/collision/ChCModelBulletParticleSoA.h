@@ -0,0 +1,96 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHC_MODELBULLETPARTICLESOA_H
+#define CHC_MODELBULLETPARTICLESOA_H
+ 
+//////////////////////////////////////////////////
+//  
+//   ChCModelBulletParticleSoA.h
+//
+//   A wrapper to use the Bullet collision detection
+//   library
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "collision/ChCModelBullet.h"
+
+
+namespace chrono 
+{
+
+// forward references
+class ChParticlesClonesSoA;
+
+namespace collision 
+{
+
+
+/// Class for the collision model of a single particle of a
+/// ChParticlesClonesSoA cluster. It is a lightweight proxy: it does
+/// not own shapes, but it references the collision shape of the sample
+/// model of the cluster, and it reads the position of the particle from
+/// the arrays of the cluster.
+/// Uses features of the Bullet library.
+
+class ChApi ChModelBulletParticleSoA : public ChModelBullet
+{
+
+public:
+
+  ChModelBulletParticleSoA();
+  virtual ~ChModelBulletParticleSoA();
+
+		/// Sets the pointer to the client owner (the ChParticlesClonesSoA cluster) and the particle number.
+  void SetParticle(ChParticlesClonesSoA* mpa, unsigned int id) {particles = mpa; particle_id = id;}
+
+    	/// Gets the pointer to the client owner, ChParticlesClonesSoA cluster. 
+  ChParticlesClonesSoA* GetParticles() {return particles;};
+    	/// Gets the number of the particle in the particle cluster. 
+  unsigned int GetParticleId() {return particle_id;};
+
+		/// Use the collision shape, the envelope, the margin and the
+		/// collision family of 'msample', without copying the shape.
+		/// The sample model must not be deleted or rebuilt while this is in use.
+  void SetSampleModel(ChModelBullet* msample);
+
+
+	// Overrides and implementations of base members:
+
+		/// Sets the position and orientation of the collision
+		/// model as the current position of the corresponding particle
+  virtual void SyncPosition();
+
+  		/// Gets the pointer to the client owner ChPhysicsItem. 
+  virtual ChPhysicsItem* GetPhysicsItem();
+
+private:
+	unsigned int particle_id;
+	ChParticlesClonesSoA* particles;
+};
+
+
+
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
+
+#endif
@@ -0,0 +1,394 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+//////////////////////////////////////////////////
+//
+//   ChCNeighborSearch.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <algorithm>
+#include "ChCNeighborSearch.h"
+#include "parallel/ChOpenMP.h"
+
+
+namespace chrono
+{
+namespace collision
+{
+
+
+static inline unsigned int HashCell(int ix, int iy, int iz)
+{
+	return ((unsigned int)ix * 73856093u) ^ ((unsigned int)iy * 19349663u) ^ ((unsigned int)iz * 83492791u);
+}
+
+
+ChNeighborSearch::ChNeighborSearch()
+{
+	cell_size = 0;
+	table_mask = 0;
+	neighbor_start.assign(1, 0);
+}
+
+void ChNeighborSearch::Clear()
+{
+	std::vector<int>().swap(cell_start);
+	std::vector<int>().swap(sorted_points);
+	std::vector<int>().swap(neighbor_list);
+	neighbor_start.assign(1, 0);
+}
+
+
+void ChNeighborSearch::UpdateCells(const std::vector< ChVector<> >& points, double cellsize)
+{
+	int n = (int)points.size();
+	cell_size = cellsize;
+
+	// hash table with about two buckets per point
+	unsigned int tsize = 64;
+	while (tsize < 2*(unsigned int)n)
+		tsize <<= 1;
+	table_mask = tsize - 1;
+
+	std::vector<unsigned int> point_bucket(n);
+	double inv_size = 1.0 / cell_size;
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		point_bucket[i] = HashCell( (int)floor(points[i].x * inv_size),
+									(int)floor(points[i].y * inv_size),
+									(int)floor(points[i].z * inv_size) ) & table_mask;
+	}
+
+	// Counting sort of the points by bucket, in parallel: each chunk of
+	// points counts its buckets, then scatters its points starting from
+	// its own offsets, so the order is the same of a serial sort.
+	int nchunks = ChMin(CHOMPfunctions::GetMaxThreads(), 1 + n / 32768);
+	std::vector< std::vector<int> > chunk_fill(nchunks);
+
+	#pragma omp parallel for schedule(static,1)
+	for (int c = 0; c < nchunks; ++c)
+	{
+		chunk_fill[c].assign(tsize, 0);
+		int i_end = (int)(((long long)n * (c+1)) / nchunks);
+		for (int i = (int)(((long long)n * c) / nchunks); i < i_end; ++i)
+			++chunk_fill[c][point_bucket[i]];
+	}
+
+	cell_start.resize(tsize+1);
+	int offset = 0;
+	for (unsigned int b = 0; b < tsize; ++b)
+	{
+		cell_start[b] = offset;
+		for (int c = 0; c < nchunks; ++c)
+		{
+			int count = chunk_fill[c][b];
+			chunk_fill[c][b] = offset;
+			offset += count;
+		}
+	}
+	cell_start[tsize] = offset;
+
+	sorted_points.resize(n);
+	#pragma omp parallel for schedule(static,1)
+	for (int c = 0; c < nchunks; ++c)
+	{
+		int i_end = (int)(((long long)n * (c+1)) / nchunks);
+		for (int i = (int)(((long long)n * c) / nchunks); i < i_end; ++i)
+			sorted_points[chunk_fill[c][point_bucket[i]]++] = i;
+	}
+}
+
+int ChNeighborSearch::FindNearCells(const ChVector<>& point, int* mcells) const
+{
+	double inv_size = 1.0 / cell_size;
+	int ix = (int)floor(point.x * inv_size);
+	int iy = (int)floor(point.y * inv_size);
+	int iz = (int)floor(point.z * inv_size);
+	int nc = 0;
+	for (int dx = -1; dx <= 1; ++dx)
+		for (int dy = -1; dy <= 1; ++dy)
+			for (int dz = -1; dz <= 1; ++dz)
+				mcells[nc++] = (int)(HashCell(ix+dx, iy+dy, iz+dz) & table_mask);
+	// different cells may share the same bucket: scan each bucket once
+	std::sort(mcells, mcells + nc);
+	return (int)(std::unique(mcells, mcells + nc) - mcells);
+}
+
+
+void ChNeighborSearch::Search(const std::vector< ChVector<> >& points, const double* radii, double radius)
+{
+	int n = (int)points.size();
+	neighbor_start.assign(n+1, 0);
+	neighbor_list.clear();
+
+	double maxradius = radius;
+	if (radii)
+		for (int i = 0; i < n; ++i)
+			maxradius = ChMax(maxradius, radii[i]);
+	if (n == 0 || maxradius <= 0)
+		return;
+
+	// With periodic boundaries, the points near the faces have images shifted
+	// by the length of the domain, that are binned too: the neighbors found
+	// among images are listed as their original points.
+	std::vector< ChVector<> > extended_points;
+	std::vector<int> image_owner;
+	if (periodic_domain.IsActive())
+	{
+		extended_points = points;
+		for (int i = 0; i < n; ++i)
+		{
+			int kmin[3] = {0, 0, 0};
+			int kmax[3] = {0, 0, 0};
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (!periodic_domain.IsPeriodic(axis))
+					continue;
+				if (points[i](axis) - periodic_domain.GetMin()(axis) < maxradius)
+					kmax[axis] = 1;
+				if (periodic_domain.GetMax()(axis) - points[i](axis) < maxradius)
+					kmin[axis] = -1;
+			}
+			for (int kx = kmin[0]; kx <= kmax[0]; ++kx)
+				for (int ky = kmin[1]; ky <= kmax[1]; ++ky)
+					for (int kz = kmin[2]; kz <= kmax[2]; ++kz)
+					{
+						if (kx == 0 && ky == 0 && kz == 0)
+							continue;
+						ChVector<> shift(kx * periodic_domain.GetLength(0),
+										 ky * periodic_domain.GetLength(1),
+										 kz * periodic_domain.GetLength(2));
+						extended_points.push_back(points[i] + shift);
+						image_owner.push_back(i);
+					}
+		}
+	}
+	const std::vector< ChVector<> >& spoints = image_owner.empty() ? points : extended_points;
+
+	UpdateCells(spoints, maxradius);
+
+	// Two passes: count the neighbors, then store them, so that
+	// the lists can be filled in parallel
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			int mcells[27];
+			int nc = FindNearCells(points[i], mcells);
+			int* mlist = pass ? &neighbor_list[0] + neighbor_start[i] : 0;
+			int count = 0;
+			for (int ic = 0; ic < nc; ++ic)
+				for (int k = cell_start[mcells[ic]]; k < cell_start[mcells[ic]+1]; ++k)
+				{
+					int js = sorted_points[k];
+					int j = js < n ? js : image_owner[js - n];
+					if (j == i)
+						continue;
+					double r = radii ? ChMax(radii[i], radii[j]) : radius;
+					if ((spoints[js] - points[i]).Length2() < r*r)
+					{
+						if (mlist)
+							mlist[count] = j;
+						++count;
+					}
+				}
+			if (!pass)
+				neighbor_start[i+1] = count;
+		}
+
+		if (!pass)
+		{
+			for (int i = 0; i < n; ++i)
+				neighbor_start[i+1] += neighbor_start[i];
+			neighbor_list.resize(neighbor_start[n]);
+			if (neighbor_list.empty())
+				return;
+		}
+	}
+}
+
+// Spread the lower 21 bits of x, so that there are two zero bits between each bit
+static inline unsigned long long SpreadBits(unsigned long long x)
+{
+	x &= 0x1fffffull;
+	x = (x | (x << 32)) & 0x1f00000000ffffull;
+	x = (x | (x << 16)) & 0x1f0000ff0000ffull;
+	x = (x | (x <<  8)) & 0x100f00f00f00f00full;
+	x = (x | (x <<  4)) & 0x10c30c30c30c30c3ull;
+	x = (x | (x <<  2)) & 0x1249249249249249ull;
+	return x;
+}
+
+// Cell size for about one point per cell, in the bounding box of the points,
+// and the corner of the bounding box.
+static double AutoCellSize(const std::vector< ChVector<> >& points, double cellsize, ChVector<>& bbmin)
+{
+	int n = (int)points.size();
+	bbmin = points[0];
+	ChVector<> bbmax = points[0];
+	for (int i = 1; i < n; ++i)
+	{
+		bbmin.x = ChMin(bbmin.x, points[i].x); bbmax.x = ChMax(bbmax.x, points[i].x);
+		bbmin.y = ChMin(bbmin.y, points[i].y); bbmax.y = ChMax(bbmax.y, points[i].y);
+		bbmin.z = ChMin(bbmin.z, points[i].z); bbmax.z = ChMax(bbmax.z, points[i].z);
+	}
+	double maxside = ChMax(bbmax.x - bbmin.x, ChMax(bbmax.y - bbmin.y, bbmax.z - bbmin.z));
+	if (cellsize <= 0)
+	{
+		ChVector<> side = bbmax - bbmin;
+		double volume = ChMax(side.x, 1e-9*maxside) * ChMax(side.y, 1e-9*maxside) * ChMax(side.z, 1e-9*maxside);
+		cellsize = pow(volume / n, 1.0/3.0);
+	}
+	// the cell indexes must fit 21 bits
+	cellsize = ChMax(cellsize, maxside / 2000000.0);
+	if (cellsize <= 0)
+		cellsize = 1;
+	return cellsize;
+}
+
+void ChNeighborSearch::ComputeMortonOrder(const std::vector< ChVector<> >& points, double cellsize, std::vector<int>& order)
+{
+	int n = (int)points.size();
+	order.resize(n);
+	if (n == 0)
+		return;
+
+	ChVector<> bbmin;
+	double inv_size = 1.0 / AutoCellSize(points, cellsize, bbmin);
+
+	std::vector< std::pair<unsigned long long, int> > keys(n);
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		unsigned long long ix = (unsigned long long)((points[i].x - bbmin.x) * inv_size);
+		unsigned long long iy = (unsigned long long)((points[i].y - bbmin.y) * inv_size);
+		unsigned long long iz = (unsigned long long)((points[i].z - bbmin.z) * inv_size);
+		keys[i].first = SpreadBits(ix) | (SpreadBits(iy) << 1) | (SpreadBits(iz) << 2);
+		keys[i].second = i;
+	}
+	std::sort(keys.begin(), keys.end());
+
+	for (int k = 0; k < n; ++k)
+		order[k] = keys[k].second;
+}
+
+double ChNeighborSearch::ComputeLocality(const std::vector< ChVector<> >& points, double cellsize)
+{
+	int n = (int)points.size();
+	if (n < 2)
+		return 1;
+
+	ChVector<> bbmin;
+	double inv_size = 1.0 / AutoCellSize(points, cellsize, bbmin);
+
+	int near_count = 0;
+	#pragma omp parallel for schedule(static) reduction(+:near_count)
+	for (int i = 1; i < n; ++i)
+	{
+		ChVector<> d = (points[i] - bbmin) * inv_size;
+		ChVector<> dp = (points[i-1] - bbmin) * inv_size;
+		if (fabs(floor(d.x) - floor(dp.x)) <= 1 &&
+			fabs(floor(d.y) - floor(dp.y)) <= 1 &&
+			fabs(floor(d.z) - floor(dp.z)) <= 1)
+			++near_count;
+	}
+	return (double)near_count / (double)(n-1);
+}
+
+
+void ChNeighborSearch::UpdateGrid(const std::vector< ChVector<> >& points, double cellsize)
+{
+	neighbor_start.assign(points.size()+1, 0);
+	neighbor_list.clear();
+
+	if (points.empty())
+	{
+		cell_start.assign(1, 0);
+		sorted_points.clear();
+		table_mask = 0;
+		cell_size = ChMax(cellsize, 1e-9);
+		return;
+	}
+
+	ChVector<> bbmin;
+	UpdateCells(points, AutoCellSize(points, cellsize, bbmin));
+}
+
+void ChNeighborSearch::QueryBox(const std::vector< ChVector<> >& points, const ChVector<>& bmin, const ChVector<>& bmax, std::vector<int>& result) const
+{
+	if (sorted_points.empty() || bmin.x > bmax.x || bmin.y > bmax.y || bmin.z > bmax.z)
+		return;
+
+	double inv_size = 1.0 / cell_size;
+	double fx0 = floor(bmin.x * inv_size), fx1 = floor(bmax.x * inv_size);
+	double fy0 = floor(bmin.y * inv_size), fy1 = floor(bmax.y * inv_size);
+	double fz0 = floor(bmin.z * inv_size), fz1 = floor(bmax.z * inv_size);
+	double ncells = (fx1 - fx0 + 1) * (fy1 - fy0 + 1) * (fz1 - fz0 + 1);
+
+	if (ncells > (double)(table_mask + 1))
+	{
+		// box larger than the grid: a linear scan is faster
+		for (int i = 0; i < (int)points.size(); ++i)
+		{
+			const ChVector<>& p = points[i];
+			if (p.x >= bmin.x && p.x <= bmax.x && p.y >= bmin.y && p.y <= bmax.y && p.z >= bmin.z && p.z <= bmax.z)
+				result.push_back(i);
+		}
+		return;
+	}
+
+	// different cells can share a bucket: scan each bucket once
+	std::vector<unsigned int> buckets;
+	buckets.reserve((size_t)ncells);
+	for (int ix = (int)fx0; ix <= (int)fx1; ++ix)
+		for (int iy = (int)fy0; iy <= (int)fy1; ++iy)
+			for (int iz = (int)fz0; iz <= (int)fz1; ++iz)
+				buckets.push_back(HashCell(ix, iy, iz) & table_mask);
+	std::sort(buckets.begin(), buckets.end());
+	buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+	for (unsigned int b = 0; b < buckets.size(); ++b)
+	{
+		for (int k = cell_start[buckets[b]]; k < cell_start[buckets[b]+1]; ++k)
+		{
+			int i = sorted_points[k];
+			if (i >= (int)points.size())	// periodic image
+				continue;
+			const ChVector<>& p = points[i];
+			if (p.x >= bmin.x && p.x <= bmax.x && p.y >= bmin.y && p.y <= bmax.y && p.z >= bmin.z && p.z <= bmax.z)
+				result.push_back(i);
+		}
+	}
+}
+
+void ChNeighborSearch::Update(const std::vector< ChVector<> >& points, double radius)
+{
+	Search(points, 0, radius);
+}
+
+void ChNeighborSearch::Update(const std::vector< ChVector<> >& points, const std::vector<double>& radii)
+{
+	assert(radii.size() == points.size());
+	Search(points, radii.empty() ? 0 : &radii[0], 0);
+}
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
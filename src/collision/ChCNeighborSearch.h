@@ -0,0 +1,136 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHC_NEIGHBORSEARCH_H
+#define CHC_NEIGHBORSEARCH_H
+
+//////////////////////////////////////////////////
+//
+//   ChCNeighborSearch.h
+//
+//   Fixed radius neighbor search for clouds of
+//   points (nodes of meshless materials, SPH fluids)
+//   with a hashed cell list.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include "core/ChApiCE.h"
+#include "core/ChVector.h"
+#include "collision/ChCPeriodicDomain.h"
+
+namespace chrono
+{
+namespace collision
+{
+
+
+///
+/// Class for finding all the pairs of points that are closer than
+/// a radius, without the collision system: points are binned in a
+/// hashed grid of cubic cells as large as the radius, so only the 27
+/// cells around each point are scanned. The result is stored as neighbor
+/// lists in compressed (CSR) format: each pair is listed twice, once
+/// for each of the two points, so that per-point accumulations can be
+/// done in parallel without write conflicts.
+/// Memory is a few integers per point, plus one integer per neighbor.
+///
+
+class ChApi ChNeighborSearch {
+public:
+	ChNeighborSearch();
+
+			/// Find the neighbors of all points, that is all pairs
+			/// with distance lower than 'radius'.
+	void Update(const std::vector< ChVector<> >& points, double radius);
+
+			/// Find the neighbors of all points, where each point has its own
+			/// radius, and a pair is found if the distance is lower than the
+			/// larger of the two radii.
+	void Update(const std::vector< ChVector<> >& points, const std::vector<double>& radii);
+
+			/// Set a domain with periodic boundaries: the points near a periodic
+			/// face are also neighbors of the points near the opposite face. The
+			/// points must be inside the domain, and its length along periodic axes
+			/// must be larger than twice the radius.
+	void SetPeriodicDomain(const ChPeriodicDomain& mdomain) {periodic_domain = mdomain;}
+	const ChPeriodicDomain& GetPeriodicDomain() const {return periodic_domain;}
+
+			/// Number of points of the last update
+	int GetNpoints() const {return (int)neighbor_start.size() - 1;}
+
+			/// Number of neighbors of the i-th point
+	int GetNneighbors(int i) const {return neighbor_start[i+1] - neighbor_start[i];}
+
+			/// Indexes of the neighbors of the i-th point, GetNneighbors(i) values
+	const int* GetNeighbors(int i) const {return neighbor_list.empty() ? 0 : &neighbor_list[0] + neighbor_start[i];}
+
+			/// Number of pairs (half the total length of the neighbor lists)
+	size_t GetNpairs() const {return neighbor_list.size() / 2;}
+
+			/// Only bin the points in a grid of cubic cells of size 'cellsize' (or
+			/// automatic size, if 0), without finding the neighbors. Use this
+			/// before QueryBox(), if neighbor lists are not needed.
+	void UpdateGrid(const std::vector< ChVector<> >& points, double cellsize);
+
+			/// Find the points that are inside the axis aligned box 'bmin'-'bmax',
+			/// scanning only the cells that overlap the box: their indexes are
+			/// appended to 'result'. Use after Update() or UpdateGrid(), with
+			/// the same points.
+	void QueryBox(const std::vector< ChVector<> >& points, const ChVector<>& bmin, const ChVector<>& bmax, std::vector<int>& result) const;
+
+			/// Release all memory
+	void Clear();
+
+			/// Compute the order of the points along a Morton (Z-order) space
+			/// filling curve through cubic cells of size 'cellsize': order[k]
+			/// is the index of the k-th point. Points in the same cell keep
+			/// their relative order. If cellsize is 0, the cells are sized to
+			/// contain about one point each. This is useful to sort particles
+			/// so that near particles are also near in memory.
+	static void ComputeMortonOrder(const std::vector< ChVector<> >& points, double cellsize, std::vector<int>& order);
+
+			/// Measure of the spatial coherence of the order of the points: the
+			/// fraction of consecutive points that are in the same or in adjacent
+			/// cells of size 'cellsize' (or automatic size, if 0). It is close
+			/// to 1 after ComputeMortonOrder(), and drops as the points mix.
+	static double ComputeLocality(const std::vector< ChVector<> >& points, double cellsize);
+
+private:
+	void Search(const std::vector< ChVector<> >& points, const double* radii, double radius);
+	void UpdateCells(const std::vector< ChVector<> >& points, double cellsize);
+	int  FindNearCells(const ChVector<>& point, int* mcells) const;
+
+	double cell_size;
+	unsigned int table_mask;
+	std::vector<int> cell_start;	// for each hash bucket, the first point in sorted_points
+	std::vector<int> sorted_points;	// points sorted by hash bucket
+
+	std::vector<int> neighbor_start;
+	std::vector<int> neighbor_list;
+
+	ChPeriodicDomain periodic_domain;
+};
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
+
+#endif
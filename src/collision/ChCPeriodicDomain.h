@@ -0,0 +1,133 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHC_PERIODICDOMAIN_H
+#define CHC_PERIODICDOMAIN_H
+
+//////////////////////////////////////////////////
+//
+//   ChCPeriodicDomain.h
+//
+//   Box domain with periodic boundaries, for
+//   DEM and SPH simulations of bulk materials.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include "core/ChVector.h"
+
+namespace chrono
+{
+namespace collision
+{
+
+
+///
+/// Class for an axis aligned box domain whose opposite faces are
+/// connected along one, two or three periodic axes: objects that leave
+/// the box from one face enter it from the opposite face, and objects near
+/// a face interact with the objects near the opposite face. This allows
+/// the simulation of a small sample of a large granular bed or fluid,
+/// without the effects of walls.
+/// Along each periodic axis, the length of the box must be larger than
+/// twice the size of the objects and of the interaction radii.
+///
+
+class ChPeriodicDomain {
+public:
+	ChPeriodicDomain() : dmin(VNULL), dmax(VNULL)
+		{
+			periodic[0] = periodic[1] = periodic[2] = false;
+		}
+
+			/// Set the box, from corner 'mmin' to corner 'mmax', and
+			/// which of its axes are periodic.
+	void Set(const ChVector<>& mmin, const ChVector<>& mmax, bool px, bool py, bool pz)
+		{
+			dmin = mmin;
+			dmax = mmax;
+			periodic[0] = px && dmax.x > dmin.x;
+			periodic[1] = py && dmax.y > dmin.y;
+			periodic[2] = pz && dmax.z > dmin.z;
+		}
+
+			/// Turn off all periodic axes.
+	void Disable() {periodic[0] = periodic[1] = periodic[2] = false;}
+
+			/// True if at least one axis is periodic.
+	bool IsActive() const {return periodic[0] || periodic[1] || periodic[2];}
+
+			/// True if the axis (0,1,2 for x,y,z) is periodic.
+	bool IsPeriodic(int axis) const {return periodic[axis];}
+
+	const ChVector<>& GetMin() const {return dmin;}
+	const ChVector<>& GetMax() const {return dmax;}
+
+			/// Length of the box along an axis (0,1,2 for x,y,z).
+	double GetLength(int axis) const {return dmax(axis) - dmin(axis);}
+
+			/// Move the point into the box, along the periodic axes, by
+			/// multiples of the length of the box. Returns true if moved.
+	bool Wrap(ChVector<>& mpoint) const
+		{
+			bool moved = false;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (!periodic[axis])
+					continue;
+				double& p = mpoint(axis);
+				if (p >= dmin(axis) && p < dmax(axis))
+					continue;
+				double length = GetLength(axis);
+				p -= length * floor((p - dmin(axis)) / length);
+				if (p >= dmax(axis))	// roundoff
+					p = dmin(axis);
+				moved = true;
+			}
+			return moved;
+		}
+
+			/// Shortest vector that is equivalent, along the periodic axes,
+			/// to the distance vector 'mdist', i.e. the distance vector to the
+			/// nearest of the periodic images of a point (minimum image).
+	ChVector<> MinimumImage(const ChVector<>& mdist) const
+		{
+			ChVector<> result = mdist;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (!periodic[axis])
+					continue;
+				double length = GetLength(axis);
+				result(axis) -= length * floor(result(axis) / length + 0.5);
+			}
+			return result;
+		}
+
+private:
+	ChVector<> dmin;
+	ChVector<> dmax;
+	bool periodic[3];
+};
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
+
+#endif
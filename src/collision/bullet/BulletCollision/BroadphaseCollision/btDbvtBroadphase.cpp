@@ -125,6 +125,7 @@ btDbvtBroadphase::btDbvtBroadphase(btOverlappingPairCache* paircache)
 	m_needcleanup		=	true;
 	m_releasepaircache	=	(paircache!=0)?false:true;
 	m_prediction		=	0;
+	m_margin			=	0;
 	m_stageCurrent		=	0;
 	m_fixedleft			=	0;
 	m_fupdates			=	1;
@@ -312,7 +313,7 @@ void							btDbvtBroadphase::setAabb(		btBroadphaseProxy* absproxy,
 #ifdef DBVT_BP_MARGIN				
 					m_sets[0].update(proxy->leaf,aabb,velocity,DBVT_BP_MARGIN)
 #else
-					m_sets[0].update(proxy->leaf,aabb,velocity)
+					m_sets[0].update(proxy->leaf,aabb,velocity,m_margin)
 #endif
 					)
 				{
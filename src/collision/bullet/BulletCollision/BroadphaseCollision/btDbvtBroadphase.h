@@ -72,6 +72,7 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 	btDbvtProxy*			m_stageRoots[STAGECOUNT+1];	// Stages list
 	btOverlappingPairCache*	m_paircache;				// Pair cache
 	btScalar				m_prediction;				// Velocity prediction
+	btScalar				m_margin;					// Fat AABB margin (if DBVT_BP_MARGIN not defined) //***ALEX***
 	int						m_stageCurrent;				// Current stage
 	int						m_fupdates;					// % of fixed updates per frame
 	int						m_dupdates;					// % of dynamic updates per frame
@@ -132,6 +133,17 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 		return m_prediction;
 	}
 
+	///fat AABB margin: moving proxies enlarge their leaf by this amount, so small 
+	///motions do not require tree updates (default 0, no margin)	//***ALEX***
+	void	setFatMargin(btScalar margin)
+	{
+		m_margin = margin;
+	}
+	btScalar getFatMargin() const
+	{
+		return m_margin;
+	}
+
 	///this setAabbForceUpdate is similar to setAabb but always forces the aabb update. 
 	///it is not part of the btBroadphaseInterface but specific to btDbvtBroadphase.
 	///it bypasses certain optimizations that prevent aabb updates (when the aabb shrinks), see
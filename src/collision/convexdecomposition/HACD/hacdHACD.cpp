@@ -440,8 +440,23 @@ namespace HACD
         delete [] m_extraDistNormals;
 	}
 
+	// Noise added to a point when a convex-hull cannot be built. Each edge or
+	// cluster has its own generator state, instead of the shared one of rand(),
+	// so that the parallel loops give the same hulls as the serial ones.
+	static Vec3<Real> HullNoise(unsigned long & state)
+	{
+		Real n[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			state = state * 1103515245UL + 12345UL;
+			n[i] = static_cast<Real>(static_cast<long>((state >> 16) % 10) - 5);
+		}
+		return Vec3<Real>(n[0], n[1], n[2]);
+	}
+
     void HACD::ComputeEdgeCost(size_t e)
     {
+		unsigned long noiseState = static_cast<unsigned long>(e);
 		GraphEdge & gE = m_graph.m_edges[e];
         long v1 = gE.m_v1;
         long v2 = gE.m_v2;
@@ -514,7 +529,7 @@ namespace HACD
 			verticesCH.Next();
 			// add noise to avoid the problem
 			ptIndex = verticesCH.GetHead()->GetData().m_name;			
-			ch->AddPoint(m_points[ptIndex]+ m_scale * 0.0001 * Vec3<Real>(rand() % 10 - 5, rand() % 10 - 5, rand() % 10 - 5), ptIndex);
+			ch->AddPoint(m_points[ptIndex]+ m_scale * 0.0001 * HullNoise(noiseState), ptIndex);
 			for(size_t v = 1; v < nV; ++v)
 			{
 				ptIndex = verticesCH.GetHead()->GetData().m_name;			
@@ -612,9 +627,12 @@ namespace HACD
     bool HACD::InitializePriorityQueue()
     {
 //		m_pqueue.reserve(m_graph.m_nE + 100);
-        for (size_t e=0; e < m_graph.m_nE; ++e) 
+		// Edge costs are independent (each edge builds its own convex-hull), so run in parallel,
+		// unless the hulls allocate from a user heap manager, that is not thread safe
+#pragma omp parallel for schedule(dynamic) if(m_heapManager == 0)
+        for (long e=0; e < (long)m_graph.m_nE; ++e) 
         {
-            ComputeEdgeCost(static_cast<long>(e));
+            ComputeEdgeCost(e);
 //			m_pqueue.push(GraphEdgePriorityQueue(static_cast<long>(e), m_graph.m_edges[e].m_error));
         }
 		return true;
@@ -955,8 +973,12 @@ namespace HACD
         m_convexHulls = new ICHUll[m_nClusters];
 		delete [] m_partition;
 	    m_partition = new long [m_nTriangles];
-		for (size_t p = 0; p != m_cVertices.size(); ++p) 
+		// Each cluster builds its own convex-hull, so run in parallel (but not with a user
+		// heap manager, as above). The simplification before is still serial.
+#pragma omp parallel for schedule(dynamic) if(m_heapManager == 0)
+		for (long p = 0; p < (long)m_cVertices.size(); ++p) 
 		{
+			unsigned long noiseState = static_cast<unsigned long>(p);
 			size_t v = m_cVertices[p];
 			m_partition[v] = static_cast<long>(p);
 			for(size_t a = 0; a < m_graph.m_vertices[v].m_ancestors.size(); a++)
@@ -984,7 +1006,7 @@ namespace HACD
 					verticesCH.Next();
 					// add noise to avoid the problem
 					ptIndex = verticesCH.GetHead()->GetData().m_name;			
-					ch->AddPoint(m_points[ptIndex]+ m_diag * 0.0001 * Vec3<Real>(rand() % 10 - 5, rand() % 10 - 5, rand() % 10 - 5), ptIndex);
+					ch->AddPoint(m_points[ptIndex]+ m_diag * 0.0001 * HullNoise(noiseState), ptIndex);
 					for(size_t v = 1; v < nV; ++v)
 					{
 						ptIndex = verticesCH.GetHead()->GetData().m_name;			
@@ -1006,7 +1028,7 @@ namespace HACD
 					verticesCH.Next();
 					// add noise to avoid the problem
 					ptIndex = verticesCH.GetHead()->GetData().m_name;			
-					ch->AddPoint(m_points[ptIndex]+ m_diag * 0.0001 * Vec3<Real>(rand() % 10 - 5, rand() % 10 - 5, rand() % 10 - 5), ptIndex);
+					ch->AddPoint(m_points[ptIndex]+ m_diag * 0.0001 * HullNoise(noiseState), ptIndex);
 					for(size_t v = 1; v < nV; ++v)
 					{
 						ptIndex = verticesCH.GetHead()->GetData().m_name;			
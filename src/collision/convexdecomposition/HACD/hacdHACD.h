@@ -157,6 +157,9 @@ namespace HACD
 		//! Sets the minimum number of clusters to be generated.
 		//! @param nClusters minimum number of clusters
 		void										SetNClusters(size_t nClusters) { m_nMinClusters = nClusters;}
+		//! Gives the minimum number of clusters to be generated.
+		//! @return minimum number of clusters
+		const size_t								GetNMinClusters() const { return m_nMinClusters;}
 		//! Gives the number of generated clusters.
 		//! @return number of generated clusters
 		const size_t								GetNClusters() const { return m_nClusters;}
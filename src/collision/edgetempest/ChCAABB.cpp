@@ -46,7 +46,7 @@ CHAABB::~CHAABB()
 
 
 
-void CHAABB::FitToGeometries(std::vector<geometry::ChGeometry*> mgeos, int firstgeo, int ngeos, double envelope)
+void CHAABB::FitToGeometries(std::vector<geometry::ChGeometry*>& mgeos, int firstgeo, int ngeos, double envelope)
 {
 	double minx, maxx, miny, maxy, minz, maxz;
 	minx = miny = minz = +10e20;
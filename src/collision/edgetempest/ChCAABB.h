@@ -76,7 +76,7 @@ public:
             /// from index 'firstgeo' up to 'firstgeo+ngeos', not included.
             /// 
   void     FitToGeometries(
-              std::vector<geometry::ChGeometry*> mgeos, ///< vector of geometric objects 
+              std::vector<geometry::ChGeometry*>& mgeos, ///< vector of geometric objects 
               int firstgeo,                             ///< geometries will be fit from this index... 
               int ngeos,                                ///< .. up to this index
               double envelope                           ///< inflate all boxes by this amount
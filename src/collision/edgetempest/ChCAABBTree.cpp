@@ -91,11 +91,75 @@ int CHAABBTree::BuildModel(double envelope)
 
   build_state = ChC_BUILD_STATE_PROCESSED;
 
+  build_cost = GetTreeCost();
+
 
   return ChC_OK;
 }
 
 
+int CHAABBTree::RefitModel(double envelope)
+{
+  if (build_state != ChC_BUILD_STATE_PROCESSED)
+	return BuildModel(envelope);
+
+  if (b.size() == 0)
+	return ChC_OK;
+
+  // Children always have higher indexes than their parent, so a
+  // backward scan of the vector processes the tree bottom-up.
+
+  for (int nb = (int)b.size()-1; nb >= 0; --nb)
+  {
+	CHAABB* mb = &b[nb];
+
+	if (mb->IsLeaf())
+	{
+		mb->FitToGeometries(geometries, mb->GetGeometryIndex(), 1, envelope);
+	}
+	else
+	{
+		// merge the two children boxes (already inflated by envelope)
+		CHAABB* c1 = &b[mb->GetFirstChildIndex()];
+		CHAABB* c2 = &b[mb->GetSecondChildIndex()];
+
+		Vector vmin, vmax;
+		vmin.x = ChMin(c1->To.x - c1->d.x, c2->To.x - c2->d.x);
+		vmin.y = ChMin(c1->To.y - c1->d.y, c2->To.y - c2->d.y);
+		vmin.z = ChMin(c1->To.z - c1->d.z, c2->To.z - c2->d.z);
+		vmax.x = ChMax(c1->To.x + c1->d.x, c2->To.x + c2->d.x);
+		vmax.y = ChMax(c1->To.y + c1->d.y, c2->To.y + c2->d.y);
+		vmax.z = ChMax(c1->To.z + c1->d.z, c2->To.z + c2->d.z);
+
+		mb->To = (vmin + vmax) * 0.5;
+		mb->d  = (vmax - vmin) * 0.5;
+	}
+  }
+
+  return RebuildIfDegraded(envelope);
+}
+
+
+double CHAABBTree::GetTreeCost()
+{
+  if (b.size() == 0)
+	return 0;
+
+  double root_area = b[0].d.x*b[0].d.y + b[0].d.y*b[0].d.z + b[0].d.z*b[0].d.x;
+  if (root_area <= 0)
+	return 0;
+
+  double area = 0;
+  for (unsigned int nb = 0; nb < b.size(); ++nb)
+  {
+	if (!b[nb].IsLeaf())
+		area += b[nb].d.x*b[nb].d.y + b[nb].d.y*b[nb].d.z + b[nb].d.z*b[nb].d.x;
+  }
+
+  return area / root_area;
+}
+
+
 void recurse_scan_AABBs (CHAABBTree* mmodel, int nb,
 						void* userdata, int current_level, int& counter,
 						void callback(ChMatrix33<>& Rot,Vector& Pos,Vector& d, int level, void* userdata))
@@ -220,10 +284,26 @@ static int split_geometries(std::vector<geometry::ChGeometry*>& mgeos, int first
 
 // Fits m->child(bn) to the num_tris triangles starting at first_tri
 // Then, if num_tris is greater than one, partitions the tris into two
-// sets, and recursively builds two children of m->child(bn)
-
-int build_recurse(CHAABBTree *m, int bn, int first_geo, int num_geos, double envelope)
+// sets, and recursively builds two children of m->child(bn).
+// Children are stored at next_box and next_box+1; the subtree of a
+// node with n geometries always takes 2n-1 boxes, so indexes do not
+// depend on the build order. When depth reaches task_depth, the
+// subtree is not built but appended to 'tasks', for parallel building.
+
+int build_recurse(CHAABBTree *m, int bn, int first_geo, int num_geos, double envelope,
+				  int next_box, int depth, int task_depth, std::vector<ChCollisionTreeBuildTask>* tasks)
 {
+  if (tasks && (depth == task_depth))
+  {
+	ChCollisionTreeBuildTask mtask;
+	mtask.bn = bn;
+	mtask.first_geo = first_geo;
+	mtask.num_geos = num_geos;
+	mtask.next_box = next_box;
+	tasks->push_back(mtask);
+	return ChC_OK;
+  }
+
   CHAABB *b = m->child(bn);
 
   double coord;
@@ -244,8 +324,7 @@ int build_recurse(CHAABBTree *m, int bn, int first_geo, int num_geos, double env
   {
     // BV not a leaf - first_child will index a BV
 
-    b->first_child = m->current_box;
-    m->current_box+=2;
+    b->first_child = next_box;
 
     // choose splitting axis
 
@@ -276,10 +355,12 @@ int build_recurse(CHAABBTree *m, int bn, int first_geo, int num_geos, double env
 
     build_recurse(m, m->child(bn)->first_child,
 					first_geo, num_first_half,
-					envelope);
+					envelope,
+					next_box + 2, depth + 1, task_depth, tasks);
     build_recurse(m, m->child(bn)->first_child + 1,
                     first_geo + num_first_half, num_geos - num_first_half,
-					envelope);
+					envelope,
+					next_box + 2*num_first_half, depth + 1, task_depth, tasks);
   }
 
   return ChC_OK;
@@ -298,9 +379,25 @@ int CHAABBTree::build_model(double envelope)
 
   current_box = 1;
 
-  // build recursively
+  // build recursively the upper levels, deferring the deeper subtrees...
+
+  std::vector<ChCollisionTreeBuildTask> tasks;
+  int task_depth = GetParallelBuildDepth(num_geometries);
+
+  build_recurse(this, 0, 0, num_geometries, envelope,
+				current_box, 0, task_depth, &tasks);
+
+  // ...then build the subtrees in parallel: they work on disjoint 
+  // ranges of geometries and boxes.
+
+  #pragma omp parallel for schedule(dynamic)
+  for (int nt = 0; nt < (int)tasks.size(); ++nt)
+  {
+	build_recurse(this, tasks[nt].bn, tasks[nt].first_geo, tasks[nt].num_geos, envelope,
+				  tasks[nt].next_box, 0, -1, NULL);
+  }
 
-  build_recurse(this, 0, 0, num_geometries, envelope);
+  current_box = (int)b.size();
 
 
   return ChC_OK;
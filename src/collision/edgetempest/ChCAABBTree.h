@@ -62,6 +62,16 @@ public:
 		/// (boxes may be inflated by an 'envelope' amount).
   int BuildModel(double envelope=0.);
 
+		/// Refits the AABB hierarchy bottom-up to the current shape of
+		/// the geometries, keeping the tree topology (no re-splitting).
+		/// The hierarchy is rebuilt if it became too loose, see
+		/// SetRebuildThreshold().
+  int RefitModel(double envelope=0.);
+
+		/// Returns the SAH cost of the hierarchy: sum of the surfaces of
+		/// the inner boxes, divided by the surface of the root box.
+  double GetTreeCost();
+
 		/// This function can be used if you want to easily scan the hierarchy 
 		/// of bounding boxes. You must provide a callback to a function which 
 		/// will be automatically called per each bounding box in this tree.
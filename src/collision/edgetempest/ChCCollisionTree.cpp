@@ -28,6 +28,7 @@
 #include "ChCGetTime.h"
 #include "ChCCollisionTree.h"
 #include "physics/ChBody.h"
+#include "parallel/ChOpenMP.h"
 
 
 namespace chrono 
@@ -46,6 +47,9 @@ ChCollisionTree::ChCollisionTree()
  
   build_state = ChC_BUILD_STATE_MODIFIED;
 
+  build_cost = 0;
+  rebuild_threshold = 1.5;
+
   m_body =NULL;
 }
 
@@ -71,6 +75,8 @@ int ChCollisionTree::ResetModel()
   
   build_state = ChC_BUILD_STATE_MODIFIED;
 
+  build_cost = 0;
+
   return ChC_OK;
 }
 
@@ -96,6 +102,47 @@ int ChCollisionTree::BuildModel(double envelope)
 }
 
 
+int ChCollisionTree::RefitModel(double envelope)
+{
+  // no BV hierarchy in base class: just rebuild
+  build_state = ChC_BUILD_STATE_MODIFIED;
+
+  return BuildModel(envelope);
+}
+
+
+int ChCollisionTree::RebuildIfDegraded(double envelope)
+{
+  // rebuild only if the refitted tree became too loose
+  if ((build_cost > 0) && (GetTreeCost() > rebuild_threshold * build_cost))
+  {
+	build_state = ChC_BUILD_STATE_MODIFIED;
+	return BuildModel(envelope);
+  }
+
+  return ChC_OK;
+}
+
+
+int ChCollisionTree::GetParallelBuildDepth(int ngeos)
+{
+  // below this amount of geometries, threading overhead is not worth
+  if (ngeos < 2048)
+	return -1;
+
+  // spawn about 4 subtrees per processor, to balance unequal splits
+  int nprocs = CHOMPfunctions::GetNumProcs();
+  if (nprocs < 2)
+	return -1;
+
+  int depth = 2;
+  while ((1 << depth) < 4*nprocs)
+	depth++;
+
+  return depth;
+}
+
+
 int ChCollisionTree::AddGeometry(geometry::ChGeometry* mgeo)
 {
 	this->geometries.push_back(mgeo);
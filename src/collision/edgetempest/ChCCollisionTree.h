@@ -114,6 +114,39 @@ public:
   void UpdateAbsoluteAABB(double envelope);
 
 
+		/// Refits the BV hierarchy to the current shape of the geometries,
+		/// without changing the tree topology. This is much faster than
+		/// a complete rebuild, and it is the way to go when geometries are
+		/// deformed but not added/removed (ex. skins of FEM meshes, cables).
+		/// If the tree was never built, it is built; if the SAH cost of the
+		/// refitted tree degrades more than GetRebuildThreshold() times the
+		/// cost at build time, it is rebuilt from scratch.
+		/// Children classes implementing some type of bounding box should
+		/// implement this; the default falls back to a complete rebuild.
+  virtual int RefitModel(double envelope=0.);
+
+		/// Returns a quality metric of the BV hierarchy, based on the
+		/// surface area heuristic (SAH): the sum of surfaces of the inner
+		/// bounding volumes, divided by the surface of the root volume.
+		/// Lower is better. Default: 0, ie. no metric available.
+  virtual double GetTreeCost() {return 0;}
+
+		/// Set the ratio between current SAH cost and SAH cost at last build 
+		/// that triggers a complete rebuild in RefitModel(). Default 1.5
+  void   SetRebuildThreshold(double mt) {rebuild_threshold = mt;}
+  double GetRebuildThreshold() {return rebuild_threshold;}
+
+		/// Returns the depth of the tree at which the builder spawns subtrees
+		/// to be built in parallel, or -1 if the model is too small to
+		/// take advantage of parallel building.
+  static int GetParallelBuildDepth(int ngeos);
+
+		/// Rebuilds the BV hierarchy from scratch if its SAH cost degraded more
+		/// than GetRebuildThreshold() times the cost at the last build. Used by
+		/// the RefitModel() of children classes, after the refit.
+  int RebuildIfDegraded(double envelope);
+
+
 public:
 
   enum eChBuildState
@@ -134,6 +167,12 @@ public:
 		/// Used by internal algorithms, contains the last accessed geometry.
   geometry::ChGeometry *last_geometry;
 
+		/// SAH cost of the hierarchy at last complete build
+  double build_cost;
+
+		/// Ratio of SAH costs that triggers a rebuild in RefitModel()
+  double rebuild_threshold;
+
 private:
 
   ChBody* m_body;
@@ -148,6 +187,22 @@ public:
 
 
 
+///
+/// Subtree deferred by the BV hierarchy builders, 
+/// to be built later in parallel.
+///
+
+struct ChCollisionTreeBuildTask
+{
+  int bn;         ///< index of the root box of the subtree
+  int first_geo;  ///< first geometry enclosed by the subtree
+  int num_geos;   ///< number of geometries enclosed by the subtree
+  int next_box;   ///< first free box index for the children of the subtree
+};
+
+
+
+
 //
 // ERROR CODES
 //
@@ -48,7 +48,7 @@ CHOBB::~CHOBB()
 
 
 
-void CHOBB::FitToGeometries(ChMatrix33<>& O, std::vector<geometry::ChGeometry*> mgeos, int firstgeo, int ngeos, double envelope)
+void CHOBB::FitToGeometries(ChMatrix33<>& O, std::vector<geometry::ChGeometry*>& mgeos, int firstgeo, int ngeos, double envelope)
 {
 	// store orientation
 
@@ -95,7 +95,7 @@ public:
 						/// axis, and a list of geometric object, this function recomputes the
 						/// bounding box in order to enclose 'ngeos' geometries, from index 'firstgeo' 
 						/// Box may be also 'inflated' by a thinckness='envelope' 
-  void     FitToGeometries(ChMatrix33<>& O, std::vector<geometry::ChGeometry*> mgeos, int firstgeo, int ngeos, double envelope);
+  void     FitToGeometries(ChMatrix33<>& O, std::vector<geometry::ChGeometry*>& mgeos, int firstgeo, int ngeos, double envelope);
 
   						/// Find if two box OBB are overlapping, given relative 
 						/// rotation matrix B, relative translation T, and half-sizes of the two OBB
@@ -92,11 +92,110 @@ int CHOBBTree::BuildModel(double envelope)
 
   build_state = ChC_BUILD_STATE_PROCESSED;
 
+  build_cost = GetTreeCost();
+
 
   return ChC_OK;
 }
 
 
+int CHOBBTree::RefitModel(double envelope)
+{
+  if (build_state != ChC_BUILD_STATE_PROCESSED)
+	return BuildModel(envelope);
+
+  int nboxes = (int)b.size();
+  if (nboxes == 0)
+	return ChC_OK;
+
+  // Boxes are stored parent-relative: compute absolute orientations top-down.
+  // Orientations are kept as they were at build time, only centers and 
+  // sizes are refitted. Children always have higher indexes than parent.
+
+  std::vector< ChMatrix33<> > Rabs(nboxes);
+  std::vector< Vector > Tabs(nboxes);
+  std::vector< int > parent(nboxes);
+
+  Rabs[0].CopyFromMatrix(b[0].Rot);
+  parent[0] = -1;
+  for (int nb = 0; nb < nboxes; ++nb)
+  {
+	if (b[nb].IsLeaf())
+		continue;
+	int c1 = b[nb].GetFirstChildIndex();
+	int c2 = b[nb].GetSecondChildIndex();
+	Rabs[c1].MatrMultiply(Rabs[nb], b[c1].Rot);
+	Rabs[c2].MatrMultiply(Rabs[nb], b[c2].Rot);
+	parent[c1] = nb;
+	parent[c2] = nb;
+  }
+
+  // The geometries of a subtree are contiguous: get their ranges bottom-up
+
+  std::vector< int > first_geo(nboxes);
+  std::vector< int > last_geo(nboxes);
+  for (int nb = nboxes-1; nb >= 0; --nb)
+  {
+	if (b[nb].IsLeaf())
+	{
+		first_geo[nb] = last_geo[nb] = b[nb].GetGeometryIndex();
+	}
+	else
+	{
+		int c1 = b[nb].GetFirstChildIndex();
+		int c2 = b[nb].GetSecondChildIndex();
+		first_geo[nb] = ChMin(first_geo[c1], first_geo[c2]);
+		last_geo[nb]  = ChMax(last_geo[c1],  last_geo[c2]);
+	}
+  }
+
+  // Fit each box to its geometries, as in the build, so that the boxes
+  // are as tight as those of a build with the same orientations
+
+  ChMatrix33<> Rrel;
+  for (int nb = 0; nb < nboxes; ++nb)
+  {
+	CHOBB* mb = &b[nb];
+	Rrel.CopyFromMatrix(mb->Rot);
+	mb->FitToGeometries(Rabs[nb], geometries, first_geo[nb], last_geo[nb] - first_geo[nb] + 1, envelope);
+	mb->Rot.CopyFromMatrix(Rrel);
+	Tabs[nb] = mb->To;
+  }
+
+  // Change centers from absolute to parent-relative
+
+  for (int nb = 0; nb < nboxes; ++nb)
+  {
+	if (parent[nb] < 0)
+		b[nb].To = Tabs[nb];
+	else
+		b[nb].To = Rabs[parent[nb]].MatrT_x_Vect(Vsub(Tabs[nb], Tabs[parent[nb]]));
+  }
+
+  return RebuildIfDegraded(envelope);
+}
+
+
+double CHOBBTree::GetTreeCost()
+{
+  if (b.size() == 0)
+	return 0;
+
+  double root_area = b[0].d.x*b[0].d.y + b[0].d.y*b[0].d.z + b[0].d.z*b[0].d.x;
+  if (root_area <= 0)
+	return 0;
+
+  double area = 0;
+  for (unsigned int nb = 0; nb < b.size(); ++nb)
+  {
+	if (!b[nb].IsLeaf())
+		area += b[nb].d.x*b[nb].d.y + b[nb].d.y*b[nb].d.z + b[nb].d.z*b[nb].d.x;
+  }
+
+  return area / root_area;
+}
+
+
 void recurse_scan_OBBs (ChMatrix33<>& PrevRot, Vector& PrevPos,
 						CHOBBTree* mmodel, int nb,
 						void* userdata, int current_level, int& counter,
@@ -184,10 +283,11 @@ void get_centroid_geometries(PQP_REAL c[3], std::vector<geometry::ChGeometry*>&
 
 void get_covariance_geometries(PQP_REAL M[3][3], std::vector<geometry::ChGeometry*>& mgeos, int firstgeo, int ngeos)
 {
-  static Vector S1;
-  static Vector S1_geo;
-  static ChMatrix33<> S2;
-  static ChMatrix33<> S2_geo;
+  // no statics here: this may run in parallel over subtrees
+  Vector S1;
+  Vector S1_geo;
+  ChMatrix33<> S2;
+  ChMatrix33<> S2_geo;
   S1 = VNULL;
   S1_geo = VNULL;
   S2.Reset();
@@ -275,10 +375,24 @@ int split_geometries(std::vector<geometry::ChGeometry*>& mgeos, int firstgeo, in
 
 // Fits m->child(bn) to the num_tris triangles starting at first_tri
 // Then, if num_tris is greater than one, partitions the tris into two
-// sets, and recursively builds two children of m->child(bn)
+// sets, and recursively builds two children of m->child(bn).
+// Children are stored at next_box and next_box+1 (see the AABB tree
+// builder); subtrees at task_depth are deferred for parallel building.
 
-int build_recurse(CHOBBTree *m, int bn, int first_geo, int num_geos, double envelope)
+int build_recurse(CHOBBTree *m, int bn, int first_geo, int num_geos, double envelope,
+				  int next_box, int depth, int task_depth, std::vector<ChCollisionTreeBuildTask>* tasks)
 {
+  if (tasks && (depth == task_depth))
+  {
+	ChCollisionTreeBuildTask mtask;
+	mtask.bn = bn;
+	mtask.first_geo = first_geo;
+	mtask.num_geos = num_geos;
+	mtask.next_box = next_box;
+	tasks->push_back(mtask);
+	return ChC_OK;
+  }
+
   CHOBB *b = m->child(bn);
 
   // compute a rotation matrix
@@ -303,7 +417,7 @@ int build_recurse(CHOBBTree *m, int bn, int first_geo, int num_geos, double enve
   R[1][2] = E[0][mid]*E[2][max] - E[0][max]*E[2][mid];
   R[2][2] = E[0][max]*E[1][mid] - E[0][mid]*E[1][max];
 
-  static ChMatrix33<> Rch;
+  ChMatrix33<> Rch;
   Rch.Set33Element(0,0, R[0][0]);Rch.Set33Element(0,1, R[0][1]);Rch.Set33Element(0,2, R[0][2]);
   Rch.Set33Element(1,0, R[1][0]);Rch.Set33Element(1,1, R[1][1]);Rch.Set33Element(1,2, R[1][2]);
   Rch.Set33Element(2,0, R[2][0]);Rch.Set33Element(2,1, R[2][1]);Rch.Set33Element(2,2, R[2][2]);
@@ -322,8 +436,7 @@ int build_recurse(CHOBBTree *m, int bn, int first_geo, int num_geos, double enve
   {
     // BV not a leaf - first_child will index a BV
 
-    b->first_child = m->current_box;
-    m->current_box +=2;
+    b->first_child = next_box;
 
     // choose splitting axis and splitting coord
 
@@ -340,10 +453,12 @@ int build_recurse(CHOBBTree *m, int bn, int first_geo, int num_geos, double enve
     // recursively build the children
 
     build_recurse(m, m->child(bn)->first_child, first_geo, num_first_half,
-					envelope);
+					envelope,
+					next_box + 2, depth + 1, task_depth, tasks);
     build_recurse(m, m->child(bn)->first_child + 1,
                   first_geo + num_first_half, num_geos - num_first_half,
-					envelope);
+					envelope,
+					next_box + 2*num_first_half, depth + 1, task_depth, tasks);
   }
   return ChC_OK;
 }
@@ -394,9 +509,25 @@ int CHOBBTree::build_model(double envelope)
 
   current_box = 1;
 
-  // build recursively
+  // build recursively the upper levels, deferring the deeper subtrees...
+
+  std::vector<ChCollisionTreeBuildTask> tasks;
+  int task_depth = GetParallelBuildDepth(num_geometries);
+
+  build_recurse(this, 0, 0, num_geometries, envelope,
+				current_box, 0, task_depth, &tasks);
+
+  // ...then build the subtrees in parallel: they work on disjoint 
+  // ranges of geometries and boxes.
+
+  #pragma omp parallel for schedule(dynamic)
+  for (int nt = 0; nt < (int)tasks.size(); ++nt)
+  {
+	build_recurse(this, tasks[nt].bn, tasks[nt].first_geo, tasks[nt].num_geos, envelope,
+				  tasks[nt].next_box, 0, -1, NULL);
+  }
 
-  build_recurse(this, 0, 0, num_geometries, envelope);
+  current_box = (int)b.size();
 
   // change BV orientations from world-relative to parent-relative
 
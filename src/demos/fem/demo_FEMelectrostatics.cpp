@@ -19,7 +19,7 @@
 // Include some headers used by this tutorial...
 
 #include "physics/ChSystem.h"
-#include "lcp/ChLcpIterativeMINRES.h"
+#include "lcp/ChLcpIterativeAMG.h"
 #include "unit_FEM/ChElementSpring.h"
 #include "unit_FEM/ChElementBar.h"
 #include "unit_FEM/ChElementTetra_4.h"
@@ -180,15 +180,13 @@ int main(int argc, char* argv[])
 	// THE SOFT-REAL-TIME CYCLE
 	//
 
-	my_system.SetLcpSolverType(ChSystem::LCP_ITERATIVE_MINRES); // <- NEEDED because other solvers can't handle stiffness matrices
+	my_system.SetLcpSolverType(ChSystem::LCP_ITERATIVE_AMG); // <- multigrid preconditioned CG, fast for scalar field meshes without constraints
 	my_system.SetIterLCPwarmStarting(false); // this helps a lot to speedup convergence in this class of problems
-	my_system.SetIterLCPmaxItersSpeed(538);
-	chrono::ChLcpIterativeMINRES* msolver = (chrono::ChLcpIterativeMINRES*)my_system.GetLcpSolverSpeed();
-	msolver->SetRelTolerance(1e-20);
-	msolver->SetTolerance(1e-20);
+	my_system.SetIterLCPmaxItersSpeed(100);
+	chrono::ChLcpIterativeAMG* msolver = (chrono::ChLcpIterativeAMG*)my_system.GetLcpSolverSpeed();
+	msolver->SetRelTolerance(1e-12);
 	msolver->SetVerbose(true);
-	msolver->SetDiagonalPreconditioning(true);
-	my_system.SetTolSpeeds(1e-20);
+	my_system.SetTolSpeeds(0);
 my_system.SetParallelThreadNumber(1);
 
 	// Note: if you are interested only in a single LINEAR STATIC solution 
@@ -193,9 +193,9 @@ int main(int argc, char* argv[])
 	// THE SOFT-REAL-TIME CYCLE
 	//
 
-	my_system.SetLcpSolverType(ChSystem::LCP_ITERATIVE_MINRES); // <- NEEDED because other solvers can't handle stiffness matrices
+	my_system.SetLcpSolverType(ChSystem::LCP_ITERATIVE_AMG); // <- multigrid preconditioned CG, fast for scalar field meshes without constraints
 	my_system.SetIterLCPwarmStarting(false); // this helps a lot to speedup convergence in this class of problems
-	my_system.SetIterLCPmaxItersSpeed(160);
+	my_system.SetIterLCPmaxItersSpeed(100);
 
 
 	// Note: if you are interested only in a single LINEAR STATIC solution 
@@ -0,0 +1,791 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChLcpIterativeAMG.cpp
+//
+//
+//    file for CHRONO HYPEROCTANT LCP solver
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "ChLcpIterativeAMG.h"
+#include "ChLcpKblockGeneric.h"
+#include <algorithm>
+
+namespace chrono
+{
+
+
+/// Sparse matrix in compressed row format, used by the multigrid levels.
+
+class ChAmgMatrix
+{
+public:
+	int nrows;
+	int ncols;
+	std::vector<int>	rowptr;
+	std::vector<int>	colind;
+	std::vector<double>	val;
+
+	ChAmgMatrix() : nrows(0), ncols(0) {}
+
+		// y = A*x
+	void Multiply(std::vector<double>& y, const std::vector<double>& x) const
+	{
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < nrows; ++i)
+		{
+			double s = 0;
+			for (int k = rowptr[i]; k < rowptr[i+1]; ++k)
+				s += val[k] * x[colind[k]];
+			y[i] = s;
+		}
+	}
+
+		// r = b - A*x
+	void Residual(std::vector<double>& r, const std::vector<double>& b, const std::vector<double>& x) const
+	{
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < nrows; ++i)
+		{
+			double s = b[i];
+			for (int k = rowptr[i]; k < rowptr[i+1]; ++k)
+				s -= val[k] * x[colind[k]];
+			r[i] = s;
+		}
+	}
+
+		// y += A*x
+	void MultiplyAndAdd(std::vector<double>& y, const std::vector<double>& x) const
+	{
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < nrows; ++i)
+		{
+			double s = 0;
+			for (int k = rowptr[i]; k < rowptr[i+1]; ++k)
+				s += val[k] * x[colind[k]];
+			y[i] += s;
+		}
+	}
+
+		// position of the (i,j) element, columns must be sorted
+	int Find(int i, int j) const
+	{
+		return (int)(std::lower_bound(colind.begin() + rowptr[i], colind.begin() + rowptr[i+1], j) - colind.begin());
+	}
+
+		// T = A'
+	void Transpose(ChAmgMatrix& T) const
+	{
+		T.nrows = ncols;
+		T.ncols = nrows;
+		T.rowptr.assign(ncols+1, 0);
+		T.colind.resize(colind.size());
+		T.val.resize(val.size());
+		for (size_t k = 0; k < colind.size(); ++k)
+			++T.rowptr[colind[k]+1];
+		for (int i = 0; i < ncols; ++i)
+			T.rowptr[i+1] += T.rowptr[i];
+		std::vector<int> fill(T.rowptr.begin(), T.rowptr.end()-1);
+		for (int i = 0; i < nrows; ++i)
+			for (int k = rowptr[i]; k < rowptr[i+1]; ++k)
+			{
+				int pos = fill[colind[k]]++;
+				T.colind[pos] = i;
+				T.val[pos] = val[k];
+			}
+	}
+
+		// C = A*B
+	void MultiplyMatrix(ChAmgMatrix& C, const ChAmgMatrix& B) const
+	{
+		C.nrows = nrows;
+		C.ncols = B.ncols;
+		C.rowptr.resize(nrows+1);
+		C.colind.clear();
+		C.val.clear();
+		std::vector<int> marker(B.ncols, -1);
+		for (int i = 0; i < nrows; ++i)
+		{
+			int start = (int)C.colind.size();
+			C.rowptr[i] = start;
+			for (int k = rowptr[i]; k < rowptr[i+1]; ++k)
+			{
+				int j = colind[k];
+				double a = val[k];
+				for (int kb = B.rowptr[j]; kb < B.rowptr[j+1]; ++kb)
+				{
+					int c = B.colind[kb];
+					if (marker[c] < 0)
+					{
+						marker[c] = (int)C.colind.size();
+						C.colind.push_back(c);
+						C.val.push_back(a * B.val[kb]);
+					}
+					else
+						C.val[marker[c]] += a * B.val[kb];
+				}
+			}
+			for (size_t k = start; k < C.colind.size(); ++k)
+				marker[C.colind[k]] = -1;
+		}
+		C.rowptr[nrows] = (int)C.colind.size();
+	}
+};
+
+
+/// A level of the multigrid hierarchy: the matrix, the transfer
+/// operators to the next coarser level, and work vectors.
+
+class ChAmgLevel
+{
+public:
+	ChAmgMatrix A;
+	ChAmgMatrix P;		// prolongation from the next coarser level
+	ChAmgMatrix R;		// restriction to the next coarser level, P'
+	std::vector<double> invdiag;
+	std::vector<double> x;
+	std::vector<double> b;
+	std::vector<double> r;
+
+	std::vector<double> L;	// coarsest level: dense Cholesky factor, lower triangle, by rows
+	bool dense;
+
+	ChAmgLevel() : dense(false) {}
+
+	void Setup()
+	{
+		int n = A.nrows;
+		invdiag.assign(n, 0.0);
+		for (int i = 0; i < n; ++i)
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				if (A.colind[k] == i && A.val[k] != 0)
+					invdiag[i] += A.val[k];
+		for (int i = 0; i < n; ++i)
+			if (invdiag[i] != 0)
+				invdiag[i] = 1.0 / invdiag[i];
+		x.assign(n, 0.0);
+		b.assign(n, 0.0);
+		r.assign(n, 0.0);
+	}
+
+		// Gauss-Seidel sweeps on A*x=b, forward or backward
+	void Smooth(int sweeps, bool forward)
+	{
+		int n = A.nrows;
+		for (int is = 0; is < sweeps; ++is)
+			for (int ii = 0; ii < n; ++ii)
+			{
+				int i = forward ? ii : (n-1-ii);
+				double s = b[i];
+				for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+					s -= A.val[k] * x[A.colind[k]];
+				x[i] += s * invdiag[i];
+			}
+	}
+
+		// Dense Cholesky factorization of A. Null pivots (singular
+		// problems, ex. without Dirichlet nodes) are skipped.
+	void FactorizeDense()
+	{
+		int n = A.nrows;
+		L.assign((size_t)n*n, 0.0);
+		for (int i = 0; i < n; ++i)
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				L[(size_t)i*n + A.colind[k]] += A.val[k];
+		for (int j = 0; j < n; ++j)
+		{
+			double* Lj = &L[(size_t)j*n];
+			double d = Lj[j];
+			for (int k = 0; k < j; ++k)
+				d -= Lj[k] * Lj[k];
+			if (d <= 1e-12 * fabs(Lj[j]) || d <= 0)
+			{
+				for (int k = 0; k <= j; ++k)
+					Lj[k] = 0;
+				for (int i = j+1; i < n; ++i)
+					L[(size_t)i*n + j] = 0;
+				continue;
+			}
+			Lj[j] = sqrt(d);
+			double invd = 1.0 / Lj[j];
+			for (int i = j+1; i < n; ++i)
+			{
+				double* Li = &L[(size_t)i*n];
+				double s = Li[j];
+				for (int k = 0; k < j; ++k)
+					s -= Li[k] * Lj[k];
+				Li[j] = s * invd;
+			}
+		}
+		dense = true;
+	}
+
+		// x = A^-1 * b with the dense factorization
+	void SolveDense()
+	{
+		int n = A.nrows;
+		for (int i = 0; i < n; ++i)
+		{
+			const double* Li = &L[(size_t)i*n];
+			double s = b[i];
+			for (int k = 0; k < i; ++k)
+				s -= Li[k] * x[k];
+			x[i] = Li[i] ? s / Li[i] : 0;
+		}
+		for (int i = n-1; i >= 0; --i)
+		{
+			double s = x[i];
+			for (int k = i+1; k < n; ++k)
+				s -= L[(size_t)k*n + i] * x[k];
+			x[i] = L[(size_t)i*n + i] ? s / L[(size_t)i*n + i] : 0;
+		}
+	}
+};
+
+
+
+ChLcpIterativeAMG::ChLcpIterativeAMG(int mmax_iters, bool mwarm_start, double mtolerance)
+			: ChLcpIterativeMINRES(mmax_iters, mwarm_start, mtolerance)
+{
+	rel_tolerance = 1e-8;
+	max_levels = 20;
+	coarsest_size = 200;
+	strength_threshold = 0.08;
+	n_smoothing = 1;
+	reuse_hierarchy = true;
+}
+
+ChLcpIterativeAMG::~ChLcpIterativeAMG()
+{
+	ResetHierarchy();
+}
+
+void ChLcpIterativeAMG::ResetHierarchy()
+{
+	for (unsigned int i = 0; i < levels.size(); ++i)
+		delete levels[i];
+	levels.clear();
+}
+
+
+void ChLcpIterativeAMG::BuildFineMatrix(ChLcpSystemDescriptor& sysd, ChAmgMatrix& A)
+{
+	std::vector<ChLcpVariables*>&  mvariables	= sysd.GetVariablesList();
+	std::vector<ChLcpKblock*>&     mstiffness	= sysd.GetKblocksList();
+
+	int nv = sysd.CountActiveVariables();
+	int nk = (int)mstiffness.size();
+
+	// The rows of the dofs of each stiffness block, -1 for inactive variables.
+	// Blocks are scattered in memory, so they are visited only here and
+	// when adding their values; all the rest works on these arrays.
+	std::vector<int> blk_start(nk+1, 0);
+	for (int ik = 0; ik < nk; ik++)
+	{
+		ChLcpKblockGeneric* mblock = (ChLcpKblockGeneric*)mstiffness[ik];
+		int kn = 0;
+		for (unsigned int jv = 0; jv < mblock->GetNvars(); jv++)
+			kn += mblock->GetVariableN(jv)->Get_ndof();
+		blk_start[ik+1] = blk_start[ik] + kn;
+	}
+	std::vector<int> blk_rows(blk_start[nk]);
+	for (int ik = 0; ik < nk; ik++)
+	{
+		ChLcpKblockGeneric* mblock = (ChLcpKblockGeneric*)mstiffness[ik];
+		int* mrows = &blk_rows[0] + blk_start[ik];
+		for (unsigned int jv = 0; jv < mblock->GetNvars(); jv++)
+		{
+			ChLcpVariables* mvar = mblock->GetVariableN(jv);
+			int jo = mvar->GetOffset();
+			for (int c = 0; c < mvar->Get_ndof(); ++c)
+				*(mrows++) = mvar->IsActive() ? jo + c : -1;
+		}
+	}
+
+	// For each row, the first row and the size of its variable, for the mass blocks
+	std::vector<int> row_var(nv);
+	std::vector<int> row_ndof(nv);
+	for (unsigned int iv = 0; iv < mvariables.size(); iv++)
+		if (mvariables[iv]->IsActive())
+			for (int k = 0; k < mvariables[iv]->Get_ndof(); ++k)
+			{
+				row_var[mvariables[iv]->GetOffset() + k] = mvariables[iv]->GetOffset();
+				row_ndof[mvariables[iv]->GetOffset() + k] = mvariables[iv]->Get_ndof();
+			}
+
+	// For each row, the stiffness blocks that reference it
+	std::vector<int> inc_start(nv+1, 0);
+	for (size_t k = 0; k < blk_rows.size(); ++k)
+		if (blk_rows[k] >= 0)
+			++inc_start[blk_rows[k] + 1];
+	for (int i = 0; i < nv; ++i)
+		inc_start[i+1] += inc_start[i];
+	std::vector<int> inc_block(inc_start[nv]);
+	std::vector<int> fill(inc_start.begin(), inc_start.end()-1);
+	for (int ik = 0; ik < nk; ik++)
+		for (int k = blk_start[ik]; k < blk_start[ik+1]; ++k)
+			if (blk_rows[k] >= 0)
+				inc_block[fill[blk_rows[k]]++] = ik;
+
+	// Sparsity pattern, with sorted columns
+	A.nrows = nv;
+	A.ncols = nv;
+	A.rowptr.resize(nv+1);
+	A.colind.clear();
+	std::vector<char> marker(nv, 0);
+	for (int i = 0; i < nv; ++i)
+	{
+		int start = (int)A.colind.size();
+		A.rowptr[i] = start;
+		for (int c = 0; c < row_ndof[i]; ++c)
+		{
+			marker[row_var[i] + c] = 1;
+			A.colind.push_back(row_var[i] + c);
+		}
+		for (int p = inc_start[i]; p < inc_start[i+1]; ++p)
+			for (int k = blk_start[inc_block[p]]; k < blk_start[inc_block[p]+1]; ++k)
+			{
+				int j = blk_rows[k];
+				if (j >= 0 && !marker[j])
+				{
+					marker[j] = 1;
+					A.colind.push_back(j);
+				}
+			}
+		for (size_t k = start; k < A.colind.size(); ++k)
+			marker[A.colind[k]] = 0;
+		std::sort(A.colind.begin() + start, A.colind.end());
+	}
+	A.rowptr[nv] = (int)A.colind.size();
+	A.val.assign(A.colind.size(), 0.0);
+
+	// Add the mass blocks of the variables
+	ChMatrixDynamic<> munit;
+	ChMatrixDynamic<> mcolumn;
+	for (unsigned int iv = 0; iv < mvariables.size(); iv++)
+	{
+		ChLcpVariables* mvar = mvariables[iv];
+		if (!mvar->IsActive())
+			continue;
+		int io = mvar->GetOffset();
+		int in = mvar->Get_ndof();
+		munit.Reset(in, 1);
+		mcolumn.Reset(in, 1);
+		for (int c = 0; c < in; ++c)
+		{
+			munit.FillElem(0);
+			munit(c) = 1;
+			mcolumn.FillElem(0);
+			mvar->Compute_inc_Mb_v(mcolumn, munit);
+			for (int r = 0; r < in; ++r)
+				A.val[A.Find(io + r, io + c)] += mcolumn(r);
+		}
+	}
+
+	// Add the stiffness blocks
+	for (int ik = 0; ik < nk; ik++)
+	{
+		ChLcpKblockGeneric* mblock = (ChLcpKblockGeneric*)mstiffness[ik];
+		const int* mrows = &blk_rows[0] + blk_start[ik];
+		int kn = blk_start[ik+1] - blk_start[ik];
+		for (int r = 0; r < kn; ++r)
+		{
+			if (mrows[r] < 0)
+				continue;
+			for (int c = 0; c < kn; ++c)
+				if (mrows[c] >= 0)
+					A.val[A.Find(mrows[r], mrows[c])] += mblock->GetKelement(r, c);
+		}
+	}
+}
+
+
+void ChLcpIterativeAMG::BuildHierarchy(ChAmgMatrix& Afine)
+{
+	ResetHierarchy();
+
+	ChAmgLevel* mlevel = new ChAmgLevel;
+	mlevel->A.nrows = Afine.nrows;
+	mlevel->A.ncols = Afine.ncols;
+	mlevel->A.rowptr.swap(Afine.rowptr);
+	mlevel->A.colind.swap(Afine.colind);
+	mlevel->A.val.swap(Afine.val);
+	mlevel->Setup();
+	levels.push_back(mlevel);
+
+	double eps = this->strength_threshold;
+
+	while (true)
+	{
+		ChAmgMatrix& A = mlevel->A;
+		int n = A.nrows;
+
+		if (n <= this->coarsest_size || (int)levels.size() >= this->max_levels)
+			break;
+
+		// Strong couplings:  |a_ij| > eps*sqrt(|a_ii*a_jj|)
+		std::vector<double> diag(n, 0.0);
+		for (int i = 0; i < n; ++i)
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				if (A.colind[k] == i)
+					diag[i] += A.val[k];
+		std::vector<char> strong(A.colind.size(), 0);
+		std::vector<char> has_strong(n, 0);
+		for (int i = 0; i < n; ++i)
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+			{
+				int j = A.colind[k];
+				if (j != i && A.val[k]*A.val[k] > eps*eps*fabs(diag[i]*diag[j]))
+				{
+					strong[k] = 1;
+					has_strong[i] = 1;
+				}
+			}
+
+		// Aggregation. Nodes without strong couplings are not aggregated,
+		// they are left to the smoother.
+		std::vector<int> agg(n, -1);
+		int nagg = 0;
+			// 1) aggregates made by a node and all its strong neighbours, if all free
+		for (int i = 0; i < n; ++i)
+		{
+			if (agg[i] >= 0 || !has_strong[i])
+				continue;
+			bool free = true;
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1] && free; ++k)
+				if (strong[k] && agg[A.colind[k]] >= 0)
+					free = false;
+			if (!free)
+				continue;
+			agg[i] = nagg;
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				if (strong[k])
+					agg[A.colind[k]] = nagg;
+			++nagg;
+		}
+			// 2) the remaining nodes join the aggregate of their strongest neighbour
+		std::vector<int> agg1(agg);
+		for (int i = 0; i < n; ++i)
+		{
+			if (agg[i] >= 0 || !has_strong[i])
+				continue;
+			double amax = 0;
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				if (strong[k] && agg1[A.colind[k]] >= 0 && fabs(A.val[k]) > amax)
+				{
+					amax = fabs(A.val[k]);
+					agg[i] = agg1[A.colind[k]];
+				}
+		}
+			// 3) new aggregates with the nodes still left
+		for (int i = 0; i < n; ++i)
+		{
+			if (agg[i] >= 0 || !has_strong[i])
+				continue;
+			agg[i] = nagg;
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				if (strong[k] && agg[A.colind[k]] < 0)
+					agg[A.colind[k]] = nagg;
+			++nagg;
+		}
+
+		// stop if the coarsening stagnates
+		if (nagg == 0 || nagg > 0.8 * n)
+			break;
+
+		// Smoothed prolongation  P = (I - w*D^-1*A)*P0, with P0 the piecewise
+		// constant interpolation on the aggregates, w = 4/3 / rho(D^-1*A).
+		// The spectral radius is bounded with Gershgorin circles.
+		double rho = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			if (diag[i] == 0)
+				continue;
+			double s = 0;
+			for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				s += fabs(A.val[k]);
+			rho = ChMax(rho, s / fabs(diag[i]));
+		}
+		double omega = (rho > 0) ? (4.0/3.0) / rho : 0;
+
+		ChAmgMatrix& P = mlevel->P;
+		P.nrows = n;
+		P.ncols = nagg;
+		P.rowptr.resize(n+1);
+		P.colind.clear();
+		P.val.clear();
+		std::vector<int> marker(nagg, -1);
+		for (int i = 0; i < n; ++i)
+		{
+			int start = (int)P.colind.size();
+			P.rowptr[i] = start;
+			if (agg[i] >= 0)
+			{
+				marker[agg[i]] = (int)P.colind.size();
+				P.colind.push_back(agg[i]);
+				P.val.push_back(1.0);
+			}
+			if (diag[i] != 0)
+			{
+				double wd = omega / diag[i];
+				for (int k = A.rowptr[i]; k < A.rowptr[i+1]; ++k)
+				{
+					int c = agg[A.colind[k]];
+					if (c < 0)
+						continue;
+					if (marker[c] < 0)
+					{
+						marker[c] = (int)P.colind.size();
+						P.colind.push_back(c);
+						P.val.push_back(-wd * A.val[k]);
+					}
+					else
+						P.val[marker[c]] -= wd * A.val[k];
+				}
+			}
+			for (size_t k = start; k < P.colind.size(); ++k)
+				marker[P.colind[k]] = -1;
+		}
+		P.rowptr[n] = (int)P.colind.size();
+
+		P.Transpose(mlevel->R);
+
+		// Galerkin coarse operator  Ac = R*A*P
+		ChAmgLevel* mcoarse = new ChAmgLevel;
+		ChAmgMatrix AP;
+		A.MultiplyMatrix(AP, P);
+		mlevel->R.MultiplyMatrix(mcoarse->A, AP);
+		mcoarse->Setup();
+		levels.push_back(mcoarse);
+
+		mlevel = mcoarse;
+		eps *= 0.5;
+	}
+
+	// The coarsest level is solved with a dense factorization, if small enough,
+	// otherwise with Gauss-Seidel sweeps.
+	if (mlevel->A.nrows <= ChMax(this->coarsest_size, 2000))
+		mlevel->FactorizeDense();
+}
+
+
+void ChLcpIterativeAMG::VCycle(unsigned int nlevel)
+{
+	ChAmgLevel* mlevel = levels[nlevel];
+
+	if (nlevel == levels.size()-1)
+	{
+		if (mlevel->dense)
+			mlevel->SolveDense();
+		else
+		{
+			std::fill(mlevel->x.begin(), mlevel->x.end(), 0.0);
+			for (int is = 0; is < 10; ++is)
+			{
+				mlevel->Smooth(1, true);
+				mlevel->Smooth(1, false);
+			}
+		}
+		return;
+	}
+
+	ChAmgLevel* mcoarse = levels[nlevel+1];
+
+	// pre-smoothing, starting from x=0
+	std::fill(mlevel->x.begin(), mlevel->x.end(), 0.0);
+	mlevel->Smooth(this->n_smoothing, true);
+
+	// coarse correction
+	mlevel->A.Residual(mlevel->r, mlevel->b, mlevel->x);
+	mlevel->R.Multiply(mcoarse->b, mlevel->r);
+	VCycle(nlevel+1);
+	mlevel->P.MultiplyAndAdd(mlevel->x, mcoarse->x);
+
+	// post-smoothing, backward so that the preconditioner is symmetric
+	mlevel->Smooth(this->n_smoothing, false);
+}
+
+
+double ChLcpIterativeAMG::Solve(
+				ChLcpSystemDescriptor& sysd		///< system description with constraints and variables
+				)
+{
+	std::vector<ChLcpKblock*>& mstiffness = sysd.GetKblocksList();
+
+	// Constraints and custom stiffness blocks are not supported: use MINRES
+	bool supported = (sysd.CountActiveConstraints() == 0);
+	for (unsigned int ik = 0; ik < mstiffness.size() && supported; ik++)
+		if (!dynamic_cast<ChLcpKblockGeneric*>(mstiffness[ik]))
+			supported = false;
+	if (!supported)
+	{
+		if (verbose)
+			GetLog() << "\n----- AMG-CG: constraints or non generic Kblocks, fall back to MINRES\n";
+		return this->Solve_SupportingStiffness(sysd);
+	}
+
+	this->tot_iterations = 0;
+
+	if (sysd.CountActiveVariables() == 0)
+		return 0.;
+
+	//
+	// --- Assemble the sparse matrix and, if needed, the multigrid hierarchy
+	//
+
+	ChAmgMatrix Afine;
+	BuildFineMatrix(sysd, Afine);
+	int nv = Afine.nrows;
+
+	if (this->reuse_hierarchy && levels.size() &&
+		levels[0]->A.nrows == nv &&
+		levels[0]->A.rowptr == Afine.rowptr &&
+		levels[0]->A.colind == Afine.colind)
+	{
+		// same sparsity: keep the coarse levels, update only the fine matrix
+		levels[0]->A.val.swap(Afine.val);
+		levels[0]->Setup();
+		if (levels[0]->dense)
+			levels[0]->FactorizeDense();
+	}
+	else
+		BuildHierarchy(Afine);
+
+	if (verbose)
+	{
+		GetLog() << "\n----- AMG-CG, n.vars nx=" << nv << "  max.iters=" << max_iterations << "  levels:";
+		for (unsigned int il = 0; il < levels.size(); ++il)
+			GetLog() << " " << levels[il]->A.nrows;
+		GetLog() << "\n";
+	}
+
+	ChAmgMatrix& A = levels[0]->A;
+
+	//
+	// --- Vector initialization
+	//
+
+	ChMatrixDynamic<> mx(nv,1);
+	ChMatrixDynamic<> md(nv,1);
+
+	if (warm_start)
+		sysd.FromUnknownsToVector(mx);
+	else
+		mx.FillElem(0);
+
+	// Initialize the d vector filling it with {f}
+	sysd.BuildDiVector(md);
+
+	std::vector<double> x(mx.GetAddress(), mx.GetAddress()+nv);
+	std::vector<double> d(md.GetAddress(), md.GetAddress()+nv);
+	std::vector<double> r(nv);
+	std::vector<double> p(nv);
+	std::vector<double> Ap(nv);
+	std::vector<double>& z = levels[0]->x;	// the V-cycle writes here
+	std::vector<double>& zb = levels[0]->b;	// the V-cycle reads here
+
+	//
+	// --- THE PRECONDITIONED CONJUGATE GRADIENT
+	//
+
+	double norm_d = 0;
+	for (int i = 0; i < nv; ++i)
+		norm_d += d[i]*d[i];
+	norm_d = sqrt(norm_d);
+	double tol = ChMax(this->rel_tolerance * norm_d, this->tolerance);
+
+	// r = d - A*x
+	A.Residual(r, d, x);
+
+	double norm_r = 0;
+	for (int i = 0; i < nv; ++i)
+		norm_r += r[i]*r[i];
+	norm_r = sqrt(norm_r);
+
+	// z = B*r, p = z
+	zb = r;
+	VCycle(0);
+	p = z;
+	double rz = 0;
+	for (int i = 0; i < nv; ++i)
+		rz += r[i]*z[i];
+
+	for (int iter = 0; iter < max_iterations; iter++)
+	{
+		if (norm_r <= tol)
+			break;
+
+		// alpha = r'*z / p'*A*p
+		A.Multiply(Ap, p);
+		double pAp = 0;
+		for (int i = 0; i < nv; ++i)
+			pAp += p[i]*Ap[i];
+		if (pAp <= 0 || rz <= 0)
+			break;
+		double alpha = rz / pAp;
+
+		// x += alpha*p,  r -= alpha*A*p
+		double maxdeltaunknowns = 0;
+		norm_r = 0;
+		for (int i = 0; i < nv; ++i)
+		{
+			x[i] += alpha * p[i];
+			r[i] -= alpha * Ap[i];
+			norm_r += r[i]*r[i];
+			maxdeltaunknowns = ChMax(maxdeltaunknowns, fabs(alpha * p[i]));
+		}
+		norm_r = sqrt(norm_r);
+
+		++this->tot_iterations;
+
+		if (this->record_violation_history)
+			AtIterationEnd(norm_r, maxdeltaunknowns, iter);
+
+		if (verbose)
+			GetLog() << "  iter=" << iter << "  |r|=" << norm_r << "\n";
+
+		// z = B*r,  p = z + beta*p
+		zb = r;
+		VCycle(0);
+		double rz_new = 0;
+		for (int i = 0; i < nv; ++i)
+			rz_new += r[i]*z[i];
+		double beta = rz_new / rz;
+		rz = rz_new;
+		for (int i = 0; i < nv; ++i)
+			p[i] = z[i] + beta * p[i];
+	}
+
+	// copy the solution in the ChLcpVariable items
+	for (int i = 0; i < nv; ++i)
+		mx(i) = x[i];
+	sysd.FromVectorToUnknowns(mx);
+
+	if (verbose) GetLog() <<"AMG-CG residual: "<< norm_r << " iterations: " << tot_iterations << " ---\n";
+
+	return 0.;
+}
+
+
+
+
+
+
+} // END_OF_NAMESPACE____
+
+
@@ -0,0 +1,146 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHLCPITERATIVEAMG_H
+#define CHLCPITERATIVEAMG_H
+
+//////////////////////////////////////////////////
+//
+//   ChLcpIterativeAMG.h
+//
+//  An iterative solver based on conjugate gradients
+//  preconditioned by algebraic multigrid, for
+//  sparse stiffness problems without constraints.
+//
+//   HEADER file for CHRONO HYPEROCTANT LCP solver
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+
+#include "ChLcpIterativeMINRES.h"
+
+
+namespace chrono
+{
+
+class ChAmgMatrix;
+class ChAmgLevel;
+
+
+/// An iterative solver for the linear problem
+///
+///  | M |*|q|- | f|= |0|
+///
+/// where M is the sparse, symmetric positive definite matrix made
+/// by the mass blocks of the variables plus the ChLcpKblockGeneric
+/// stiffness blocks, as in FEM problems. It uses conjugate gradients
+/// preconditioned by a V-cycle of smoothed aggregation algebraic
+/// multigrid, where the coarse levels are built from the sparsity
+/// graph of the matrix, that is from the connectivity of the elements.
+/// The number of iterations is almost independent on the size of the
+/// mesh, so it is much faster than MINRES on fine meshes.
+/// It is best suited to scalar field problems (thermal, electrostatics,
+/// with ChNodeFEMxyzP nodes and ChElementTetra_4_P elements); it also
+/// works, though with slower convergence, on elasticity problems.
+/// Fixed nodes (disabled variables) are Dirichlet conditions.
+/// If the system contains constraints, or stiffness blocks that are not
+/// ChLcpKblockGeneric, it falls back to ChLcpIterativeMINRES.
+
+class ChApi ChLcpIterativeAMG : public ChLcpIterativeMINRES
+{
+protected:
+			//
+			// DATA
+			//
+	int		max_levels;
+	int		coarsest_size;
+	double	strength_threshold;
+	int		n_smoothing;
+	bool	reuse_hierarchy;
+
+	std::vector<ChAmgLevel*> levels;
+
+	void BuildFineMatrix(ChLcpSystemDescriptor& sysd, ChAmgMatrix& A);
+	void BuildHierarchy(ChAmgMatrix& A);
+	void VCycle(unsigned int nlevel);
+
+public:
+			//
+			// CONSTRUCTORS
+			//
+
+	ChLcpIterativeAMG(
+				int mmax_iters=50,      ///< max.number of iterations
+				bool mwarm_start=false,	///< uses warm start?
+				double mtolerance=0.0   ///< tolerance for termination criterion
+				);
+
+	virtual ~ChLcpIterativeAMG();
+
+			//
+			// FUNCTIONS
+			//
+
+				/// Performs the solution of the problem.
+				/// The iteration stops when the norm of the residual is lower than
+				/// the tolerance, or lower than rel_tolerance*|f| (default 1e-8),
+				/// see SetTolerance() and SetRelTolerance().
+				/// \return  the maximum constraint violation after termination.
+	virtual double Solve(
+				ChLcpSystemDescriptor& sysd		///< system description with constraints and variables
+				);
+
+				/// Maximum number of levels of the multigrid hierarchy (default 20)
+	void SetMaxLevels(int ml) {this->max_levels = ml;}
+	int  GetMaxLevels() {return this->max_levels;}
+
+				/// The coarsening stops when a level has less than these unknowns,
+				/// that are solved with a dense factorization (default 200)
+	void SetCoarsestSize(int ms) {this->coarsest_size = ms;}
+	int  GetCoarsestSize() {return this->coarsest_size;}
+
+				/// Threshold for strong couplings in aggregation, |a_ij| > e*sqrt(|a_ii*a_jj|)
+				/// (default 0.08, halved at each level)
+	void   SetStrengthThreshold(double me) {this->strength_threshold = me;}
+	double GetStrengthThreshold() {return this->strength_threshold;}
+
+				/// Number of Gauss-Seidel sweeps before (forward) and after (backward)
+				/// the coarse correction, at each level (default 1)
+	void SetSmoothingSweeps(int mn) {this->n_smoothing = mn;}
+	int  GetSmoothingSweeps() {return this->n_smoothing;}
+
+				/// If true (default), the coarse levels are rebuilt only when the
+				/// number of unknowns or the sparsity of the matrix changes, as
+				/// in transient simulations with constant time step; this saves
+				/// the setup time. The solution does not depend on this, only the
+				/// convergence rate may degrade if the matrix values change a lot.
+	void SetReuseHierarchy(bool mr) {this->reuse_hierarchy = mr;}
+	bool GetReuseHierarchy() {return this->reuse_hierarchy;}
+
+				/// Forces the rebuild of the coarse levels at the next Solve()
+	void ResetHierarchy();
+
+				/// Number of levels in the last multigrid hierarchy
+	int GetNlevels() {return (int)levels.size();}
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+
+
+
+#endif  // END of ChLcpIterativeAMG.h
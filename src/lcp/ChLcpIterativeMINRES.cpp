@@ -555,6 +555,8 @@ double ChLcpIterativeMINRES::Solve_SupportingStiffness(
 		// ---------------------------------------------
 		// METRICS - convergence, plots, etc
 
+		++this->tot_iterations;
+
 		// For recording into correction/residuals/violation history, if debugging
 		if (this->record_violation_history)
 			AtIterationEnd(r_proj_resid, maxdeltaunknowns, iter);
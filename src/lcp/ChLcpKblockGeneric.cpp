@@ -23,6 +23,7 @@
 
  
 #include "ChLcpKblockGeneric.h" 
+#include <algorithm>
 
 #include "core/ChMemory.h" // must be after system's include (memory leak debugger).
 
@@ -36,6 +37,13 @@ ChClassRegister<ChLcpKblockGeneric> a_registration_ChLcpKblockGeneric;
 
 
 
+// Index of the (row,col) element, with row<=col, in a packed upper triangle of size n
+static inline int PackedIndex(int row, int col, int n)
+{
+	return row*n - (row*(row-1))/2 + (col-row);
+}
+
+
 ChLcpKblockGeneric& ChLcpKblockGeneric::operator=(const ChLcpKblockGeneric& other)
 {
 	if (&other == this) return *this;
@@ -44,6 +52,10 @@ ChLcpKblockGeneric& ChLcpKblockGeneric::operator=(const ChLcpKblockGeneric& othe
 	//ChLcpKblock::operator=(other);
 
 	this->variables = other.variables;
+	this->storage = other.storage;
+	this->Ksize = other.Ksize;
+	this->Kpacked = other.Kpacked;
+	this->Kpacked_f = other.Kpacked_f;
 
 	if (other.K)
 	{
@@ -66,20 +78,166 @@ void  ChLcpKblockGeneric::SetVariables(std::vector<ChLcpVariables*> mvariables)
 
 	variables = mvariables;
 
-	// destroy the K matrix if needed
-	if (K) delete K; K=0;
-
-	int msize = 0;
+	Ksize = 0;
 	for (unsigned int iv = 0; iv < variables.size(); iv++)
-		msize += variables[iv]->Get_ndof();
+		Ksize += variables[iv]->Get_ndof();
 	
 	// reallocate the K matrix 
-	K = new ChMatrixDynamic<double>(msize, msize);
+	AllocateK();
+}
+
+
+void ChLcpKblockGeneric::SetStorage(eChKstorage mstorage)
+{
+	storage = mstorage;
+	AllocateK();
+}
+
+
+void ChLcpKblockGeneric::AllocateK()
+{
+	// destroy the K matrix if needed
+	if (K) delete K; K=0;
+	std::vector<double>().swap(Kpacked);
+	std::vector<float>().swap(Kpacked_f);
+
+	if (variables.empty())
+		return;
+
+	int npacked = (Ksize*(Ksize+1))/2;
+	switch (storage)
+	{
+	case KSTORAGE_SYMMETRIC:
+		Kpacked.resize(npacked, 0.);
+		break;
+	case KSTORAGE_SYMMETRIC_FLOAT:
+		Kpacked_f.resize(npacked, 0.f);
+		break;
+	default:
+		K = new ChMatrixDynamic<double>(Ksize, Ksize);
+	}
+}
+
+
+void ChLcpKblockGeneric::Set_K(const ChMatrix<double>& mK)
+{
+	assert(mK.GetRows() == Ksize && mK.GetColumns() == Ksize);
+
+	switch (storage)
+	{
+	case KSTORAGE_SYMMETRIC:
+		{
+			double* mP = &Kpacked[0];
+			for (int r = 0; r < Ksize; r++)
+				for (int c = r; c < Ksize; c++)
+					*mP++ = mK(r,c);
+		}
+		break;
+	case KSTORAGE_SYMMETRIC_FLOAT:
+		{
+			float* mP = &Kpacked_f[0];
+			for (int r = 0; r < Ksize; r++)
+				for (int c = r; c < Ksize; c++)
+					*mP++ = (float)mK(r,c);
+		}
+		break;
+	default:
+		K->CopyFromMatrix(mK);
+	}
+}
+
+
+double ChLcpKblockGeneric::GetKelement(int row, int col) const
+{
+	if (storage == KSTORAGE_FULL)
+		return (*K)(row,col);
+	if (row > col)
+		std::swap(row, col);
+	if (storage == KSTORAGE_SYMMETRIC)
+		return Kpacked[PackedIndex(row, col, Ksize)];
+	return (double)Kpacked_f[PackedIndex(row, col, Ksize)];
+}
+
+
+size_t ChLcpKblockGeneric::GetKmemory() const
+{
+	if (K)
+		return K->GetRows() * K->GetColumns() * sizeof(double);
+	return Kpacked.size() * sizeof(double) + Kpacked_f.size() * sizeof(float);
+}
+
+
+// Product of the packed upper triangle 'mP' by 'vect', added to 'result', for
+// the active variables only. Each off-diagonal element contributes to two rows.
+// Products are accumulated in double also when Real is float.
+template <class Real>
+static void PackedMultiplyAndAdd(const Real* mP, int msize, const std::vector<ChLcpVariables*>& variables,
+								 ChMatrix<double>& result, const ChMatrix<double>& vect)
+{
+	int kio =0;
+	for (unsigned int iv = 0; iv< variables.size(); iv++)
+	{
+		int io = variables[iv]->GetOffset();
+		int in = variables[iv]->Get_ndof();
+
+		if (variables[iv]->IsActive())
+		{
+			for (int r = 0; r< in; r++)
+			{
+				int kr = kio + r;
+				const Real* mrow = mP + PackedIndex(kr, kr, msize) - kr; // so that mrow[c] is the (kr,c) element, c>=kr
+				double vr = vect(io+r);
+				double tot = (double)mrow[kr] * vr;
+
+				// rest of the diagonal block
+				for (int c = r+1; c< in; c++)
+				{
+					double a = (double)mrow[kio+c];
+					tot += a * vect(io+c);
+					result(io+c) += a * vr;
+				}
+
+				// off-diagonal blocks, right of the diagonal block
+				int kjo = kio + in;
+				for (unsigned int jv = iv+1; jv< variables.size(); jv++)
+				{
+					int jo = variables[jv]->GetOffset();
+					int jn = variables[jv]->Get_ndof();
+
+					if (variables[jv]->IsActive())
+					{
+						for (int c = 0; c< jn; c++)
+						{
+							double a = (double)mrow[kjo+c];
+							tot += a * vect(jo+c);
+							result(jo+c) += a * vr;
+						}
+					}
+					kjo += jn;
+				}
+
+				result(io+r) += tot;
+			}
+		}
+
+		kio += in;
+	}
 }
 
 
 void ChLcpKblockGeneric::MultiplyAndAdd(ChMatrix<double>& result, const ChMatrix<double>& vect) const
 {
+	if (storage == KSTORAGE_SYMMETRIC)
+	{
+		PackedMultiplyAndAdd(&Kpacked[0], Ksize, variables, result, vect);
+		return;
+	}
+	if (storage == KSTORAGE_SYMMETRIC_FLOAT)
+	{
+		PackedMultiplyAndAdd(&Kpacked_f[0], Ksize, variables, result, vect);
+		return;
+	}
+
 	assert(K);
 
 	int kio =0;
@@ -135,7 +293,7 @@ void ChLcpKblockGeneric::DiagonalAdd(ChMatrix<double>& result)
 			for (int r = 0; r < in; r++)
 			{
 				//GetLog() << "Summing" << result(io+r) << " to " << (*this->K)(kio+r,kio+r) << "\n";
-				result(io+r) += (*this->K)(kio+r,kio+r);
+				result(io+r) += this->GetKelement(kio+r,kio+r);
 			}
 		}
 		kio += in;
@@ -146,9 +304,21 @@ void ChLcpKblockGeneric::DiagonalAdd(ChMatrix<double>& result)
 
 void ChLcpKblockGeneric::Build_K(ChSparseMatrix& storage, bool add)
 {
-	if (!K) 
+	if (Ksize == 0 || (!K && this->storage == KSTORAGE_FULL)) 
 		return;
 
+	// packed storages: unpack in a temporary full matrix, this is not performance critical
+	ChMatrixDynamic<double> Kfull;
+	ChMatrix<double>* mK = this->K;
+	if (this->IsPacked())
+	{
+		Kfull.Reset(Ksize, Ksize);
+		for (int r = 0; r < Ksize; r++)
+			for (int c = 0; c < Ksize; c++)
+				Kfull(r,c) = this->GetKelement(r,c);
+		mK = &Kfull;
+	}
+
 	int kio =0;
 	for (unsigned int iv = 0; iv< this->GetNvars(); iv++)
 	{
@@ -166,9 +336,9 @@ void ChLcpKblockGeneric::Build_K(ChSparseMatrix& storage, bool add)
 				if (this->GetVariableN(jv)->IsActive())
 				{
 					if (add)
-						storage.PasteSumClippedMatrix(this->K, kio, kjo, in, jn,  io,jo);
+						storage.PasteSumClippedMatrix(mK, kio, kjo, in, jn,  io,jo);
 					else
-						storage.PasteClippedMatrix   (this->K, kio, kjo, in, jn,  io,jo);
+						storage.PasteClippedMatrix   (mK, kio, kjo, in, jn,  io,jo);
 				}
 
 				kjo += jn;
@@ -30,6 +30,7 @@
 ///////////////////////////////////////////////////
 
 
+#include <vector>
 #include "lcp/ChLcpKblock.h"
 
 
@@ -53,12 +54,24 @@ namespace chrono
 /// Note that all blocks in K, all masses and constraint
 /// jacobians Cq are not really assembled in large matrices, so to
 /// exploit sparsity.
+/// If K is symmetric, as for most stiffness matrices, it can be stored
+/// as a packed upper triangle, optionally in single precision, to save
+/// memory and memory bandwidth (see SetStorage() ).
 
 
 class ChApi ChLcpKblockGeneric : public ChLcpKblock
 {
 	CH_RTTI(ChLcpKblockGeneric, ChLcpKblock)
 
+public:
+			/// Storage of the K matrix
+	enum eChKstorage
+	{
+		KSTORAGE_FULL = 0,		///< full dense matrix, accessed with Get_K()
+		KSTORAGE_SYMMETRIC,		///< packed upper triangle, double precision, loaded with Set_K()
+		KSTORAGE_SYMMETRIC_FLOAT	///< packed upper triangle, single precision (products are accumulated in double), loaded with Set_K()
+	};
+
 private:
 			//
 			// DATA
@@ -66,8 +79,15 @@ private:
 
 	ChMatrixDynamic<double>* K;
 
+	std::vector<double> Kpacked;	// upper triangle, by rows, if KSTORAGE_SYMMETRIC
+	std::vector<float>  Kpacked_f;	// upper triangle, by rows, if KSTORAGE_SYMMETRIC_FLOAT
+	eChKstorage storage;
+	int Ksize;
+
 	std::vector<ChLcpVariables*> variables;
 
+	void AllocateK();
+
 public:
 
 			//
@@ -77,17 +97,23 @@ public:
 	ChLcpKblockGeneric()
 				{
 					K=0;
+					storage = KSTORAGE_FULL;
+					Ksize = 0;
 				}
 
 	ChLcpKblockGeneric(std::vector<ChLcpVariables*> mvariables)
 				{
 					K=0;
+					storage = KSTORAGE_FULL;
+					Ksize = 0;
 					this->SetVariables(mvariables);
 				}
 
 	ChLcpKblockGeneric(ChLcpVariables* mvariableA, ChLcpVariables* mvariableB)
 				{
 					K=0;
+					storage = KSTORAGE_FULL;
+					Ksize = 0;
 					std::vector<ChLcpVariables*> mvars;
 					mvars.push_back(mvariableA);
 					mvars.push_back(mvariableB);
@@ -120,13 +146,34 @@ public:
 
 
 
+				/// Set the storage of the K matrix. The symmetric storages assume
+				/// that K is symmetric, and only use its upper triangle.
+				/// The K matrix is reallocated, and its content is lost.
+	void SetStorage(eChKstorage mstorage);
+	eChKstorage GetStorage() const {return storage;}
+
+				/// Returns true if K is stored as a packed triangle: in this case
+				/// Get_K() returns NULL and K must be loaded with Set_K().
+	bool IsPacked() const {return storage != KSTORAGE_FULL;}
+
 				/// Access the K stiffness matrix as a single block,
-				/// referring only to the referenced ChVariable objects 
+				/// referring only to the referenced ChVariable objects.
+				/// Returns NULL if K is stored as a packed triangle, see SetStorage().
 	virtual ChMatrix<double>* Get_K()
 				{
 					return K;
 				}
 
+				/// Copy 'mK' into the K matrix, whatever the storage: with packed
+				/// storages only the upper triangle of 'mK' is used.
+	void Set_K(const ChMatrix<double>& mK);
+
+				/// Get the (row,col) element of the K matrix, whatever the storage.
+	double GetKelement(int row, int col) const;
+
+				/// Number of bytes used to store the K matrix.
+	size_t GetKmemory() const;
+
 				/// Computes the product of the corresponding blocks in the 
 				/// system matrix (ie. the K matrix blocks) by 'vect', and add to 'result'. 
 				/// NOTE: the 'vect' and 'result' vectors must already have
@@ -18,6 +18,7 @@
 #include "ChRandomParticlePosition.h"
 #include "ChRandomParticleAlignment.h"
 #include "ChRandomParticleVelocity.h"
+#include "ChParticlePool.h"
 #include "core/ChMathematics.h"
 #include "core/ChVector.h"
 #include "core/ChMatrix.h"
@@ -54,6 +55,7 @@ public:
 			particle_velocity    = ChSharedPtr<ChRandomParticleVelocity> (new ChRandomParticleVelocity);
 			particle_angular_velocity = ChSharedPtr<ChRandomParticleVelocity> (new ChRandomParticleVelocity);
 			creation_callback	 = 0;
+			recycle_callback	 = 0;
 			use_praticle_reservoir = false;
 			particle_reservoir = 1000;
 			created_particles	= 0;
@@ -62,6 +64,10 @@ public:
 			/// Function that creates random particles with random shape, position
 			/// and alignment each time it is called. 
 			/// Typically, one calls this function once per timestep.
+			/// If a particle pool is set, particles are taken from the pool
+			/// while available, and created only when the pool is empty.
+			/// All the particles of the timestep are added to the system
+			/// at once, with ChSystem::AddBodies().
 	void EmitParticles(ChSystem& msystem, double dt)
 		{
 			// get n.of particles to generate in this dt timestep, with floor roundoff
@@ -70,35 +76,68 @@ public:
 			if ((dt*particles_per_second - floor(dt*particles_per_second)) > ChRandom())
 				particles_per_step++;
 
+			if (use_praticle_reservoir)
+				particles_per_step = ChMin(particles_per_step, ChMax(this->particle_reservoir, 0));
+
+			new_particles.clear();
+			new_particles.reserve(particles_per_step);
+
 			// create the particles for this timestep
 			for (int i = 0; i < particles_per_step; ++i)
 			{
-				if ((use_praticle_reservoir)&&(this->particle_reservoir <= 0))
-					return;
-
 				ChCoordsys<> mcoords;
 				mcoords.pos = particle_positioner->RandomPosition();
 				mcoords.rot = particle_aligner->RandomAlignment();
 
-				ChSharedPtr<ChBody> mbody = particle_creator->RandomGenerateAndCallbacks(mcoords);
+				ChSharedPtr<ChBody> mbody;
+				if (!particle_pool.IsNull())
+					mbody = particle_pool->Take();
+
+				bool recycled = !mbody.IsNull();
+				if (!recycled)
+				{
+					mbody = particle_creator->RandomGenerateAndCallbacks(mcoords);
+				}
+				else
+				{
+					// recycled particle: reset its state
+					mbody->SetCoord(mcoords);
+					mbody->SetNoSpeedNoAcceleration();
+					mbody->Empty_forces_accumulators();
+					mbody->SetSleeping(false);
+				}
 				
 				mbody->SetPos_dt(particle_velocity->RandomVelocity());
 				mbody->SetWvel_par(particle_angular_velocity->RandomVelocity());
 
-				if (this->creation_callback)
+				if (!recycled && this->creation_callback)
 					this->creation_callback->PostCreation(mbody, mcoords, *particle_creator.get_ptr());
+				if (recycled && this->recycle_callback)
+					this->recycle_callback->PostCreation(mbody, mcoords, *particle_creator.get_ptr());
 
-				msystem.Add(mbody);
+				new_particles.push_back(mbody);
 
 				--this->particle_reservoir;
 				++this->created_particles;
 			}
+
+			msystem.AddBodies(new_particles);
+			new_particles.clear();
 		}
 
 			/// Pass an object from a ChPostCreationCallback-inherited class if you want to 
 			/// set additional stuff on each created particle (ex.set some random asset, set some random material, or such)
+			/// It is not called for the particles taken from the pool, that
+			/// already have their assets etc.: see SetCallbackPostRecycle().
 	void SetCallbackPostCreation(ChCallbackPostCreation* mcallback) {this->creation_callback = mcallback;}
 
+			/// Pass an object from a ChPostCreationCallback-inherited class if you want to
+			/// update the particles taken from the pool before they are emitted again
+			/// (ex. reset a counter or a color). Note that the particles put in the pool
+			/// by ChParticlePool::Prebuild() never went through the creation callback
+			/// of the emitter, so use this also to complete them, if needed.
+	void SetCallbackPostRecycle(ChCallbackPostCreation* mcallback) {this->recycle_callback = mcallback;}
+
 			/// Set the particle creator, that is an object whose class is
 			/// inherited from ChRandomShapeCreator
 	void SetParticleCreator   (ChSharedPtr<ChRandomShapeCreator> mc) {particle_creator = mc;}
@@ -118,6 +157,15 @@ public:
 			/// Access the flow rate, measured as n.of particles per second.
 	double& ParticlesPerSecond() {return particles_per_second;}
 
+			/// Set a pool of particles to be emitted before creating new ones,
+			/// for example a pool filled by a ChParticleProcessEventRecycle
+			/// or by ChParticlePool::Prebuild(). Note that shapes are not
+			/// generated again for recycled particles.
+	void SetParticlePool(ChSharedPtr<ChParticlePool> mpool) {particle_pool = mpool;}
+
+			/// Get the pool of particles, if any.
+	ChSharedPtr<ChParticlePool> GetParticlePool() {return particle_pool;}
+
 			/// Turn on this to limit the limit on max amount of particles.
 	void SetUseParticleReservoir(bool ml) {this->use_praticle_reservoir = ml;}
 
@@ -133,6 +181,9 @@ private:
 	ChSharedPtr<ChRandomParticleVelocity>  particle_velocity;
 	ChSharedPtr<ChRandomParticleVelocity>  particle_angular_velocity;
 	ChCallbackPostCreation* creation_callback;
+	ChCallbackPostCreation* recycle_callback;
+	ChSharedPtr<ChParticlePool> particle_pool;
+	std::vector< ChSharedPtr<ChBody> > new_particles;
 	
 	int  particle_reservoir;
 	bool use_praticle_reservoir;
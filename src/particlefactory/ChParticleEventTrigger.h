@@ -36,6 +36,13 @@ public:
 		/// be done, return false means that no ChParticleProcessEvent must be done.
 	virtual bool TriggerEvent(ChSharedPtr<ChBody> mbody, ChSystem& msystem) = 0;
 
+		/// Children classes might optionally implement this, if events can
+		/// be triggered only by particles whose center is inside an axis aligned
+		/// box: in this case return true and set the box, so that a ChParticleProcessor
+		/// with a ChParticleSpatialIndex calls TriggerEvent() only for the particles
+		/// in the box. Return false (default) if all particles must be tested.
+	virtual bool GetBoundingBox(ChVector<>& bmin, ChVector<>& bmax) {return false;}
+
 		/// Children classes might optionally implement this.
 		/// The ChParticleProcessor will call this once, before each ProcessParticles()
 	virtual void SetupPreProcess(ChSystem& msystem) {};
@@ -90,6 +97,29 @@ public:
 			return false;
 	}
 
+		/// The axis aligned box that contains the volume, if not
+		/// triggering outside.
+	virtual bool GetBoundingBox(ChVector<>& bmin, ChVector<>& bmax)
+	{
+		if (invert_volume)
+			return false;
+
+		// points p are inside if |Pos + Rot*p| < Size, component-wise
+		for (int i = 0; i < 3; ++i)
+		{
+			double center = 0;
+			double halfsize = 0;
+			for (int j = 0; j < 3; ++j)
+			{
+				center   -= mbox.Rot(j,i) * mbox.Pos(j);
+				halfsize += fabs(mbox.Rot(j,i)) * mbox.Size(j);
+			}
+			bmin(i) = center - halfsize;
+			bmax(i) = center + halfsize;
+		}
+		return true;
+	}
+
 	void SetTriggerOutside(bool minvert) { invert_volume = minvert;}
 
 	geometry::ChBox mbox;
@@ -135,9 +165,19 @@ public:
 			/// the the particle is crossing a rectangle. 
 	virtual bool TriggerEvent(ChSharedPtr<ChBody> mbody, ChSystem& msystem)
 	{
-		ChVector<> particle_pos = mbody->GetPos();
 		ChVector<> localpos = rectangle_csys.TrasformParentToLocal(mbody->GetPos());
 
+		// Is in upper part of rectangle? Store in hash table for next
+		// run, so that one will know if the particle crossed the rectangle into Z<0
+		if ((localpos.z>0) && (localpos.z < margin)
+			&& (fabs(localpos.x)< 0.5*Xsize+margin) 
+			&& (fabs(localpos.y)< 0.5*Ysize+margin))
+		{
+			_particle_last_pos mlastpos(mbody, localpos);
+			new_positions.insert((size_t)mbody.get_ptr(), mlastpos);
+			return false;
+		}
+
 		// Is in lower part of rectangle?
 		if ((localpos.z<=0) && (-localpos.z < margin)
 				&& (fabs(localpos.x)< 0.5*Xsize+margin) 
@@ -173,26 +213,37 @@ public:
 	}
 
 
+		/// The axis aligned box that contains the rectangle, enlarged by the margin.
+	virtual bool GetBoundingBox(ChVector<>& bmin, ChVector<>& bmax)
+	{
+		ChVector<> localsize(0.5*Xsize+margin, 0.5*Ysize+margin, margin);
+		ChMatrix33<> rot(rectangle_csys.rot);
+		for (int i = 0; i < 3; ++i)
+		{
+			double halfsize = 0;
+			for (int j = 0; j < 3; ++j)
+				halfsize += fabs(rot(i,j)) * localsize(j);
+			bmin(i) = rectangle_csys.pos(i) - halfsize;
+			bmax(i) = rectangle_csys.pos(i) + halfsize;
+		}
+		return true;
+	}
+
+		/// The particles that were found in the upper part by TriggerEvent()
+		/// are kept for the next run, if still in the system.
 	virtual void SetupPostProcess(ChSystem& msystem) 
 	{
 		last_positions.clear();
 
-		ChSystem::IteratorBodies myiter = msystem.IterBeginBodies();
-		while (myiter != msystem.IterEndBodies())
+		ChHashTable<size_t, _particle_last_pos >::iterator miter = new_positions.begin();
+		while (miter != new_positions.end())
 		{
-			ChVector<> localpos = rectangle_csys.TrasformParentToLocal((*myiter)->GetPos());
-			if ((localpos.z>0) && (localpos.z < margin)
-				&& (fabs(localpos.x)< 0.5*Xsize+margin) 
-				&& (fabs(localpos.y)< 0.5*Ysize+margin))
-			{
-				// ok, was in the upper part Z>0 of the triangle.. store in hash table for next
-				// run, so that one will know if the particle crossed the rectangle into Z<0
-				_particle_last_pos mlastpos((*myiter), localpos);
-				last_positions.insert((size_t)(*myiter).get_ptr(), mlastpos);
-			}
-
-			++myiter;
+			if ((*miter).second.mbody->GetSystem() == &msystem)
+				last_positions.insert((*miter).first, (*miter).second);
+			++miter;
 		}
+
+		new_positions.clear();
 	};
 
 	double Xsize;
@@ -204,6 +255,7 @@ public:
 
 protected:
 	ChHashTable<size_t, _particle_last_pos > last_positions;
+	ChHashTable<size_t, _particle_last_pos > new_positions;
 
 };
 
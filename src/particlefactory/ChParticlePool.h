@@ -0,0 +1,93 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHPARTICLEPOOL_H
+#define CHPARTICLEPOOL_H
+
+
+#include <vector>
+#include "ChRandomShapeCreator.h"
+#include "core/ChSmartpointers.h"
+#include "physics/ChBody.h"
+
+
+namespace chrono {
+namespace particlefactory {
+
+
+	/// Class for a pool of particles that are not in a ChSystem,
+	/// ready to be emitted by a ChParticleEmitter. Particles can be
+	/// created in advance, with Prebuild(), or they can be put back
+	/// in the pool after they are removed from the system (see
+	/// ChParticleProcessEventRecycle): in this way bodies, with their
+	/// collision models and assets, are recycled instead of being
+	/// deleted and created again, that is expensive when thousands
+	/// of particles per second are emitted.
+class ChParticlePool : public ChShared
+{
+public:
+	ChParticlePool()
+		{
+			max_particles = 100000;
+		}
+
+			/// Create 'amount' particles with the given shape creator
+			/// (also executing its callbacks) and put them in the pool.
+	void Prebuild(ChRandomShapeCreator& mcreator, int amount)
+		{
+			particles.reserve(particles.size() + amount);
+			for (int i = 0; i < amount; ++i)
+				Put(mcreator.RandomGenerateAndCallbacks(CSYSNORM));
+		}
+
+			/// Put a particle in the pool. It must not be in a ChSystem.
+			/// If the pool is full, the particle is not stored (so it will be
+			/// deleted, if not referenced elsewhere).
+	void Put(ChSharedPtr<ChBody> mbody)
+		{
+			assert(mbody->GetSystem()==0);
+			if (particles.size() < max_particles)
+				particles.push_back(mbody);
+		}
+
+			/// Take a particle from the pool. Its position, speed and forces
+			/// are the ones it had when put in the pool, so set them again.
+			/// Returns an empty shared pointer if the pool is empty.
+	ChSharedPtr<ChBody> Take()
+		{
+			if (particles.empty())
+				return ChSharedPtr<ChBody>();
+			ChSharedPtr<ChBody> mbody = particles.back();
+			particles.pop_back();
+			return mbody;
+		}
+
+			/// Number of particles in the pool.
+	size_t GetNparticles() const {return particles.size();}
+
+			/// Max number of particles that can be stored in the pool.
+	void SetMaxParticles(size_t mmax) {max_particles = mmax;}
+	size_t GetMaxParticles() const {return max_particles;}
+
+			/// Remove all particles from the pool.
+	void Clear() {particles.clear();}
+
+private:
+	std::vector< ChSharedPtr<ChBody> > particles;
+	size_t max_particles;
+};
+
+
+} // end of namespace particlefactory
+} // end of namespace chrono
+
+
+#endif
@@ -16,6 +16,7 @@
 
 #include "physics/ChSystem.h"
 #include "ChParticleEventTrigger.h"
+#include "ChParticlePool.h"
 
 
 namespace chrono {
@@ -62,16 +63,90 @@ public:
 	/// Note that this does not necessarily means also deletion of the particle,
 	/// because they are handled with shared pointers; however if they were 
 	/// referenced only by the ChSystem, this also leads to deletion.
+	/// Particles are removed all together after the processing, or, if
+	/// SetDeferred(true), only when ApplyRemovals() is called: in this way
+	/// a single ChParticleProcessEventRemove can be shared by many processors,
+	/// and all their removals are done once per step.
 class ChParticleProcessEventRemove : public ChParticleProcessEvent
 {
 public:
-		/// Remove the particle from the system. 
+	ChParticleProcessEventRemove()
+	{
+		deferred = false;
+	}
+
+		/// Mark the particle for removal.
 	virtual void ParticleProcessEvent(ChSharedPtr<ChBody> mbody, 
 									  ChSystem& msystem, 
 									  ChSharedPtr<ChParticleEventTrigger> mprocessor ) 
 	{
-		msystem.Remove(mbody);
+		to_remove.push_back(mbody);
+	}
+
+		/// Remove the marked particles, if not deferred.
+	virtual void SetupPostProcess(ChSystem& msystem) 
+	{
+		if (!deferred)
+			ApplyRemovals(msystem);
+	}
+
+		/// Remove all the marked particles from the system.
+	void ApplyRemovals(ChSystem& msystem)
+	{
+		if (!to_remove.empty())
+			msystem.RemoveBodies(to_remove);
+		to_remove.clear();
 	}
+
+		/// If true, the marked particles are removed only by ApplyRemovals().
+		/// Default false.
+	void SetDeferred(bool mdeferred) {deferred = mdeferred;}
+	bool GetDeferred() const {return deferred;}
+
+		/// Number of particles marked for removal.
+	size_t GetNmarked() const {return to_remove.size();}
+
+private:
+	std::vector< ChSharedPtr<ChBody> > to_remove;
+	bool deferred;
+};
+
+
+	/// Processed particle will be removed and put in a ChParticlePool,
+	/// so that a ChParticleEmitter that uses the same pool can emit
+	/// it again, instead of creating a new particle.
+	/// Particles are removed all together after the processing.
+class ChParticleProcessEventRecycle : public ChParticleProcessEvent
+{
+public:
+	ChParticleProcessEventRecycle(ChSharedPtr<ChParticlePool> mpool) : pool(mpool) {}
+
+		/// Mark the particle for removal.
+	virtual void ParticleProcessEvent(ChSharedPtr<ChBody> mbody, 
+									  ChSystem& msystem, 
+									  ChSharedPtr<ChParticleEventTrigger> mprocessor ) 
+	{
+		to_recycle.push_back(mbody);
+	}
+
+		/// Remove the marked particles and put them in the pool.
+	virtual void SetupPostProcess(ChSystem& msystem) 
+	{
+		msystem.RemoveBodies(to_recycle);
+		for (unsigned int i = 0; i < to_recycle.size(); ++i)
+		{
+			if (to_recycle[i]->GetSystem() == 0)
+				pool->Put(to_recycle[i]);
+		}
+		to_recycle.clear();
+	}
+
+		/// Access the pool where particles are put.
+	ChSharedPtr<ChParticlePool> GetPool() {return pool;}
+
+private:
+	ChSharedPtr<ChParticlePool> pool;
+	std::vector< ChSharedPtr<ChBody> > to_recycle;
 };
 
 
@@ -16,6 +16,7 @@
 #include "core/ChSmartpointers.h"
 #include "ChParticleEventTrigger.h"
 #include "ChParticleProcessEvent.h"
+#include "ChParticleSpatialIndex.h"
 
 namespace chrono {
 namespace particlefactory {
@@ -34,6 +35,10 @@ namespace particlefactory {
 	/// the default particle event processor is ChParticleProcessEventDoNothing, so
 	/// the default behavior is 'do nothing', so you must plug in more sophisticated ones
 	/// after you create the ChParticleProcessor and before you use it.
+	/// Note: if a ChParticleSpatialIndex is set, and the trigger has a bounding
+	/// box (see ChParticleEventTrigger::GetBoundingBox), only the particles in
+	/// the box are tested; this is much faster when there are many processors
+	/// (ex. removal boxes, flow counters) in a system with many particles.
 class ChParticleProcessor : public ChShared
 {
 public:
@@ -58,16 +63,39 @@ public:
 
 		int nprocessed = 0;
 
-		ChSystem::IteratorBodies myiter = msystem.IterBeginBodies();
-		while (myiter != msystem.IterEndBodies())
+		ChVector<> bmin, bmax;
+		if (!this->spatial_index.IsNull() && this->trigger->GetBoundingBox(bmin, bmax))
 		{
-			if (this->trigger->TriggerEvent((*myiter), msystem))
+			// test only the particles in the box of the trigger
+			this->spatial_index->UpdateIfNeeded(msystem);
+			this->spatial_index->Query(bmin, bmax, candidates);
+
+			for (unsigned int i = 0; i < candidates.size(); ++i)
 			{
-					this->particle_processor->ParticleProcessEvent((*myiter), msystem, this->trigger);
-					++nprocessed;
+				ChSharedPtr<ChBody> mbody = this->spatial_index->GetBody(candidates[i]);
+				if (mbody->GetSystem() != &msystem)
+					continue; // removed after the update of the index
+
+				if (this->trigger->TriggerEvent(mbody, msystem))
+				{
+						this->particle_processor->ParticleProcessEvent(mbody, msystem, this->trigger);
+						++nprocessed;
+				}
 			}
+		}
+		else
+		{
+			ChSystem::IteratorBodies myiter = msystem.IterBeginBodies();
+			while (myiter != msystem.IterEndBodies())
+			{
+				if (this->trigger->TriggerEvent((*myiter), msystem))
+				{
+						this->particle_processor->ParticleProcessEvent((*myiter), msystem, this->trigger);
+						++nprocessed;
+				}
 
-			++myiter;
+				++myiter;
+			}
 		}
 
 		this->particle_processor->SetupPostProcess(msystem);
@@ -82,9 +110,17 @@ public:
 		/// Use this function to plug in a particle event processor.
 	void SetParticleEventProcessor ( ChSharedPtr<ChParticleProcessEvent> mproc) { particle_processor = mproc;}
 
+		/// Use this function to plug in a spatial index of the particles,
+		/// that can be shared by many processors of the same system.
+		/// Default: none, all particles are tested.
+	void SetSpatialIndex ( ChSharedPtr<ChParticleSpatialIndex> mindex) { spatial_index = mindex;}
+	ChSharedPtr<ChParticleSpatialIndex> GetSpatialIndex() { return spatial_index;}
+
 protected:
 	ChSharedPtr<ChParticleEventTrigger> trigger;
 	ChSharedPtr<ChParticleProcessEvent> particle_processor;
+	ChSharedPtr<ChParticleSpatialIndex> spatial_index;
+	std::vector<int> candidates;
 };
 
 
@@ -0,0 +1,113 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHPARTICLESPATIALINDEX_H
+#define CHPARTICLESPATIALINDEX_H
+
+
+#include <vector>
+#include "core/ChSmartpointers.h"
+#include "physics/ChSystem.h"
+#include "collision/ChCNeighborSearch.h"
+
+
+namespace chrono {
+namespace particlefactory {
+
+
+	/// Class for a grid of the centers of the bodies of a ChSystem, that
+	/// can be shared by many ChParticleProcessor objects: in this way,
+	/// processors whose trigger has a bounding box (ex. removal boxes,
+	/// flow counters) test only the bodies that are in the box, instead
+	/// of all the bodies of the system.
+	/// The grid is built at most once per time step: with UpdateIfNeeded(),
+	/// called by the processors, it is rebuilt only if the time or the
+	/// number of bodies changed since the last build. Bodies that are
+	/// removed after the build are skipped by the processors; bodies that
+	/// are added at the same time of the build are not seen until the next
+	/// one, unless Update() is called again.
+class ChParticleSpatialIndex : public ChShared
+{
+public:
+	ChParticleSpatialIndex()
+		{
+			cell_size = 0;
+			last_time = 0;
+			last_nbodies = -1;
+		}
+
+			/// Set the size of the cubic cells of the grid. If 0 (default)
+			/// the size is automatic, with about one body per cell.
+	void SetCellSize(double msize) {cell_size = msize;}
+	double GetCellSize() const {return cell_size;}
+
+			/// Put the centers of all bodies of the system in the grid.
+	void Update(ChSystem& msystem)
+		{
+			bodies.clear();
+			positions.clear();
+			bodies.reserve(msystem.Get_bodylist()->size());
+			positions.reserve(msystem.Get_bodylist()->size());
+
+			ChSystem::IteratorBodies myiter = msystem.IterBeginBodies();
+			while (myiter != msystem.IterEndBodies())
+			{
+				bodies.push_back(*myiter);
+				positions.push_back(bodies.back()->GetPos());
+				++myiter;
+			}
+
+			grid.UpdateGrid(positions, cell_size);
+
+			last_time = msystem.GetChTime();
+			last_nbodies = (int)bodies.size();
+		}
+
+			/// Same as Update(), but only if the time or the number of bodies
+			/// of the system changed since the last update.
+	void UpdateIfNeeded(ChSystem& msystem)
+		{
+			if (msystem.GetChTime() != last_time ||
+				(int)msystem.Get_bodylist()->size() != last_nbodies)
+				Update(msystem);
+		}
+
+			/// Find the bodies whose center was in the axis aligned box
+			/// 'bmin'-'bmax' at the last update. Their indexes, to be
+			/// used with GetBody(), are put in 'result'.
+	void Query(const ChVector<>& bmin, const ChVector<>& bmax, std::vector<int>& result) const
+		{
+			result.clear();
+			grid.QueryBox(positions, bmin, bmax, result);
+		}
+
+			/// Get the i-th body of the last update. It might have been
+			/// removed from the system after the update.
+	const ChSharedPtr<ChBody>& GetBody(int i) const {return bodies[i];}
+
+			/// Number of bodies in the grid.
+	int GetNbodies() const {return (int)bodies.size();}
+
+private:
+	std::vector< ChSharedPtr<ChBody> > bodies;
+	std::vector< ChVector<> > positions;
+	collision::ChNeighborSearch grid;
+	double cell_size;
+	double last_time;
+	int last_nbodies;
+};
+
+
+} // end of namespace particlefactory
+} // end of namespace chrono
+
+
+#endif
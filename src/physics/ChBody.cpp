@@ -283,6 +283,16 @@ void ChBody::VariablesQbIncrementPosition(double dt_step)
     this->SetRot( mnewrot );
 }
 
+void ChBody::WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain)
+{
+    if (!this->IsActive()) 
+        return;
+
+    ChVector<> mpos = this->GetPos();
+    if (mdomain.Wrap(mpos))
+        this->SetPos(mpos);
+}
+
 
 
 void ChBody::SetNoSpeedNoAcceleration()
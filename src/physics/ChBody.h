@@ -278,6 +278,9 @@ public:
                 /// Does not automatically update markers & forces.
     void VariablesQbIncrementPosition(double step);
 
+                /// Move the body back into the periodic domain, if it left it.
+    void WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain);
+
 
                 /// Tell to a system descriptor that there are variables of type
                 /// ChLcpVariables in this object (for further passing it to a LCP solver)
@@ -24,9 +24,11 @@
 #include "physics/ChSystem.h"
 #include "physics/ChBody.h"
 #include "physics/ChParticlesClones.h"
+#include "physics/ChParticlesClonesSoA.h"
 #include "lcp/ChLcpConstraintTwoContactN.h"
 #include "collision/ChCModelBulletBody.h"
 #include "collision/ChCModelBulletParticle.h"
+#include "collision/ChCModelBulletParticleSoA.h"
 
 #include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
 
@@ -132,6 +134,8 @@ void ChContactContainer::BeginAddContact()
 
 	lastcontact_roll = contactlist_roll.begin();
 	n_added_roll = 0;
+
+	material_table.Update();
 }
 
 void ChContactContainer::EndAddContact()
@@ -162,6 +166,8 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
 	ChLcpVariablesBody* varB = 0;
 	ChSharedPtr<ChMaterialSurface> mmatA;
 	ChSharedPtr<ChMaterialSurface> mmatB;
+	ChFrame<> soaframeA;	// particles of ChParticlesClonesSoA have no frame object
+	ChFrame<> soaframeB;
 
 	if (ChModelBulletBody* mmboA = dynamic_cast<ChModelBulletBody*>(mcontact.modelA))
 	{
@@ -179,6 +185,15 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
 			mmatA = mpclone->GetMaterialSurface();
 		}
 	}
+	if (ChModelBulletParticleSoA* mmsoaA = dynamic_cast<ChModelBulletParticleSoA*>(mcontact.modelA))
+	{
+		ChParticlesClonesSoA* mpsoa = mmsoaA->GetParticles();
+		unsigned int id = mmsoaA->GetParticleId();
+		soaframeA.SetCoord(mpsoa->GetParticlePos(id), mpsoa->GetParticleRot(id));
+		frameA = &soaframeA;
+		varA   = &mpsoa->GetParticleVariables(id);
+		mmatA  = mpsoa->GetMaterialSurface();
+	}
 
 	if (ChModelBulletBody* mmboB = dynamic_cast<ChModelBulletBody*>(mcontact.modelB))
 	{
@@ -196,6 +211,15 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
 			mmatB = mpclone->GetMaterialSurface();
 		}
 	}
+	if (ChModelBulletParticleSoA* mmsoaB = dynamic_cast<ChModelBulletParticleSoA*>(mcontact.modelB))
+	{
+		ChParticlesClonesSoA* mpsoa = mmsoaB->GetParticles();
+		unsigned int id = mmsoaB->GetParticleId();
+		soaframeB.SetCoord(mpsoa->GetParticlePos(id), mpsoa->GetParticleRot(id));
+		frameB = &soaframeB;
+		varB   = &mpsoa->GetParticleVariables(id);
+		mmatB  = mpsoa->GetMaterialSurface();
+	}
 
 	if (!(frameA && frameB))
 		return;
@@ -206,20 +230,10 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
 	if ((inactiveA && inactiveB))
 		return;
 
-	// Compute default material-couple values.
-
-	ChMaterialCouple mat;
+	// Get default material-couple values, precomputed in the material table.
 
-	mat.static_friction		= (float)ChMin( mmatA->static_friction,		mmatB->static_friction);
-	mat.rolling_friction	= (float)ChMin( mmatA->rolling_friction,	mmatB->rolling_friction);
-	mat.spinning_friction	= (float)ChMin( mmatA->spinning_friction,	mmatB->spinning_friction);
-	mat.restitution			= (float)ChMin( mmatA->restitution,			mmatB->restitution);
-	mat.cohesion			= (float)ChMin( mmatA->cohesion,			mmatB->cohesion);
-	mat.dampingf			= (float)ChMin( mmatA->dampingf,			mmatB->dampingf);
-	mat.compliance			= (float)(mmatA->compliance+mmatB->compliance);
-	mat.complianceT			= (float)(mmatA->complianceT+mmatB->complianceT);
-	mat.complianceRoll		= (float)(mmatA->complianceRoll+mmatB->complianceRoll);
-	mat.complianceSpin      = (float)(mmatA->complianceSpin+mmatB->complianceSpin);
+	ChMaterialCouple mstorage;
+	ChMaterialCouple mat = material_table.GetComposite(mmatA, mmatB, mstorage);
 
 	// Launch the contact callback, if any, to set custom friction & material 
 	// properties, if implemented by the user:
@@ -34,6 +34,8 @@
 #include "physics/ChContactContainerBase.h"
 #include "physics/ChContact.h"
 #include "physics/ChContactRolling.h"
+#include "physics/ChMaterialSurface.h"
+#include "physics/ChMaterialPairTable.h"
 #include <list>
 
 namespace chrono
@@ -71,6 +73,8 @@ protected:
 
 	std::list<ChContactRolling*>::iterator lastcontact_roll;
 
+	ChMaterialPairTable<ChMaterialSurface, ChMaterialCouple> material_table;
+
 public:
 				//
 	  			// CONSTRUCTORS
@@ -115,6 +119,9 @@ public:
 					/// report all contacts).
 	virtual void ReportAllContacts(ChReportContactCallback* mcallback);
 
+					/// Access the table of the materials of the contacting objects,
+					/// with the precomputed composite properties of their pairs.
+	ChMaterialPairTable<ChMaterialSurface, ChMaterialCouple>& GetMaterialTable() {return material_table;}
 
 
 
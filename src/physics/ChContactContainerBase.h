@@ -145,6 +145,11 @@ public:
 					/// it does nothing.
 	virtual void EndAddContact() {};
 
+					/// Return false if this container cannot use speculative contacts
+					/// (contacts with positive distance, see ChCollisionSystemBullet::SetSpeculativeContacts()),
+					/// so the collision system does not compute them.
+	virtual bool AcceptsSpeculativeContacts() {return true;}
+
 
 
 
@@ -104,6 +104,8 @@ void ChContactContainerDEM::BeginAddContact()
 {
 	lastcontact = contactlist.begin();
 	n_added = 0;
+
+	material_table.Update();
 }
 
 
@@ -119,7 +121,8 @@ void ChContactContainerDEM::EndAddContact()
 
 void ChContactContainerDEM::AddContact(const collision::ChCollisionInfo& mcontact)
 {
-	// Do nothing if the shapes are separated
+	// Do nothing if the shapes are separated (penalty contacts have no
+	// force there: this also discards the contacts within the envelopes)
 	if (mcontact.distance >= 0)
 		return;
 
@@ -136,14 +139,21 @@ void ChContactContainerDEM::AddContact(const collision::ChCollisionInfo& mcontac
 	if (!mmboA->GetBody()->IsActive() && !mmboB->GetBody()->IsActive())
 		return;
 
+	// Composite material properties, precomputed in the material table
+	ChCompositeMaterialDEM mstorage;
+	const ChCompositeMaterialDEM& mat = material_table.GetComposite(
+			((ChBodyDEM*)mmboA->GetBody())->GetMaterialSurfaceDEM(),
+			((ChBodyDEM*)mmboB->GetBody())->GetMaterialSurfaceDEM(),
+			mstorage);
+
 	// Reuse an existing contact or create a new one
 	if (lastcontact != contactlist.end()) {
 		// reuse old contacts
-		(*lastcontact)->Reset(mmboA, mmboB, mcontact);
+		(*lastcontact)->Reset(mmboA, mmboB, mcontact, mat);
 		lastcontact++;
 	} else {
 		// add new contact
-		ChContactDEM* mc = new ChContactDEM(mmboA, mmboB, mcontact);
+		ChContactDEM* mc = new ChContactDEM(mmboA, mmboB, mcontact, mat);
 		contactlist.push_back(mc);
 		lastcontact = contactlist.end();
 	}
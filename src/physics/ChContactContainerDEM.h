@@ -31,6 +31,8 @@
 
 #include "physics/ChContactContainerBase.h"
 #include "physics/ChContactDEM.h"
+#include "physics/ChMaterialSurfaceDEM.h"
+#include "physics/ChMaterialPairTable.h"
 #include <list>
 
 namespace chrono
@@ -58,6 +60,8 @@ protected:
 
 	std::list<ChContactDEM*>::iterator lastcontact;
 
+	ChMaterialPairTable<ChMaterialSurfaceDEM, ChCompositeMaterialDEM> material_table;
+
 
 public:
 				//
@@ -100,6 +104,10 @@ public:
 					/// purges the end of the list of contacts that were not reused (if any).
 	virtual void EndAddContact();
 
+					/// Penalty contacts have a force only where the shapes overlap, so
+					/// speculative contacts are not used: the collision system skips them.
+	virtual bool AcceptsSpeculativeContacts() {return false;}
+
 					/// Scans all the contacts and for each contact exacutes the ReportContactCallback()
 					/// function of the user object inherited from ChReportContactCallback.
 					/// Child classes of ChContactContainerBase should try to implement this (although
@@ -107,6 +115,10 @@ public:
 					/// report all contacts).
 	virtual void ReportAllContacts(ChReportContactCallback* mcallback);
 
+					/// Access the table of the materials of the contacting bodies,
+					/// with the precomputed composite properties of their pairs.
+	ChMaterialPairTable<ChMaterialSurfaceDEM, ChCompositeMaterialDEM>& GetMaterialTable() {return material_table;}
+
 
 
 					/// In detail, it computes jacobians, violations, etc. and stores 
@@ -47,9 +47,10 @@ double ChContactDEM::m_minSlipVelocity = 1e-4;
 // Construct a new DEM contact between two models using the specified contact pair information.
 ChContactDEM::ChContactDEM(collision::ChModelBulletBody*     mod1,
                            collision::ChModelBulletBody*     mod2,
-                           const collision::ChCollisionInfo& cinfo)
+                           const collision::ChCollisionInfo& cinfo,
+                           const ChCompositeMaterialDEM&     mat)
 {
-	Reset(mod1, mod2, cinfo);
+	Reset(mod1, mod2, cinfo, mat);
 }
 
 
@@ -57,7 +58,8 @@ ChContactDEM::ChContactDEM(collision::ChModelBulletBody*     mod1,
 void
 ChContactDEM::Reset(collision::ChModelBulletBody*     mod1,
                     collision::ChModelBulletBody*     mod2,
-                    const collision::ChCollisionInfo& cinfo)
+                    const collision::ChCollisionInfo& cinfo,
+                    const ChCompositeMaterialDEM&     mat)
 {
 	assert(cinfo.distance < 0);
 
@@ -83,14 +85,14 @@ ChContactDEM::Reset(collision::ChModelBulletBody*     mod1,
 	m_p2_loc = body2->Point_World2Body(m_p2);
 
 	// Calculate contact force
-	CalculateForce();
+	CalculateForce(mat);
 }
 
 
 // Calculate the contact force to be applied to body2, based on the
 // globally specified contact force models (normal and tangential).
 void
-ChContactDEM::CalculateForce()
+ChContactDEM::CalculateForce(const ChCompositeMaterialDEM& mat)
 {
 	ChBodyDEM* body1 = (ChBodyDEM*) m_mod1->GetBody();
 	ChBodyDEM* body2 = (ChBodyDEM*) m_mod2->GetBody();
@@ -113,9 +115,6 @@ ChContactDEM::CalculateForce()
 	//// TODO:  how can I get this with current collision system!?!?!?
 	double R_eff = 1;
 
-	// Calculate composite material properties
-	ChCompositeMaterialDEM mat = ChMaterialSurfaceDEM::CompositeMaterial(body1->GetMaterialSurfaceDEM(), body2->GetMaterialSurfaceDEM());
-
 	// Normal force
 	double forceN;
 
@@ -35,6 +35,8 @@
 namespace chrono
 {
 
+struct ChCompositeMaterialDEM;
+
 ///
 /// Class representing a contact between DEM bodies
 ///
@@ -56,17 +58,21 @@ public:
 	ChContactDEM() {}
 	ChContactDEM(collision::ChModelBulletBody*     mod1,
 	             collision::ChModelBulletBody*     mod2,
-	             const collision::ChCollisionInfo& cinfo);
+	             const collision::ChCollisionInfo& cinfo,
+	             const ChCompositeMaterialDEM&     mat);
 
 	~ChContactDEM() {}
 
 	/// This is the worked function for calculating and recording a new
 	/// contact. It calculates and stores kinematic information and the
 	/// resulting contact force and is used to construct a new contact
-	//// or to reset an existing one for reuse.
+	//// or to reset an existing one for reuse. The composite material
+	/// properties of the two bodies are usually taken from the material
+	/// table of the contact container.
 	void Reset(collision::ChModelBulletBody*     mod1,
 	           collision::ChModelBulletBody*     mod2,
-	           const collision::ChCollisionInfo& cinfo);
+	           const collision::ChCollisionInfo& cinfo,
+	           const ChCompositeMaterialDEM&     mat);
 
 	/// Get the contact coordinate system, expressed in absolute frame.
 	/// This is the coordinate system of the contact plane and normal.
@@ -105,8 +111,9 @@ public:
 	/// Get the collision model 2, with point P2.
 	collision::ChCollisionModel* GetModel2() {return (collision::ChCollisionModel*) m_mod2;}
 
-	/// Calculate contact force, expressed in absolute coordinates.
-	void CalculateForce();
+	/// Calculate contact force, expressed in absolute coordinates,
+	/// given the composite material properties of the two bodies.
+	void CalculateForce(const ChCompositeMaterialDEM& mat);
 
 	/// Apply contact forces to bodies.
 	void ConstraintsFbLoadForces(double factor);
@@ -0,0 +1,413 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChDeformableTerrain.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <algorithm>
+
+#include "physics/ChDeformableTerrain.h"
+#include "physics/ChSystem.h"
+#include "collision/ChCModelBullet.h"
+#include "collision/bullet/btBulletCollisionCommon.h"
+
+#include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
+
+
+namespace chrono
+{
+
+
+using namespace collision;
+
+
+
+// Register into the object factory, to enable run-time
+// dynamic creation and persistence
+ChClassRegister<ChDeformableTerrain> a_registration_ChDeformableTerrain;
+
+
+// Floor division, also for negative indexes
+static inline int floor_div(int a, int b)
+{
+	return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+}
+
+
+ChDeformableTerrain::ChDeformableTerrain()
+{
+	height = 0;
+	cell_size = 0.05;
+	height_callback = 0;
+
+	Kphi = 2e6;
+	Kc = 0;
+	n = 1.1;
+	cohesion = 0;
+	friction_angle = 30;
+	janosi_K = 0.01;
+	elastic_K = 2e8;
+	damping = 3e4;
+
+	last_time = 0;
+	nupdates = 0;
+	ncontact_cells = 0;
+}
+
+
+ChDeformableTerrain::~ChDeformableTerrain()
+{
+	ClearTiles();
+}
+
+
+void ChDeformableTerrain::Initialize(double mheight, double mcell_size)
+{
+	height = mheight;
+	cell_size = mcell_size;
+	ClearTiles();
+}
+
+
+void ChDeformableTerrain::SetHeightCallback(ChHeightCallback* mcallback)
+{
+	height_callback = mcallback;
+	ClearTiles();
+}
+
+
+void ChDeformableTerrain::SetSoilParameters(double mKphi, double mKc, double mn,
+						   double mcohesion, double mfriction_angle, double mjanosi_K,
+						   double melastic_K, double mdamping)
+{
+	Kphi = mKphi;
+	Kc = mKc;
+	n = mn;
+	cohesion = mcohesion;
+	friction_angle = mfriction_angle;
+	janosi_K = mjanosi_K;
+	elastic_K = melastic_K;
+	damping = mdamping;
+}
+
+
+void ChDeformableTerrain::AddBody(ChSharedPtr<ChBody> mbody)
+{
+	for (unsigned int i = 0; i < bodies.size(); ++i)
+		if (bodies[i].get_ptr() == mbody.get_ptr())
+			return;
+	bodies.push_back(mbody);
+	body_force.push_back(VNULL);
+	body_torque.push_back(VNULL);
+}
+
+
+void ChDeformableTerrain::RemoveBody(ChSharedPtr<ChBody> mbody)
+{
+	for (unsigned int i = 0; i < bodies.size(); ++i)
+	{
+		if (bodies[i].get_ptr() == mbody.get_ptr())
+		{
+			bodies.erase(bodies.begin() + i);
+			body_force.erase(body_force.begin() + i);
+			body_torque.erase(body_torque.begin() + i);
+			return;
+		}
+	}
+}
+
+
+void ChDeformableTerrain::ClearTiles()
+{
+	for (TileMap::iterator it = tiles.begin(); it != tiles.end(); ++it)
+		delete it->second;
+	tiles.clear();
+}
+
+
+ChDeformableTerrain::ChTerrainTile* ChDeformableTerrain::FindTile(int i, int k, int& mcell) const
+{
+	int ti = floor_div(i, TILE_SIZE);
+	int tk = floor_div(k, TILE_SIZE);
+	TileMap::const_iterator found = tiles.find(std::make_pair(ti, tk));
+	if (found == tiles.end())
+		return 0;
+	mcell = (i - ti * TILE_SIZE) * TILE_SIZE + (k - tk * TILE_SIZE);
+	return found->second;
+}
+
+
+ChDeformableTerrain::ChTerrainTile* ChDeformableTerrain::GetTile(int i, int k, int& mcell)
+{
+	ChTerrainTile* tile = FindTile(i, k, mcell);
+	if (tile)
+		return tile;
+
+	int ti = floor_div(i, TILE_SIZE);
+	int tk = floor_div(k, TILE_SIZE);
+	tile = new ChTerrainTile;
+	tile->level.resize(TILE_SIZE * TILE_SIZE);
+	tile->sinkage.assign(TILE_SIZE * TILE_SIZE, 0.);
+	tile->shear.assign(TILE_SIZE * TILE_SIZE, 0.);
+	tile->contact.assign(TILE_SIZE * TILE_SIZE, -1);
+	for (int li = 0; li < TILE_SIZE; ++li)
+		for (int lk = 0; lk < TILE_SIZE; ++lk)
+			tile->level[li * TILE_SIZE + lk] = GetUndeformedHeight(ti * TILE_SIZE + li, tk * TILE_SIZE + lk);
+	tiles[std::make_pair(ti, tk)] = tile;
+
+	mcell = (i - ti * TILE_SIZE) * TILE_SIZE + (k - tk * TILE_SIZE);
+	return tile;
+}
+
+
+double ChDeformableTerrain::GetUndeformedHeight(int i, int k) const
+{
+	if (!height_callback)
+		return height;
+	return height_callback->GetHeight((i + 0.5) * cell_size, (k + 0.5) * cell_size);
+}
+
+
+double ChDeformableTerrain::GetHeight(double x, double z) const
+{
+	int i = (int)floor(x / cell_size);
+	int k = (int)floor(z / cell_size);
+	int mcell;
+	ChTerrainTile* tile = FindTile(i, k, mcell);
+	if (!tile)
+		return GetUndeformedHeight(i, k);
+	return tile->level[mcell] - tile->sinkage[mcell];
+}
+
+
+double ChDeformableTerrain::GetSinkage(double x, double z) const
+{
+	int i = (int)floor(x / cell_size);
+	int k = (int)floor(z / cell_size);
+	int mcell;
+	ChTerrainTile* tile = FindTile(i, k, mcell);
+	if (!tile)
+		return 0;
+	return tile->sinkage[mcell];
+}
+
+
+
+//////// UPDATING
+
+
+void ChDeformableTerrain::Update(double mytime)
+{
+	double dt = mytime - last_time;
+	if (dt < 0)
+		dt = 0;
+	last_time = mytime;
+
+	ChPhysicsItem::Update(mytime);
+
+	body_force.resize(bodies.size());
+	body_torque.resize(bodies.size());
+	ncontact_cells = 0;
+	++nupdates;
+
+	for (unsigned int i = 0; i < bodies.size(); ++i)
+	{
+		body_force[i] = VNULL;
+		body_torque[i] = VNULL;
+		if (bodies[i]->GetSystem() != GetSystem())
+			continue;
+		ProcessBody(i, dt);
+	}
+}
+
+
+void ChDeformableTerrain::ProcessBody(int ibody, double dt)
+{
+	ChBody* body = bodies[ibody].get_ptr();
+
+	ChModelBullet* model = dynamic_cast<ChModelBullet*>(body->GetCollisionModel());
+	if (!model)
+		return;
+	btCollisionObject* btobject = model->GetBulletModel();
+	btCollisionShape* btshape = btobject->getCollisionShape();
+	if (!btshape)
+		return;
+
+	// The collision shapes are enlarged by the envelope
+	model->SyncPosition();
+	double envelope = model->GetEnvelope();
+	ChVector<> aabb_min, aabb_max;
+	model->GetAABB(aabb_min, aabb_max);
+
+	// Cells under the body (footprint)
+	int imin = (int)floor(aabb_min.x / cell_size);
+	int imax = (int)floor(aabb_max.x / cell_size);
+	int kmin = (int)floor(aabb_min.z / cell_size);
+	int kmax = (int)floor(aabb_max.z / cell_size);
+	int ni = imax - imin + 1;
+	int nk = kmax - kmin + 1;
+	int ncells = ni * nk;
+
+	std::vector<double> hit_y(ncells);
+	std::vector<ChVector<> > hit_normal(ncells);
+	std::vector<char> hit(ncells, 0);
+
+	// Vertical rays from below the body, up to the soil surface: the tiles are
+	// only read here, so the cells can be processed in parallel.
+	#pragma omp parallel for schedule(static)
+	for (int ic = 0; ic < ncells; ++ic)
+	{
+		int i = imin + ic / nk;
+		int k = kmin + ic % nk;
+		int mcell;
+		ChTerrainTile* tile = FindTile(i, k, mcell);
+		double surface = tile ? (tile->level[mcell] - tile->sinkage[mcell]) : GetUndeformedHeight(i, k);
+		if (aabb_min.y >= surface)
+			continue;
+
+		double x = (i + 0.5) * cell_size;
+		double z = (k + 0.5) * cell_size;
+		btVector3 from(x, aabb_min.y - cell_size, z);
+		btVector3 to(x, ChMin(aabb_max.y, surface + envelope), z);
+		btTransform from_tr; from_tr.setIdentity(); from_tr.setOrigin(from);
+		btTransform to_tr;   to_tr.setIdentity();   to_tr.setOrigin(to);
+
+		btCollisionWorld::ClosestRayResultCallback result(from, to);
+		btCollisionWorld::rayTestSingle(from_tr, to_tr, btobject, btshape, btobject->getWorldTransform(), result);
+		if (!result.hasHit())
+			continue;
+
+		ChVector<> normal(result.m_hitNormalWorld.x(), result.m_hitNormalWorld.y(), result.m_hitNormalWorld.z());
+		double y = result.m_hitPointWorld.y() - normal.y * envelope;
+		if (y >= surface)
+			continue;
+		hit_y[ic] = y;
+		hit_normal[ic] = normal;
+		hit[ic] = 1;
+	}
+
+	// Width of the contact patch, for the Bekker model: the smallest
+	// side of the box of the cells in contact
+	int ci_min = ni, ci_max = -1, ck_min = nk, ck_max = -1;
+	for (int ic = 0; ic < ncells; ++ic)
+	{
+		if (!hit[ic])
+			continue;
+		ci_min = ChMin(ci_min, ic / nk); ci_max = ChMax(ci_max, ic / nk);
+		ck_min = ChMin(ck_min, ic % nk); ck_max = ChMax(ck_max, ic % nk);
+	}
+
+	if (ci_max < 0)
+		return;
+
+	// Tiles are allocated serially
+	std::vector<ChTerrainTile*> cell_tile(ncells, (ChTerrainTile*)0);
+	std::vector<int> cell_index(ncells, 0);
+	for (int ic = 0; ic < ncells; ++ic)
+		if (hit[ic])
+			cell_tile[ic] = GetTile(imin + ic / nk, kmin + ic % nk, cell_index[ic]);
+
+	double b = ChMax(cell_size, cell_size * ChMin(ci_max - ci_min + 1, ck_max - ck_min + 1));
+	double area = cell_size * cell_size;
+	double tan_phi = tan(friction_angle * CH_C_DEG_TO_RAD);
+	double k_bekker = Kc / b + Kphi;
+
+	std::vector<ChVector<> > cell_force(ncells);
+
+	#pragma omp parallel for schedule(static)
+	for (int ic = 0; ic < ncells; ++ic)
+	{
+		if (!hit[ic])
+			continue;
+		ChTerrainTile* tile = cell_tile[ic];
+		int mcell = cell_index[ic];
+
+		double s = tile->level[mcell] - hit_y[ic];	// total sinkage
+		double& sp = tile->sinkage[mcell];				// permanent sinkage
+		ChVector<> N = -hit_normal[ic];					// from the soil into the body
+
+		ChVector<> P((imin + ic / nk + 0.5) * cell_size, hit_y[ic], (kmin + ic % nk + 0.5) * cell_size);
+		ChVector<> vel = body->PointSpeedLocalToParent(body->Point_World2Body(P));
+		double vn = Vdot(vel, N);
+		ChVector<> vt = vel - N * vn;
+
+		// Elastic unloading/reloading, limited by the Bekker pressure:
+		// beyond it the soil flows and the rut becomes deeper
+		double p_yield = k_bekker * pow(s, n);
+		double p_elastic = elastic_K * (s - sp);
+		if (p_elastic > p_yield)
+		{
+			sp = s - p_yield / elastic_K;
+			p_elastic = p_yield;
+		}
+		double p = ChMax(0., p_elastic - damping * vn);
+
+		// Janosi-Hanamoto shear, with the shear displacement accumulated
+		// while the cell stays in contact (with any body: the footprints
+		// of many bodies can overlap)
+		if (tile->contact[mcell] < nupdates - 1)
+			tile->shear[mcell] = 0;
+		double vt_norm = vt.Length();
+		tile->shear[mcell] += vt_norm * dt;
+		tile->contact[mcell] = nupdates;
+		double tau = (cohesion + p * tan_phi) * (1. - exp(-tile->shear[mcell] / janosi_K));
+
+		// (below 1 cm/s of slip the direction of the shear is not
+		// defined, and the stress is proportional to the velocity)
+		ChVector<> F = N * (p * area);
+		F -= vt * (tau * area / ChMax(vt_norm, 0.01));
+		cell_force[ic] = F;
+	}
+
+	ChVector<> cog = body->GetPos();
+	ChVector<> force = VNULL;
+	ChVector<> torque = VNULL;
+	int ncontacts = 0;
+	for (int ic = 0; ic < ncells; ++ic)
+	{
+		if (!hit[ic])
+			continue;
+		ChVector<> P((imin + ic / nk + 0.5) * cell_size, hit_y[ic], (kmin + ic % nk + 0.5) * cell_size);
+		force += cell_force[ic];
+		torque += Vcross(P - cog, cell_force[ic]);
+		++ncontacts;
+	}
+	body_force[ibody] = force;
+	body_torque[ibody] = torque;
+	ncontact_cells += ncontacts;
+}
+
+
+void ChDeformableTerrain::ConstraintsFbLoadForces(double factor)
+{
+	for (unsigned int i = 0; i < bodies.size(); ++i)
+	{
+		ChBody* body = bodies[i].get_ptr();
+		if (body->GetSystem() != GetSystem() || !body->Variables().IsActive())
+			continue;
+		body->Variables().Get_fb().PasteSumVector(body_force[i] * factor, 0, 0);
+		body->Variables().Get_fb().PasteSumVector(body->Dir_World2Body(body_torque[i]) * factor, 3, 0);
+	}
+}
+
+
+
+} // END_OF_NAMESPACE____
+
+
@@ -0,0 +1,206 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHDEFORMABLETERRAIN_H
+#define CHDEFORMABLETERRAIN_H
+
+//////////////////////////////////////////////////
+//
+//   ChDeformableTerrain.h
+//
+//   Deformable soil represented by a height grid,
+//   with Bekker-Wong pressure-sinkage and Janosi-
+//   Hanamoto shear (terramechanics).
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include <map>
+#include "physics/ChPhysicsItem.h"
+#include "physics/ChBody.h"
+
+
+namespace chrono
+{
+
+
+///
+/// Class for a deformable soil, much cheaper than a bed of DEM particles,
+/// for vehicles on off-road terrain. The soil is a height grid of square
+/// cells on the horizontal plane (the Y axis is the vertical): under each
+/// body that was added with AddBody() (wheels, track shoes, feet) a vertical
+/// ray per cell finds the bottom of its collision shape, and where it is
+/// below the soil surface the cell pushes with the pressure of the
+/// Bekker-Wong model, p = (Kc/b + Kphi) z^n, where z is the sinkage and b
+/// is the width of the contact patch; the soil is compacted where the
+/// pressure exceeds it (ruts), and is elastic below it. Slipping bodies
+/// feel the shear stress of the Mohr-Coulomb and Janosi-Hanamoto models,
+/// tau = (c + p tan(phi)) (1 - exp(-j/K)), where j is the accumulated
+/// shear displacement, that gives traction and rolling resistance.
+/// Cells are stored in square tiles, allocated only where bodies touched
+/// the soil, so the terrain has no bounds and the memory is proportional
+/// to the deformed area; only the cells under the bodies are processed,
+/// in parallel. Bodies must have a collision model (that may not be in
+/// the collision system, if they do not need other contacts), and should
+/// not collide also with a rigid ground at the same place.
+///
+
+class ChApi ChDeformableTerrain : public ChPhysicsItem
+{
+	CH_RTTI(ChDeformableTerrain,ChPhysicsItem);
+
+public:
+
+			/// Class to be used as a callback interface for an initial
+			/// uneven soil: implement GetHeight() in a child class, for example
+			/// to read a heightmap image or a DEM file.
+	class ChApi ChHeightCallback
+	{
+	public:
+		virtual ~ChHeightCallback() {}
+				/// Height of the undeformed soil at the horizontal position x,z.
+				/// It can be called by many threads at once (the cells under a
+				/// body are processed in a OpenMP loop), so it must be thread-safe,
+				/// ex. only read the heightmap.
+		virtual double GetHeight(double x, double z) = 0;
+	};
+
+				//
+	  			// CONSTRUCTORS
+				//
+
+	ChDeformableTerrain();
+	~ChDeformableTerrain();
+
+				//
+	  			// FUNCTIONS
+				//
+
+				/// Set the height of the flat undeformed soil and the size of the
+				/// square cells (a fraction of the size of the contact patches, ex.
+				/// 1/10 of the wheel width). Call before the simulation: it
+				/// removes all deformations.
+	void Initialize(double mheight, double mcell_size);
+
+				/// Set a callback for an uneven undeformed soil, instead of the flat
+				/// one (the callback is not deleted by the terrain). Call before
+				/// the simulation: it removes all deformations.
+	void SetHeightCallback(ChHeightCallback* mcallback);
+
+				/// Set the parameters of the soil:
+				/// - Kphi: frictional modulus of the Bekker model [Pa/m^n]
+				/// - Kc: cohesive modulus of the Bekker model [Pa/m^(n-1)]
+				/// - n: exponent of sinkage of the Bekker model (usually 0.6-1.2)
+				/// - cohesion: Mohr cohesive limit [Pa]
+				/// - friction_angle: Mohr friction angle [degrees]
+				/// - janosi_K: shear deformation modulus of Janosi-Hanamoto [m]
+				/// - elastic_K: stiffness of the elastic unloading/reloading [Pa/m],
+				///   must be larger than Kphi
+				/// - damping: viscous damping of the vertical motion [Pa s/m]
+	void SetSoilParameters(double mKphi, double mKc, double mn,
+						   double mcohesion, double mfriction_angle, double mjanosi_K,
+						   double melastic_K, double mdamping);
+
+				/// Add a body that interacts with the soil.
+	void AddBody(ChSharedPtr<ChBody> mbody);
+				/// Remove a body, so it does not interact with the soil anymore.
+	void RemoveBody(ChSharedPtr<ChBody> mbody);
+				/// Number of bodies that interact with the soil.
+	int GetNbodies() const {return (int)bodies.size();}
+
+				/// Force and torque (about the center of mass, both in absolute
+				/// coordinates) that the soil applied to the i-th body at the last update.
+	const ChVector<>& GetBodyForce(int i) const {return body_force[i];}
+	const ChVector<>& GetBodyTorque(int i) const {return body_torque[i];}
+
+				/// Height of the soil surface at the horizontal position x,z,
+				/// with the permanent deformations (ruts).
+	double GetHeight(double x, double z) const;
+
+				/// Permanent sinkage of the soil at the horizontal position x,z.
+	double GetSinkage(double x, double z) const;
+
+				/// Number of cells in contact at the last update.
+	int GetNcontactCells() const {return ncontact_cells;}
+
+				/// Number of allocated tiles (the deformed area).
+	int GetNtiles() const {return (int)tiles.size();}
+
+				/// Number of cells per side of a tile.
+	static int GetTileSize() {return TILE_SIZE;}
+
+				//
+	  			// UPDATING FUNCTIONS
+				//
+
+				/// Find the contacts of the bodies with the soil, deform the soil
+				/// and compute the forces on the bodies. The shear displacements
+				/// are accumulated only if the time advanced since the last update.
+	virtual void Update (double mytime);
+
+				/// Apply the forces of the soil to the bodies
+	virtual void ConstraintsFbLoadForces(double factor=1.);
+
+private:
+	enum { TILE_SIZE = 32 };
+
+	// Square tile of TILE_SIZE*TILE_SIZE cells
+	struct ChTerrainTile
+	{
+		std::vector<double> level;		// undeformed height
+		std::vector<double> sinkage;	// permanent (plastic) sinkage
+		std::vector<double> shear;		// accumulated shear displacement
+		std::vector<int>	contact;	// last update with a contact, for the shear
+	};
+
+	typedef std::map< std::pair<int,int>, ChTerrainTile* > TileMap;
+
+	void ClearTiles();
+	ChTerrainTile* FindTile(int i, int k, int& mcell) const;
+	ChTerrainTile* GetTile(int i, int k, int& mcell);
+	double GetUndeformedHeight(int i, int k) const;
+	void   ProcessBody(int ibody, double dt);
+
+	std::vector< ChSharedPtr<ChBody> > bodies;
+	std::vector< ChVector<> > body_force;
+	std::vector< ChVector<> > body_torque;
+
+	TileMap tiles;
+	double height;
+	double cell_size;
+	ChHeightCallback* height_callback;
+
+	double Kphi;
+	double Kc;
+	double n;
+	double cohesion;
+	double friction_angle;
+	double janosi_K;
+	double elastic_K;
+	double damping;
+
+	double last_time;
+	int nupdates;
+	int ncontact_cells;
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
@@ -0,0 +1,144 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHDOMAINGRID_H
+#define CHDOMAINGRID_H
+
+//////////////////////////////////////////////////
+//
+//   ChDomainGrid.h
+//
+//   Partition of the space in boxes, for the
+//   domain decomposition of DEM systems.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <vector>
+#include "core/ChVector.h"
+
+
+namespace chrono
+{
+
+
+///
+/// Class for a partition of the space in nx*ny*nz boxes (domains), with a
+/// lattice that divides the axis aligned box from 'min' to 'max' in equal
+/// parts. The boxes on the faces of the lattice extend to infinity, so each
+/// point of the space belongs to exactly one domain.
+/// Domains are numbered as i + nx*(j + ny*k), where i,j,k are the indexes
+/// of the box along x,y,z.
+///
+
+class ChDomainGrid {
+public:
+	ChDomainGrid() : gmin(VNULL), gmax(1,1,1)
+		{
+			ndiv[0] = ndiv[1] = ndiv[2] = 1;
+		}
+
+			/// Set the lattice, from corner 'mmin' to corner 'mmax',
+			/// with 'nx', 'ny', 'nz' boxes along the three axes.
+	void Set(const ChVector<>& mmin, const ChVector<>& mmax, int nx, int ny, int nz)
+		{
+			gmin = mmin;
+			gmax = mmax;
+			ndiv[0] = nx > 0 ? nx : 1;
+			ndiv[1] = ny > 0 ? ny : 1;
+			ndiv[2] = nz > 0 ? nz : 1;
+		}
+
+	const ChVector<>& GetMin() const {return gmin;}
+	const ChVector<>& GetMax() const {return gmax;}
+
+			/// Number of boxes along an axis (0,1,2 for x,y,z).
+	int GetNdiv(int axis) const {return ndiv[axis];}
+
+			/// Total number of domains.
+	int GetNdomains() const {return ndiv[0] * ndiv[1] * ndiv[2];}
+
+			/// Index of the box that contains the coordinate 'x' along an axis.
+	int GetCellIndex(int axis, double x) const
+		{
+			double size = (gmax(axis) - gmin(axis)) / ndiv[axis];
+			if (size <= 0)
+				return 0;
+			double fi = floor((x - gmin(axis)) / size);
+			if (fi < 0)
+				return 0;
+			if (fi >= ndiv[axis])
+				return ndiv[axis] - 1;
+			return (int)fi;
+		}
+
+			/// Domain from the indexes along x,y,z.
+	int GetDomain(int i, int j, int k) const {return i + ndiv[0] * (j + ndiv[1] * k);}
+
+			/// Domain that contains the point.
+	int GetDomain(const ChVector<>& mpoint) const
+		{
+			return GetDomain(GetCellIndex(0, mpoint.x), GetCellIndex(1, mpoint.y), GetCellIndex(2, mpoint.z));
+		}
+
+			/// Find the domains that intersect the axis aligned box
+			/// 'bmin'-'bmax', except the domain 'mexclude', if any.
+	void GetDomains(const ChVector<>& bmin, const ChVector<>& bmax, std::vector<int>& result, int mexclude = -1) const
+		{
+			result.clear();
+			int i0 = GetCellIndex(0, bmin.x), i1 = GetCellIndex(0, bmax.x);
+			int j0 = GetCellIndex(1, bmin.y), j1 = GetCellIndex(1, bmax.y);
+			int k0 = GetCellIndex(2, bmin.z), k1 = GetCellIndex(2, bmax.z);
+			for (int k = k0; k <= k1; ++k)
+				for (int j = j0; j <= j1; ++j)
+					for (int i = i0; i <= i1; ++i)
+					{
+						int d = GetDomain(i, j, k);
+						if (d != mexclude)
+							result.push_back(d);
+					}
+		}
+
+			/// Get the box of a domain, as in the lattice (the boxes on the
+			/// faces of the lattice also contain all the points outside it).
+	void GetDomainBox(int mdomain, ChVector<>& bmin, ChVector<>& bmax) const
+		{
+			int idx[3];
+			idx[0] = mdomain % ndiv[0];
+			idx[1] = (mdomain / ndiv[0]) % ndiv[1];
+			idx[2] = mdomain / (ndiv[0] * ndiv[1]);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				double size = (gmax(axis) - gmin(axis)) / ndiv[axis];
+				bmin(axis) = gmin(axis) + idx[axis] * size;
+				bmax(axis) = gmin(axis) + (idx[axis] + 1) * size;
+			}
+		}
+
+private:
+	ChVector<> gmin;
+	ChVector<> gmax;
+	int ndiv[3];
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+
+#endif
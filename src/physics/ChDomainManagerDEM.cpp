@@ -0,0 +1,169 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChDomainManagerDEM.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "physics/ChDomainManagerDEM.h"
+
+#include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
+
+
+namespace chrono
+{
+
+
+
+ChDomainManagerDEM::ChDomainManagerDEM()
+{
+	ghost_width = 0;
+	factory = 0;
+	next_id = 0;
+	ChTime = 0;
+}
+
+
+ChDomainManagerDEM::~ChDomainManagerDEM()
+{
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		delete nodes[i];
+	nodes.clear();
+}
+
+
+void ChDomainManagerDEM::SetGrid(const ChVector<>& mmin, const ChVector<>& mmax, int nx, int ny, int nz)
+{
+	grid.Set(mmin, mmax, nx, ny, nz);
+}
+
+
+void ChDomainManagerDEM::SetBodyFactory(ChDomainBodyFactory* mfactory)
+{
+	factory = mfactory;
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		nodes[i]->SetBodyFactory(factory);
+}
+
+
+void ChDomainManagerDEM::Initialize()
+{
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		delete nodes[i];
+	nodes.clear();
+
+	local_of_domain.assign(grid.GetNdomains(), -1);
+	for (int d = 0; d < grid.GetNdomains(); ++d)
+	{
+		if (!IsLocalDomain(d))
+			continue;
+		local_of_domain[d] = (int)nodes.size();
+		nodes.push_back(new ChDomainNodeDEM(d, grid));
+		nodes.back()->SetBodyFactory(factory);
+	}
+	outgoing.resize(nodes.size());
+	incoming.resize(nodes.size());
+}
+
+
+ChDomainNodeDEM* ChDomainManagerDEM::GetNode(int mdomain)
+{
+	if (mdomain < 0 || mdomain >= (int)local_of_domain.size() || local_of_domain[mdomain] < 0)
+		return 0;
+	return nodes[local_of_domain[mdomain]];
+}
+
+
+bool ChDomainManagerDEM::AddBody(ChDomainBodyState& mstate)
+{
+	mstate.id = next_id++;
+	ChDomainNodeDEM* node = GetNode(grid.GetDomain(mstate.pos));
+	if (!node)
+		return false;
+	node->AddBody(mstate);
+	return true;
+}
+
+
+int ChDomainManagerDEM::GetNlocalBodies() const
+{
+	int nbodies = 0;
+	for (unsigned int i = 0; i < nodes.size(); ++i)
+		nbodies += nodes[i]->GetNownedBodies();
+	return nbodies;
+}
+
+
+void ChDomainManagerDEM::DoStepDynamics(double dt)
+{
+	int nnodes = (int)nodes.size();
+
+	// Ghost layers
+	#pragma omp parallel for schedule(dynamic,1) if(nnodes > 1)
+	for (int i = 0; i < nnodes; ++i)
+		nodes[i]->PackGhosts(ghost_width, outgoing[i]);
+
+	Exchange(outgoing, incoming);
+
+	// The nodes are independent: integrate them in parallel (with one node,
+	// the system can still use threads in its own loops)
+	#pragma omp parallel for schedule(dynamic,1) if(nnodes > 1)
+	for (int i = 0; i < nnodes; ++i)
+	{
+		nodes[i]->UpdateGhosts(incoming[i]);
+		nodes[i]->GetSystem()->DoStepDynamics(dt);
+		nodes[i]->PackMigrants(outgoing[i]);
+	}
+
+	// Migration
+	Exchange(outgoing, incoming);
+
+	#pragma omp parallel for schedule(dynamic,1) if(nnodes > 1)
+	for (int i = 0; i < nnodes; ++i)
+		nodes[i]->ReceiveMigrants(incoming[i]);
+
+	ChTime += dt;
+}
+
+
+
+//////////////////////////////////////
+//////////////////////////////////////
+
+/// THREADS
+
+
+void ChDomainManagerThreadsDEM::Exchange(std::vector< std::vector< std::vector<ChDomainBodyState> > >& outgoing,
+										 std::vector< std::vector<ChDomainBodyState> >& incoming)
+{
+	// All domains are local, so the n-th node is the n-th domain
+	int nnodes = (int)nodes.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int n = 0; n < nnodes; ++n)
+	{
+		incoming[n].clear();
+		for (int src = 0; src < nnodes; ++src)
+			incoming[n].insert(incoming[n].end(), outgoing[src][n].begin(), outgoing[src][n].end());
+	}
+}
+
+
+
+} // END_OF_NAMESPACE____
+
+
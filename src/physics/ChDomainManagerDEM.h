@@ -0,0 +1,148 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHDOMAINMANAGERDEM_H
+#define CHDOMAINMANAGERDEM_H
+
+//////////////////////////////////////////////////
+//
+//   ChDomainManagerDEM.h
+//
+//   Spatial domain decomposition of DEM systems,
+//   with migration of bodies and ghost layers.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include "physics/ChDomainNodeDEM.h"
+
+
+namespace chrono
+{
+
+
+///
+/// Base class for the simulation of a large DEM system decomposed in
+/// boxes (see ChDomainGrid), each with its own ChSystemDEM in a
+/// ChDomainNodeDEM. At each step, each domain receives the ghost copies
+/// of the bodies of the other domains that are within the ghost width
+/// from its box, all the domains are integrated, then the bodies that
+/// left their domain migrate to the new one.
+/// The ghost width must be at least the largest distance between the
+/// centers of two bodies in contact (ex. the diameter of the largest
+/// grains), plus the distance that a body can travel in a step.
+/// Inherited classes implement the exchange of the bodies between the
+/// domains, and decide which domains are in this process (the local
+/// nodes): see ChDomainManagerThreadsDEM, and ChDomainManagerMPI in
+/// the MPI unit.
+///
+
+class ChApi ChDomainManagerDEM
+{
+public:
+	ChDomainManagerDEM();
+	virtual ~ChDomainManagerDEM();
+
+			/// Set the lattice of the domains, from corner 'mmin' to corner
+			/// 'mmax', with 'nx', 'ny', 'nz' boxes along the three axes. Call
+			/// before Initialize().
+	void SetGrid(const ChVector<>& mmin, const ChVector<>& mmax, int nx, int ny, int nz);
+	const ChDomainGrid& GetGrid() const {return grid;}
+
+			/// Set the width of the ghost layers.
+	void SetGhostWidth(double mwidth) {ghost_width = mwidth;}
+	double GetGhostWidth() const {return ghost_width;}
+
+			/// Set the factory of the bodies, for all domains (not
+			/// deleted by the manager). Call before adding bodies.
+	void SetBodyFactory(ChDomainBodyFactory* mfactory);
+
+			/// Create the nodes of the local domains.
+	virtual void Initialize();
+
+			/// Add a body, given its state, to the domain that contains its
+			/// center, if local. Its 'id' is set to a new identifier, that is
+			/// the same in all processes if all of them add the same bodies in
+			/// the same order. Returns true if the body went to a local domain.
+	bool AddBody(ChDomainBodyState& mstate);
+
+			/// Advance all the local domains by a time step.
+	void DoStepDynamics(double dt);
+
+			/// Time of the simulation.
+	double GetChTime() const {return ChTime;}
+
+			/// Number of local domains (nodes) and their access.
+	int GetNlocalNodes() const {return (int)nodes.size();}
+	ChDomainNodeDEM* GetLocalNode(int i) {return nodes[i];}
+
+			/// Node of a domain, or null if the domain is not local.
+	ChDomainNodeDEM* GetNode(int mdomain);
+
+			/// Number of bodies owned by the local domains.
+	int GetNlocalBodies() const;
+
+			/// Number of bodies of all the domains.
+	virtual int GetNtotalBodies() {return GetNlocalBodies();}
+
+protected:
+			/// True if the domain must have a node in this process.
+	virtual bool IsLocalDomain(int mdomain) = 0;
+
+			/// Deliver the bodies: outgoing[n][d] are the states sent by the
+			/// n-th local node to domain d, incoming[n] must receive all the
+			/// states sent to the n-th local node.
+	virtual void Exchange(std::vector< std::vector< std::vector<ChDomainBodyState> > >& outgoing,
+						  std::vector< std::vector<ChDomainBodyState> >& incoming) = 0;
+
+	ChDomainGrid grid;
+	double ghost_width;
+	ChDomainBodyFactory* factory;
+
+	std::vector<ChDomainNodeDEM*> nodes;
+	std::vector<int> local_of_domain;		// index in 'nodes', or -1
+	int next_id;
+	double ChTime;
+
+	std::vector< std::vector< std::vector<ChDomainBodyState> > > outgoing;
+	std::vector< std::vector<ChDomainBodyState> > incoming;
+};
+
+
+
+///
+/// Domain decomposition of a DEM system, with all the domains in this
+/// process and with a thread per domain: the domains are integrated
+/// in parallel, and the bodies are exchanged in shared memory.
+/// Use more domains than threads, to balance the load.
+///
+
+class ChApi ChDomainManagerThreadsDEM : public ChDomainManagerDEM
+{
+protected:
+	virtual bool IsLocalDomain(int mdomain) {return true;}
+
+	virtual void Exchange(std::vector< std::vector< std::vector<ChDomainBodyState> > >& outgoing,
+						  std::vector< std::vector<ChDomainBodyState> >& incoming);
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
@@ -0,0 +1,372 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChDomainNodeDEM.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "physics/ChDomainNodeDEM.h"
+
+#include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
+
+
+namespace chrono
+{
+
+
+using namespace collision;
+
+
+
+//////////////////////////////////////
+//////////////////////////////////////
+
+/// BODY STATE
+
+
+ChDomainBodyState::ChDomainBodyState()
+{
+	id = -1;
+	shape = SHAPE_SPHERE;
+	shape_params[0] = shape_params[1] = shape_params[2] = shape_params[3] = 0;
+	pos = VNULL;
+	rot = QUNIT;
+	pos_dt = VNULL;
+	wvel_loc = VNULL;
+	mass = 1;
+	inertiaXX = ChVector<>(1,1,1);
+	SetMaterial(ChMaterialSurfaceDEM());
+}
+
+
+void ChDomainBodyState::SetSphere(double radius, double density)
+{
+	shape = SHAPE_SPHERE;
+	shape_params[0] = radius;
+	mass = density * (4./3.) * CH_C_PI * radius * radius * radius;
+	double iner = 0.4 * mass * radius * radius;
+	inertiaXX = ChVector<>(iner, iner, iner);
+}
+
+
+void ChDomainBodyState::SetBox(double hx, double hy, double hz, double density)
+{
+	shape = SHAPE_BOX;
+	shape_params[0] = hx;
+	shape_params[1] = hy;
+	shape_params[2] = hz;
+	mass = density * 8. * hx * hy * hz;
+	inertiaXX = ChVector<>((1./3.) * mass * (hy*hy + hz*hz),
+						   (1./3.) * mass * (hx*hx + hz*hz),
+						   (1./3.) * mass * (hx*hx + hy*hy));
+}
+
+
+void ChDomainBodyState::SetMaterial(const ChMaterialSurfaceDEM& mmat)
+{
+	young_modulus = mmat.GetYoungModulus();
+	poisson_ratio = mmat.GetPoissonRatio();
+	static_friction = mmat.GetSfriction();
+	sliding_friction = mmat.GetKfriction();
+	restitution = mmat.GetRestitution();
+	dissipation_factor = mmat.GetDissipationFactor();
+	cohesion = mmat.GetCohesion();
+}
+
+
+void ChDomainBodyState::GetMaterial(ChMaterialSurfaceDEM& mmat) const
+{
+	mmat.SetYoungModulus(young_modulus);
+	mmat.SetPoissonRatio(poisson_ratio);
+	mmat.SetSfriction(static_friction);
+	mmat.SetKfriction(sliding_friction);
+	mmat.SetRestitution(restitution);
+	mmat.SetDissipationFactor(dissipation_factor);
+	mmat.SetCohesion(cohesion);
+}
+
+
+
+//////////////////////////////////////
+//////////////////////////////////////
+
+/// BODY FACTORY
+
+
+ChSharedPtr<ChBodyDEM> ChDomainBodyFactory::CreateBody(const ChDomainBodyState& mstate)
+{
+	ChSharedPtr<ChBodyDEM> body(new ChBodyDEM);
+	body->GetCollisionModel()->ClearModel();
+	switch (mstate.shape)
+	{
+	case ChDomainBodyState::SHAPE_BOX:
+		body->GetCollisionModel()->AddBox(mstate.shape_params[0], mstate.shape_params[1], mstate.shape_params[2]);
+		break;
+	default:
+		body->GetCollisionModel()->AddSphere(mstate.shape_params[0]);
+		break;
+	}
+	body->GetCollisionModel()->BuildModel();
+	body->SetCollide(true);
+	return body;
+}
+
+
+
+//////////////////////////////////////
+//////////////////////////////////////
+
+/// DOMAIN NODE
+
+
+ChDomainNodeDEM::ChDomainNodeDEM(int mindex, const ChDomainGrid& mgrid)
+{
+	index = mindex;
+	grid = mgrid;
+	system = new ChSystemDEM;
+	factory = &default_factory;
+	nghosts = 0;
+	stamp = 0;
+}
+
+
+ChDomainNodeDEM::~ChDomainNodeDEM()
+{
+	records.clear();
+	delete system;
+}
+
+
+ChSharedPtr<ChMaterialSurfaceDEM> ChDomainNodeDEM::GetMaterial(const ChDomainBodyState& mstate)
+{
+	// Bodies with the same properties share the material, that is
+	// faster for the material table of the contact container
+	ChMaterialSurfaceDEM mmat;
+	mstate.GetMaterial(mmat);
+	for (unsigned int i = 0; i < materials.size(); ++i)
+		if (materials[i]->Equals(mmat))
+			return materials[i];
+	ChSharedPtr<ChMaterialSurfaceDEM> newmat(new ChMaterialSurfaceDEM(mmat));
+	materials.push_back(newmat);
+	return newmat;
+}
+
+
+ChSharedPtr<ChBodyDEM> ChDomainNodeDEM::CreateBody(const ChDomainBodyState& mstate)
+{
+	ChSharedPtr<ChBodyDEM> body = factory->CreateBody(mstate);
+	body->SetIdentifier(mstate.id);
+	body->SetMaterialSurfaceDEM(GetMaterial(mstate));
+	body->SetMass(mstate.mass);
+	body->SetInertiaXX(mstate.inertiaXX);
+	ApplyState(body.get_ptr(), mstate);
+	return body;
+}
+
+
+void ChDomainNodeDEM::ApplyState(ChBodyDEM* mbody, const ChDomainBodyState& mstate)
+{
+	mbody->SetCoord(mstate.pos, mstate.rot);
+	mbody->SetPos_dt(mstate.pos_dt);
+	mbody->SetWvel_loc(mstate.wvel_loc);
+}
+
+
+void ChDomainNodeDEM::StoreState(ChDomainRecord& mrecord)
+{
+	ChBodyDEM* body = mrecord.body.get_ptr();
+	mrecord.state.pos = body->GetPos();
+	mrecord.state.rot = body->GetRot();
+	mrecord.state.pos_dt = body->GetPos_dt();
+	mrecord.state.wvel_loc = body->GetWvel_loc();
+	mrecord.state.mass = body->GetMass();
+	mrecord.state.inertiaXX = body->GetInertiaXX();
+}
+
+
+void ChDomainNodeDEM::AddBody(const ChDomainBodyState& mstate)
+{
+	ChDomainRecord& record = records[mstate.id];
+	if (!record.body.IsNull())
+		return;
+	record.body = CreateBody(mstate);
+	record.state = mstate;
+	record.ghost = false;
+	record.stamp = stamp;
+	system->AddBody(record.body);
+}
+
+
+ChSharedPtr<ChBodyDEM> ChDomainNodeDEM::GetBody(int mid)
+{
+	RecordMap::iterator found = records.find(mid);
+	if (found == records.end())
+		return ChSharedPtr<ChBodyDEM>();
+	return found->second.body;
+}
+
+
+bool ChDomainNodeDEM::IsGhost(int mid) const
+{
+	RecordMap::const_iterator found = records.find(mid);
+	return found != records.end() && found->second.ghost;
+}
+
+
+void ChDomainNodeDEM::GetOwnedStates(std::vector<ChDomainBodyState>& mstates)
+{
+	mstates.clear();
+	mstates.reserve(GetNownedBodies());
+	for (RecordMap::iterator it = records.begin(); it != records.end(); ++it)
+	{
+		if (it->second.ghost)
+			continue;
+		StoreState(it->second);
+		mstates.push_back(it->second.state);
+	}
+}
+
+
+void ChDomainNodeDEM::PackGhosts(double ghost_width, std::vector< std::vector<ChDomainBodyState> >& outgoing)
+{
+	outgoing.resize(grid.GetNdomains());
+	for (unsigned int d = 0; d < outgoing.size(); ++d)
+		outgoing[d].clear();
+
+	ChVector<> width(ghost_width, ghost_width, ghost_width);
+	for (RecordMap::iterator it = records.begin(); it != records.end(); ++it)
+	{
+		if (it->second.ghost)
+			continue;
+		ChVector<> pos = it->second.body->GetPos();
+		grid.GetDomains(pos - width, pos + width, mdomains, index);
+		if (mdomains.empty())
+			continue;
+		StoreState(it->second);
+		for (unsigned int i = 0; i < mdomains.size(); ++i)
+			outgoing[mdomains[i]].push_back(it->second.state);
+	}
+}
+
+
+void ChDomainNodeDEM::UpdateGhosts(const std::vector<ChDomainBodyState>& incoming)
+{
+	++stamp;
+
+	std::vector< ChSharedPtr<ChBody> > newghosts;
+	for (unsigned int i = 0; i < incoming.size(); ++i)
+	{
+		const ChDomainBodyState& mstate = incoming[i];
+		RecordMap::iterator found = records.find(mstate.id);
+		if (found != records.end())
+		{
+			if (found->second.ghost)
+			{
+				ApplyState(found->second.body.get_ptr(), mstate);
+				found->second.stamp = stamp;
+			}
+			continue;
+		}
+		ChDomainRecord& record = records[mstate.id];
+		record.body = CreateBody(mstate);
+		record.body->SetBodyFixed(true);
+		record.state = mstate;
+		record.ghost = true;
+		record.stamp = stamp;
+		++nghosts;
+		newghosts.push_back(record.body);
+	}
+	system->AddBodies(newghosts);
+
+	// Ghosts of bodies that went away from this domain
+	std::vector< ChSharedPtr<ChBody> > oldghosts;
+	RecordMap::iterator it = records.begin();
+	while (it != records.end())
+	{
+		if (it->second.ghost && it->second.stamp != stamp)
+		{
+			oldghosts.push_back(it->second.body);
+			records.erase(it++);
+			--nghosts;
+		}
+		else
+			++it;
+	}
+	system->RemoveBodies(oldghosts);
+}
+
+
+void ChDomainNodeDEM::PackMigrants(std::vector< std::vector<ChDomainBodyState> >& outgoing)
+{
+	outgoing.resize(grid.GetNdomains());
+	for (unsigned int d = 0; d < outgoing.size(); ++d)
+		outgoing[d].clear();
+
+	for (RecordMap::iterator it = records.begin(); it != records.end(); ++it)
+	{
+		if (it->second.ghost)
+			continue;
+		int d = grid.GetDomain(it->second.body->GetPos());
+		if (d == index)
+			continue;
+		StoreState(it->second);
+		outgoing[d].push_back(it->second.state);
+
+		// It is probably still near: keep it as a ghost, the next
+		// update of the ghosts will move it or remove it
+		it->second.body->SetBodyFixed(true);
+		it->second.ghost = true;
+		++nghosts;
+	}
+}
+
+
+void ChDomainNodeDEM::ReceiveMigrants(const std::vector<ChDomainBodyState>& incoming)
+{
+	std::vector< ChSharedPtr<ChBody> > newbodies;
+	for (unsigned int i = 0; i < incoming.size(); ++i)
+	{
+		const ChDomainBodyState& mstate = incoming[i];
+		RecordMap::iterator found = records.find(mstate.id);
+		if (found != records.end())
+		{
+			// Already here as a ghost
+			if (found->second.ghost)
+			{
+				ApplyState(found->second.body.get_ptr(), mstate);
+				found->second.body->SetBodyFixed(false);
+				found->second.ghost = false;
+				found->second.state = mstate;
+				--nghosts;
+			}
+			continue;
+		}
+		ChDomainRecord& record = records[mstate.id];
+		record.body = CreateBody(mstate);
+		record.state = mstate;
+		record.ghost = false;
+		record.stamp = stamp;
+		newbodies.push_back(record.body);
+	}
+	system->AddBodies(newbodies);
+}
+
+
+
+} // END_OF_NAMESPACE____
+
+
@@ -0,0 +1,213 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHDOMAINNODEDEM_H
+#define CHDOMAINNODEDEM_H
+
+//////////////////////////////////////////////////
+//
+//   ChDomainNodeDEM.h
+//
+//   Domain of a DEM system decomposed in boxes,
+//   with its own ChSystemDEM, its bodies and the
+//   ghost copies of the bodies of the neighbours.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include <map>
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "physics/ChDomainGrid.h"
+
+
+namespace chrono
+{
+
+
+///
+/// State of a body of a decomposed DEM system: all that is needed to
+/// create a copy of the body in another domain (shape, mass, material)
+/// and to move it there (position and speed). It is a plain structure,
+/// copied byte per byte when bodies migrate or are sent as ghosts,
+/// also between processes.
+///
+
+struct ChApi ChDomainBodyState
+{
+	enum eShape {
+		SHAPE_SPHERE = 0,	///< shape_params[0] is the radius
+		SHAPE_BOX,			///< shape_params[0..2] are the half sizes
+		SHAPE_USER			///< and following values: see ChDomainBodyFactory
+	};
+
+	ChDomainBodyState();
+
+			/// Set a sphere shape, with mass and inertia from the density.
+	void SetSphere(double radius, double density);
+			/// Set a box shape, with mass and inertia from the density.
+	void SetBox(double hx, double hy, double hz, double density);
+			/// Copy the properties of a material.
+	void SetMaterial(const ChMaterialSurfaceDEM& mmat);
+			/// Get the properties of the material.
+	void GetMaterial(ChMaterialSurfaceDEM& mmat) const;
+
+	int id;					///< unique identifier, given by ChDomainManagerDEM::AddBody()
+	int shape;				///< one of eShape
+	double shape_params[4];
+
+	ChVector<> pos;
+	ChQuaternion<> rot;
+	ChVector<> pos_dt;
+	ChVector<> wvel_loc;
+	double mass;
+	ChVector<> inertiaXX;
+
+	float young_modulus;
+	float poisson_ratio;
+	float static_friction;
+	float sliding_friction;
+	float restitution;
+	float dissipation_factor;
+	float cohesion;
+};
+
+
+///
+/// Class to be used as a callback interface for creating the bodies of a
+/// decomposed DEM system, when they are added, when they migrate to another
+/// domain, or when a domain needs a ghost copy of them. The default version
+/// creates spheres and boxes; inherit from it for other shapes (with 'shape'
+/// from ChDomainBodyState::SHAPE_USER on). Mass, position, speed and
+/// material are set by the caller.
+/// The same factory is used by all the domains, and ChDomainManagerThreadsDEM
+/// calls it from many threads at once: CreateBody() must be thread-safe, ex.
+/// it must not modify shared data nor share shapes or materials among the
+/// bodies it creates (reference counts are not atomic).
+///
+
+class ChApi ChDomainBodyFactory
+{
+public:
+	virtual ~ChDomainBodyFactory() {}
+			/// Create a body, with the collision model of the shape.
+	virtual ChSharedPtr<ChBodyDEM> CreateBody(const ChDomainBodyState& mstate);
+};
+
+
+///
+/// Class for one of the domains of a DEM system decomposed in boxes
+/// (see ChDomainGrid). It has its own ChSystemDEM, with the bodies whose
+/// center is in the domain (owned bodies) and with fixed copies of the
+/// bodies of other domains that are near enough to touch them (ghosts).
+/// At each step the ghosts are updated, the system is integrated (the
+/// contact forces between owned bodies and ghosts are computed in both
+/// domains, with the same states, so they are equal and opposite), then
+/// the bodies that left the domain migrate to their new domain.
+/// The exchange of the bodies between domains is done by a
+/// ChDomainManagerDEM, that can use threads or processes.
+/// Fixed bodies that are not decomposed (ground, walls) can be added to
+/// the system of each domain with GetSystem().
+///
+
+class ChApi ChDomainNodeDEM
+{
+public:
+	ChDomainNodeDEM(int mindex, const ChDomainGrid& mgrid);
+	~ChDomainNodeDEM();
+
+			/// Index of the domain in the grid.
+	int GetIndex() const {return index;}
+
+			/// The system of this domain.
+	ChSystemDEM* GetSystem() {return system;}
+
+			/// Set the factory of the bodies (not deleted by the node). If null,
+			/// the default factory of spheres and boxes is used.
+	void SetBodyFactory(ChDomainBodyFactory* mfactory) {factory = mfactory ? mfactory : &default_factory;}
+
+			/// Add a body, owned by this domain.
+	void AddBody(const ChDomainBodyState& mstate);
+
+			/// Number of bodies owned by this domain.
+	int GetNownedBodies() const {return (int)records.size() - nghosts;}
+			/// Number of ghost copies of bodies of other domains.
+	int GetNghostBodies() const {return nghosts;}
+
+			/// Get the body with an identifier, owned or ghost (null if
+			/// not in this domain).
+	ChSharedPtr<ChBodyDEM> GetBody(int mid);
+			/// True if the body with an identifier is a ghost.
+	bool IsGhost(int mid) const;
+
+			/// Get the current states of the owned bodies, ex. for output.
+	void GetOwnedStates(std::vector<ChDomainBodyState>& mstates);
+
+			//
+			// EXCHANGE OF BODIES (used by ChDomainManagerDEM)
+			//
+
+			/// Put in outgoing[d] the states of the owned bodies that are within
+			/// 'ghost_width' from domain d. The vector has a slot per domain.
+	void PackGhosts(double ghost_width, std::vector< std::vector<ChDomainBodyState> >& outgoing);
+
+			/// Create, move or remove the ghosts, after the states received
+			/// from the other domains (ghosts that are not received are removed).
+	void UpdateGhosts(const std::vector<ChDomainBodyState>& incoming);
+
+			/// Put in outgoing[d] the states of the owned bodies whose center is
+			/// now in domain d. They stay here as ghosts until the next update.
+	void PackMigrants(std::vector< std::vector<ChDomainBodyState> >& outgoing);
+
+			/// Take the ownership of the bodies that migrated to this domain.
+	void ReceiveMigrants(const std::vector<ChDomainBodyState>& incoming);
+
+private:
+	struct ChDomainRecord
+	{
+		ChSharedPtr<ChBodyDEM> body;
+		ChDomainBodyState state;	// shape, mass and material
+		bool ghost;
+		int stamp;					// last ghost update
+	};
+
+	typedef std::map<int, ChDomainRecord> RecordMap;
+
+	ChSharedPtr<ChBodyDEM> CreateBody(const ChDomainBodyState& mstate);
+	ChSharedPtr<ChMaterialSurfaceDEM> GetMaterial(const ChDomainBodyState& mstate);
+	void StoreState(ChDomainRecord& mrecord);
+	void ApplyState(ChBodyDEM* mbody, const ChDomainBodyState& mstate);
+
+	int index;
+	ChDomainGrid grid;
+	ChSystemDEM* system;
+	ChDomainBodyFactory default_factory;
+	ChDomainBodyFactory* factory;
+
+	RecordMap records;
+	int nghosts;
+	int stamp;
+	std::vector< ChSharedPtr<ChMaterialSurfaceDEM> > materials;
+	std::vector<int> mdomains;
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
@@ -0,0 +1,232 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHMATERIALPAIRTABLE_H
+#define CHMATERIALPAIRTABLE_H
+
+///////////////////////////////////////////////////
+//
+//   ChMaterialPairTable.h
+//
+//   Table of materials with integer IDs, and of the
+//   precomputed composite properties of their pairs.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include <map>
+#include "core/ChSmartpointers.h"
+
+
+namespace chrono
+{
+
+
+/// Class for a table of surface materials, each with a small integer ID,
+/// and of the composite properties of all pairs of materials, so that
+/// contacts do not need to combine the properties of the two materials
+/// each time. It is used by the contact containers, that register the
+/// materials of the bodies the first time they are in contact.
+/// The composite properties of a material are computed again only
+/// when Update() finds that its properties have changed.
+/// Materials shared by many bodies use the table at best: when the
+/// table is full (see SetMaxMaterials()) the composite properties of
+/// other materials are computed on the fly.
+/// The template parameters are the material class, that must have a
+/// 'material_id' integer hint, a Equals() function, and a static
+/// CompositeMaterial() function, and the class of composite properties
+/// returned by it (ex. ChMaterialSurfaceDEM and ChCompositeMaterialDEM).
+/// Note: the table keeps a reference to its materials, until Update()
+/// finds that it holds the last one, and writes their 'material_id'
+/// hint; the reference counts are not thread-safe: a
+/// material must not be used by systems that are stepped concurrently
+/// (ex. the domains of ChDomainManagerThreadsDEM), give each its own copy.
+/// A material can be in the tables of systems that are stepped one after
+/// the other, but the hint is then often wrong, so lookups are slower.
+
+template <class Tmaterial, class Tcomposite>
+class ChMaterialPairTable
+{
+public:
+			/// Value of the 'material_id' hint of the materials that did
+			/// not fit in a full table.
+	enum {NOT_TABLED = -2};
+
+	ChMaterialPairTable() : max_materials(128) {}
+
+			/// Get the ID of a material, registering it if not yet in the
+			/// table. Returns -1 if the table is full.
+	int GetMaterialId(const ChSharedPtr<Tmaterial>& mmat)
+		{
+			int id = mmat->material_id;
+			if (id >= 0 && id < (int)materials.size() && materials[id].get_ptr() == mmat.get_ptr())
+				return id;
+			// already refused by a full table: go straight to the direct path
+			if (id == NOT_TABLED && (int)materials.size() >= max_materials)
+				return -1;
+			return Register(mmat);
+		}
+
+			/// Index of the composite properties of the materials
+			/// with IDs 'idA' and 'idB' (the table is symmetric).
+	int GetPairIndex(int idA, int idB) const {return idA * (int)materials.size() + idB;}
+
+			/// Get the composite properties of a pair of materials, given the
+			/// index from GetPairIndex().
+	const Tcomposite& GetComposite(int pairindex) const {return pairs[pairindex];}
+
+			/// Get the composite properties of two materials, from the table
+			/// if possible, otherwise computing them. Use 'mstorage' for the
+			/// result, if computed.
+	const Tcomposite& GetComposite(const ChSharedPtr<Tmaterial>& matA,
+								   const ChSharedPtr<Tmaterial>& matB,
+								   Tcomposite& mstorage)
+		{
+			int idA = GetMaterialId(matA);
+			int idB = GetMaterialId(matB);
+			if (idA < 0 || idB < 0)
+			{
+				mstorage = Tmaterial::CompositeMaterial(matA, matB);
+				return mstorage;
+			}
+			return pairs[GetPairIndex(idA, idB)];
+		}
+
+			/// Compute again the composite properties of the materials
+			/// whose properties changed since the last update (this is cheap,
+			/// because materials are few: call it once per step). Materials
+			/// that are referenced only by the table (ex. their bodies were
+			/// removed) are dropped, and the others get new, compact IDs.
+	void Update()
+		{
+			Prune();
+			for (unsigned int i = 0; i < materials.size(); ++i)
+			{
+				if (!snapshots[i].Equals(*materials[i]))
+				{
+					snapshots[i] = *materials[i];
+					UpdatePairs(i);
+				}
+			}
+		}
+
+			/// Number of registered materials.
+	int GetNmaterials() const {return (int)materials.size();}
+
+			/// Maximum number of materials in the table (the table
+			/// has the square of this number of pairs). Default 128.
+	void SetMaxMaterials(int mmax) {max_materials = mmax;}
+	int  GetMaxMaterials() const {return max_materials;}
+
+			/// Remove all materials from the table.
+	void Clear()
+		{
+			materials.clear();
+			snapshots.clear();
+			pairs.clear();
+			lookup.clear();
+		}
+
+private:
+	int Register(const ChSharedPtr<Tmaterial>& mmat)
+		{
+			// The hint can be wrong if the material is also in other tables
+			typename std::map<Tmaterial*, int>::iterator found = lookup.find(mmat.get_ptr());
+			if (found != lookup.end())
+			{
+				mmat.get_ptr()->material_id = found->second;
+				return found->second;
+			}
+
+			if ((int)materials.size() >= max_materials)
+			{
+				mmat.get_ptr()->material_id = NOT_TABLED;
+				return -1;
+			}
+
+			int id = (int)materials.size();
+			int n = id + 1;
+			materials.push_back(mmat);
+			snapshots.push_back(*mmat);
+			lookup[mmat.get_ptr()] = id;
+			mmat.get_ptr()->material_id = id;
+
+			std::vector<Tcomposite> newpairs(n * n);
+			for (int i = 0; i < id; ++i)
+				for (int j = 0; j < id; ++j)
+					newpairs[i * n + j] = pairs[i * id + j];
+			pairs.swap(newpairs);
+
+			UpdatePairs(id);
+			return id;
+		}
+
+	void Prune()
+		{
+			int n = (int)materials.size();
+			std::vector<int> newid(n);
+			int m = 0;
+			for (int i = 0; i < n; ++i)
+				newid[i] = (materials[i].ReferenceCounter() > 1) ? m++ : -1;
+			if (m == n)
+				return;
+
+			std::vector< ChSharedPtr<Tmaterial> > newmaterials(m);
+			std::vector< Tmaterial > newsnapshots(m);
+			std::vector< Tcomposite > newpairs(m * m);
+			lookup.clear();
+			for (int i = 0; i < n; ++i)
+			{
+				if (newid[i] < 0)
+					continue;
+				newmaterials[newid[i]] = materials[i];
+				newsnapshots[newid[i]] = snapshots[i];
+				for (int j = 0; j < n; ++j)
+					if (newid[j] >= 0)
+						newpairs[newid[i] * m + newid[j]] = pairs[i * n + j];
+				lookup[materials[i].get_ptr()] = newid[i];
+				materials[i].get_ptr()->material_id = newid[i];
+			}
+			materials.swap(newmaterials);
+			snapshots.swap(newsnapshots);
+			pairs.swap(newpairs);
+		}
+
+	void UpdatePairs(int id)
+		{
+			int n = (int)materials.size();
+			for (int j = 0; j < n; ++j)
+			{
+				Tcomposite mat = Tmaterial::CompositeMaterial(materials[id], materials[j]);
+				pairs[id * n + j] = mat;
+				pairs[j * n + id] = mat;
+			}
+		}
+
+	std::vector< ChSharedPtr<Tmaterial> > materials;
+	std::vector< Tmaterial > snapshots;		// properties at the last update
+	std::vector< Tcomposite > pairs;
+	std::map< Tmaterial*, int > lookup;
+	int max_materials;
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
@@ -25,6 +25,8 @@
 ///////////////////////////////////////////////////
 
 #include "core/ChShared.h"
+#include "core/ChMathematics.h"
+#include "physics/ChMaterialCouple.h"
 
 
 namespace chrono
@@ -55,6 +57,10 @@ public:
 	float  complianceRoll;
 	float  complianceSpin;
 
+				// Index in the ChMaterialPairTable of the contact container
+				// (only a hint, used to avoid searches, see ChMaterialPairTable).
+	int    material_id;
+
 
 			//
 			// CONSTRUCTORS
@@ -70,7 +76,8 @@ public:
 						compliance(0),
 						complianceT(0),
 						complianceRoll(0),
-						complianceSpin(0)
+						complianceSpin(0),
+						material_id(-1)
 					{
 					};
 
@@ -92,6 +99,7 @@ public:
 						complianceT=other.complianceT;
 						complianceRoll=other.complianceRoll;
 						complianceSpin=other.complianceSpin;
+						material_id=-1;
 					}
 
 			//
@@ -176,6 +184,42 @@ public:
 	float  GetComplianceSpinning() {return complianceSpin;}
 	void   SetComplianceSpinning(float mval) {complianceSpin = mval;}
 
+				/// Returns true if all properties are equal to the ones of the other material.
+	bool   Equals(const ChMaterialSurface& other) const
+					{
+						return (static_friction==other.static_friction) &&
+							   (sliding_friction==other.sliding_friction) &&
+							   (rolling_friction==other.rolling_friction) &&
+							   (spinning_friction==other.spinning_friction) &&
+							   (restitution==other.restitution) &&
+							   (cohesion==other.cohesion) &&
+							   (dampingf==other.dampingf) &&
+							   (compliance==other.compliance) &&
+							   (complianceT==other.complianceT) &&
+							   (complianceRoll==other.complianceRoll) &&
+							   (complianceSpin==other.complianceSpin);
+					}
+
+				/// Calculate the composite material properties of a contact
+				/// between two materials (minimum of frictions, restitution,
+				/// cohesion and damping, sum of compliances).
+	static ChMaterialCouple CompositeMaterial(const ChSharedPtr<ChMaterialSurface>& matA,
+											  const ChSharedPtr<ChMaterialSurface>& matB)
+					{
+						ChMaterialCouple mat;
+						mat.static_friction		= (float)ChMin( matA->static_friction,		matB->static_friction);
+						mat.rolling_friction	= (float)ChMin( matA->rolling_friction,		matB->rolling_friction);
+						mat.spinning_friction	= (float)ChMin( matA->spinning_friction,	matB->spinning_friction);
+						mat.restitution			= (float)ChMin( matA->restitution,			matB->restitution);
+						mat.cohesion			= (float)ChMin( matA->cohesion,				matB->cohesion);
+						mat.dampingf			= (float)ChMin( matA->dampingf,				matB->dampingf);
+						mat.compliance			= (float)(matA->compliance+matB->compliance);
+						mat.complianceT			= (float)(matA->complianceT+matB->complianceT);
+						mat.complianceRoll		= (float)(matA->complianceRoll+matB->complianceRoll);
+						mat.complianceSpin		= (float)(matA->complianceSpin+matB->complianceSpin);
+						return mat;
+					}
+
 
 			//
 			// STREAMING
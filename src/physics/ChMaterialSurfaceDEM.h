@@ -67,6 +67,8 @@ public:
 
 	float cohesion;              ///< Constant cohesion force
 
+	int material_id;             ///< Index in the ChMaterialPairTable of the contact container (a hint, see ChMaterialPairTable)
+
 			//
 			// CONSTRUCTORS
 			//
@@ -78,7 +80,8 @@ public:
 		sliding_friction(0.6f),
 		restitution(0.5f),
 		dissipation_factor(0.1f),
-		cohesion(0)
+		cohesion(0),
+		material_id(-1)
 	{}
 
 	// Copy constructor
@@ -91,6 +94,7 @@ public:
 		restitution = other.restitution;
 		dissipation_factor = other.dissipation_factor;
 		cohesion = other.cohesion;
+		material_id = -1;
 	}
 
 	~ChMaterialSurfaceDEM() {}
@@ -129,6 +133,18 @@ public:
 	float GetCohesion() const        {return cohesion;}
 	void  SetCohesion(float val)     {cohesion = val;}
 
+	/// Returns true if all properties are equal to the ones of the other material.
+	bool  Equals(const ChMaterialSurfaceDEM& other) const
+	{
+		return young_modulus == other.young_modulus &&
+		       poisson_ratio == other.poisson_ratio &&
+		       static_friction == other.static_friction &&
+		       sliding_friction == other.sliding_friction &&
+		       restitution == other.restitution &&
+		       dissipation_factor == other.dissipation_factor &&
+		       cohesion == other.cohesion;
+	}
+
 	/// Calculate composite material properties
 	static ChCompositeMaterialDEM
 	CompositeMaterial(const ChSharedPtr<ChMaterialSurfaceDEM>& mat1,
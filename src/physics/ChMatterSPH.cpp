@@ -55,6 +55,7 @@ ChClassRegister<ChMatterSPH> a_registration_ChMatterSPH;
 ChNodeSPH::ChNodeSPH()
 {
 	this->collision_model = new ChModelBulletNode;
+	this->collide_neighbors = true;
 	
 	this->UserForce = VNULL;
 	this->h_rad = 0.1;
@@ -67,17 +68,23 @@ ChNodeSPH::ChNodeSPH()
 
 ChNodeSPH::~ChNodeSPH()
 {
-	delete collision_model; 
+	if (collision_model)
+		delete collision_model; 
 }
 
 ChNodeSPH::ChNodeSPH (const ChNodeSPH& other) :
 					ChNodeXYZ(other) 
 {
-	this->collision_model = new ChModelBulletNode;
-	this->collision_model->AddSphere(other.coll_rad); 
-	((ChModelBulletNode*)collision_model)->SetNode(
-		((ChModelBulletNode*)other.collision_model)->GetNodes(),
-		((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	this->collision_model = 0;
+	if (other.collision_model)
+	{
+		this->collision_model = new ChModelBulletNode;
+		this->collision_model->AddSphere(other.coll_rad); 
+		((ChModelBulletNode*)collision_model)->SetNode(
+			((ChModelBulletNode*)other.collision_model)->GetNodes(),
+			((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	}
+	this->collide_neighbors = other.collide_neighbors;
 
 	this->UserForce = other.UserForce;
 	this->SetKernelRadius(other.h_rad);
@@ -97,11 +104,22 @@ ChNodeSPH& ChNodeSPH::operator= (const ChNodeSPH& other)
 
 	ChNodeXYZ::operator=(other);
 
-	this->collision_model->ClearModel();
-	this->collision_model->AddSphere(other.coll_rad ); 
-	((ChModelBulletNode*)collision_model)->SetNode(
-		((ChModelBulletNode*)other.collision_model)->GetNodes(),
-		((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	if (other.collision_model)
+	{
+		if (!this->collision_model)
+			this->collision_model = new ChModelBulletNode;
+		this->collision_model->ClearModel();
+		this->collision_model->AddSphere(other.coll_rad ); 
+		((ChModelBulletNode*)collision_model)->SetNode(
+			((ChModelBulletNode*)other.collision_model)->GetNodes(),
+			((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	}
+	else if (this->collision_model)
+	{
+		delete this->collision_model;
+		this->collision_model = 0;
+	}
+	this->collide_neighbors = other.collide_neighbors;
 	
 	this->UserForce = other.UserForce;
 	this->SetKernelRadius(other.h_rad);
@@ -118,15 +136,21 @@ ChNodeSPH& ChNodeSPH::operator= (const ChNodeSPH& other)
 void ChNodeSPH::SetKernelRadius(double mr)
 {
 	h_rad = mr;
-	double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
-	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, ChMax(0.0, aabb_rad-coll_rad) );
+	SetCollisionRadius(coll_rad);
 }
 	
 void ChNodeSPH::SetCollisionRadius(double mr)
 {
 	coll_rad = mr;
-	double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
-	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, ChMax(0.0, aabb_rad-coll_rad) );
+	if (!this->collision_model)
+		return;
+	double envelope = coll_rad;	// just a small envelope, if near nodes are found by the cell list
+	if (collide_neighbors)
+	{
+		double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
+		envelope = ChMax(0.0, aabb_rad-coll_rad);
+	}
+	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, envelope );
 }
 
 
@@ -176,6 +200,12 @@ void ChContinuumSPH::StreamIN(ChStreamInBinary& mstream)
 ChMatterSPH::ChMatterSPH ()
 {
 	this->do_collide = false;
+	this->use_cell_list = false;
+
+	this->reorder_interval = 0;
+	this->reorder_counter = 0;
+	this->reorder_locality = 0;
+	this->reorder_callback = 0;
 
 	this->nodes.clear();
 
@@ -198,6 +228,12 @@ void ChMatterSPH::Copy(ChMatterSPH* source)
 	ChIndexedNodes::Copy(source);
 
 	do_collide = source->do_collide;
+	use_cell_list = source->use_cell_list;
+
+	reorder_interval = source->reorder_interval;
+	reorder_counter = 0;
+	reorder_locality = source->reorder_locality;
+	reorder_callback = source->reorder_callback;
 
 	this->material = source->material;
 	
@@ -226,15 +262,51 @@ void ChMatterSPH::ResizeNnodes(int newsize)
 		this->nodes[j] = ChSharedPtr<ChNodeSPH>(new ChNodeSPH);
 
 		this->nodes[j]->variables.SetUserData((void*)this); // UserData unuseful in future cuda solver?
-		((ChModelBulletNode*)this->nodes[j]->collision_model)->SetNode(this,j);
-		this->nodes[j]->collision_model->AddSphere(0.001); //***TEST***
-		this->nodes[j]->collision_model->BuildModel();
+		this->SetupNodeCollisionModel(j, 0.001); //***TEST***
 	}
 
 	this->SetCollide(oldcoll); // this will also add particle coll.models to coll.engine, if already in a ChSystem
 
 }
 
+void ChMatterSPH::SetupNodeCollisionModel(unsigned int j, double sphere_rad)
+{
+	ChNodeSPH* mnode = this->nodes[j].get_ptr();
+
+	mnode->collide_neighbors = !this->use_cell_list;
+
+	// with the cell list, collision models are needed only for colliding with other objects
+	if (this->use_cell_list && !this->do_collide)
+	{
+		if (mnode->collision_model)
+			delete mnode->collision_model;
+		mnode->collision_model = 0;
+		return;
+	}
+
+	if (!mnode->collision_model)
+		mnode->collision_model = new ChModelBulletNode;
+	((ChModelBulletNode*)mnode->collision_model)->SetNode(this,j);
+	mnode->collision_model->ClearModel();
+	mnode->collision_model->AddSphere(sphere_rad);
+	mnode->collision_model->BuildModel();
+}
+
+void ChMatterSPH::SetUseCellList (bool muse)
+{
+	if (muse == this->use_cell_list)
+		return;
+
+	bool oldcoll = this->GetCollide();
+	this->SetCollide(false); // this will remove old particle coll.models from coll.engine, if previously added
+
+	this->use_cell_list = muse;
+	for (unsigned int j = 0; j < nodes.size(); j++)
+		this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+
+	this->SetCollide(oldcoll); // this will also add particle coll.models to coll.engine, if already in a ChSystem
+}
+
 
 void ChMatterSPH::AddNode(ChVector<double> initial_state)
 {
@@ -245,9 +317,7 @@ void ChMatterSPH::AddNode(ChVector<double> initial_state)
 	this->nodes.push_back(newp);
 
 	newp->variables.SetUserData((void*)this);  // UserData unuseful in future cuda solver?
-	((ChModelBulletNode*)newp->collision_model)->SetNode(this,nodes.size()-1);
-	newp->collision_model->AddSphere(0.1); //***TEST***
-	newp->collision_model->BuildModel(); // will also add to system, if collision is on.
+	this->SetupNodeCollisionModel(nodes.size()-1, 0.1); //***TEST*** will also add to system, if collision is on.
 }
 
 
@@ -330,43 +400,214 @@ void ChMatterSPH::VariablesFbReset()
 	}
 }
 
+// Same kernels of ChProximityContainerSPH, with the constant
+// factor precomputed per node.
+
+static inline double W_poly6_factor(double h)
+{
+	return 315.0 / (64.0 * CH_C_PI * pow(h,9));
+}
+
+static inline double W_poly6(double r, double h, double factor)
+{
+	if (r < h)
+	{
+		double q = h*h - r*r;
+		return factor * q*q*q;
+	}
+	else return 0;
+}
+
+static inline double W_sq_visco_factor(double h)
+{
+	return 45.0 / (CH_C_PI * pow(h,6));
+}
+
+static inline double W_sq_visco(double r, double h, double factor)
+{
+	if (r < h)
+	{
+		return factor * (h - r);
+	}
+	else return 0;
+}
+
+// the factor of the pressure gradient kernel is the same of W_sq_visco
+static inline void W_gr_press(ChVector<>& Wresult, const ChVector<>& r, const double r_length, const double h, double factor)
+{
+	if (r_length < h)
+	{
+		Wresult = r;
+		Wresult *= -factor * (h - r_length)*(h - r_length);
+	}
+	else Wresult = VNULL;
+}
+
+
+void ChMatterSPH::AccumulateCellListStep1()
+{
+	int nnodes = (int)nodes.size();
+	const collision::ChPeriodicDomain& periodic_domain = neighbor_search.GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
+
+	// Gather from the neighbors of each node: since each pair is listed for
+	// both nodes, each node writes only its own data, so no races.
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nnodes; i++)
+	{
+		ChNodeSPH* mnodeA = this->nodes[i].get_ptr();
+		int nneighbors = neighbor_search.GetNneighbors(i);
+		const int* neighbors = neighbor_search.GetNeighbors(i);
+
+		ChVector<> x_A = mnodeA->pos;
+		double h_A = mnodeA->h_rad;
+		double Wfactor_A = W_poly6_factor(h_A);
+
+		double density = 0;
+
+		for (int k = 0; k < nneighbors; k++)
+		{
+			ChNodeSPH* mnodeB = this->nodes[neighbors[k]].get_ptr();
+			double h_B = mnodeB->h_rad;
+
+			ChVector<> r_BA = mnodeB->pos - x_A;
+			if (periodic)
+				r_BA = periodic_domain.MinimumImage(r_BA);
+			double dist_BA = r_BA.Length();
+			double W_k_poly6 = W_poly6( dist_BA, h_A, Wfactor_A );
+			if (h_B != h_A)
+				W_k_poly6 = 0.5*(W_k_poly6 + W_poly6( dist_BA, h_B, W_poly6_factor(h_B) ));
+
+			density += mnodeB->GetMass() * W_k_poly6;
+		}
+
+		mnodeA->density += density;
+	}
+}
+
+void ChMatterSPH::AccumulateCellListStep2()
+{
+	int nnodes = (int)nodes.size();
+	double viscosity = this->material.Get_viscosity();
+	const collision::ChPeriodicDomain& periodic_domain = neighbor_search.GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nnodes; i++)
+	{
+		ChNodeSPH* mnodeA = this->nodes[i].get_ptr();
+		int nneighbors = neighbor_search.GetNneighbors(i);
+		const int* neighbors = neighbor_search.GetNeighbors(i);
+
+		ChVector<> x_A = mnodeA->pos;
+		ChVector<> v_A = mnodeA->pos_dt;
+		double h_A = mnodeA->h_rad;
+		double Vfactor_A = W_sq_visco_factor(h_A);
+
+		ChVector<> force = VNULL;
+
+		for (int k = 0; k < nneighbors; k++)
+		{
+			ChNodeSPH* mnodeB = this->nodes[neighbors[k]].get_ptr();
+			double h_B = mnodeB->h_rad;
+
+			ChVector<> r_BA = mnodeB->pos - x_A;
+			if (periodic)
+				r_BA = periodic_domain.MinimumImage(r_BA);
+			double dist_BA = r_BA.Length();
+
+			// pressure forces
+
+			ChVector<> W_k_press;
+			W_gr_press( W_k_press, r_BA, dist_BA, h_A, Vfactor_A );
+			double W_k_visc = W_sq_visco( dist_BA, h_A, Vfactor_A );
+			if (h_B != h_A)
+			{
+				double Vfactor_B = W_sq_visco_factor(h_B);
+				ChVector<> W_k_press_B;
+				W_gr_press( W_k_press_B, r_BA, dist_BA, h_B, Vfactor_B );
+				W_k_press = (W_k_press + W_k_press_B) * 0.5;
+				W_k_visc  = 0.5*(W_k_visc + W_sq_visco( dist_BA, h_B, Vfactor_B ));
+			}
+
+			double avg_press = 0.5*(mnodeA->pressure + mnodeB->pressure);
+
+			force += W_k_press * (mnodeA->volume * avg_press * mnodeB->volume);
+
+			// viscous forces
+
+			force += (mnodeB->pos_dt - v_A) * ( mnodeA->volume * viscosity * mnodeB->volume * W_k_visc );
+		}
+
+		mnodeA->UserForce += force;
+	}
+}
+
+
 void ChMatterSPH::VariablesFbLoadForces(double factor)
 {
 
 	// COMPUTE THE SPH FORCES HERE
 
-	// First, find if any ChProximityContainerSPH object is present
-	// in the system,
+	int nnodes = (int)nodes.size();
+
+	// First, find the near nodes: with the cell list of this cluster, or
+	// else with the ChProximityContainerSPH object that must be present
+	// in the system, where the collision engine stored the pairs.
 
 	ChProximityContainerSPH* edges =0;
-	std::list<ChPhysicsItem*>::iterator iterotherphysics = this->GetSystem()->Get_otherphysicslist()->begin();
-	while (iterotherphysics != this->GetSystem()->Get_otherphysicslist()->end())
+
+	if (this->use_cell_list)
 	{
-		if (edges=dynamic_cast<ChProximityContainerSPH*>(*iterotherphysics))
-			break;
-		iterotherphysics++;
+		std::vector< ChVector<> > points(nnodes);
+		std::vector< double > radii(nnodes);
+		for (int j = 0; j < nnodes; j++)
+		{
+			points[j] = this->nodes[j]->pos;
+			radii[j]  = this->nodes[j]->h_rad;
+		}
+		this->neighbor_search.SetPeriodicDomain(this->GetSystem()->GetPeriodicDomain());
+		this->neighbor_search.Update(points, radii);
+	}
+	else
+	{
+		std::list<ChPhysicsItem*>::iterator iterotherphysics = this->GetSystem()->Get_otherphysicslist()->begin();
+		while (iterotherphysics != this->GetSystem()->Get_otherphysicslist()->end())
+		{
+			if ((edges = dynamic_cast<ChProximityContainerSPH*>(*iterotherphysics)))
+				break;
+			iterotherphysics++;
+		}
+		assert(edges); // If using a ChMatterSPH, you must add also a ChProximityContainerSPH.
 	}
-	assert(edges); // If using a ChMatterSPH, you must add also a ChProximityContainerSPH.
 	
 
 	// 1- Per-node initialization
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
-		this->nodes[j]->UserForce = VNULL;
-		this->nodes[j]->density = 0;
+		ChNodeSPH* mnode = this->nodes[j].get_ptr();
+		mnode->UserForce = VNULL;
+		mnode->density = 0;
 	}
 
 	// 2- Per-edge initialization and accumulation of particles's density
 
-	edges->AccumulateStep1();
+	if (this->use_cell_list)
+		this->AccumulateCellListStep1();
+	else
+		edges->AccumulateStep1();
 
 	// 3- Per-node volume and pressure computation
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	double pressure_stiffness = this->material.Get_pressure_stiffness();
+	double ref_density = this->material.Get_density();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
-		ChSharedPtr<ChNodeSPH> mnode (this->nodes[j]);
-		assert(!mnode.IsNull());
+		ChNodeSPH* mnode = this->nodes[j].get_ptr();
 
 		// node volume is v=mass/density
 		if (mnode->density)
@@ -375,28 +616,32 @@ void ChMatterSPH::VariablesFbLoadForces(double factor)
 			mnode->volume = 0; 
 
 		// node pressure = k(dens - dens_0);
-		mnode->pressure = this->material.Get_pressure_stiffness() * ( mnode->density - this->material.Get_density() );
+		mnode->pressure = pressure_stiffness * ( mnode->density - ref_density );
 	}
 
 	// 4- Per-edge forces computation and accumulation
 
-	edges->AccumulateStep2();
+	if (this->use_cell_list)
+		this->AccumulateCellListStep2();
+	else
+		edges->AccumulateStep2();
 
 
 	// 5- Per-node load forces in LCP
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	ChVector<> G_acc = GetSystem()->Get_G_acc();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
+		ChNodeSPH* mnode = this->nodes[j].get_ptr();
+
 		// particle gyroscopic force:
 		// none.
 
 		// add gravity 
-		ChVector<> Gforce = GetSystem()->Get_G_acc() * this->nodes[j]->GetMass();
-		ChVector<> TotForce = this->nodes[j]->UserForce + Gforce; 
-
-		// downcast
-		ChSharedPtr<ChNodeSPH> mnode ( this->nodes[j]);
-		assert (!mnode.IsNull());
+		ChVector<> Gforce = G_acc * mnode->GetMass();
+		ChVector<> TotForce = mnode->UserForce + Gforce; 
 
 		mnode->variables.Get_fb().PasteSumVector(TotForce * factor ,0,0);
 	}
@@ -442,20 +687,39 @@ void ChMatterSPH::VariablesQbIncrementPosition(double dt_step)
 	//if (!this->IsActive()) 
 	//	return;
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	int nnodes = (int)nodes.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
+		ChNodeSPH* mnode = this->nodes[j].get_ptr();
+
 		// Updates position with incremental action of speed contained in the
 		// 'qb' vector:  pos' = pos + dt * speed   , like in an Eulero step.
 
-		ChVector<> newspeed = this->nodes[j]->variables.Get_qb().ClipVector(0,0);
+		ChVector<> newspeed = mnode->variables.Get_qb().ClipVector(0,0);
 
 		// ADVANCE POSITION: pos' = pos + dt * vel
-		this->nodes[j]->SetPos( this->nodes[j]->GetPos() + newspeed * dt_step);
+		mnode->SetPos( mnode->GetPos() + newspeed * dt_step);
 	}
 
 
 }
 
+void ChMatterSPH::WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain)
+{
+	int nnodes = (int)nodes.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
+	{
+		ChNodeSPH* mnode = this->nodes[j].get_ptr();
+		ChVector<> mpos = mnode->GetPos();
+		if (mdomain.Wrap(mpos))
+			mnode->SetPos(mpos);
+	}
+}
+
 
 
 //////////////
@@ -489,6 +753,17 @@ void ChMatterSPH::Update()
 						
 void ChMatterSPH::Update (double mytime)
 {	
+		// Reorder the nodes, if needed, once per time step: the contacts keep
+		// pointers to the nodes, and the forces are computed later, so a new
+		// order is safe here (not in SyncCollisionModels(), that is called
+		// also when the cluster is added to a system).
+	if (mytime > this->GetChTime() && this->reorder_interval > 0 && ++this->reorder_counter >= this->reorder_interval)
+	{
+		this->reorder_counter = 0;
+		if (this->reorder_locality <= 0 || this->GetLocality() < this->reorder_locality)
+			this->ReorderNodes();
+	}
+
 		// Inherit time changes of parent class
 	ChPhysicsItem::Update(mytime);
 
@@ -516,7 +791,14 @@ void ChMatterSPH::SetCollide (bool mcoll)
 	if (mcoll)
 	{
 		this->do_collide = true;
-		if (GetSystem())
+		if (this->use_cell_list)
+		{
+			// collision models are not kept when not colliding, so create them now
+			// (this also adds them to the collision engine, if already in a ChSystem)
+			for (unsigned int j = 0; j < nodes.size(); j++)
+				this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+		}
+		else if (GetSystem())
 		{
 			for (unsigned int j = 0; j < nodes.size(); j++)
 			{
@@ -531,17 +813,70 @@ void ChMatterSPH::SetCollide (bool mcoll)
 		{
 			for (unsigned int j = 0; j < nodes.size(); j++)
 			{
-				GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
+				if (this->nodes[j]->collision_model)
+					GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
 			}
 		}
+		if (this->use_cell_list)
+		{
+			for (unsigned int j = 0; j < nodes.size(); j++)
+				this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+		}
+	}
+}
+
+// Node positions, and the largest kernel radius as cell size
+static double GetNodePoints(const std::vector< ChSharedPtr<ChNodeSPH> >& nodes, std::vector< ChVector<> >& points)
+{
+	double cellsize = 0;
+	points.resize(nodes.size());
+	for (unsigned int j = 0; j < nodes.size(); j++)
+	{
+		points[j] = nodes[j]->pos;
+		cellsize = ChMax(cellsize, nodes[j]->h_rad);
+	}
+	return cellsize;
+}
+
+void ChMatterSPH::ReorderNodes()
+{
+	this->reorder_counter = 0;
+
+	if (nodes.size() < 2)
+		return;
+
+	std::vector< ChVector<> > points;
+	double cellsize = GetNodePoints(this->nodes, points);
+
+	std::vector<int> order;
+	ChNeighborSearch::ComputeMortonOrder(points, cellsize, order);
+
+	std::vector< ChSharedPtr<ChNodeSPH> > old_nodes(this->nodes);
+	for (unsigned int j = 0; j < nodes.size(); j++)
+	{
+		this->nodes[j] = old_nodes[order[j]];
+		if (this->nodes[j]->collision_model)
+			((ChModelBulletNode*)this->nodes[j]->collision_model)->SetNode(this,j);
 	}
+
+	if (this->reorder_callback)
+		this->reorder_callback->OnReorder(this, order);
+}
+
+double ChMatterSPH::GetLocality()
+{
+	std::vector< ChVector<> > points;
+	double cellsize = GetNodePoints(this->nodes, points);
+
+	return ChNeighborSearch::ComputeLocality(points, cellsize);
 }
 
 void ChMatterSPH::SyncCollisionModels()
 {
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->nodes[j]->collision_model->SyncPosition();
+		if (this->nodes[j]->collision_model)
+			this->nodes[j]->collision_model->SyncPosition();
 	}
 }
 
@@ -551,7 +886,8 @@ void ChMatterSPH::AddCollisionModelsToSystem()
 	SyncCollisionModels();
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Add(this->nodes[j]->collision_model);
+		if (this->nodes[j]->collision_model)
+			this->GetSystem()->GetCollisionSystem()->Add(this->nodes[j]->collision_model);
 	}
 }
 
@@ -560,7 +896,8 @@ void ChMatterSPH::RemoveCollisionModelsFromSystem()
 	assert(this->GetSystem());
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
+		if (this->nodes[j]->collision_model)
+			this->GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
 	}
 }
 
@@ -571,6 +908,8 @@ void ChMatterSPH::UpdateParticleCollisionModels()
 {
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
+		if (!this->nodes[j]->collision_model)
+			continue;
 		this->nodes[j]->collision_model->ClearModel();
 		//***TO DO*** UPDATE RADIUS OF SPHERE? this->nodes[j]->collision_model->AddCopyOfAnotherModel(this->particle_collision_model);
 		this->nodes[j]->collision_model->BuildModel();
@@ -34,9 +34,11 @@
 #include <math.h>
 
 #include "physics/ChIndexedNodes.h"
+#include "physics/ChReorderCallback.h"
 #include "physics/ChNodeXYZ.h"
 #include "physics/ChContinuumMaterial.h"
 #include "collision/ChCCollisionModel.h"
+#include "collision/ChCNeighborSearch.h"
 #include "lcp/ChLcpVariablesNode.h"
 
 
@@ -89,7 +91,9 @@ public:
 	
 	ChLcpVariablesNode  variables;
 
-	collision::ChCollisionModel*  collision_model;
+	collision::ChCollisionModel*  collision_model;	// can be NULL, if the cluster uses the cell list and does not collide
+
+	bool collide_neighbors;	// if true, the collision model also finds the near nodes (larger envelope)
 
 	ChVector<> UserForce;
 
@@ -175,6 +179,18 @@ private:
 
 	bool do_collide;
 
+	bool use_cell_list;
+	collision::ChNeighborSearch neighbor_search;
+
+	int reorder_interval;
+	int reorder_counter;
+	double reorder_locality;
+	ChReorderCallback* reorder_callback;
+
+	void SetupNodeCollisionModel(unsigned int j, double sphere_rad);
+	void AccumulateCellListStep1();
+	void AccumulateCellListStep2();
+
 public:
 
 			//
@@ -204,6 +220,24 @@ public:
 	void  SetCollide (bool mcoll);
 	bool  GetCollide() {return do_collide;}
 
+				/// If true, the nodes within the kernel radius of each node are
+				/// found with a ChNeighborSearch cell list, rebuilt at each step,
+				/// and the density, pressure and viscous forces are summed per
+				/// node, in parallel, instead of per pair by a
+				/// ChProximityContainerSPH (that is not needed then). The collision
+				/// engine does not search the pairs: the nodes have collision
+				/// models only if SetCollide(true), to collide with other objects.
+				/// Note that in this mode the nodes interact only with nodes of
+				/// the same cluster, and the kernels of two nodes with different
+				/// radii are averaged.
+				/// Default: false.
+	void  SetUseCellList (bool muse);
+	bool  GetUseCellList() {return use_cell_list;}
+
+				/// Access the cell list used when GetUseCellList() is true,
+				/// with the neighbors of the last step.
+	collision::ChNeighborSearch& GetNeighborSearch() {return neighbor_search;}
+
 
 			//
 	  		// FUNCTIONS
@@ -223,6 +257,37 @@ public:
 				/// vector as initial position.
 	void AddNode(ChVector<double> initial_state);
 
+				/// Sort the nodes along a space filling curve (Morton order)
+				/// of their positions, with cells as large as the kernel radius,
+				/// so that nodes that are near in space are also near in memory,
+				/// and the loops over nodes and neighbors make a better use of
+				/// caches. The node objects are not copied, so shared pointers
+				/// to nodes (ex. in links) remain valid, but their indexes change:
+				/// use SetReorderCallback() if you keep indexes of nodes.
+	void ReorderNodes();
+
+				/// Reorder the nodes automatically, as in ReorderNodes(),
+				/// every 'msteps' time steps (default 0, i.e. never).
+	void SetReorderInterval(int msteps) {reorder_interval = msteps;}
+	int  GetReorderInterval() {return reorder_interval;}
+
+				/// If larger than 0, the automatic reordering of SetReorderInterval()
+				/// is done only if GetLocality() is below this value, so the locality
+				/// is computed every 'msteps' time steps, not at each step (default 0,
+				/// i.e. always reorder). Ex. 0.5.
+	void   SetReorderLocality(double mthreshold) {reorder_locality = mthreshold;}
+	double GetReorderLocality() {return reorder_locality;}
+
+				/// Fraction of consecutive nodes that are also near in space,
+				/// within the kernel radius, from 0 to 1. It is close to 1
+				/// after ReorderNodes(), and drops as the material flows.
+	double GetLocality();
+
+				/// Set a callback that is called after each reordering of the
+				/// nodes, to update user data that refers to node indexes.
+				/// It is not deleted by the cluster. Use 0 to remove it.
+	void SetReorderCallback(ChReorderCallback* mcallback) {reorder_callback = mcallback;}
+
 
 
 		//
@@ -265,6 +330,9 @@ public:
 				/// Does not automatically update markers & forces.
 	void VariablesQbIncrementPosition(double step);
 
+				/// Move the nodes that left the periodic domain back into it.
+	void WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain);
+
 
 				/// Tell to a system descriptor that there are variables of type
 				/// ChLcpVariables in this object (for further passing it to a LCP solver)
@@ -29,6 +29,7 @@
 
 #include "physics/ChExternalObject.h"
 #include "collision/ChCModelBulletParticle.h"
+#include "collision/ChCNeighborSearch.h"
 #include "core/ChLinearAlgebra.h"
 
 #include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
@@ -132,6 +133,11 @@ ChParticlesClones::ChParticlesClones ()
 	sleep_starttime = 0;
 	sleep_minspeed = 0.1f;
 	sleep_minwvel = 0.04f; 
+
+	reorder_interval = 0;
+	reorder_counter = 0;
+	reorder_locality = 0;
+	reorder_callback = 0;
 }
 
 
@@ -171,6 +177,11 @@ void ChParticlesClones::Copy(ChParticlesClones* source)
 	sleep_starttime = source->sleep_starttime;
 	sleep_minspeed = source->sleep_minspeed;
 	sleep_minwvel = source->sleep_minwvel;
+
+	reorder_interval = source->reorder_interval;
+	reorder_counter = 0;
+	reorder_locality = source->reorder_locality;
+	reorder_callback = source->reorder_callback;
 }
 
 
@@ -334,6 +345,16 @@ void ChParticlesClones::VariablesQbIncrementPosition(double dt_step)
 	}
 }
 
+void ChParticlesClones::WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain)
+{
+	for (unsigned int j = 0; j < particles.size(); j++)
+	{
+		ChVector<> mpos = this->particles[j]->GetPos();
+		if (mdomain.Wrap(mpos))
+			this->particles[j]->SetPos(mpos);
+	}
+}
+
 
 
 //////////////
@@ -433,6 +454,17 @@ void ChParticlesClones::Update()
 						
 void ChParticlesClones::Update (double mytime)
 {	
+	// Reorder the particles, if needed, once per time step: the contacts keep
+	// pointers to the particles, so a new order is safe here (not in
+	// SyncCollisionModels(), that is called also when the cluster is added
+	// to a system).
+	if (mytime > ChTime && reorder_interval > 0 && ++reorder_counter >= reorder_interval)
+	{
+		reorder_counter = 0;
+		if (reorder_locality <= 0 || GetLocality() < reorder_locality)
+			ReorderParticles();
+	}
+
 	ChTime = mytime;
 
 	//TrySleeping();			// See if the body can fall asleep; if so, put it to sleeping 
@@ -460,12 +492,7 @@ void ChParticlesClones::SetCollide (bool mcoll)
 	{
 		this->do_collide = true;
 		if (GetSystem())
-		{
-			for (unsigned int j = 0; j < particles.size(); j++)
-			{
-				GetSystem()->GetCollisionSystem()->Add(this->particles[j]->collision_model);
-			}
-		}
+			AddCollisionModelsToSystem();
 	}
 	else 
 	{
@@ -480,6 +507,41 @@ void ChParticlesClones::SetCollide (bool mcoll)
 	}
 }
 
+void ChParticlesClones::ReorderParticles()
+{
+	reorder_counter = 0;
+
+	unsigned int n = (unsigned int)particles.size();
+	if (n < 2)
+		return;
+
+	std::vector< ChVector<> > points(n);
+	for (unsigned int j = 0; j < n; j++)
+		points[j] = particles[j]->GetPos();
+
+	std::vector<int> order;
+	ChNeighborSearch::ComputeMortonOrder(points, 0, order);
+
+	std::vector<ChAparticle*> old_particles(particles);
+	for (unsigned int j = 0; j < n; j++)
+	{
+		particles[j] = old_particles[order[j]];
+		((ChModelBulletParticle*)particles[j]->collision_model)->SetParticle(this,j);
+	}
+
+	if (reorder_callback)
+		reorder_callback->OnReorder(this, order);
+}
+
+double ChParticlesClones::GetLocality()
+{
+	std::vector< ChVector<> > points(particles.size());
+	for (unsigned int j = 0; j < particles.size(); j++)
+		points[j] = particles[j]->GetPos();
+
+	return ChNeighborSearch::ComputeLocality(points, 0);
+}
+
 void ChParticlesClones::SyncCollisionModels()
 {
 	for (unsigned int j = 0; j < particles.size(); j++)
@@ -492,19 +554,23 @@ void ChParticlesClones::AddCollisionModelsToSystem()
 {
 	assert(this->GetSystem());
 	SyncCollisionModels();
+	std::vector<ChCollisionModel*> models(particles.size());
 	for (unsigned int j = 0; j < particles.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Add(this->particles[j]->collision_model);
+		models[j] = this->particles[j]->collision_model;
 	}
+	this->GetSystem()->GetCollisionSystem()->AddBatch(models);
 }
 
 void ChParticlesClones::RemoveCollisionModelsFromSystem() 
 {
 	assert(this->GetSystem());
+	std::vector<ChCollisionModel*> models(particles.size());
 	for (unsigned int j = 0; j < particles.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Remove(this->particles[j]->collision_model);
+		models[j] = this->particles[j]->collision_model;
 	}
+	this->GetSystem()->GetCollisionSystem()->RemoveBatch(models);
 }
 
 
@@ -32,6 +32,7 @@
 #include <math.h>
 
 #include "physics/ChIndexedParticles.h"
+#include "physics/ChReorderCallback.h"
 #include "collision/ChCCollisionModel.h"
 #include "lcp/ChLcpVariablesBodySharedMass.h"
 #include "physics/ChMaterialSurface.h"
@@ -119,6 +120,11 @@ private:
 	float  sleep_minwvel;
 	float  sleep_starttime;
 
+	int reorder_interval;
+	int reorder_counter;
+	double reorder_locality;
+	ChReorderCallback* reorder_callback;
+
 public:
 
 			//
@@ -179,6 +185,35 @@ public:
 				/// before adding particles!
 	void AddParticle(ChCoordsys<double> initial_state = CSYSNORM);
 
+				/// Sort the particles along a space filling curve (Morton order)
+				/// of their positions, so that particles that are near in space
+				/// are also near in memory, and the loops over particles make
+				/// a better use of caches. The particle objects are not copied,
+				/// only their indexes change: call this only when you do not
+				/// keep indexes of particles, or use SetReorderCallback().
+	void ReorderParticles();
+
+				/// Reorder the particles automatically, as in ReorderParticles(),
+				/// every 'msteps' time steps (default 0, i.e. never).
+	void SetReorderInterval(int msteps) {reorder_interval = msteps;}
+	int  GetReorderInterval() {return reorder_interval;}
+
+				/// If larger than 0, the automatic reordering of SetReorderInterval()
+				/// is done only if GetLocality() is below this value, so the locality
+				/// is computed every 'msteps' time steps, not at each step (default 0,
+				/// i.e. always reorder). Ex. 0.5.
+	void   SetReorderLocality(double mthreshold) {reorder_locality = mthreshold;}
+	double GetReorderLocality() {return reorder_locality;}
+
+				/// Fraction of consecutive particles that are also near in space,
+				/// from 0 to 1. It is close to 1 after ReorderParticles().
+	double GetLocality();
+
+				/// Set a callback that is called after each reordering of the
+				/// particles, to update user data that refers to particle indexes.
+				/// It is not deleted by the cluster. Use 0 to remove it.
+	void SetReorderCallback(ChReorderCallback* mcallback) {reorder_callback = mcallback;}
+
 
 
 			 // Override/implement LCP system functions of ChPhysicsItem
@@ -217,6 +252,9 @@ public:
 				/// Does not automatically update markers & forces.
 	void VariablesQbIncrementPosition(double step);
 
+				/// Move the particles that left the periodic domain back into it.
+	void WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain);
+
 
 				/// Tell to a system descriptor that there are variables of type
 				/// ChLcpVariables in this object (for further passing it to a LCP solver)
@@ -0,0 +1,548 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChParticlesClonesSoA.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "physics/ChParticlesClonesSoA.h"
+#include "physics/ChSystem.h"
+#include "physics/ChGlobal.h"
+
+#include "collision/ChCModelBulletParticleSoA.h"
+
+#include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
+
+namespace chrono
+{
+
+using namespace collision;
+using namespace geometry;
+
+
+// Register into the object factory, to enable run-time
+// dynamic creation and persistence
+ChClassRegister<ChParticlesClonesSoA> a_registration_ChParticlesClonesSoA;
+
+
+
+ChParticlesClonesSoA::ChParticlesClonesSoA ()
+{
+	do_collide = false;
+
+	variables = 0;
+	variables_capacity = 0;
+
+	this->SetMass(1.0);
+	this->SetInertiaXX(ChVector<double>(1.0,1.0,1.0));
+	this->SetInertiaXY(ChVector<double>(0,0,0));
+
+	particle_collision_model = new ChModelBulletParticleSoA();
+	particle_collision_model->SetParticle(this,9999999);
+
+	matsurface = ChSharedPtr<ChMaterialSurface>(new ChMaterialSurface);
+
+	SetIdentifier(GetUniqueIntID()); // mark with unique ID
+}
+
+
+ChParticlesClonesSoA::~ChParticlesClonesSoA ()
+{
+	this->ResizeNparticles(0);
+
+	if (variables)
+		delete[] variables;
+	variables = 0;
+
+	if (particle_collision_model)
+		delete particle_collision_model;
+	particle_collision_model = 0;
+}
+
+void ChParticlesClonesSoA::Copy(ChParticlesClonesSoA* source)
+{
+		// copy the parent class data...
+	ChPhysicsItem::Copy(source);
+
+	this->SetCollide(false);
+
+	this->SetMass(source->GetMass());
+	this->SetInertiaXX(source->GetInertiaXX());
+	this->SetInertiaXY(source->GetInertiaXY());
+
+	particle_collision_model->ClearModel();
+
+	this->matsurface = source->matsurface;  // also copy-duplicate the material? Let the user handle this..
+
+	ResizeNparticles((int)source->GetNparticles());
+
+	pos		= source->pos;
+	rot		= source->rot;
+	pos_dt	= source->pos_dt;
+	wvel_loc= source->wvel_loc;
+	user_force  = source->user_force;
+	user_torque = source->user_torque;
+
+	this->SetCollide(source->do_collide);
+}
+
+
+
+void ChParticlesClonesSoA::ReserveVariables(unsigned int mcapacity)
+{
+	if (mcapacity <= variables_capacity)
+		return;
+
+	// Grow by doubling, so that adding particles one by one is amortized O(1).
+	// Pointers to the old variables are not valid after this, but they
+	// are injected again in the LCP descriptor at each step.
+	unsigned int newcapacity = std::max(mcapacity, 2*variables_capacity);
+	ChLcpVariablesBodySharedMass* newvariables = new ChLcpVariablesBodySharedMass[newcapacity];
+
+	for (unsigned int j = 0; j < newcapacity; j++)
+	{
+		if (j < variables_capacity)
+			newvariables[j] = variables[j];
+		newvariables[j].SetSharedMass(&this->particle_mass);
+		newvariables[j].SetUserData((void*)this);
+	}
+
+	if (variables)
+		delete[] variables;
+	variables = newvariables;
+	variables_capacity = newcapacity;
+}
+
+void ChParticlesClonesSoA::ReserveNparticles(unsigned int mcapacity)
+{
+	pos.reserve(mcapacity);
+	rot.reserve(mcapacity);
+	pos_dt.reserve(mcapacity);
+	wvel_loc.reserve(mcapacity);
+	user_force.reserve(mcapacity);
+	user_torque.reserve(mcapacity);
+	if (do_collide)
+		collision_models.reserve(mcapacity);
+
+	ReserveVariables(mcapacity);
+}
+
+
+void ChParticlesClonesSoA::ResizeNparticles(int newsize)
+{
+	bool oldcoll = this->GetCollide();
+	this->SetCollide(false); // this will remove and delete old particle coll.models, if any
+
+	pos.clear();
+	rot.clear();
+	pos_dt.clear();
+	wvel_loc.clear();
+	user_force.clear();
+	user_torque.clear();
+
+	pos.resize(newsize, VNULL);
+	rot.resize(newsize, QUNIT);
+	pos_dt.resize(newsize, VNULL);
+	wvel_loc.resize(newsize, VNULL);
+	user_force.resize(newsize, VNULL);
+	user_torque.resize(newsize, VNULL);
+
+	if (newsize == 0)
+	{
+		if (variables)
+			delete[] variables;
+		variables = 0;
+		variables_capacity = 0;
+	}
+	ReserveVariables(newsize);
+	for (int j = 0; j < newsize; j++)
+		variables[j].Get_qb().FillElem(0.0);
+
+	this->SetCollide(oldcoll); // this will also create particle coll.models and add them to coll.engine, if already in a ChSystem
+}
+
+
+void ChParticlesClonesSoA::AddParticle(ChCoordsys<double> initial_state)
+{
+	unsigned int id = (unsigned int)pos.size();
+
+	ReserveVariables(id+1);
+	variables[id].Get_qb().FillElem(0.0);
+
+	pos.push_back(initial_state.pos);
+	rot.push_back(initial_state.rot);
+	pos_dt.push_back(VNULL);
+	wvel_loc.push_back(VNULL);
+	user_force.push_back(VNULL);
+	user_torque.push_back(VNULL);
+
+	if (do_collide)
+	{
+		ChModelBulletParticleSoA* newmodel = new ChModelBulletParticleSoA;
+		newmodel->SetParticle(this, id);
+		newmodel->SetSampleModel(this->particle_collision_model);
+		collision_models.push_back(newmodel);
+
+		if (GetSystem())
+		{
+			newmodel->SyncPosition();
+			GetSystem()->GetCollisionSystem()->Add(newmodel);
+		}
+	}
+}
+
+
+
+////
+void ChParticlesClonesSoA::InjectVariables(ChLcpSystemDescriptor& mdescriptor)
+{
+	for (unsigned int j = 0; j < pos.size(); j++)
+	{
+		mdescriptor.InsertVariables(&(this->variables[j]));
+	}
+}
+
+
+void ChParticlesClonesSoA::VariablesFbReset()
+{
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		this->variables[j].Get_fb().FillElem(0.0);
+	}
+}
+
+void ChParticlesClonesSoA::VariablesFbLoadForces(double factor)
+{
+	ChVector<> Gforce;
+	if (GetSystem())
+		Gforce = GetSystem()->Get_G_acc() * this->particle_mass.GetBodyMass();
+
+	const ChMatrix33<>& inertia = this->particle_mass.GetBodyInertia();
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		// particle gyroscopic force:
+		const ChVector<>& Wvel = this->wvel_loc[j];
+		ChVector<> gyro = Vcross (Wvel, inertia.Matr_x_Vect (Wvel));
+
+		// add applied forces and torques (and also the gyroscopic torque and gravity!) to 'fb' vector
+		this->variables[j].Get_fb().PasteSumVector((this->user_force[j] + Gforce) * factor ,0,0);
+		this->variables[j].Get_fb().PasteSumVector((this->user_torque[j] - gyro)  * factor ,3,0);
+	}
+}
+
+
+void ChParticlesClonesSoA::VariablesQbLoadSpeed()
+{
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		// set current speed in 'qb', it can be used by the LCP solver when working in incremental mode
+		this->variables[j].Get_qb().PasteVector(this->pos_dt[j]  ,0,0);
+		this->variables[j].Get_qb().PasteVector(this->wvel_loc[j],3,0);
+	}
+}
+
+void ChParticlesClonesSoA::VariablesFbIncrementMq()
+{
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		this->variables[j].Compute_inc_Mb_v(this->variables[j].Get_fb(), this->variables[j].Get_qb());
+	}
+}
+
+void ChParticlesClonesSoA::VariablesQbSetSpeed(double step)
+{
+	int n = (int)pos.size();
+
+	// Accelerations are not stored, so 'step' is not used.
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		// from 'qb' vector, sets particle speed
+		this->pos_dt[j]   = this->variables[j].Get_qb().ClipVector(0,0);
+		this->wvel_loc[j] = this->variables[j].Get_qb().ClipVector(3,0);
+	}
+}
+
+void ChParticlesClonesSoA::VariablesQbIncrementPosition(double dt_step)
+{
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		// Updates position with incremental action of speed contained in the
+		// 'qb' vector:  pos' = pos + dt * speed   , like in an Eulero step.
+
+		ChVector<> newspeed = this->variables[j].Get_qb().ClipVector(0,0);
+		ChVector<> newwel   = this->variables[j].Get_qb().ClipVector(3,0);
+
+		// ADVANCE POSITION: pos' = pos + dt * vel
+		this->pos[j] += newspeed * dt_step;
+
+		// ADVANCE ROTATION: rot' = [dt*wwel]%rot  (use quaternion for delta rotation)
+		ChQuaternion<> mdeltarot;
+		ChVector<> newwel_abs = this->rot[j].Rotate(newwel);
+		double mangle = newwel_abs.Length() * dt_step;
+		newwel_abs.Normalize();
+		mdeltarot.Q_from_AngAxis(mangle, newwel_abs);
+		this->rot[j] = mdeltarot % this->rot[j];
+	}
+}
+
+void ChParticlesClonesSoA::WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain)
+{
+	int n = (int)pos.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+		mdomain.Wrap(this->pos[j]);
+}
+
+
+
+//////////////
+
+
+void ChParticlesClonesSoA::SetNoSpeedNoAcceleration()
+{
+	std::fill(pos_dt.begin(),   pos_dt.end(),   VNULL);
+	std::fill(wvel_loc.begin(), wvel_loc.end(), VNULL);
+}
+
+
+
+
+////
+// The inertia tensor functions
+
+void ChParticlesClonesSoA::SetInertia (const ChMatrix33<>& newXInertia)
+{
+	this->particle_mass.SetBodyInertia(newXInertia);
+}
+
+void ChParticlesClonesSoA::SetInertiaXX (const ChVector<>& iner)
+{
+	this->particle_mass.GetBodyInertia().SetElement(0,0,iner.x);
+	this->particle_mass.GetBodyInertia().SetElement(1,1,iner.y);
+	this->particle_mass.GetBodyInertia().SetElement(2,2,iner.z);
+	this->particle_mass.GetBodyInertia().FastInvert(&this->particle_mass.GetBodyInvInertia());
+}
+void ChParticlesClonesSoA::SetInertiaXY (const ChVector<>& iner)
+{
+	this->particle_mass.GetBodyInertia().SetElement(0,1,iner.x);
+	this->particle_mass.GetBodyInertia().SetElement(0,2,iner.y);
+	this->particle_mass.GetBodyInertia().SetElement(1,2,iner.z);
+	this->particle_mass.GetBodyInertia().SetElement(1,0,iner.x);
+	this->particle_mass.GetBodyInertia().SetElement(2,0,iner.y);
+	this->particle_mass.GetBodyInertia().SetElement(2,1,iner.z);
+	this->particle_mass.GetBodyInertia().FastInvert(&this->particle_mass.GetBodyInvInertia());
+}
+
+ChVector<> ChParticlesClonesSoA::GetInertiaXX()
+{
+	ChVector<> iner;
+	iner.x= this->particle_mass.GetBodyInertia().GetElement(0,0);
+	iner.y= this->particle_mass.GetBodyInertia().GetElement(1,1);
+	iner.z= this->particle_mass.GetBodyInertia().GetElement(2,2);
+	return iner;
+}
+
+ChVector<> ChParticlesClonesSoA::GetInertiaXY()
+{
+	ChVector<> iner;
+	iner.x= this->particle_mass.GetBodyInertia().GetElement(0,1);
+	iner.y= this->particle_mass.GetBodyInertia().GetElement(0,2);
+	iner.z= this->particle_mass.GetBodyInertia().GetElement(1,2);
+	return iner;
+}
+
+
+
+
+// collision stuff
+
+void ChParticlesClonesSoA::CreateCollisionModels()
+{
+	collision_models.resize(pos.size());
+	for (unsigned int j = 0; j < pos.size(); j++)
+	{
+		collision_models[j] = new ChModelBulletParticleSoA;
+		collision_models[j]->SetParticle(this, j);
+		collision_models[j]->SetSampleModel(this->particle_collision_model);
+	}
+}
+
+void ChParticlesClonesSoA::DeleteCollisionModels()
+{
+	for (unsigned int j = 0; j < collision_models.size(); j++)
+		delete collision_models[j];
+	collision_models.clear();
+	std::vector<ChModelBulletParticleSoA*>().swap(collision_models); // release memory
+}
+
+void ChParticlesClonesSoA::SetCollide (bool mcoll)
+{
+	if (mcoll == this->do_collide)
+		return;
+
+	if (mcoll)
+	{
+		this->do_collide = true;
+		CreateCollisionModels();
+		if (GetSystem())
+			AddCollisionModelsToSystem();
+	}
+	else
+	{
+		if (GetSystem())
+			RemoveCollisionModelsFromSystem();
+		this->do_collide = false;
+		DeleteCollisionModels();
+	}
+}
+
+void ChParticlesClonesSoA::SyncCollisionModels()
+{
+	int n = (int)collision_models.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < n; j++)
+	{
+		this->collision_models[j]->SyncPosition();
+	}
+}
+
+void ChParticlesClonesSoA::AddCollisionModelsToSystem()
+{
+	assert(this->GetSystem());
+	SyncCollisionModels();
+	std::vector<ChCollisionModel*> models(collision_models.begin(), collision_models.end());
+	this->GetSystem()->GetCollisionSystem()->AddBatch(models);
+}
+
+void ChParticlesClonesSoA::RemoveCollisionModelsFromSystem()
+{
+	assert(this->GetSystem());
+	std::vector<ChCollisionModel*> models(collision_models.begin(), collision_models.end());
+	this->GetSystem()->GetCollisionSystem()->RemoveBatch(models);
+}
+
+
+////
+
+void ChParticlesClonesSoA::UpdateParticleCollisionModels()
+{
+	if (!do_collide)
+		return;
+
+	// The broadphase must see the new bounding boxes, so re-insert the models.
+	if (GetSystem())
+		RemoveCollisionModelsFromSystem();
+
+	for (unsigned int j = 0; j < collision_models.size(); j++)
+	{
+		this->collision_models[j]->SetSampleModel(this->particle_collision_model);
+	}
+
+	if (GetSystem())
+		AddCollisionModelsToSystem();
+}
+
+
+
+
+//////// FILE I/O
+
+void ChParticlesClonesSoA::StreamOUT(ChStreamOutBinary& mstream)
+{
+			// class version number
+	mstream.VersionWrite(1);
+
+		// serialize parent class too
+	ChPhysicsItem::StreamOUT(mstream);
+
+		// stream out all member data
+	ChVector<> vfoo;
+	mstream << this->GetMass();
+	vfoo = GetInertiaXX();	mstream << vfoo;
+	vfoo = GetInertiaXY();	mstream << vfoo;
+
+	mstream << (int)pos.size();
+	for (unsigned int j = 0; j < pos.size(); j++)
+	{
+		mstream << pos[j];
+		mstream << rot[j];
+		mstream << pos_dt[j];
+		mstream << wvel_loc[j];
+	}
+
+	//***TO DO*** stream collision model
+}
+
+void ChParticlesClonesSoA::StreamIN(ChStreamInBinary& mstream)
+{
+		// class version number
+	int version = mstream.VersionRead();
+
+		// deserialize parent class too
+	ChPhysicsItem::StreamIN(mstream);
+
+		// stream in all member data
+	double dfoo;
+	ChVector<> vfoo;
+	mstream >> dfoo;	this->SetMass(dfoo);
+	mstream >> vfoo;	this->SetInertiaXX(vfoo);
+	mstream >> vfoo;	this->SetInertiaXY(vfoo);
+
+	int n;
+	mstream >> n;
+	this->ResizeNparticles(n);
+	for (int j = 0; j < n; j++)
+	{
+		mstream >> pos[j];
+		mstream >> rot[j];
+		mstream >> pos_dt[j];
+		mstream >> wvel_loc[j];
+	}
+
+	//***TO DO*** unstream collision model
+}
+
+
+
+
+
+
+} // END_OF_NAMESPACE____
+
+
+/////////////////////
@@ -0,0 +1,308 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHPARTICLESCLONESSOA_H
+#define CHPARTICLESCLONESSOA_H
+
+//////////////////////////////////////////////////
+//
+//   ChParticlesClonesSoA.h
+//
+//   Class for clusters of particle 'clones', that is many
+//   rigid objects that share the same shape and mass,
+//   stored as arrays of states (structure of arrays).
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <vector>
+
+#include "physics/ChPhysicsItem.h"
+#include "collision/ChCModelBulletParticleSoA.h"
+#include "lcp/ChLcpVariablesBodySharedMass.h"
+#include "physics/ChMaterialSurface.h"
+
+
+namespace chrono
+{
+
+// Forward references (for parent hierarchy pointer)
+
+class ChSystem;
+
+
+/// Class for clusters of 'clone' particles, that is many
+/// rigid objects with the same shape and mass, as ChParticlesClones,
+/// but where there is no object per particle: positions, rotations,
+/// speeds and applied forces of all particles are stored in
+/// contiguous arrays, the LCP variables are in a single array, and
+/// all particles share the collision shape of the sample model.
+/// A lightweight collision model, that does not own shapes, is
+/// created for each particle only when the collision is enabled.
+/// This takes few hundreds of bytes per particle, so it can be used
+/// for granular flows with millions of particles.
+/// Notes:
+/// - contacts are created by the default ChContactContainer, as for
+///   ChParticlesClones, that is with the DVI approach;
+/// - there is no speed clamping and no sleeping; accelerations are
+///   not stored.
+
+class ChApi ChParticlesClonesSoA : public ChPhysicsItem
+{
+						// Chrono simulation of RTTI, needed for serialization
+	CH_RTTI(ChParticlesClonesSoA,ChPhysicsItem);
+
+private:
+			//
+	  		// DATA
+			//
+
+						// The states of the particles:
+	std::vector< ChVector<> >		pos;
+	std::vector< ChQuaternion<> >	rot;
+	std::vector< ChVector<> >		pos_dt;
+	std::vector< ChVector<> >		wvel_loc;	// angular speeds, in particle coords
+
+						// Forces and torques applied by the user
+	std::vector< ChVector<> >		user_force;
+	std::vector< ChVector<> >		user_torque;
+
+						// LCP variables of the particles, in a single array
+	ChLcpVariablesBodySharedMass*	variables;
+	unsigned int					variables_capacity;
+
+						// Collision models of the particles, only if collision is on
+	std::vector<collision::ChModelBulletParticleSoA*> collision_models;
+
+						// Shared mass of particles
+	ChSharedMassBody		 particle_mass;
+
+						// Sample collision model
+	collision::ChModelBulletParticleSoA*  particle_collision_model;
+
+	bool do_collide;
+
+						// data for surface contact and impact (can be shared):
+	ChSharedPtr<ChMaterialSurface> matsurface;
+
+	void ReserveVariables(unsigned int mcapacity);
+	void CreateCollisionModels();
+	void DeleteCollisionModels();
+
+public:
+
+			//
+	  		// CONSTRUCTORS
+			//
+
+				/// Build a cluster of particles.
+				/// By default the cluster will contain 0 particles.
+	ChParticlesClonesSoA ();
+
+				/// Destructor
+	~ChParticlesClonesSoA ();
+
+				/// Copy from another ChParticlesClonesSoA.
+	void Copy(ChParticlesClonesSoA* source);
+
+
+			//
+	  		// FLAGS
+			//
+
+
+				/// Enable/disable the collision for this cluster of particles.
+				/// When enabled, a collision model is created for each particle,
+				/// referencing the shape of the sample collision model: so define
+				/// the shape using GetCollisionModel()-> before enabling the collision.
+	void  SetCollide (bool mcoll);
+	virtual bool GetCollide() {return do_collide;}
+
+
+			//
+	  		// FUNCTIONS
+			//
+
+				/// Get the number of particles
+	size_t GetNparticles() const {return pos.size();}
+
+				/// Resize the particle cluster. Also clear the state of
+				/// previously created particles, if any.
+	void ResizeNparticles(int newsize);
+
+				/// Add a new particle to the particle cluster, passing a
+				/// coordinate system as initial state.
+	void AddParticle(ChCoordsys<double> initial_state = CSYSNORM);
+
+				/// Reserve memory for 'mcapacity' particles, to avoid
+				/// reallocations when adding many particles with AddParticle()
+	void ReserveNparticles(unsigned int mcapacity);
+
+
+				/// Access the position of the N-th particle
+	const ChVector<>& GetParticlePos(unsigned int n) const {return pos[n];}
+	void SetParticlePos(unsigned int n, const ChVector<>& mpos) {pos[n] = mpos;}
+
+				/// Access the rotation of the N-th particle
+	const ChQuaternion<>& GetParticleRot(unsigned int n) const {return rot[n];}
+	void SetParticleRot(unsigned int n, const ChQuaternion<>& mrot) {rot[n] = mrot;}
+
+				/// Access the speed of the N-th particle
+	const ChVector<>& GetParticlePos_dt(unsigned int n) const {return pos_dt[n];}
+	void SetParticlePos_dt(unsigned int n, const ChVector<>& mvel) {pos_dt[n] = mvel;}
+
+				/// Access the angular speed of the N-th particle, in particle coordinates
+	const ChVector<>& GetParticleWvel_loc(unsigned int n) const {return wvel_loc[n];}
+	void SetParticleWvel_loc(unsigned int n, const ChVector<>& mwvel) {wvel_loc[n] = mwvel;}
+
+				/// Get the position and rotation of the N-th particle as a frame
+	ChFrame<> GetParticleFrame(unsigned int n) const {return ChFrame<>(pos[n], rot[n]);}
+
+				/// Access the force applied by the user to the N-th particle, in
+				/// absolute coordinates. It is not reset after each step.
+	ChVector<>& ParticleForce(unsigned int n) {return user_force[n];}
+				/// Access the torque applied by the user to the N-th particle, in
+				/// particle coordinates. It is not reset after each step.
+	ChVector<>& ParticleTorque(unsigned int n) {return user_torque[n];}
+
+				/// Access the LCP variables of the N-th particle
+	ChLcpVariablesBodySharedMass& GetParticleVariables(unsigned int n) {return variables[n];}
+
+				/// Direct access to the arrays of the states, for bulk operations
+				/// (ex. initialization, output). Do not resize them.
+	std::vector< ChVector<> >&		GetPositions() {return pos;}
+	std::vector< ChQuaternion<> >&	GetRotations() {return rot;}
+	std::vector< ChVector<> >&		GetSpeeds() {return pos_dt;}
+	std::vector< ChVector<> >&		GetAngularSpeeds() {return wvel_loc;}
+	std::vector< ChVector<> >&		GetForces() {return user_force;}
+	std::vector< ChVector<> >&		GetTorques() {return user_torque;}
+
+				/// Number of coordinates of the particle cluster
+	virtual int GetDOF  ()   {return 6*(int)GetNparticles();}
+
+				/// Get the coordinate systems of the particles, for the assets
+	virtual ChFrame<> GetAssetsFrame(unsigned int nclone=0) {return GetParticleFrame(nclone);}
+	virtual unsigned int GetAssetsFrameNclones() {return (unsigned int)GetNparticles();}
+
+
+			 // Override/implement LCP system functions of ChPhysicsItem
+			 // (to assembly/manage data for LCP system solver).
+			 // All these work on the arrays of particles, in parallel.
+
+				/// Sets the 'fb' part of the LCP variables to zero.
+	void VariablesFbReset();
+
+				/// Adds the current forces applied to particles (including gyroscopic torque
+				/// and gravity) in the 'fb' part: qf+=forces*factor
+	void VariablesFbLoadForces(double factor=1.);
+
+				/// Initialize the 'qb' part of the LCP variables with the
+				/// current value of particle speeds.
+	void VariablesQbLoadSpeed();
+
+				/// Adds M*q (masses multiplied current 'qb') to Fb
+	void VariablesFbIncrementMq();
+
+				/// Fetches the particle speeds from the 'qb' part of the LCP variables.
+	void VariablesQbSetSpeed(double step=0.);
+
+				/// Increment particle positions by the 'qb' part of the LCP variables,
+				/// multiplied by a 'step' factor.
+				///     pos+=qb*step
+	void VariablesQbIncrementPosition(double step);
+
+				/// Move the particles that left the periodic domain back into it.
+	void WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain);
+
+				/// Tell to a system descriptor that there are variables of type
+				/// ChLcpVariables in this object (for further passing it to a LCP solver)
+	virtual void InjectVariables(ChLcpSystemDescriptor& mdescriptor);
+
+
+			   // Other functions
+
+				/// Set no speed and no accelerations (but does not change the position)
+	void SetNoSpeedNoAcceleration();
+
+				/// Access the collision model for the collision engine: this is the 'sample'
+				/// collision model whose shape is used by all particles.
+	collision::ChCollisionModel* GetCollisionModel() {return particle_collision_model;}
+
+				/// Synchronize coll.models coordinates and bounding boxes to the positions of the particles.
+	virtual void SyncCollisionModels();
+	virtual void AddCollisionModelsToSystem();
+	virtual void RemoveCollisionModelsFromSystem();
+
+				/// After you changed the shapes of the sample coll.model (the one
+				/// that you access with GetCollisionModel() ) you need to call this
+				/// function so that all collision models of particles will reference it.
+	void UpdateParticleCollisionModels();
+
+
+				/// Access the material surface properties, referenced by this
+				/// particle cluster. The material surface contains properties such as friction, etc.
+	ChSharedPtr<ChMaterialSurface>& GetMaterialSurface() {return this->matsurface;}
+				/// Set the material surface properties by passing a ChMaterialSurface object.
+	void SetMaterialSurface(ChSharedPtr<ChMaterialSurface>& mnewsurf) {this->matsurface = mnewsurf;}
+
+
+				/// Mass of each particle. Must be positive.
+	void   SetMass (double newmass) { if (newmass>0.) this->particle_mass.SetBodyMass(newmass);}
+	double GetMass() {return this->particle_mass.GetBodyMass();}
+
+				/// Set the inertia tensor of each particle
+	void SetInertia (const ChMatrix33<>& newXInertia);
+				/// Set the diagonal part of the inertia tensor of each particle
+	void SetInertiaXX (const ChVector<>& iner);
+				/// Get the diagonal part of the inertia tensor of each particle
+	ChVector<> GetInertiaXX();
+				/// Set the extradiagonal part of the inertia tensor of each particle
+				/// (xy, yz, zx values, the rest is symmetric)
+	void SetInertiaXY (const ChVector<>& iner);
+				/// Get the extradiagonal part of the inertia tensor of each particle
+				/// (xy, yz, zx values, the rest is symmetric)
+	ChVector<> GetInertiaXY();
+
+
+			//
+			// STREAMING
+			//
+
+
+				/// Method to allow deserializing a persistent binary archive (ex: a file)
+				/// into transient data.
+	void StreamIN(ChStreamInBinary& mstream);
+
+				/// Method to allow serializing transient data into a persistent
+				/// binary archive (ex: a file).
+	void StreamOUT(ChStreamOutBinary& mstream);
+
+
+};
+
+
+
+
+typedef ChSharedPtr<ChParticlesClonesSoA> ChSharedParticlesClonesSoAPtr;
+
+
+
+} // END_OF_NAMESPACE____
+
+
+#endif
@@ -37,6 +37,7 @@
 #include "assets/ChAsset.h"
 #include "lcp/ChLcpSystemDescriptor.h"
 #include "collision/ChCCollisionModel.h"
+#include "collision/ChCPeriodicDomain.h"
 
 
 namespace chrono
@@ -232,6 +233,13 @@ public:
 				/// timestepping schemes that do: M*v_new = M*v_old + forces*dt
 	virtual void VariablesFbIncrementMq() {};
 
+				/// Called by the time integrators of the dynamics, not by static or
+				/// kinematic analyses, after the known terms were loaded, with the
+				/// actual time step. Items that advance some of their variables with
+				/// substeps of their own (ex. the explicit subcycling of a FEM mesh)
+				/// can overwrite here the 'fb' of those variables with M*v_end.
+	virtual void VariablesFbLoadSubsteps(double step) {};
+
 				/// Fetches the item speed (ex. linear and angular vel.in rigid bodies) from the
 				/// 'qb' part of the ChLcpVariables and sets it as the current item speed.
 				/// If 'step' is not 0, also should compute the approximate acceleration of
@@ -246,6 +254,12 @@ public:
 				/// numerical integration (Eulero integration).
 	virtual void VariablesQbIncrementPosition(double step) {};
 
+				/// Move the item (or its particles, nodes, etc.) back into the box of
+				/// the periodic domain, if it left it through a periodic face. The ChSystem
+				/// calls this after VariablesQbIncrementPosition(), if a periodic domain is set.
+				/// Items whose parts are linked to other items must not cross periodic faces.
+	virtual void WrapPeriodicPosition(const collision::ChPeriodicDomain& mdomain) {};
+
 				/// Tell to a system descriptor that there are variables of type
 				/// ChLcpVariables in this object (for further passing it to a LCP solver)
 				/// Basically does nothing, but maybe that inherited classes may specialize this.
@@ -121,6 +121,12 @@ void ChProximityContainerSPH::AddProximity(
 	if (!(mmpaA && mmpaB))
 		return;
 
+	// clusters using the cell list find their near nodes by themselves
+	ChMatterSPH* mmatA = dynamic_cast<ChMatterSPH*>(mmpaA->GetNodes());
+	ChMatterSPH* mmatB = dynamic_cast<ChMatterSPH*>(mmpaB->GetNodes());
+	if ((mmatA && mmatA->GetUseCellList()) || (mmatB && mmatB->GetUseCellList()))
+		return;
+
 	if ((fixedA && fixedB))
 		return;
 
@@ -206,6 +212,9 @@ static void W_gr_press(ChVector<>& Wresult, const ChVector<>& r, const double r_
 void ChProximityContainerSPH::AccumulateStep1()
 {
 	// Per-edge data computation
+	const collision::ChPeriodicDomain& periodic_domain = this->GetSystem()->GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
+
 	std::list<ChProximitySPH*>::iterator iterproximity = proximitylist.begin();
 	while(iterproximity != proximitylist.end())
 	{
@@ -218,6 +227,8 @@ void ChProximityContainerSPH::AccumulateStep1()
 		ChVector<> x_B  = mnodeB->GetPos();
 
 		ChVector<> r_BA = x_B  - x_A ;
+		if (periodic)
+			r_BA = periodic_domain.MinimumImage(r_BA);
 		double dist_BA = r_BA.Length();
 
 		double W_k_poly6 =  W_poly6( dist_BA, mnodeA->GetKernelRadius() );
@@ -235,6 +246,9 @@ void ChProximityContainerSPH::AccumulateStep1()
 void ChProximityContainerSPH::AccumulateStep2()
 {
 	// Per-edge data computation (transfer stress to forces)
+	const collision::ChPeriodicDomain& periodic_domain = this->GetSystem()->GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
+
 	std::list<ChProximitySPH*>::iterator iterproximity = proximitylist.begin();
 	while(iterproximity != proximitylist.end())
 	{
@@ -247,6 +261,8 @@ void ChProximityContainerSPH::AccumulateStep2()
 		ChVector<> x_B  = mnodeB->GetPos();
 
 		ChVector<> r_BA = x_B - x_A;
+		if (periodic)
+			r_BA = periodic_domain.MinimumImage(r_BA);
 		double dist_BA = r_BA.Length();
 
 		// increment pressure forces
@@ -0,0 +1,66 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHREORDERCALLBACK_H
+#define CHREORDERCALLBACK_H
+
+//////////////////////////////////////////////////
+//
+//   ChReorderCallback.h
+//
+//   Callback interface for the clusters of nodes
+//   or particles that can be sorted in a new order.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <vector>
+#include "core/ChApiCE.h"
+
+
+namespace chrono
+{
+
+// forward references
+class ChPhysicsItem;
+
+
+/// Class to be used as a callback interface for some user defined
+/// action to be taken each time the nodes (or particles) of a cluster
+/// are sorted in a new order, for example to improve memory locality.
+/// The node objects are the same, so shared pointers to nodes remain
+/// valid, but the user should update any reference based on indexes.
+/// The user must implement an inherited class and implement a custom
+/// OnReorder() function.
+
+class ChApi ChReorderCallback
+{
+public:
+	virtual ~ChReorderCallback() {}
+
+			/// Callback, called after the reordering of the 'mitem' cluster:
+			/// new_to_old[i] is the index, before the reordering, of the
+			/// node that now has index i.
+	virtual void OnReorder(ChPhysicsItem* mitem, const std::vector<int>& new_to_old) = 0;
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+
+#endif
@@ -42,6 +42,7 @@
 #include "lcp/ChLcpIterativeSORmultithread.h"
 #include "lcp/ChLcpIterativeJacobi.h"
 #include "lcp/ChLcpIterativeMINRES.h"
+#include "lcp/ChLcpIterativeAMG.h"
 #include "lcp/ChLcpIterativePMINRES.h"
 #include "lcp/ChLcpIterativeBB.h"
 #include "lcp/ChLcpIterativePCG.h"
@@ -572,6 +573,10 @@ void ChSystem::SetLcpSolverType(eCh_lcpSolver mval)
 		LCP_solver_speed = new ChLcpIterativeMINRES();
 		LCP_solver_stab = new ChLcpIterativeMINRES();
 		break;
+	case LCP_ITERATIVE_AMG:
+		LCP_solver_speed = new ChLcpIterativeAMG();
+		LCP_solver_stab = new ChLcpIterativeAMG();
+		break;
 	default:
 		LCP_solver_speed = new ChLcpIterativeSymmSOR();
 		LCP_solver_stab  = new ChLcpIterativeSymmSOR();
@@ -726,7 +731,10 @@ void ChSystem::ChangeCollisionSystem(ChCollisionSystem* newcollsystem)
 	assert (this->GetNbodies()==0);
 	assert (newcollsystem);
 	if (this->collision_system) 
+	{
+		newcollsystem->SetPeriodicDomain(this->collision_system->GetPeriodicDomain());
 		delete (this->collision_system);
+	}
 	this->collision_system = newcollsystem;
 }
 
@@ -874,8 +882,7 @@ int ChSystem::ExecuteControlsFor3DStep()
 
 void ChSystem::AddBody (ChSharedPtr<ChBody> newbody)
 {
-	assert(std::find<std::vector<ChBody*>::iterator>(bodylist.begin(), bodylist.end(), newbody.get_ptr())==bodylist.end());
-	assert(newbody->GetSystem()==0); // should remove from other system before adding here
+	assert(newbody->GetSystem()==0); // should remove from other system before adding here (also, avoids adding twice)
 
 	newbody->AddRef();
 	newbody->SetSystem (this);
@@ -886,6 +893,34 @@ void ChSystem::AddBody (ChSharedPtr<ChBody> newbody)
 		newbody->AddCollisionModelsToSystem(); 
 }
 
+void ChSystem::AddBodies (const std::vector< ChSharedPtr<ChBody> >& newbodies)
+{
+	bodylist.reserve(bodylist.size() + newbodies.size());
+
+	std::vector<ChCollisionModel*> newmodels;
+	newmodels.reserve(newbodies.size());
+
+	for (unsigned int i = 0; i < newbodies.size(); i++)
+	{
+		ChBody* newbody = newbodies[i].get_ptr();
+		assert(newbody->GetSystem()==0); // should remove from other system before adding here (also, avoids adding twice)
+
+		newbody->AddRef();
+		newbody->SetSystem (this);
+		bodylist.push_back(newbody);
+
+		if (newbody->GetCollide())
+		{
+			newbody->SyncCollisionModels();
+			newmodels.push_back(newbody->GetCollisionModel());
+		}
+	}
+
+	// add to collision system too, all at once
+	if (newmodels.size())
+		collision_system->AddBatch(newmodels);
+}
+
 void ChSystem::RemoveBody (ChSharedPtr<ChBody> mbody)
 {
 	assert(std::find<std::vector<ChBody*>::iterator>(bodylist.begin(), bodylist.end(), mbody.get_ptr() )!=bodylist.end());
@@ -902,6 +937,40 @@ void ChSystem::RemoveBody (ChSharedPtr<ChBody> mbody)
 	// this may delete the body, if none else's still referencing it..
 	mbody->RemoveRef();
 }
+
+void ChSystem::RemoveBodies (const std::vector< ChSharedPtr<ChBody> >& mbodies)
+{
+	std::vector<ChCollisionModel*> oldmodels;
+
+	// mark the bodies to remove, nullifying their backward link to system
+	for (unsigned int i = 0; i < mbodies.size(); i++)
+	{
+		ChBody* mbody = mbodies[i].get_ptr();
+		if (mbody->GetSystem() != this)
+			continue;
+
+		if (mbody->GetCollide())
+			oldmodels.push_back(mbody->GetCollisionModel());
+
+		mbody->SetSystem(0);
+	}
+
+	// remove from collision system, all at once
+	if (oldmodels.size())
+		collision_system->RemoveBatch(oldmodels);
+
+	// compact the list of bodies in a single pass
+	unsigned int nkept = 0;
+	for (unsigned int i = 0; i < bodylist.size(); i++)
+	{
+		ChBody* mbody = bodylist[i];
+		if (mbody->GetSystem() == this)
+			bodylist[nkept++] = mbody;
+		else
+			mbody->RemoveRef(); // still referenced by the caller, not deleted here
+	}
+	bodylist.resize(nkept);
+}
    
 void ChSystem::AddLink (ChLink* newlink)
 { 
@@ -1629,6 +1698,16 @@ void ChSystem::LCPprepare_load(bool load_jacobians,
 
 } 
 
+void ChSystem::LCPprepare_substeps(double step)
+{
+	HIER_OTHERPHYSICS_INIT
+	while HIER_OTHERPHYSICS_NOSTOP
+	{
+		PHpointer->VariablesFbLoadSubsteps(step);
+		HIER_OTHERPHYSICS_NEXT
+	}
+}
+
 void ChSystem::LCPprepare_inject(ChLcpSystemDescriptor& mdescriptor)
 {
 	mdescriptor.BeginInsertion(); // This resets the vectors of constr. and var. pointers.
@@ -1987,6 +2066,9 @@ int ChSystem::Integrate_Y_impulse_Anitescu()
 	                max_penetration_recovery_speed, // vlim, max penetrations recovery speed (positive for exiting)
 	                true);                          // do above max. clamping on -C/dt
 
+	// items with variables advanced by substeps (ex. subcycled FEM nodes)
+	LCPprepare_substeps(step);
+
 	// if warm start is used, can exploit cached multipliers from last step...
 	LCPprepare_Li_from_speed_cache(); 
 
@@ -2010,12 +2092,16 @@ int ChSystem::Integrate_Y_impulse_Anitescu()
  
 	// perform an Eulero integration step (1st order stepping as pos+=v_new*dt)
 
+	const ChPeriodicDomain& periodic_domain = collision_system->GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
 
 	HIER_BODY_INIT
 	while HIER_BODY_NOSTOP
 	{
 		// EULERO INTEGRATION: pos+=v_new*dt  (do not do this, if GPU already computed it)
 		Bpointer->VariablesQbIncrementPosition(step);
+		if (periodic)
+			Bpointer->WrapPeriodicPosition(periodic_domain);
 		// Set body speed, and approximates the acceleration by differentiation.
 		Bpointer->VariablesQbSetSpeed(step);
 
@@ -2028,6 +2114,8 @@ int ChSystem::Integrate_Y_impulse_Anitescu()
 	{
 		// EULERO INTEGRATION: pos+=v_new*dt  (do not do this, if GPU already computed it)
 		PHpointer->VariablesQbIncrementPosition(step);
+		if (periodic)
+			PHpointer->WrapPeriodicPosition(periodic_domain);
 		// Set body speed, and approximates the acceleration by differentiation.
 		PHpointer->VariablesQbSetSpeed(step);
 
@@ -2125,6 +2213,9 @@ int ChSystem::Integrate_Y_impulse_Tasora()
 	                0.0,       // max constr.recovery speed (positive for exiting) 
 	                true);     // do above max. clamping on -C/dt
 
+	// items with variables advanced by substeps (ex. subcycled FEM nodes)
+	LCPprepare_substeps(step);
+
 	// if warm start is used, can exploit cached multipliers from last step...
 	LCPprepare_Li_from_speed_cache();
 
@@ -2148,12 +2239,16 @@ int ChSystem::Integrate_Y_impulse_Tasora()
 
 	// perform an Eulero integration step (1st order stepping as pos+=v_new*dt)
 
+	const ChPeriodicDomain& periodic_domain = collision_system->GetPeriodicDomain();
+	bool periodic = periodic_domain.IsActive();
 
 	HIER_BODY_INIT
 	while HIER_BODY_NOSTOP
 	{
 		// EULERO INTEGRATION: pos+=v_new*dt
 		Bpointer->VariablesQbIncrementPosition(step);
+		if (periodic)
+			Bpointer->WrapPeriodicPosition(periodic_domain);
 		// Set body speed, and approximates the acceleration by differentiation.
 		Bpointer->VariablesQbSetSpeed(step);
 
@@ -2166,6 +2261,8 @@ int ChSystem::Integrate_Y_impulse_Tasora()
 	{
 		// EULERO INTEGRATION: pos+=v_new*dt
 		PHpointer->VariablesQbIncrementPosition(step);
+		if (periodic)
+			PHpointer->WrapPeriodicPosition(periodic_domain);
 		// Set body speed, and approximates the acceleration by differentiation.
 		PHpointer->VariablesQbSetSpeed(step);
 
@@ -2438,11 +2535,6 @@ int ChSystem::DoStaticLinear()
 	// make the vectors of pointers to constraint and variables, for LCP solver
 	LCPprepare_inject(*this->LCP_descriptor);
 
-//***DEBUG***
-this->GetLcpSystemDescriptor()->DumpLastMatrices();
-
-
-
 		// Solve the LCP problem.
 		// Solution variables are 'Dpos', delta positions.
 		// Note: use settings of the 'speed' lcp solver (i.e. use max number
@@ -2451,24 +2543,6 @@ this->GetLcpSystemDescriptor()->DumpLastMatrices();
 							*this->LCP_descriptor
 							);	
 
-//***DEBUG***
-
-// **CHECK*** optional check for correctness in result
-chrono::ChMatrixDynamic<double> md;
-GetLcpSystemDescriptor()->BuildDiVector(md);			// d={f;-b}
-
-chrono::ChMatrixDynamic<double> mx;
-GetLcpSystemDescriptor()->FromUnknownsToVector(mx);		// x ={q,-l}
-chrono::ChStreamOutAsciiFile file_x("dump_x.dat");
-mx.StreamOUTdenseMatlabFormat(file_x);
-
-chrono::ChMatrixDynamic<double> mZx;
-GetLcpSystemDescriptor()->SystemProduct(mZx, &mx);		// Zx = Z*x
-
-GetLog() << "CHECK: norm of solver residual: ||Z*x-d|| -------------------\n";
-GetLog() << (mZx - md).NormInf() << "\n";
-
-
 	// Updates the reactions of the constraint, getting them from solver data
 	LCPresult_Li_into_reactions(1.0) ; 
 
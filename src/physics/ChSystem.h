@@ -253,6 +253,7 @@ public:
 						 LCP_ITERATIVE_APGD,
 						 LCP_DEM,
 						 LCP_ITERATIVE_MINRES,
+						 LCP_ITERATIVE_AMG,		// only for FEM problems without constraints, ex. thermal or electrostatic meshes
 					};
 
 				/// Choose the LCP solver type, to be used for the simultaneous
@@ -378,6 +379,12 @@ public:
 				
 				/// Attach a body to this system. Must be an object of exactly ChBody class.
 	virtual void AddBody (ChSharedPtr<ChBody> newbody);
+				/// Attach many bodies to this system at once. This is faster than
+				/// calling AddBody() for each body: the list of bodies is grown only
+				/// once, and the collision models are inserted in the collision
+				/// system with a single batch insertion. Use it when many bodies
+				/// are created at the same time, for example by particle emitters.
+	virtual void AddBodies (const std::vector< ChSharedPtr<ChBody> >& newbodies);
 				/// Attach a link to this system. Must be an object of ChLink or derived classes.
 	virtual void AddLink (ChSharedPtr<ChLink> newlink);
 	void AddLink (ChLink* newlink);  // _internal use
@@ -395,6 +402,12 @@ public:
 
 				/// Remove a body from this system.
 	virtual void RemoveBody (ChSharedPtr<ChBody> mbody); 
+				/// Remove many bodies from this system at once. This is faster than
+				/// calling RemoveBody() for each body, that costs a linear search in
+				/// the list of bodies: here the list is compacted once, and the collision
+				/// models are removed from the collision system with a single batch
+				/// removal. Bodies that are not in this system (or repeated) are skipped.
+	virtual void RemoveBodies (const std::vector< ChSharedPtr<ChBody> >& mbodies);
 				/// Remove a link from this system.
 	virtual void RemoveLink (ChSharedPtr<ChLink> mlink); 
 				/// Remove a link from this system (faster version, mostly internal use)
@@ -670,6 +683,11 @@ protected:
 							   bool do_clamp		///< if true, limit the recovery of constraint drifting
 						);
 
+				/// After LCPprepare_load(), lets the items that advance some variables
+				/// with substeps of their own set the known terms of those variables,
+				/// see ChPhysicsItem::VariablesFbLoadSubsteps(). Only for dynamic steps.
+	virtual void LCPprepare_substeps(double step);
+
 				/// Pushes back all ChConstraints and ChVariables contained in links,bodies,etc. 
 				/// into the LCP descriptor. 
 	virtual void LCPprepare_inject(ChLcpSystemDescriptor& mdescriptor);
@@ -787,6 +805,14 @@ public:
 				/// client ChSystem object).
 	collision::ChCollisionSystem* GetCollisionSystem() {return collision_system;}; 
 
+				/// Set a box domain with periodic boundaries: bodies, particles and SPH nodes
+				/// that leave the box through a periodic face enter it from the opposite face,
+				/// and the collision system finds the contacts between objects near opposite
+				/// faces. This allows the simulation of a small sample of a large granular bed
+				/// or fluid. Bodies with links must not cross the periodic faces.
+	void SetPeriodicDomain(const collision::ChPeriodicDomain& mdomain) {collision_system->SetPeriodicDomain(mdomain);}
+	const collision::ChPeriodicDomain& GetPeriodicDomain() const {return collision_system->GetPeriodicDomain();}
+
 
 
 				/// Turn on this feature to let the system put to sleep the bodies whose
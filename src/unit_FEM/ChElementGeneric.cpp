@@ -20,17 +20,42 @@ namespace fem
 {
 
 
+// Scratch matrix of each thread, where the elements with a packed Kblock
+// compute their full matrices. Elements are loaded in parallel, so it cannot
+// be shared, and a buffer in each element would take back the memory saved
+// by the packed storage. Allocated at the first use, then only resized.
+static ChMatrixDynamic<>* packed_scratch = 0;
+#pragma omp threadprivate(packed_scratch)
+
+
+void ChElementGeneric::KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor)
+{
+	if (!this->Kmatr.IsPacked())
+	{
+		this->ComputeKRMmatricesGlobal(*this->Kmatr.Get_K(), Kfactor, Rfactor, Mfactor);
+		return;
+	}
+
+	if (!packed_scratch)
+		packed_scratch = new ChMatrixDynamic<>;
+	packed_scratch->Reset(this->GetNdofs(), this->GetNdofs());
+	this->ComputeKRMmatricesGlobal(*packed_scratch, Kfactor, Rfactor, Mfactor);
+	this->Kmatr.Set_K(*packed_scratch);
+}
+
+
 void ChElementGeneric::VariablesFbLoadInternalForces(double factor) 
 {
-	
-	ChMatrixDynamic<> mFi(this->GetNdofs(), 1);
-	this->ComputeInternalForces(mFi);
-	mFi.MatrScale(factor);
+	// the buffer is allocated only at the first call
+	Fi_buffer.Resize(this->GetNdofs(), 1);
+	this->ComputeInternalForces(Fi_buffer);
+	Fi_buffer.MatrScale(factor);
 	int stride = 0;
 	for (int in=0; in < this->GetNnodes(); in++)
 	{
-		int nodedofs = GetNodeN(in)->Get_ndof();
-		GetNodeN(in)->Variables().Get_fb().PasteSumClippedMatrix(&mFi, stride,0, nodedofs,1, 0,0);
+		ChNodeFEMbase* mnode = GetNodeN(in).get_ptr();
+		int nodedofs = mnode->Get_ndof();
+		mnode->Variables().Get_fb().PasteSumClippedMatrix(&Fi_buffer, stride,0, nodedofs,1, 0,0);
 		stride += nodedofs;
 	}
 };
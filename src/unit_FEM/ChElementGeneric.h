@@ -38,6 +38,7 @@ class ChApiFem ChElementGeneric : public ChElementBase
 {
 protected:
 	ChLcpKblockGeneric Kmatr;
+	ChMatrixDynamic<> Fi_buffer;	// nodal internal forces, kept here to avoid allocations at each step
 
 public:
 
@@ -63,15 +64,15 @@ public:
 				/// Adds the current stiffness K and damping R and mass M matrices in encapsulated
 				/// ChLcpKblock item(s), if any. The K, R, M matrices are load with scaling 
 				/// values Kfactor, Rfactor, Mfactor. 
-	virtual void KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor)
-				{
-					this->ComputeKRMmatricesGlobal(*this->Kmatr.Get_K(), Kfactor, Rfactor, Mfactor);
-				}
+				/// If the ChLcpKblock uses a packed storage, the matrices are computed
+				/// in a full scratch matrix of the thread, then packed.
+	virtual void KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor);
 
 				/// Adds the internal forces, expressed as nodal forces, into the
 				/// encapsulated ChLcpVariables, in the 'fb' part: qf+=forces*factor
 				/// (This is a default (a bit unoptimal) book keeping so that in children classes you can avoid 
 				/// implementing this VariablesFbLoadInternalForces function, unless you need faster code)
+				/// Not thread safe for elements sharing nodes: see the element coloring in ChMesh.
 	virtual void VariablesFbLoadInternalForces(double factor=1.);
 
 
@@ -493,24 +493,24 @@ public:
 	virtual void ComputeStiffnessMatrix() 
 		{
 			double Jdet;
-			ChMatrixDynamic<> *temp = new ChMatrixDynamic<>;
-			ChMatrixDynamic<> BT;
+			// fixed size temporaries, allocated once outside the Gauss loop
+			ChMatrixNM<double,60,6> BTD;
+			ChMatrixNM<double,60,60> temp;
+			// start from zero, so that SetupInitial() can be called again
+			StiffnessMatrix.Reset();
 			this->Volume = 0;
 
 			for(unsigned int i=0; i < GpVector.size(); i++)
 			{
 				ComputeMatrB(GpVector[i], Jdet);
-				BT = *GpVector[i]->MatrB;
-				BT.MatrTranspose();
-				*temp = (BT * Material->Get_StressStrainMatrix() * *(GpVector[i]->MatrB));
-				temp->MatrScale(GpVector[i]->GetWeight());
-				temp->MatrScale(Jdet);
-				StiffnessMatrix.MatrAdd(StiffnessMatrix,*temp);
+				BTD.MatrTMultiply(*(GpVector[i]->MatrB), Material->Get_StressStrainMatrix());
+				temp.MatrMultiply(BTD, *(GpVector[i]->MatrB));
+				temp.MatrScale(GpVector[i]->GetWeight() * Jdet);
+				StiffnessMatrix.MatrAdd(StiffnessMatrix,temp);
 				
 				// by the way also computes volume:
 				this->Volume  += GpVector[i]->GetWeight() * Jdet;
 			}
-			delete temp;
 		}
 
 //////////////////// *** OLD METHOD (before GaussIntegrationRule) *** //////////////////////
@@ -724,14 +724,15 @@ public:
 
 					// warp the local stiffness matrix K in order to obtain global 
 					// tangent stiffness CKCt:
-					ChMatrixDynamic<> CK(GetNdofs(), GetNdofs());
-					ChMatrixDynamic<> CKCt(GetNdofs(), GetNdofs()); // the global, corotated, K matrix, for 20 nodes
+					// (fixed size temporaries: no heap allocation at each step)
+					ChMatrixNM<double,60,60> CK;
+					ChMatrixNM<double,60,60> CKCt; // the global, corotated, K matrix, for 20 nodes
 					ChMatrixCorotation<>::ComputeCK(StiffnessMatrix, this->A, 20, CK);
 					ChMatrixCorotation<>::ComputeKCt(CK, this->A, 20, CKCt);
 
 					// For K stiffness matrix and R damping matrix:
 
-					double mkfactor = Kfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingK();
+					double mkfactor = Kfactor + Rfactor * this->Material->Get_RayleighDampingK();
 
 					CKCt.MatrScale( mkfactor );
 
@@ -744,7 +745,7 @@ public:
 						double lumped_node_mass = (this->Volume * this->Material->Get_density() ) / 20.0;
 						for (int id = 0; id < GetNdofs(); id++)
 						{
-							double amfactor = Mfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingM();
+							double amfactor = Mfactor + Rfactor * this->Material->Get_RayleighDampingM();
 							H(id,id)+= amfactor * lumped_node_mass;
 						}
 					}
@@ -761,18 +762,19 @@ public:
 					assert((Fi.GetRows() == GetNdofs()) && (Fi.GetColumns()==1));
 
 						// set up vector of nodal displacements (in local element system) u_l = R*p - p0
-					ChMatrixDynamic<> displ(GetNdofs(),1);
-					this->GetField(displ);
+					ChMatrixNM<double,60,1> displ;
+					for (int in=0; in < 20; ++in)
+						displ.PasteVector(A.MatrT_x_Vect(nodes[in]->pos) - nodes[in]->GetX0(), in*3, 0); // nodal displacements, local
 
 						// [local Internal Forces] = [Klocal] * displ + [Rlocal] * displ_dt
-					ChMatrixDynamic<> FiK_local(GetNdofs(),1);
+					ChMatrixNM<double,60,1> FiK_local;
 					FiK_local.MatrMultiply(StiffnessMatrix, displ);
 
 					for (int in=0; in < 20; ++in)
 					{
 						displ.PasteVector(A.MatrT_x_Vect(nodes[in]->pos_dt), in*3, 0); // nodal speeds, local
 					}
-					ChMatrixDynamic<> FiR_local(GetNdofs(),1);
+					ChMatrixNM<double,60,1> FiR_local;
 					FiR_local.MatrMultiply(StiffnessMatrix, displ);
 					FiR_local.MatrScale(this->Material->Get_RayleighDampingK());
 
@@ -22,6 +22,164 @@ ChElementHexa_8::~ChElementHexa_8()
 }
 
 
+static const int HEXA8_LANES = ChMatrixCorotation<>::BATCH_LANES;
+
+// Same as ChVector::Normalize(), on HEXA8_LANES vectors (structure-of-arrays)
+static void NormalizeLanes(double v[3][HEXA8_LANES])
+{
+	for (int l = 0; l < HEXA8_LANES; l++)
+	{
+		double mlength = sqrt(v[0][l]*v[0][l] + v[1][l]*v[1][l] + v[2][l]*v[2][l]);
+		bool null = (mlength < CH_NANOTOL);
+		double inv = 1/mlength;
+		v[0][l] = null ? 1.0 : v[0][l] * inv;
+		v[1][l] = null ? 0.0 : v[1][l] * inv;
+		v[2][l] = null ? 0.0 : v[2][l] * inv;
+	}
+}
+
+// Same as ChMatrix33::Set_A_Xdir(Xdir.GetNormalized(), Ydir.GetNormalized()) on
+// HEXA8_LANES directions. Lanes with Xdir parallel to Ydir are flagged as 'singular'.
+static void FrameLanes(double Xdir[3][HEXA8_LANES], double Ydir[3][HEXA8_LANES], double R[9][HEXA8_LANES], bool singular[HEXA8_LANES])
+{
+	NormalizeLanes(Xdir);
+	NormalizeLanes(Xdir);
+	NormalizeLanes(Ydir);
+	for (int l = 0; l < HEXA8_LANES; l++)
+	{
+		double zx = (Xdir[1][l] * Ydir[2][l])-(Xdir[2][l] * Ydir[1][l]);
+		double zy = (Xdir[2][l] * Ydir[0][l])-(Xdir[0][l] * Ydir[2][l]);
+		double zz = (Xdir[0][l] * Ydir[1][l])-(Xdir[1][l] * Ydir[0][l]);
+		double mzlen = sqrt(zx*zx + zy*zy + zz*zz);
+		singular[l] = (mzlen < 0.0001);
+		double inv = 1.0/mzlen;
+		zx *= inv;
+		zy *= inv;
+		zz *= inv;
+		R[0][l] = Xdir[0][l];
+		R[3][l] = Xdir[1][l];
+		R[6][l] = Xdir[2][l];
+		R[1][l] = (zy * Xdir[2][l])-(zz * Xdir[1][l]);
+		R[4][l] = (zz * Xdir[0][l])-(zx * Xdir[2][l]);
+		R[7][l] = (zx * Xdir[1][l])-(zy * Xdir[0][l]);
+		R[2][l] = zx;
+		R[5][l] = zy;
+		R[8][l] = zz;
+	}
+}
+
+
+void ChElementHexa_8::UpdateRotationBatch(ChElementHexa_8* const elements[], int n)
+{
+	const int L = HEXA8_LANES;
+	double Xdir0[3][L], Ydir0[3][L];
+	double Xdir [3][L], Ydir [3][L];
+	double rotX0[9][L];
+	double rotXcurrent[9][L];
+	bool singular0[L], singular[L];
+
+	for (int first = 0; first < n; first += L)
+	{
+		int nlanes = ChMin(L, n - first);
+
+		// gather (unused lanes repeat the first element)
+		for (int l = 0; l < L; l++)
+		{
+			ChElementHexa_8* mel = elements[first + ((l < nlanes) ? l : 0)];
+			std::vector< ChSharedPtr<ChNodeFEMxyz> >& mnodes = mel->nodes;
+
+			ChVector<> mXdir = (mnodes[4]->GetX0() + mnodes[5]->GetX0() + mnodes[6]->GetX0() + mnodes[7]->GetX0()) -
+							   (mnodes[0]->GetX0() + mnodes[1]->GetX0() + mnodes[2]->GetX0() + mnodes[3]->GetX0());
+			ChVector<> mYdir = (mnodes[2]->GetX0() + mnodes[3]->GetX0() + mnodes[6]->GetX0() + mnodes[7]->GetX0()) -
+							   (mnodes[0]->GetX0() + mnodes[1]->GetX0() + mnodes[4]->GetX0() + mnodes[5]->GetX0());
+			Xdir0[0][l] = mXdir.x;  Xdir0[1][l] = mXdir.y;  Xdir0[2][l] = mXdir.z;
+			Ydir0[0][l] = mYdir.x;  Ydir0[1][l] = mYdir.y;  Ydir0[2][l] = mYdir.z;
+
+			mXdir = (mnodes[4]->pos + mnodes[5]->pos + mnodes[6]->pos + mnodes[7]->pos) -
+					(mnodes[0]->pos + mnodes[1]->pos + mnodes[2]->pos + mnodes[3]->pos);
+			mYdir = (mnodes[2]->pos + mnodes[3]->pos + mnodes[6]->pos + mnodes[7]->pos) -
+					(mnodes[0]->pos + mnodes[1]->pos + mnodes[4]->pos + mnodes[5]->pos);
+			Xdir[0][l] = mXdir.x;  Xdir[1][l] = mXdir.y;  Xdir[2][l] = mXdir.z;
+			Ydir[0][l] = mYdir.x;  Ydir[1][l] = mYdir.y;  Ydir[2][l] = mYdir.z;
+		}
+
+		FrameLanes(Xdir0, Ydir0, rotX0, singular0);
+		FrameLanes(Xdir,  Ydir,  rotXcurrent, singular);
+
+		// scatter A = rotXcurrent * rotX0'
+		for (int l = 0; l < nlanes; l++)
+		{
+			ChElementHexa_8* mel = elements[first + l];
+			if (singular0[l] || singular[l])
+			{
+				// rare degenerate case: use the non-batched code
+				mel->UpdateRotation();
+				continue;
+			}
+			for (int row = 0; row < 3; ++row)
+				for (int colres = 0; colres < 3; ++colres)
+				{
+					double sum = 0;
+					for (int col = 0; col < 3; ++col)
+						sum += rotXcurrent[3*row+col][l] * rotX0[3*colres+col][l];
+					mel->A(row,colres) = sum;
+				}
+		}
+	}
+}
+
+
+void ChElementHexa_8::KRMmatricesLoadBatch(ChElementHexa_8* const elements[], int n, double Kfactor, double Rfactor, double Mfactor)
+{
+	const int L = ChMatrixCorotation<>::BATCH_LANES;
+	const ChMatrix<>*   K[L];
+	const ChMatrix33<>* R[L];
+	ChMatrix<>*         H[L];
+	ChMatrixNM<double,24,24> Hpacked[L];		// used if the Kblocks use a packed storage (on the stack, not allocated)
+
+	for (int first = 0; first < n; first += L)
+	{
+		int nlanes = ChMin(L, n - first);
+		for (int l = 0; l < nlanes; l++)
+		{
+			K[l] = &elements[first+l]->StiffnessMatrix;
+			R[l] = &elements[first+l]->A;
+			if (elements[first+l]->Kmatr.IsPacked())
+			{
+				H[l] = &Hpacked[l];
+			}
+			else
+				H[l] = elements[first+l]->Kmatr.Get_K();
+		}
+
+		ChMatrixCorotation<>::ComputeCKCtBatch(K, R, 8, nlanes, H);
+
+		// same as the rest of ComputeKRMmatricesGlobal()
+		for (int l = 0; l < nlanes; l++)
+		{
+			ChElementHexa_8* mel = elements[first+l];
+			ChMatrix<>& mH = *H[l];
+
+			double mkfactor = Kfactor + Rfactor * mel->Material->Get_RayleighDampingK();
+			mH.MatrScale( mkfactor );
+
+			if (Mfactor)
+			{
+				double lumped_node_mass = (mel->Volume * mel->Material->Get_density() ) / 8.0;
+				for (int id = 0; id < 24; id++)
+				{
+					double amfactor = Mfactor + Rfactor * mel->Material->Get_RayleighDampingM();
+					mH(id,id)+= amfactor * lumped_node_mass;
+				}
+			}
+
+			if (mel->Kmatr.IsPacked())
+				mel->Kmatr.Set_K(mH);
+		}
+	}
+}
+
+
 
 } // END_OF_NAMESPACE____
 } // END_OF_NAMESPACE____
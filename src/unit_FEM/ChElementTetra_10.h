@@ -429,14 +429,15 @@ public:
 
 					// warp the local stiffness matrix K in order to obtain global 
 					// tangent stiffness CKCt:
-					ChMatrixDynamic<> CK(GetNdofs(),GetNdofs());
-					ChMatrixDynamic<> CKCt(GetNdofs(),GetNdofs()); // the global, corotated, K matrix
+					// (fixed size temporaries: no heap allocation at each step)
+					ChMatrixNM<double,30,30> CK;
+					ChMatrixNM<double,30,30> CKCt; // the global, corotated, K matrix
 					ChMatrixCorotation<>::ComputeCK(StiffnessMatrix, this->A, 10, CK);
 					ChMatrixCorotation<>::ComputeKCt(CK, this->A, 10, CKCt);
 					
 					// For K stiffness matrix and R damping matrix:
 
-					double mkfactor = Kfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingK();
+					double mkfactor = Kfactor + Rfactor * this->Material->Get_RayleighDampingK();
 
 					CKCt.MatrScale( mkfactor );
 
@@ -448,7 +449,7 @@ public:
 						double lumped_node_mass = (this->GetVolume() * this->Material->Get_density() ) / (double)this->GetNnodes();
 						for (int id = 0; id < GetNdofs(); id++)
 						{
-							double amfactor = Mfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingM();
+							double amfactor = Mfactor + Rfactor * this->Material->Get_RayleighDampingM();
 							H(id,id)+= amfactor * lumped_node_mass;
 						}
 					}
@@ -464,11 +465,12 @@ public:
 					assert((Fi.GetRows() == GetNdofs()) && (Fi.GetColumns()==1));
 
 						// set up vector of nodal displacements (in local element system) u_l = R*p - p0
-					ChMatrixDynamic<> displ(GetNdofs(),1);
-					this->GetField(displ);
+					ChMatrixNM<double,30,1> displ;
+					for (int in=0; in < 10; ++in)
+						displ.PasteVector(A.MatrT_x_Vect(nodes[in]->pos) - nodes[in]->GetX0(), in*3, 0); // nodal displacements, local
 
 						// [local Internal Forces] = [Klocal] * displ + [Rlocal] * displ_dt
-					ChMatrixDynamic<> FiK_local(GetNdofs(),1);
+					ChMatrixNM<double,30,1> FiK_local;
 					FiK_local.MatrMultiply(StiffnessMatrix, displ);
 
 					displ.PasteVector(A.MatrT_x_Vect(nodes[0]->pos_dt), 0, 0); // nodal speeds, local
@@ -481,7 +483,7 @@ public:
 					displ.PasteVector(A.MatrT_x_Vect(nodes[7]->pos_dt),21, 0);
 					displ.PasteVector(A.MatrT_x_Vect(nodes[8]->pos_dt),24, 0);
 					displ.PasteVector(A.MatrT_x_Vect(nodes[9]->pos_dt),27, 0);
-					ChMatrixDynamic<> FiR_local(GetNdofs(),1);
+					ChMatrixNM<double,30,1> FiR_local;
 					FiR_local.MatrMultiply(StiffnessMatrix, displ);
 					FiR_local.MatrScale(this->Material->Get_RayleighDampingK());
 
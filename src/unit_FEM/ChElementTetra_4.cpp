@@ -34,6 +34,113 @@ ChElementTetra_4::~ChElementTetra_4()
 }
 
 
+void ChElementTetra_4::UpdateRotationBatch(ChElementTetra_4* const elements[], int n)
+{
+	const int L = PolarDecomposition::LANES;
+	double P [12][L];	// node positions, P[3*node+coord][lane]
+	double mM[12][L];	// upper 4x3 part of mM, mM[3*row+col][lane]
+	double F [9][L];
+	double Q [9][L];
+	double det[L];
+
+	for (int first = 0; first < n; first += L)
+	{
+		int nlanes = ChMin(L, n - first);
+
+		// gather (unused lanes repeat the first element)
+		for (int l = 0; l < L; l++)
+		{
+			ChElementTetra_4* mel = elements[first + ((l < nlanes) ? l : 0)];
+			for (int in = 0; in < 4; in++)
+			{
+				const ChVector<>& mpos = mel->nodes[in]->pos;
+				P[3*in+0][l] = mpos.x;
+				P[3*in+1][l] = mpos.y;
+				P[3*in+2][l] = mpos.z;
+				for (int ic = 0; ic < 3; ic++)
+					mM[3*in+ic][l] = mel->mM(in,ic);
+			}
+		}
+
+		// F=P*mM (only upper-left 3x3 block!)
+		for (int colres=0; colres < 3; ++colres)
+			for (int row=0; row < 3; ++row)
+				for (int l = 0; l < L; l++)
+				{
+					double sum = 0;
+					for (int col=0; col < 4; ++col)
+						sum+= P[3*col+row][l] * mM[3*col+colres][l];
+					F[3*row+colres][l] = sum;
+				}
+
+		PolarDecomposition::ComputeLanes(F, Q, det, nlanes, 1E-6);
+
+		// scatter
+		for (int l = 0; l < nlanes; l++)
+		{
+			ChMatrix33<>& mA = elements[first + l]->A;
+			for (int i = 0; i < 9; i++)
+				mA.GetAddress()[i] = (det[l] < 0) ? -Q[i][l] : Q[i][l];
+		}
+	}
+}
+
+
+void ChElementTetra_4::KRMmatricesLoadBatch(ChElementTetra_4* const elements[], int n, double Kfactor, double Rfactor, double Mfactor)
+{
+	const int L = ChMatrixCorotation<>::BATCH_LANES;
+	const ChMatrix<>*   K[L];
+	const ChMatrix33<>* R[L];
+	ChMatrix<>*         H[L];
+	ChMatrixNM<double,12,12> Hpacked[L];		// used if the Kblocks use a packed storage (on the stack, not allocated)
+
+	for (int first = 0; first < n; first += L)
+	{
+		int nlanes = ChMin(L, n - first);
+		for (int l = 0; l < nlanes; l++)
+		{
+			K[l] = &elements[first+l]->StiffnessMatrix;
+			R[l] = &elements[first+l]->A;
+			if (elements[first+l]->Kmatr.IsPacked())
+			{
+				H[l] = &Hpacked[l];
+			}
+			else
+				H[l] = elements[first+l]->Kmatr.Get_K();
+		}
+
+		ChMatrixCorotation<>::ComputeCKCtBatch(K, R, 4, nlanes, H);
+
+		// same as the rest of ComputeKRMmatricesGlobal()
+		for (int l = 0; l < nlanes; l++)
+		{
+			ChElementTetra_4* mel = elements[first+l];
+			ChMatrix<>& mH = *H[l];
+
+			for (int row = 0; row < 11; ++row)
+				for (int col = row+1; col < 12; ++col)
+					mH(row,col) = mH(col,row);
+
+			double mkfactor = Kfactor + Rfactor * mel->Material->Get_RayleighDampingK();
+			mH.MatrScale( mkfactor );
+
+			if (Mfactor)
+			{
+				double lumped_node_mass = (mel->GetVolume() * mel->Material->Get_density() ) / 4.0;
+				for (int id = 0; id < 12; id++)
+				{
+					double amfactor = Mfactor + Rfactor * mel->Material->Get_RayleighDampingM();
+					mH(id,id)+= amfactor * lumped_node_mass;
+				}
+			}
+
+			if (mel->Kmatr.IsPacked())
+				mel->Kmatr.Set_K(mH);
+		}
+	}
+}
+
+
 
 } // END_OF_NAMESPACE____
 } // END_OF_NAMESPACE____
@@ -201,6 +201,15 @@ if (max_err > 1e-10)
 					//GetLog() << "FEM rotation: \n" << A << "\n" ;
 				}
 
+				/// Same as UpdateRotation(), for n elements at once: node positions
+				/// are gathered in structure-of-arrays form and the deformation gradients
+				/// and polar decompositions are computed across elements, in vectorizable loops.
+	static void UpdateRotationBatch(ChElementTetra_4* const elements[], int n);
+
+				/// Same as KRMmatricesLoad(), for n elements at once, corotating
+				/// the stiffness matrices across elements in vectorizable loops.
+	static void KRMmatricesLoadBatch(ChElementTetra_4* const elements[], int n, double Kfactor, double Rfactor, double Mfactor);
+
 
 				/// Sets H as the global stiffness matrix K, scaled  by Kfactor. Optionally, also
 				/// superimposes global damping matrix R, scaled by Rfactor, and global mass matrix M multiplied by Mfactor.
@@ -210,8 +219,9 @@ if (max_err > 1e-10)
 
 					// warp the local stiffness matrix K in order to obtain global 
 					// tangent stiffness CKCt:
-					ChMatrixDynamic<> CK(12,12);
-					ChMatrixDynamic<> CKCt(12,12); // the global, corotated, K matrix
+					// (fixed size temporaries: no heap allocation at each step)
+					ChMatrixNM<double,12,12> CK;
+					ChMatrixNM<double,12,12> CKCt; // the global, corotated, K matrix
 					ChMatrixCorotation<>::ComputeCK(StiffnessMatrix, this->A, 4, CK);
 					ChMatrixCorotation<>::ComputeKCt(CK, this->A, 4, CKCt);
 /*
@@ -240,38 +250,6 @@ for (int row = 0; row < CKCt.GetRows()-1; ++row)
 
 
 
-//***DEBUG***
-double max_err=0; int err_r = -1; int err_c = -1;
-for (int row = 0; row < StiffnessMatrix.GetRows(); ++row)
-	for (int col = 0; col < StiffnessMatrix.GetColumns(); ++col)
-	{
-		double diff = fabs (StiffnessMatrix.GetElement(row,col)-StiffnessMatrix.GetElement(col,row));
-		if (diff > max_err)
-		{
-			max_err = diff;
-			err_r = row;
-			err_c = col;
-		}
-	}
-if (max_err > 1e-10)
-	GetLog() << "NONSYMMETRIC local stiffness matrix! err " << max_err << " at " << err_r << "," << err_c << "\n";
-max_err=0; err_r = -1; err_c = -1; double maxval = 0;
-for (int row = 0; row < CKCt.GetRows(); ++row)
-	for (int col = 0; col < CKCt.GetColumns(); ++col)
-	{
-		double diff = fabs (CKCt.GetElement(row,col)-CKCt.GetElement(col,row));
-		if (diff > max_err)
-		{
-			max_err = diff;
-			err_r = row;
-			err_c = col;
-		}
-		if (CKCt.GetElement(row,col) > maxval)
-			maxval = CKCt.GetElement(row,col);
-	}
-if (max_err > 1e-10)
-	GetLog() << "NONSYMMETRIC corotated matrix! err " << max_err << " at " << err_r << "," << err_c << ",   maxval=" << maxval<< "\n";
-
 					// DEBUG
 					/*
 					ChMatrixDynamic<> Ctest(12,12);
@@ -288,7 +266,7 @@ if (max_err > 1e-10)
 
 					// For K stiffness matrix and R damping matrix:
 
-					double mkfactor = Kfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingK();
+					double mkfactor = Kfactor + Rfactor * this->Material->Get_RayleighDampingK();
 
 					CKCt.MatrScale( mkfactor );
 
@@ -301,7 +279,7 @@ if (max_err > 1e-10)
 						double lumped_node_mass = (this->GetVolume() * this->Material->Get_density() ) / 4.0;
 						for (int id = 0; id < 12; id++)
 						{
-							double amfactor = Mfactor + Rfactor * this->GetMaterial()->Get_RayleighDampingM();
+							double amfactor = Mfactor + Rfactor * this->Material->Get_RayleighDampingM();
 							H(id,id)+= amfactor * lumped_node_mass;
 						}
 					}
@@ -317,18 +295,22 @@ if (max_err > 1e-10)
 					assert((Fi.GetRows() == 12) && (Fi.GetColumns()==1));
 
 						// set up vector of nodal displacements (in local element system) u_l = R*p - p0
-					ChMatrixDynamic<> displ(12,1);
-					this->GetField(displ); // nodal displacements, local
+						// (fixed size temporaries: no heap allocation at each step)
+					ChMatrixNM<double,12,1> displ;
+					displ.PasteVector(A.MatrT_x_Vect(nodes[0]->pos) - nodes[0]->GetX0(), 0, 0); // nodal displacements, local
+					displ.PasteVector(A.MatrT_x_Vect(nodes[1]->pos) - nodes[1]->GetX0(), 3, 0);
+					displ.PasteVector(A.MatrT_x_Vect(nodes[2]->pos) - nodes[2]->GetX0(), 6, 0);
+					displ.PasteVector(A.MatrT_x_Vect(nodes[3]->pos) - nodes[3]->GetX0(), 9, 0);
 
 						// [local Internal Forces] = [Klocal] * displ + [Rlocal] * displ_dt
-					ChMatrixDynamic<> FiK_local(12,1);
+					ChMatrixNM<double,12,1> FiK_local;
 					FiK_local.MatrMultiply(StiffnessMatrix, displ);
 
 					displ.PasteVector(A.MatrT_x_Vect(nodes[0]->pos_dt), 0, 0); // nodal speeds, local
 					displ.PasteVector(A.MatrT_x_Vect(nodes[1]->pos_dt), 3, 0);
 					displ.PasteVector(A.MatrT_x_Vect(nodes[2]->pos_dt), 6, 0);
 					displ.PasteVector(A.MatrT_x_Vect(nodes[3]->pos_dt), 9, 0);
-					ChMatrixDynamic<> FiR_local(12,1);
+					ChMatrixNM<double,12,1> FiR_local;
 					FiR_local.MatrMultiply(StiffnessMatrix, displ);
 					FiR_local.MatrScale(this->Material->Get_RayleighDampingK());
 
@@ -556,21 +538,21 @@ public:
 				/// superimposes global damping matrix R, scaled by Rfactor, and global mass matrix M multiplied by Mfactor.
 	virtual void ComputeKRMmatricesGlobal	(ChMatrix<>& H, double Kfactor, double Rfactor=0, double Mfactor=0) 
 				{
-					assert((H.GetRows() == 12) && (H.GetColumns()==12));
+					assert((H.GetRows() == 4) && (H.GetColumns()==4));
 					
 					// For K  matrix (jacobian d/dT of  c dT/dt + div [C] grad T = f ) 
 
-					ChMatrixDynamic<> mK(this->StiffnessMatrix); // local copy of stiffness 
+					ChMatrixNM<double,4,4> mK(this->StiffnessMatrix); // local copy of stiffness 
 					mK.MatrScale( Kfactor );
 
 					H.PasteMatrix(&mK,0,0);
 
 					// For R  matrix: (jacobian d/d\dot(T) of  c dT/dt + div [C] grad T = f ) 
 					if (Rfactor)
-					 if (this->GetMaterial()->Get_DtMultiplier() )		
+					 if (this->Material->Get_DtMultiplier() )		
 					{
 						// lumped approx. integration of c
-						double lumped_node_c = (this->GetVolume() * this->GetMaterial()->Get_DtMultiplier() ) / 4.0;
+						double lumped_node_c = (this->GetVolume() * this->Material->Get_DtMultiplier() ) / 4.0;
 						for (int id = 0; id < 4; id++)
 						{
 							H(id,id)+= Rfactor*lumped_node_c;
@@ -589,14 +571,17 @@ public:
 				/// in the Fi vector. The iterative solver uses this to know if the residual went to zero.
 	virtual void ComputeInternalForces	(ChMatrixDynamic<>& Fi)
 				{
-					assert((Fi.GetRows() == 12) && (Fi.GetColumns()==1));
+					assert((Fi.GetRows() == 4) && (Fi.GetColumns()==1));
 
 						// set up vector of nodal fields
-					ChMatrixDynamic<> displ(4,1);
-					this->GetField(displ);
+					ChMatrixNM<double,4,1> displ;
+					displ(0) = nodes[0]->GetP();
+					displ(1) = nodes[1]->GetP();
+					displ(2) = nodes[2]->GetP();
+					displ(3) = nodes[3]->GetP();
 
 						// [local Internal Forces] = [Klocal] * P 
-					ChMatrixDynamic<> FiK_local(4,1);
+					ChMatrixNM<double,4,1> FiK_local;
 					FiK_local.MatrMultiply(StiffnessMatrix, displ);
 
 					//***TO DO*** derivative terms? + [Rlocal] * P_dt ???? ***NO because Poisson  rho dP/dt + div [C] grad P = 0
@@ -73,6 +73,21 @@ public:
 	                       const int nblocks,         /// number of rotation blocks
 	                       ChMatrix<Real>& KC);       /// result matrix: C*K
 
+
+		/// Number of matrices processed at once by ComputeCKCtBatch()
+	enum { BATCH_LANES = 8 };
+
+		/// Perform the corotation C*K*C' of the K matrices of n elements,
+		/// each with its own rotation R. Blocks of BATCH_LANES elements are
+		/// gathered as structure-of-arrays, so that the loops across
+		/// elements can be vectorized by the compiler. The results are the
+		/// same as ComputeCK() followed by ComputeKCt().
+	static void ComputeCKCtBatch(const ChMatrix<Real>* const K[],   /// matrices to corotate, one per element
+	                             const ChMatrix33<Real>* const R[], /// 3x3 rotation matrices, one per element
+	                             const int nblocks,                 /// number of rotation blocks
+	                             const int n,                       /// number of elements
+	                             ChMatrix<Real>* const CKCt[]);     /// result matrices: C*K*C', one per element
+
 };
 
 /// Perform a corotation (warping) of a K matrix by pre-multiplying
@@ -173,6 +188,79 @@ ChMatrixCorotation<Real>::ComputeKCt(const ChMatrix<Real>& K,    /// matrix to c
 }
 
 
+/// batched version, for many elements
+template <class Real>
+void
+ChMatrixCorotation<Real>::ComputeCKCtBatch(const ChMatrix<Real>* const K[],   /// matrices to corotate, one per element
+                                           const ChMatrix33<Real>* const R[], /// 3x3 rotation matrices, one per element
+                                           const int nblocks,                 /// number of rotation blocks
+                                           const int n,                       /// number of elements
+                                           ChMatrix<Real>* const CKCt[])      /// result matrices: C*K*C', one per element
+{
+	const int L = BATCH_LANES;
+	Real mR [9][L];
+	Real mK [9][L];
+	Real mCK[9][L];
+	Real mCKCt[9][L];
+
+	for (int first = 0; first < n; first += L)
+	{
+		int nlanes = ChMin(L, n - first);
+
+		// gather rotations (unused lanes repeat the first element)
+		for (int l = 0; l < L; l++)
+		{
+			const ChMatrix33<Real>* lR = R[first + ((l < nlanes) ? l : 0)];
+			for (int i = 0; i < 9; i++)
+				mR[i][l] = lR->GetAddress()[i];
+		}
+
+		for (int iblock = 0; iblock < nblocks; iblock++)
+			for (int jblock = 0; jblock < nblocks; jblock++)
+			{
+				for (int l = 0; l < L; l++)
+				{
+					const ChMatrix<Real>* lK = K[first + ((l < nlanes) ? l : 0)];
+					for (int row = 0; row < 3; ++row)
+						for (int col = 0; col < 3; ++col)
+							mK[3*row+col][l] = (*lK)((3*iblock)+row, (3*jblock)+col);
+				}
+
+				// CK = R * K  for this block
+				for (int row = 0; row < 3; ++row)
+					for (int colres = 0; colres < 3; ++colres)
+						for (int l = 0; l < L; l++)
+						{
+							Real sum = 0;
+							for (int col = 0; col < 3; ++col)
+								sum += mR[3*row+col][l] * mK[3*col+colres][l];
+							mCK[3*row+colres][l] = sum;
+						}
+
+				// CKCt = CK * R'  for this block
+				for (int rowres = 0; rowres < 3; ++rowres)
+					for (int row = 0; row < 3; ++row)
+						for (int l = 0; l < L; l++)
+						{
+							Real sum = 0;
+							for (int col = 0; col < 3; ++col)
+								sum += mCK[3*rowres+col][l] * mR[3*row+col][l];
+							mCKCt[3*rowres+row][l] = sum;
+						}
+
+				// scatter
+				for (int l = 0; l < nlanes; l++)
+				{
+					ChMatrix<Real>* lCKCt = CKCt[first + l];
+					for (int row = 0; row < 3; ++row)
+						for (int col = 0; col < 3; ++col)
+							(*lCKCt)((3*iblock)+row, (3*jblock)+col) = mCKCt[3*row+col][l];
+				}
+			}
+	}
+}
+
+
 } // END_OF_NAMESPACE____
 } // END_OF_NAMESPACE____
 
@@ -46,6 +46,7 @@ ChClassRegister<ChMatterMeshless> a_registration_ChMatterMeshless;
 ChNodeMeshless::ChNodeMeshless()
 {
 	this->collision_model = new ChModelBulletNode;
+	this->collide_neighbors = true;
 	
 	this->pos_ref = VNULL;
 	this->UserForce = VNULL;
@@ -59,17 +60,23 @@ ChNodeMeshless::ChNodeMeshless()
 
 ChNodeMeshless::~ChNodeMeshless()
 {
-	delete collision_model; 
+	if (collision_model)
+		delete collision_model; 
 }
 
 ChNodeMeshless::ChNodeMeshless (const ChNodeMeshless& other) :
 					ChNodeXYZ(other) 
 {
-	this->collision_model = new ChModelBulletNode;
-	this->collision_model->AddSphere(other.coll_rad); 
-	((ChModelBulletNode*)collision_model)->SetNode(
-		((ChModelBulletNode*)other.collision_model)->GetNodes(),
-		((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	this->collision_model = 0;
+	if (other.collision_model)
+	{
+		this->collision_model = new ChModelBulletNode;
+		this->collision_model->AddSphere(other.coll_rad); 
+		((ChModelBulletNode*)collision_model)->SetNode(
+			((ChModelBulletNode*)other.collision_model)->GetNodes(),
+			((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	}
+	this->collide_neighbors = other.collide_neighbors;
 
 	this->pos_ref = other.pos_ref;
 	this->UserForce = other.UserForce;
@@ -95,11 +102,22 @@ ChNodeMeshless& ChNodeMeshless::operator= (const ChNodeMeshless& other)
 
 	ChNodeXYZ::operator=(other);
 
-	this->collision_model->ClearModel();
-	this->collision_model->AddSphere(other.coll_rad ); 
-	((ChModelBulletNode*)collision_model)->SetNode(
-		((ChModelBulletNode*)other.collision_model)->GetNodes(),
-		((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	if (other.collision_model)
+	{
+		if (!this->collision_model)
+			this->collision_model = new ChModelBulletNode;
+		this->collision_model->ClearModel();
+		this->collision_model->AddSphere(other.coll_rad ); 
+		((ChModelBulletNode*)collision_model)->SetNode(
+			((ChModelBulletNode*)other.collision_model)->GetNodes(),
+			((ChModelBulletNode*)other.collision_model)->GetNodeId());
+	}
+	else if (this->collision_model)
+	{
+		delete this->collision_model;
+		this->collision_model = 0;
+	}
+	this->collide_neighbors = other.collide_neighbors;
 	
 	this->pos_ref = other.pos_ref;
 	this->UserForce = other.UserForce;
@@ -123,15 +141,21 @@ ChNodeMeshless& ChNodeMeshless::operator= (const ChNodeMeshless& other)
 void ChNodeMeshless::SetKernelRadius(double mr)
 {
 	h_rad = mr;
-	double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
-	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, ChMax(0.0, aabb_rad-coll_rad) );
+	SetCollisionRadius(coll_rad);
 }
 	
 void ChNodeMeshless::SetCollisionRadius(double mr)
 {
 	coll_rad = mr;
-	double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
-	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, ChMax(0.0, aabb_rad-coll_rad) );
+	if (!this->collision_model)
+		return;
+	double envelope = coll_rad;	// just a small envelope, if near nodes are found by the cell list
+	if (collide_neighbors)
+	{
+		double aabb_rad = h_rad/2; // to avoid too many pairs: bounding boxes hemisizes will sum..  __.__--*--
+		envelope = ChMax(0.0, aabb_rad-coll_rad);
+	}
+	((ChModelBulletNode*)this->collision_model)->SetSphereRadius(coll_rad, envelope );
 }
 
 
@@ -148,6 +172,12 @@ void ChNodeMeshless::SetCollisionRadius(double mr)
 ChMatterMeshless::ChMatterMeshless ()
 {
 	this->do_collide = false;
+	this->use_cell_list = false;
+
+	this->reorder_interval = 0;
+	this->reorder_counter = 0;
+	this->reorder_locality = 0;
+	this->reorder_callback = 0;
 	
 	// By default, make a VonMises material
 	ChSharedPtr<ChContinuumPlasticVonMises> defaultmaterial (new ChContinuumPlasticVonMises);
@@ -176,6 +206,12 @@ void ChMatterMeshless::Copy(ChMatterMeshless* source)
 	ChIndexedNodes::Copy(source);
 
 	do_collide = source->do_collide;
+	use_cell_list = source->use_cell_list;
+
+	reorder_interval = source->reorder_interval;
+	reorder_counter = 0;
+	reorder_locality = source->reorder_locality;
+	reorder_callback = source->reorder_callback;
 	
 	ResizeNnodes(source->GetNnodes());
 }
@@ -206,15 +242,51 @@ void ChMatterMeshless::ResizeNnodes(int newsize)
 		this->nodes[j] = ChSharedPtr<ChNodeMeshless>(new ChNodeMeshless);
 
 		this->nodes[j]->variables.SetUserData((void*)this); // UserData unuseful in future cuda solver?
-		((ChModelBulletNode*)this->nodes[j]->collision_model)->SetNode(this,j);
-		this->nodes[j]->collision_model->AddSphere(0.001); //***TEST***
-		this->nodes[j]->collision_model->BuildModel();
+		this->SetupNodeCollisionModel(j, 0.001); //***TEST***
 	}
 
 	this->SetCollide(oldcoll); // this will also add particle coll.models to coll.engine, if already in a ChSystem
 
 }
 
+void ChMatterMeshless::SetupNodeCollisionModel(unsigned int j, double sphere_rad)
+{
+	ChNodeMeshless* mnode = this->nodes[j].get_ptr();
+
+	mnode->collide_neighbors = !this->use_cell_list;
+
+	// with the cell list, collision models are needed only for colliding with other objects
+	if (this->use_cell_list && !this->do_collide)
+	{
+		if (mnode->collision_model)
+			delete mnode->collision_model;
+		mnode->collision_model = 0;
+		return;
+	}
+
+	if (!mnode->collision_model)
+		mnode->collision_model = new ChModelBulletNode;
+	((ChModelBulletNode*)mnode->collision_model)->SetNode(this,j);
+	mnode->collision_model->ClearModel();
+	mnode->collision_model->AddSphere(sphere_rad);
+	mnode->collision_model->BuildModel();
+}
+
+void ChMatterMeshless::SetUseCellList (bool muse)
+{
+	if (muse == this->use_cell_list)
+		return;
+
+	bool oldcoll = this->GetCollide();
+	this->SetCollide(false); // this will remove old particle coll.models from coll.engine, if previously added
+
+	this->use_cell_list = muse;
+	for (unsigned int j = 0; j < nodes.size(); j++)
+		this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+
+	this->SetCollide(oldcoll); // this will also add particle coll.models to coll.engine, if already in a ChSystem
+}
+
 
 void ChMatterMeshless::AddNode(ChVector<double> initial_state)
 {
@@ -226,9 +298,7 @@ void ChMatterMeshless::AddNode(ChVector<double> initial_state)
 	this->nodes.push_back(newp);
 
 	newp->variables.SetUserData((void*)this);  // UserData unuseful in future cuda solver?
-	((ChModelBulletNode*)newp->collision_model)->SetNode(this,nodes.size()-1);
-	newp->collision_model->AddSphere(0.1); //***TEST***
-	newp->collision_model->BuildModel(); // will also add to system, if collision is on.
+	this->SetupNodeCollisionModel(nodes.size()-1, 0.1); //***TEST*** will also add to system, if collision is on.
 }
 
 
@@ -313,47 +383,214 @@ void ChMatterMeshless::VariablesFbReset()
 	}
 }
 
+// Same kernels of ChProximityContainerMeshless, with the constant
+// factor precomputed per node.
+
+static inline double W_sph_factor(double h)
+{
+	return 315.0 / (64.0 * CH_C_PI * pow(h,9));
+}
+
+static inline double W_sph(double r, double h, double factor)
+{
+	if (r < h)
+	{
+		double q = h*h - r*r;
+		return factor * q*q*q;
+	}
+	else return 0;
+}
+
+static inline double W_sq_visco_factor(double h)
+{
+	return 45.0 / (CH_C_PI * pow(h,6));
+}
+
+static inline double W_sq_visco(double r, double h, double factor)
+{
+	if (r < h)
+	{
+		return factor * (h - r);
+	}
+	else return 0;
+}
+
+
+void ChMatterMeshless::AccumulateCellListStep1()
+{
+	int nnodes = (int)nodes.size();
+
+	// Gather from the neighbors of each node: since each pair is listed for
+	// both nodes, each node writes only its own data, so no races.
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nnodes; i++)
+	{
+		ChNodeMeshless* mnodeA = this->nodes[i].get_ptr();
+		int nneighbors = neighbor_search.GetNneighbors(i);
+		const int* neighbors = neighbor_search.GetNeighbors(i);
+
+		ChVector<> x_Aref = mnodeA->pos_ref;
+		ChVector<> u_A = mnodeA->pos - x_Aref;
+		double h_A = mnodeA->h_rad;
+		double Wfactor_A = W_sph_factor(h_A);
+
+		double density = 0;
+		double Am[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+		double Jm[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+
+		for (int k = 0; k < nneighbors; k++)
+		{
+			ChNodeMeshless* mnodeB = this->nodes[neighbors[k]].get_ptr();
+
+			ChVector<> d_BA = mnodeB->pos_ref - x_Aref;
+			double W_BA = W_sph( d_BA.Length(), h_A, Wfactor_A );
+			if (W_BA == 0)
+				continue;
+			ChVector<> g_BA = (mnodeB->pos - mnodeB->pos_ref) - u_A;
+
+			density += mnodeB->GetMass() * W_BA;
+
+			double m_inc[3] = {d_BA.x * W_BA, d_BA.y * W_BA, d_BA.z * W_BA};
+			double d[3]     = {d_BA.x, d_BA.y, d_BA.z};
+			double g[3]     = {g_BA.x, g_BA.y, g_BA.z};
+			for (int r = 0; r < 3; r++)
+				for (int c = 0; c < 3; c++)
+				{
+					Am[r][c] += m_inc[r] * d[c];	// Aa += d_BA*d_BA'*W_BA
+					Jm[r][c] += m_inc[r] * g[c];	// J  += d_BA*W_BA*g_BA'
+				}
+		}
+
+		mnodeA->density += density;
+		for (int r = 0; r < 3; r++)
+			for (int c = 0; c < 3; c++)
+			{
+				mnodeA->Amoment.Element(r,c) += Am[r][c];
+				mnodeA->J.Element(r,c) += Jm[r][c];
+			}
+	}
+}
+
+void ChMatterMeshless::AccumulateCellListStep2()
+{
+	int nnodes = (int)nodes.size();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nnodes; i++)
+	{
+		ChNodeMeshless* mnodeA = this->nodes[i].get_ptr();
+		int nneighbors = neighbor_search.GetNneighbors(i);
+		const int* neighbors = neighbor_search.GetNeighbors(i);
+
+		ChVector<> x_A = mnodeA->pos;
+		ChVector<> x_Aref = mnodeA->pos_ref;
+		ChVector<> v_A = mnodeA->pos_dt;
+		double h_A = mnodeA->h_rad;
+		double Wfactor_A = W_sph_factor(h_A);
+		double Vfactor_A = W_sq_visco_factor(h_A);
+
+		ChVector<> force = VNULL;
+
+		for (int k = 0; k < nneighbors; k++)
+		{
+			ChNodeMeshless* mnodeB = this->nodes[neighbors[k]].get_ptr();
+			double h_B = mnodeB->h_rad;
+
+			// elastoplastic forces, from stress of both nodes
+			ChVector<> d_BA = mnodeB->pos_ref - x_Aref;
+			double dist_BA = d_BA.Length();
+			double W_BA = W_sph( dist_BA, h_A, Wfactor_A );
+			double W_AB = (h_B == h_A) ? W_BA : W_sph( dist_BA, h_B, W_sph_factor(h_B) );
+
+			if (W_BA != 0)
+				force += mnodeA->FA * (d_BA*W_BA);
+			if (W_AB != 0)
+				force += mnodeB->FA * (d_BA*W_AB);
+
+			// viscous forces
+			if (this->viscosity)
+			{
+				double r_length = (mnodeB->pos - x_A).Length();
+				double W_visc = W_sq_visco( r_length, h_A, Vfactor_A );
+				if (h_B == h_A)
+					W_visc *= 2.0;
+				else
+					W_visc += W_sq_visco( r_length, h_B, W_sq_visco_factor(h_B) );
+				force += (mnodeB->pos_dt - v_A) * ( mnodeA->volume * this->viscosity * mnodeB->volume * 0.5 * W_visc );
+			}
+		}
+
+		mnodeA->UserForce += force;
+	}
+}
+
+
 void ChMatterMeshless::VariablesFbLoadForces(double factor)
 {
 
 	// COMPUTE THE MESHLESS FORCES HERE
 
-	// First, find if any ChProximityContainerMeshless object is present
-	// in the system,
+	int nnodes = (int)nodes.size();
+
+	// First, find the near nodes: with the cell list of this cluster, or
+	// else with the ChProximityContainerMeshless object that must be present
+	// in the system, where the collision engine stored the pairs.
 
 	ChProximityContainerMeshless* edges =0;
-	std::list<ChPhysicsItem*>::iterator iterotherphysics = this->GetSystem()->Get_otherphysicslist()->begin();
-	while (iterotherphysics != this->GetSystem()->Get_otherphysicslist()->end())
+
+	if (this->use_cell_list)
+	{
+		std::vector< ChVector<> > points(nnodes);
+		std::vector< double > radii(nnodes);
+		for (int j = 0; j < nnodes; j++)
+		{
+			points[j] = this->nodes[j]->pos_ref;
+			radii[j]  = this->nodes[j]->h_rad;
+		}
+		this->neighbor_search.Update(points, radii);
+	}
+	else
 	{
-		if (edges=dynamic_cast<ChProximityContainerMeshless*>(*iterotherphysics))
-			break;
-		iterotherphysics++;
+		std::list<ChPhysicsItem*>::iterator iterotherphysics = this->GetSystem()->Get_otherphysicslist()->begin();
+		while (iterotherphysics != this->GetSystem()->Get_otherphysicslist()->end())
+		{
+			if ((edges = dynamic_cast<ChProximityContainerMeshless*>(*iterotherphysics)))
+				break;
+			iterotherphysics++;
+		}
+		assert(edges); // If using a ChMatterMeshless, you must add also a ChProximityContainerMeshless.
 	}
-	assert(edges); // If using a ChMatterMeshless, you must add also a ChProximityContainerMeshless.
 	
 
 	// 1- Per-node initialization
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
-		this->nodes[j]->J.FillElem(0.0);
-		this->nodes[j]->Amoment.FillElem(0.0);
-		this->nodes[j]->t_strain.FillElem(0.0);
-		this->nodes[j]->e_stress.FillElem(0.0); 
-		this->nodes[j]->UserForce = VNULL;
-		this->nodes[j]->density = 0;
+		ChNodeMeshless* mnode = this->nodes[j].get_ptr();
+		mnode->J.FillElem(0.0);
+		mnode->Amoment.FillElem(0.0);
+		mnode->t_strain.FillElem(0.0);
+		mnode->e_stress.FillElem(0.0); 
+		mnode->UserForce = VNULL;
+		mnode->density = 0;
 	}
 
 	// 2- Per-edge initialization and accumulation of values in particles's J, Amoment, m_v, density
 
-	edges->AccumulateStep1();
+	if (this->use_cell_list)
+		this->AccumulateCellListStep1();
+	else
+		edges->AccumulateStep1();
 
 	// 3- Per-node inversion of A and computation of strain stress
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	ChContinuumElastoplastic* mmaterial = this->material.get_ptr();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
-		ChSharedPtr<ChNodeMeshless> mnode (this->nodes[j]);
-		assert(!mnode.IsNull());
+		ChNodeMeshless* mnode = this->nodes[j].get_ptr();
 
 		// node volume is v=mass/density
 		if (mnode->density>0)
@@ -388,15 +625,15 @@ void ChMatterMeshless::VariablesFbLoadForces(double factor)
 			mnode->t_strain.ConvertFromMatrix(mtensor); // store 'step strain' de, change in total strain
 			
 			ChStrainTensor<> strainplasticflow;
-			this->material->ComputeReturnMapping(strainplasticflow,	 // dEp, flow of elastic strain (correction)
-											 nodes[j]->t_strain, // increment of total strain
-											 nodes[j]->e_strain, // last elastic strain
-											 nodes[j]->p_strain  // last plastic strain
+			mmaterial->ComputeReturnMapping(strainplasticflow,	 // dEp, flow of elastic strain (correction)
+											 mnode->t_strain, // increment of total strain
+											 mnode->e_strain, // last elastic strain
+											 mnode->p_strain  // last plastic strain
 											 );
 			ChStrainTensor<> proj_e_strain; 
-			proj_e_strain.MatrSub(nodes[j]->e_strain, strainplasticflow);
-			proj_e_strain.MatrInc(nodes[j]->t_strain);
-			this->GetMaterial()->ComputeElasticStress(mnode->e_stress, proj_e_strain); 
+			proj_e_strain.MatrSub(mnode->e_strain, strainplasticflow);
+			proj_e_strain.MatrInc(mnode->t_strain);
+			mmaterial->ComputeElasticStress(mnode->e_stress, proj_e_strain); 
 			mnode->e_stress.ConvertToMatrix(mtensor);
 
 			/*
@@ -417,22 +654,27 @@ void ChMatterMeshless::VariablesFbLoadForces(double factor)
 
 	// 4- Per-edge force transfer from stress, and add also viscous forces
 
-	edges->AccumulateStep2();
+	if (this->use_cell_list)
+		this->AccumulateCellListStep2();
+	else
+		edges->AccumulateStep2();
 
 
 	// 5- Per-node load force
 
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	ChVector<> G_acc = GetSystem()->Get_G_acc();
+
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
+		ChNodeMeshless* mnode = this->nodes[j].get_ptr();
+
 		// particle gyroscopic force:
 		// none.
 
 		// add gravity 
-		ChVector<> Gforce = GetSystem()->Get_G_acc() * this->nodes[j]->GetMass();
-		ChVector<> TotForce = this->nodes[j]->UserForce + Gforce; 
-
-		ChSharedPtr<ChNodeMeshless> mnode (this->nodes[j]);
-		assert(!mnode.IsNull());
+		ChVector<> Gforce = G_acc * mnode->GetMass();
+		ChVector<> TotForce = mnode->UserForce + Gforce; 
 
 		mnode->variables.Get_fb().PasteSumVector(TotForce * factor ,0,0);
 		
@@ -479,44 +721,43 @@ void ChMatterMeshless::VariablesQbIncrementPosition(double dt_step)
 {
 	//if (!this->IsActive()) 
 	//	return;
+
+	int nnodes = (int)nodes.size();
+	ChContinuumElastoplastic* mmaterial = this->material.get_ptr();
+
+	double dtpfact = dt_step* mmaterial->Get_flow_rate();
+	if (dtpfact>1.0)
+		dtpfact = 1.0; // clamp if dt is larger than plastic flow duration
  
-	for (unsigned int j = 0; j < nodes.size(); j++)
+	#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nnodes; j++)
 	{
-		ChSharedPtr<ChNodeMeshless> mnode (this->nodes[j]);
-		assert(!mnode.IsNull());
+		ChNodeMeshless* mnode = this->nodes[j].get_ptr();
 		
 		// Integrate plastic flow 
 		ChStrainTensor<> strainplasticflow;
-		this->material->ComputeReturnMapping(strainplasticflow,	 // dEp, flow of elastic strain (correction)
-											 nodes[j]->t_strain, // increment of total strain
-											 nodes[j]->e_strain, // last elastic strain
-											 nodes[j]->p_strain  // last plastic strain
+		mmaterial->ComputeReturnMapping(strainplasticflow,	 // dEp, flow of elastic strain (correction)
+											 mnode->t_strain, // increment of total strain
+											 mnode->e_strain, // last elastic strain
+											 mnode->p_strain  // last plastic strain
 											 );
-		double dtpfact = dt_step* this->material->Get_flow_rate();
-		if (dtpfact>1.0)
-			dtpfact = 1.0; // clamp if dt is larger than plastic flow duration
 
-		this->nodes[j]->p_strain.MatrInc(strainplasticflow*dtpfact);
+		mnode->p_strain.MatrInc(strainplasticflow*dtpfact);
 
 		// Increment total elastic tensor and proceed for next step 
-		this->nodes[j]->pos_ref = this->nodes[j]->pos;
-	 	this->nodes[j]->e_strain.MatrInc(this->nodes[j]->t_strain);
-	 //	this->nodes[j]->e_strain.MatrDec(strainplasticflow*dtpfact);
-		this->nodes[j]->t_strain.FillElem(0.0); // unuseful? will be overwritten anyway
-	} 
-
-	for (unsigned int j = 0; j < nodes.size(); j++)
-	{
+		mnode->pos_ref = mnode->pos;
+	 	mnode->e_strain.MatrInc(mnode->t_strain);
+	 //	mnode->e_strain.MatrDec(strainplasticflow*dtpfact);
+		mnode->t_strain.FillElem(0.0); // unuseful? will be overwritten anyway
 
 		// Updates position with incremental action of speed contained in the
 		// 'qb' vector:  pos' = pos + dt * speed   , like in an Eulero step.
 
-		ChVector<> newspeed = this->nodes[j]->variables.Get_qb().ClipVector(0,0);
+		ChVector<> newspeed = mnode->variables.Get_qb().ClipVector(0,0);
 
 		// ADVANCE POSITION: pos' = pos + dt * vel
-		this->nodes[j]->SetPos( this->nodes[j]->GetPos() + newspeed * dt_step);
-	}
-
+		mnode->SetPos( mnode->GetPos() + newspeed * dt_step);
+	} 
 
 }
 
@@ -553,6 +794,17 @@ void ChMatterMeshless::Update()
 						
 void ChMatterMeshless::Update (double mytime)
 {	
+		// Reorder the nodes, if needed, once per time step: the contacts keep
+		// pointers to the nodes, and the forces are computed later, so a new
+		// order is safe here (not in SyncCollisionModels(), that is called
+		// also when the cluster is added to a system).
+	if (mytime > this->GetChTime() && this->reorder_interval > 0 && ++this->reorder_counter >= this->reorder_interval)
+	{
+		this->reorder_counter = 0;
+		if (this->reorder_locality <= 0 || this->GetLocality() < this->reorder_locality)
+			this->ReorderNodes();
+	}
+
 		// Inherit time changes of parent class
 	ChPhysicsItem::Update(mytime);
 
@@ -580,7 +832,14 @@ void ChMatterMeshless::SetCollide (bool mcoll)
 	if (mcoll)
 	{
 		this->do_collide = true;
-		if (GetSystem())
+		if (this->use_cell_list)
+		{
+			// collision models are not kept when not colliding, so create them now
+			// (this also adds them to the collision engine, if already in a ChSystem)
+			for (unsigned int j = 0; j < nodes.size(); j++)
+				this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+		}
+		else if (GetSystem())
 		{
 			for (unsigned int j = 0; j < nodes.size(); j++)
 			{
@@ -595,17 +854,70 @@ void ChMatterMeshless::SetCollide (bool mcoll)
 		{
 			for (unsigned int j = 0; j < nodes.size(); j++)
 			{
-				GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
+				if (this->nodes[j]->collision_model)
+					GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
 			}
 		}
+		if (this->use_cell_list)
+		{
+			for (unsigned int j = 0; j < nodes.size(); j++)
+				this->SetupNodeCollisionModel(j, this->nodes[j]->coll_rad);
+		}
+	}
+}
+
+// Node positions, and the largest kernel radius as cell size
+static double GetNodePoints(const std::vector< ChSharedPtr<ChNodeMeshless> >& nodes, std::vector< ChVector<> >& points)
+{
+	double cellsize = 0;
+	points.resize(nodes.size());
+	for (unsigned int j = 0; j < nodes.size(); j++)
+	{
+		points[j] = nodes[j]->pos;
+		cellsize = ChMax(cellsize, nodes[j]->h_rad);
+	}
+	return cellsize;
+}
+
+void ChMatterMeshless::ReorderNodes()
+{
+	this->reorder_counter = 0;
+
+	if (nodes.size() < 2)
+		return;
+
+	std::vector< ChVector<> > points;
+	double cellsize = GetNodePoints(this->nodes, points);
+
+	std::vector<int> order;
+	ChNeighborSearch::ComputeMortonOrder(points, cellsize, order);
+
+	std::vector< ChSharedPtr<ChNodeMeshless> > old_nodes(this->nodes);
+	for (unsigned int j = 0; j < nodes.size(); j++)
+	{
+		this->nodes[j] = old_nodes[order[j]];
+		if (this->nodes[j]->collision_model)
+			((ChModelBulletNode*)this->nodes[j]->collision_model)->SetNode(this,j);
 	}
+
+	if (this->reorder_callback)
+		this->reorder_callback->OnReorder(this, order);
+}
+
+double ChMatterMeshless::GetLocality()
+{
+	std::vector< ChVector<> > points;
+	double cellsize = GetNodePoints(this->nodes, points);
+
+	return ChNeighborSearch::ComputeLocality(points, cellsize);
 }
 
 void ChMatterMeshless::SyncCollisionModels()
 {
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->nodes[j]->collision_model->SyncPosition();
+		if (this->nodes[j]->collision_model)
+			this->nodes[j]->collision_model->SyncPosition();
 	}
 }
 
@@ -615,7 +927,8 @@ void ChMatterMeshless::AddCollisionModelsToSystem()
 	SyncCollisionModels();
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Add(this->nodes[j]->collision_model);
+		if (this->nodes[j]->collision_model)
+			this->GetSystem()->GetCollisionSystem()->Add(this->nodes[j]->collision_model);
 	}
 }
 
@@ -624,7 +937,8 @@ void ChMatterMeshless::RemoveCollisionModelsFromSystem()
 	assert(this->GetSystem());
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
-		this->GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
+		if (this->nodes[j]->collision_model)
+			this->GetSystem()->GetCollisionSystem()->Remove(this->nodes[j]->collision_model);
 	}
 }
 
@@ -635,6 +949,8 @@ void ChMatterMeshless::UpdateParticleCollisionModels()
 {
 	for (unsigned int j = 0; j < nodes.size(); j++)
 	{
+		if (!this->nodes[j]->collision_model)
+			continue;
 		this->nodes[j]->collision_model->ClearModel();
 		//***TO DO*** UPDATE RADIUS OF MeshlessERE? this->nodes[j]->collision_model->AddCopyOfAnotherModel(this->particle_collision_model);
 		this->nodes[j]->collision_model->BuildModel();
@@ -35,10 +35,12 @@
 
 #include "ChApiFEM.h"
 #include "physics/ChIndexedNodes.h"
+#include "physics/ChReorderCallback.h"
 #include "physics/ChNodeXYZ.h"
 #include "collision/ChCCollisionModel.h"
 #include "lcp/ChLcpVariablesNode.h"
 #include "physics/ChContinuumMaterial.h"
+#include "collision/ChCNeighborSearch.h"
 
 namespace chrono
 {
@@ -108,7 +110,9 @@ public:
 	ChStressTensor<> e_stress; // stress
 
 	ChLcpVariablesNode	variables;
-	ChCollisionModel*	collision_model;
+	ChCollisionModel*	collision_model;	// can be NULL, if the cluster uses the cell list and does not collide
+
+	bool collide_neighbors;	// if true, the collision model also finds the near nodes (larger envelope)
 
 	ChVector<> UserForce;		
 
@@ -146,6 +150,18 @@ private:
 
 	bool do_collide;
 
+	bool use_cell_list;
+	ChNeighborSearch neighbor_search;
+
+	int reorder_interval;
+	int reorder_counter;
+	double reorder_locality;
+	ChReorderCallback* reorder_callback;
+
+	void SetupNodeCollisionModel(unsigned int j, double sphere_rad);
+	void AccumulateCellListStep1();
+	void AccumulateCellListStep2();
+
 public:
 
 			//
@@ -175,6 +191,22 @@ public:
 	void  SetCollide (bool mcoll);
 	bool  GetCollide() {return do_collide;}
 
+				/// If true, the near nodes of this cluster are found with a
+				/// ChNeighborSearch cell list, instead of the collision engine.
+				/// This is much faster, and saves a lot of memory because collision
+				/// models are created only if SetCollide(true), with a small
+				/// envelope, just for colliding with other objects. Also, a
+				/// ChProximityContainerMeshless is not needed. Note that in this
+				/// mode the nodes interact only with nodes of the same cluster,
+				/// and the viscous kernels of two nodes are averaged.
+				/// Default: false.
+	void  SetUseCellList (bool muse);
+	bool  GetUseCellList() {return use_cell_list;}
+
+				/// Access the cell list used when GetUseCellList() is true,
+				/// with the neighbors of the last step.
+	ChNeighborSearch& GetNeighborSearch() {return neighbor_search;}
+
 
 			//
 	  		// FUNCTIONS
@@ -194,6 +226,37 @@ public:
 				/// vector as initial position.
 	void AddNode(ChVector<double> initial_state);
 
+				/// Sort the nodes along a space filling curve (Morton order)
+				/// of their positions, with cells as large as the kernel radius,
+				/// so that nodes that are near in space are also near in memory,
+				/// and the loops over nodes and neighbors make a better use of
+				/// caches. The node objects are not copied, so shared pointers
+				/// to nodes (ex. in links) remain valid, but their indexes change:
+				/// use SetReorderCallback() if you keep indexes of nodes.
+	void ReorderNodes();
+
+				/// Reorder the nodes automatically, as in ReorderNodes(),
+				/// every 'msteps' time steps (default 0, i.e. never).
+	void SetReorderInterval(int msteps) {reorder_interval = msteps;}
+	int  GetReorderInterval() {return reorder_interval;}
+
+				/// If larger than 0, the automatic reordering of SetReorderInterval()
+				/// is done only if GetLocality() is below this value, so the locality
+				/// is computed every 'msteps' time steps, not at each step (default 0,
+				/// i.e. always reorder). Ex. 0.5.
+	void   SetReorderLocality(double mthreshold) {reorder_locality = mthreshold;}
+	double GetReorderLocality() {return reorder_locality;}
+
+				/// Fraction of consecutive nodes that are also near in space,
+				/// within the kernel radius, from 0 to 1. It is close to 1
+				/// after ReorderNodes(), and drops as the material flows.
+	double GetLocality();
+
+				/// Set a callback that is called after each reordering of the
+				/// nodes, to update user data that refers to node indexes.
+				/// It is not deleted by the cluster. Use 0 to remove it.
+	void SetReorderCallback(ChReorderCallback* mcallback) {reorder_callback = mcallback;}
+
 
 
 		//
@@ -12,17 +12,27 @@
 
 
 #include "core/ChMath.h"
+#include "core/ChStream.h"
 #include "physics/ChObject.h"
 #include "ChMesh.h"
 // for the TetGen parsing:
 #include "ChNodeFEMxyz.h"
+#include "ChNodeFEMxyzP.h"
+#include "ChNodeFEMxyzrot.h"
 #include "ChElementTetra_4.h"
+#include "ChElementHexa_8.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <string>
 #include <algorithm>
 #include <functional> 
+#include <map>
+#include <typeinfo>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <sys/stat.h>
 
 
 using namespace std;
@@ -35,8 +45,15 @@ namespace fem
 
 
 
+// number of elements per task, in batched loops
+static const int BATCH_SIZE = 64;
+
+
 void ChMesh::SetupInitial()
 {
+	if (node_ordering != NODEORDER_NONE)
+		ReorderNodes(node_ordering);
+
 	n_dofs = 0;
 
 	for (unsigned int i=0; i< vnodes.size(); i++)
@@ -47,10 +64,581 @@ void ChMesh::SetupInitial()
 
 	for (unsigned int i=0; i< velements.size(); i++)
 	{
+			//    - set the storage of the stiffness block
+		if (ChElementGeneric* melgeneric = dynamic_cast<ChElementGeneric*>(velements[i].get_ptr()))
+			if (melgeneric->Kstiffness().GetStorage() != kblock_storage)
+				melgeneric->Kstiffness().SetStorage(kblock_storage);
+
 			//    - precompute matrices, such as the [Kl] local stiffness of each element, if needed, etc.
 		velements[i]->SetupInitial();
 	}
 
+	ComputeElementColors();
+
+	SetupExplicitMasses();
+	if (explicit_integration)
+		ComputeCriticalTimeStep();
+	subcycling_step = 0;
+}
+
+
+void ChMesh::ComputeElementColors()
+{
+	element_colors.clear();
+
+	// per node, the list of the colors of the elements that touch it
+	std::map<ChNodeFEMbase*, std::vector<unsigned int> > node_colors;
+	std::vector<bool> color_taken;
+
+	// greedy coloring: each element gets the first color not used by its nodes
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		color_taken.assign(element_colors.size()+1, false);
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+		{
+			std::vector<unsigned int>& mcolors = node_colors[velements[ie]->GetNodeN(in).get_ptr()];
+			for (unsigned int ic = 0; ic < mcolors.size(); ic++)
+				color_taken[mcolors[ic]] = true;
+		}
+		unsigned int mcolor = 0;
+		while (color_taken[mcolor])
+			++mcolor;
+
+		if (mcolor == element_colors.size())
+			element_colors.push_back(std::vector<unsigned int>());
+		element_colors[mcolor].push_back(ie);
+
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+			node_colors[velements[ie]->GetNodeN(in).get_ptr()].push_back(mcolor);
+	}
+
+	// collect the elements that can be processed in batches; exact type
+	// match, because inherited classes may change UpdateRotation() etc.
+	batch_tetra4.clear();
+	batch_hexa8.clear();
+	element_batched.assign(velements.size(), 0);
+	if (use_batches)
+	{
+		for (unsigned int ie = 0; ie < velements.size(); ie++)
+		{
+			ChElementBase* mel = velements[ie].get_ptr();
+			if (typeid(*mel) == typeid(ChElementTetra_4))
+			{
+				batch_tetra4.push_back((ChElementTetra_4*)mel);
+				element_batched[ie] = 1;
+			}
+			else if (typeid(*mel) == typeid(ChElementHexa_8))
+			{
+				batch_hexa8.push_back((ChElementHexa_8*)mel);
+				element_batched[ie] = 1;
+			}
+		}
+	}
+
+	colors_valid = true;
+}
+
+
+// Returns in 'mpos' the position of a node, if it has one.
+static bool GetNodePosition(ChNodeFEMbase* mnode, ChVector<>& mpos)
+{
+	if (ChNodeFEMxyz* mnodexyz = dynamic_cast<ChNodeFEMxyz*>(mnode))
+		mpos = mnodexyz->GetPos();
+	else if (ChNodeFEMxyzP* mnodexyzP = dynamic_cast<ChNodeFEMxyzP*>(mnode))
+		mpos = mnodexyzP->GetPos();
+	else if (ChNodeFEMxyzrot* mnodexyzrot = dynamic_cast<ChNodeFEMxyzrot*>(mnode))
+		mpos = mnodexyzrot->GetPos();
+	else
+		return false;
+	return true;
+}
+
+// Spreads the lower 10 bits of x so that there are two zero bits between each.
+static unsigned int SpreadBits10(unsigned int x)
+{
+	x &= 0x3ff;
+	x = (x | (x << 16)) & 0x030000ff;
+	x = (x | (x <<  8)) & 0x0300f00f;
+	x = (x | (x <<  4)) & 0x030c30c3;
+	x = (x | (x <<  2)) & 0x09249249;
+	return x;
+}
+
+// Breadth-first visit of the nodes connected to 'mstart' that are not yet
+// visited, appending them to 'order' level by level, with the neighbours of
+// each node in order of increasing degree (Cuthill-McKee). Returns the number
+// of levels, and the position in 'order' where the last level begins; the
+// visited flags are set only if 'mark' is true.
+static int CuthillMcKeeVisit(unsigned int mstart, 
+							 const std::vector< std::vector<unsigned int> >& adjacency,
+							 std::vector<char>& visited,
+							 std::vector<unsigned int>& order,
+							 unsigned int& last_level_begin,
+							 bool mark)
+{
+	unsigned int mbegin = (unsigned int)order.size();
+	order.push_back(mstart);
+	visited[mstart] = 1;
+
+	std::vector< std::pair<unsigned int, unsigned int> > mneighbours;
+	int nlevels = 1;
+	unsigned int level_end = (unsigned int)order.size();
+	last_level_begin = mbegin;
+	for (unsigned int i = mbegin; i < order.size(); i++)
+	{
+		if (i == level_end)
+		{
+			++nlevels;
+			last_level_begin = i;
+			level_end = (unsigned int)order.size();
+		}
+		const std::vector<unsigned int>& madj = adjacency[order[i]];
+		mneighbours.clear();
+		for (unsigned int j = 0; j < madj.size(); j++)
+			if (!visited[madj[j]])
+			{
+				mneighbours.push_back(std::make_pair((unsigned int)adjacency[madj[j]].size(), madj[j]));
+				visited[madj[j]] = 1;
+			}
+		std::sort(mneighbours.begin(), mneighbours.end());
+		for (unsigned int j = 0; j < mneighbours.size(); j++)
+			order.push_back(mneighbours[j].second);
+	}
+	if (!mark)
+		for (unsigned int i = mbegin; i < order.size(); i++)
+			visited[order[i]] = 0;
+	return nlevels;
+}
+
+void ChMesh::ComputeNodeOrder(eChNodeOrdering mord, std::vector<unsigned int>& new_order)
+{
+	new_order.clear();
+	new_order.reserve(vnodes.size());
+
+	if (mord == NODEORDER_NONE)
+	{
+		for (unsigned int i = 0; i < vnodes.size(); i++)
+			new_order.push_back(i);
+	}
+	else if (mord == NODEORDER_RCM)
+	{
+		std::map<ChNodeFEMbase*, unsigned int> node_index;
+		for (unsigned int i = 0; i < vnodes.size(); i++)
+			node_index[vnodes[i].get_ptr()] = i;
+
+		// node-to-node connectivity through the elements
+		std::vector< std::vector<unsigned int> > adjacency(vnodes.size());
+		std::vector<unsigned int> melnodes;
+		for (unsigned int ie = 0; ie < velements.size(); ie++)
+		{
+			melnodes.clear();
+			for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+			{
+				std::map<ChNodeFEMbase*, unsigned int>::iterator it = node_index.find(velements[ie]->GetNodeN(in).get_ptr());
+				if (it != node_index.end())
+					melnodes.push_back(it->second);
+			}
+			for (unsigned int a = 0; a < melnodes.size(); a++)
+				for (unsigned int b = 0; b < melnodes.size(); b++)
+					if (melnodes[a] != melnodes[b])
+						adjacency[melnodes[a]].push_back(melnodes[b]);
+		}
+		for (unsigned int i = 0; i < adjacency.size(); i++)
+		{
+			std::sort(adjacency[i].begin(), adjacency[i].end());
+			adjacency[i].erase(std::unique(adjacency[i].begin(), adjacency[i].end()), adjacency[i].end());
+		}
+
+		// nodes by increasing degree: the first not yet visited is the
+		// node with lowest degree in its connected part of the mesh
+		std::vector< std::pair<unsigned int, unsigned int> > mdegrees(vnodes.size());
+		for (unsigned int i = 0; i < vnodes.size(); i++)
+			mdegrees[i] = std::make_pair((unsigned int)adjacency[i].size(), i);
+		std::sort(mdegrees.begin(), mdegrees.end());
+
+		std::vector<char> visited(vnodes.size(), 0);
+		std::vector<unsigned int> mlevel;
+		for (unsigned int i = 0; i < mdegrees.size(); i++)
+		{
+			if (visited[mdegrees[i].second])
+				continue;
+
+			// start from a pseudo-peripheral node of this connected part: from the node
+			// with the lowest degree, move to the farthest node with the lowest degree
+			// while this increases the number of levels (George-Liu).
+			unsigned int mstart = mdegrees[i].second;
+			unsigned int mlast;
+			mlevel.clear();
+			int nlevels = CuthillMcKeeVisit(mstart, adjacency, visited, mlevel, mlast, false);
+			for (int iter = 0; iter < 8 && nlevels > 1; iter++)
+			{
+				unsigned int mfar = mlevel[mlast];
+				for (unsigned int j = mlast; j < mlevel.size(); j++)
+					if (adjacency[mlevel[j]].size() < adjacency[mfar].size())
+						mfar = mlevel[j];
+				mlevel.clear();
+				int nlevels_far = CuthillMcKeeVisit(mfar, adjacency, visited, mlevel, mlast, false);
+				if (nlevels_far <= nlevels)
+					break;
+				mstart = mfar;
+				nlevels = nlevels_far;
+			}
+
+			CuthillMcKeeVisit(mstart, adjacency, visited, new_order, mlast, true);
+		}
+
+		std::reverse(new_order.begin(), new_order.end());
+	}
+	else if (mord == NODEORDER_MORTON)
+	{
+		// nodes without position, if any, go at the end in original order
+		std::vector<ChVector<> > mpos(vnodes.size());
+		std::vector<char> has_pos(vnodes.size(), 0);
+		ChVector<> mmin( 1e30);
+		ChVector<> mmax(-1e30);
+		for (unsigned int i = 0; i < vnodes.size(); i++)
+		{
+			if (!GetNodePosition(vnodes[i].get_ptr(), mpos[i]))
+				continue;
+			has_pos[i] = 1;
+			mmin.x = ChMin(mmin.x, mpos[i].x); mmax.x = ChMax(mmax.x, mpos[i].x);
+			mmin.y = ChMin(mmin.y, mpos[i].y); mmax.y = ChMax(mmax.y, mpos[i].y);
+			mmin.z = ChMin(mmin.z, mpos[i].z); mmax.z = ChMax(mmax.z, mpos[i].z);
+		}
+		// same scaling on the three axes, 10 bits per axis
+		double msize = ChMax(mmax.x - mmin.x, ChMax(mmax.y - mmin.y, mmax.z - mmin.z));
+		double mscale = (msize > 0) ? 1023.0 / msize : 0;
+
+		std::vector< std::pair<unsigned int, unsigned int> > mkeys(vnodes.size());
+		for (unsigned int i = 0; i < vnodes.size(); i++)
+		{
+			unsigned int mkey = 0xffffffff;
+			if (has_pos[i])
+				mkey = (SpreadBits10((unsigned int)((mpos[i].x - mmin.x) * mscale)) << 2) |
+					   (SpreadBits10((unsigned int)((mpos[i].y - mmin.y) * mscale)) << 1) |
+					    SpreadBits10((unsigned int)((mpos[i].z - mmin.z) * mscale));
+			mkeys[i] = std::make_pair(mkey, i);
+		}
+		std::sort(mkeys.begin(), mkeys.end());
+		for (unsigned int i = 0; i < mkeys.size(); i++)
+			new_order.push_back(mkeys[i].second);
+	}
+}
+
+void ChMesh::ReorderNodes(eChNodeOrdering mord)
+{
+	if (mord == NODEORDER_NONE || vnodes.empty())
+		return;
+
+	std::map<ChNodeFEMbase*, unsigned int> node_index;
+	for (unsigned int i = 0; i < vnodes.size(); i++)
+		node_index[vnodes[i].get_ptr()] = i;
+
+	// new_order[i] is the old index of the node that goes in i-th position
+	std::vector<unsigned int> new_order;
+	ComputeNodeOrder(mord, new_order);
+
+	std::vector<unsigned int> new_index(vnodes.size());
+	std::vector< ChSharedPtr<ChNodeFEMbase> > mnodes(vnodes.size());
+	for (unsigned int i = 0; i < new_order.size(); i++)
+	{
+		mnodes[i] = vnodes[new_order[i]];
+		new_index[new_order[i]] = i;
+	}
+	vnodes.swap(mnodes);
+
+	// sort elements by their lowest node index, keeping the original order for ties
+	std::vector< std::pair<unsigned int, unsigned int> > mkeys(velements.size());
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		unsigned int mkey = 0xffffffff;
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+		{
+			std::map<ChNodeFEMbase*, unsigned int>::iterator it = node_index.find(velements[ie]->GetNodeN(in).get_ptr());
+			if (it != node_index.end())
+				mkey = std::min(mkey, new_index[it->second]);
+		}
+		mkeys[ie] = std::make_pair(mkey, ie);
+	}
+	std::sort(mkeys.begin(), mkeys.end());
+	std::vector< ChSharedPtr<ChElementBase> > melements(velements.size());
+	for (unsigned int ie = 0; ie < mkeys.size(); ie++)
+		melements[ie] = velements[mkeys[ie].second];
+	velements.swap(melements);
+
+	colors_valid = false;
+}
+
+
+void ChMesh::SetupExplicitMasses()
+{
+	// remove the masses lumped at a previous setup, if any
+	for (std::map<ChNodeFEMbase*, double>::iterator it = explicit_lumped_mass.begin(); it != explicit_lumped_mass.end(); ++it)
+	{
+		ChNodeFEMxyz* mnode = (ChNodeFEMxyz*)it->first;
+		mnode->SetMass(mnode->GetMass() - it->second);
+	}
+	explicit_lumped_mass.clear();
+
+	if (!explicit_integration)
+		return;
+
+	for (unsigned int i = 0; i < vnodes.size(); i++)
+		if (!dynamic_cast<ChNodeFEMxyz*>(vnodes[i].get_ptr()))
+			throw ChException("Explicit integration of ChMesh needs ChNodeFEMxyz nodes only");
+
+	// row-sum lumping of the element mass matrices
+	ChMatrixDynamic<> Me;
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		int nd = velements[ie]->GetNdofs();
+		Me.Reset(nd, nd);
+		velements[ie]->ComputeKRMmatricesGlobal(Me, 0, 0, 1.0);
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+		{
+			double mnodemass = 0;
+			for (int k = 0; k < 3; k++)
+				for (int c = 0; c < nd; c++)
+					mnodemass += Me(3*in+k, c);
+			explicit_lumped_mass[velements[ie]->GetNodeN(in).get_ptr()] += mnodemass / 3.0;
+		}
+	}
+
+	for (std::map<ChNodeFEMbase*, double>::iterator it = explicit_lumped_mass.begin(); it != explicit_lumped_mass.end(); ++it)
+	{
+		ChNodeFEMxyz* mnode = (ChNodeFEMxyz*)it->first;
+		mnode->SetMass(mnode->GetMass() + it->second);
+	}
+}
+
+
+double ChMesh::ComputeCriticalTimeStep()
+{
+	element_critical_dt.assign(velements.size(), 1e30);
+	double mdt_min = 1e30;
+
+	ChMatrixDynamic<> Ke;
+	ChMatrixDynamic<> Me;
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		ChElementBase* mel = velements[ie].get_ptr();
+		int nd = mel->GetNdofs();
+		if (nd != 3 * mel->GetNnodes())
+			continue;
+		mel->Update();
+		Ke.Reset(nd, nd);
+		Me.Reset(nd, nd);
+		mel->ComputeKRMmatricesGlobal(Ke, 1.0, 0, 0);
+		mel->ComputeKRMmatricesGlobal(Me, 0, 0, 1.0);
+
+		// highest frequency of the element, bounded with Gershgorin circles of inv(M)*K,
+		// with the lumped element masses, or the node masses for massless elements
+		double momega2 = 0;
+		for (int r = 0; r < nd; r++)
+		{
+			double mk = 0, mm = 0;
+			for (int c = 0; c < nd; c++)
+			{
+				mk += fabs(Ke(r,c));
+				mm += Me(r,c);
+			}
+			if (mm <= 0)
+				if (ChNodeFEMxyz* mnode = dynamic_cast<ChNodeFEMxyz*>(mel->GetNodeN(r/3).get_ptr()))
+					mm = mnode->GetMass();
+			if (mm > 0)
+				momega2 = ChMax(momega2, mk / mm);
+		}
+		if (momega2 > 0)
+			element_critical_dt[ie] = 2.0 / sqrt(momega2);
+		mdt_min = ChMin(mdt_min, element_critical_dt[ie]);
+	}
+
+	return mdt_min;
+}
+
+
+void ChMesh::SetupSubcycling(double step)
+{
+	subcycling_step = step;
+	subcycling_levels = 0;
+	fast_nodes.clear();
+	fast_node_level.clear();
+	level_elements.clear();
+	element_fast_nodes.clear();
+
+	if (element_critical_dt.size() != velements.size())
+		ComputeCriticalTimeStep();
+
+	// level of each element: 2^level substeps make it stable
+	std::vector<int> element_level(velements.size(), 0);
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		double mdt = explicit_safety * element_critical_dt[ie];
+		int mlevel = 0;
+		while (mdt * (1 << mlevel) < step && mlevel < explicit_max_levels)
+			++mlevel;
+		if (mdt * (1 << mlevel) < step)
+		{
+			subcycling_step = 0;
+			std::ostringstream merr;
+			merr << "Explicit integration of ChMesh: element " << ie << " needs more subcycling levels than " << explicit_max_levels;
+			throw ChException(merr.str());
+		}
+		element_level[ie] = mlevel;
+		subcycling_levels = ChMax(subcycling_levels, mlevel);
+	}
+	if (subcycling_levels == 0)
+		return;
+
+	// level of each node: the highest level of its elements
+	std::map<ChNodeFEMbase*, int> node_level;
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+		{
+			int& mlevel = node_level[velements[ie]->GetNodeN(in).get_ptr()];
+			mlevel = ChMax(mlevel, element_level[ie]);
+		}
+
+	std::map<ChNodeFEMbase*, int> fast_index;
+	for (unsigned int i = 0; i < vnodes.size(); i++)
+	{
+		std::map<ChNodeFEMbase*, int>::iterator it = node_level.find(vnodes[i].get_ptr());
+		if (it == node_level.end() || it->second == 0 || vnodes[i]->GetFixed())
+			continue;
+		fast_index[it->first] = (int)fast_nodes.size();
+		fast_nodes.push_back((ChNodeFEMxyz*)it->first);
+		fast_node_level.push_back(it->second);
+	}
+
+	level_elements.resize(subcycling_levels + 1);
+	element_fast_nodes.resize(velements.size());
+	for (unsigned int ie = 0; ie < velements.size(); ie++)
+	{
+		int mlevel = 0;
+		for (int in = 0; in < velements[ie]->GetNnodes(); in++)
+		{
+			std::map<ChNodeFEMbase*, int>::iterator it = fast_index.find(velements[ie]->GetNodeN(in).get_ptr());
+			int mfast = (it == fast_index.end()) ? -1 : it->second;
+			element_fast_nodes[ie].push_back(mfast);
+			if (mfast >= 0)
+				mlevel = ChMax(mlevel, fast_node_level[mfast]);
+		}
+		for (int L = 1; L <= mlevel; L++)
+			level_elements[L].push_back(ie);
+	}
+
+	fast_pos0.resize(fast_nodes.size());
+	fast_vel0.resize(fast_nodes.size());
+	fast_pos_end.resize(fast_nodes.size());
+	fast_vel_end.resize(fast_nodes.size());
+	fast_substep_impulse.resize(fast_nodes.size());
+	fast_impulse.resize(fast_nodes.size());
+	fast_constrained.assign(fast_nodes.size(), false);
+}
+
+
+void ChMesh::ExplicitSubcycle(double step)
+{
+	int nf = (int)fast_nodes.size();
+	for (int i = 0; i < nf; i++)
+	{
+		fast_pos0[i] = fast_nodes[i]->GetPos();
+		fast_vel0[i] = fast_nodes[i]->GetPos_dt();
+		fast_impulse[i] = VNULL;
+	}
+
+	// Ticks of the finest level; at each tick, the elements touching nodes of
+	// level L are evaluated if the tick is a multiple of 2^(levels-L), and their
+	// forces act for a substep of step/2^L. Each node collects the impulses of its
+	// elements during its own substep, so that the nodes at the border between
+	// levels exchange the same impulses (the momentum is kept), and it is moved
+	// at the end of its substep: symplectic Euler, as in the step of the system.
+	// Constrained nodes move with their initial speed, and collect the impulse,
+	// so that the solver sees them as in a plain step.
+	int nticks = 1 << subcycling_levels;
+	ChMatrixDynamic<> Fi;
+	for (int i = 0; i < nf; i++)
+		fast_substep_impulse[i] = VNULL;
+	for (int s = 0; s < nticks; s++)
+	{
+		int mlevel = subcycling_levels;
+		while (mlevel > 1 && (s % (nticks >> (mlevel-1))) == 0)
+			--mlevel;
+
+		const std::vector<unsigned int>& melements = level_elements[mlevel];
+		for (unsigned int k = 0; k < melements.size(); k++)
+		{
+			ChElementBase* mel = velements[melements[k]].get_ptr();
+			const std::vector<int>& mfast = element_fast_nodes[melements[k]];
+			int mel_level = 0;
+			for (int in = 0; in < (int)mfast.size(); in++)
+				if (mfast[in] >= 0)
+					mel_level = ChMax(mel_level, fast_node_level[mfast[in]]);
+			double mdt = step / (double)(1 << mel_level);
+
+			mel->Update();
+			Fi.Resize(mel->GetNdofs(), 1);
+			mel->ComputeInternalForces(Fi);
+			for (int in = 0; in < (int)mfast.size(); in++)
+			{
+				if (mfast[in] >= 0)
+				{
+					fast_substep_impulse[mfast[in]] += Fi.ClipVector(3*in, 0) * mdt;
+				}
+				else
+				{
+					// not subcycled: these impulses replace the force at the beginning
+					// of the step, already loaded in 'fb'
+					ChLcpVariables& mvars = ((ChNodeFEMxyz*)mel->GetNodeN(in).get_ptr())->Variables();
+					mvars.Get_fb().PasteSumVector(Fi.ClipVector(3*in, 0) * (s == 0 ? mdt - step : mdt), 0, 0);
+				}
+			}
+		}
+
+		// nodes at the end of their substep
+		for (int i = 0; i < nf; i++)
+		{
+			int mperiod = nticks >> fast_node_level[i];
+			if ((s + 1) % mperiod != 0)
+				continue;
+			ChNodeFEMxyz* mnode = fast_nodes[i];
+			double mdt = step / (double)(1 << fast_node_level[i]);
+			ChVector<> mimpulse = fast_substep_impulse[i] + mnode->GetForce() * mdt;
+			fast_substep_impulse[i] = VNULL;
+			if (fast_constrained[i])
+				fast_impulse[i] += mimpulse;
+			else
+				mnode->SetPos_dt(mnode->GetPos_dt() + mimpulse * (1.0 / mnode->GetMass()));
+			mnode->SetPos(mnode->GetPos() + mnode->GetPos_dt() * mdt);
+		}
+	}
+
+	// Back to the state at the beginning of the step; the subcycled motion
+	// enters the step as the known term M*v_end, and the end positions are
+	// used in VariablesQbIncrementPosition()
+	for (int i = 0; i < nf; i++)
+	{
+		ChNodeFEMxyz* mnode = fast_nodes[i];
+		if (fast_constrained[i])
+		{
+			fast_vel_end[i] = fast_vel0[i] + fast_impulse[i] * (1.0 / mnode->GetMass());
+			fast_pos_end[i] = fast_pos0[i] + fast_vel_end[i] * step;
+		}
+		else
+		{
+			fast_pos_end[i] = mnode->GetPos();
+			fast_vel_end[i] = mnode->GetPos_dt();
+		}
+		mnode->SetPos(fast_pos0[i]);
+		mnode->SetPos_dt(fast_vel0[i]);
+		ChLcpVariables& mvars = mnode->Variables();
+		mvars.Get_fb().PasteVector(fast_vel_end[i] * mnode->GetMass(), 0, 0);
+	}
+	subcycled = true;
+
+	// elements touching fast nodes were rotated at intermediate states
+	for (unsigned int k = 0; k < level_elements[1].size(); k++)
+		velements[level_elements[1][k]]->Update();
 }
 
 
@@ -82,17 +670,25 @@ void ChMesh::AddNode ( ChSharedPtr<ChNodeFEMbase> m_node)
 void ChMesh::AddElement ( ChSharedPtr<ChElementBase> m_elem)
 {
 	this->velements.push_back(m_elem);
+	colors_valid = false;
 }
 
 void ChMesh::ClearElements ()
 {
 	velements.clear();
+	subcycling_step = 0;
+	element_colors.clear();
+	colors_valid = false;
 }
 
 void ChMesh::ClearNodes ()
 {
 	velements.clear();
 	vnodes.clear();
+	explicit_lumped_mass.clear();
+	subcycling_step = 0;
+	element_colors.clear();
+	colors_valid = false;
 }
 
 
@@ -107,171 +703,377 @@ void ChMesh::Update (double m_time)
 	// Parent class update
 	ChIndexedNodes::Update(m_time);
 	
-	for (unsigned int i=0; i< velements.size(); i++)
+	if (!colors_valid)
+	{
+		for (unsigned int i=0; i< velements.size(); i++)
+		{
+				//    - update auxiliary stuff, ex. update element's rotation matrices if corotational..
+			velements[i]->Update();
+		}
+		return;
+	}
+
+	// batched elements: only the rotation needs update
+	int nbatches = ((int)batch_tetra4.size() + BATCH_SIZE-1) / BATCH_SIZE;
+	#pragma omp parallel for schedule(static)
+	for (int ib = 0; ib < nbatches; ib++)
+		ChElementTetra_4::UpdateRotationBatch(&batch_tetra4[ib*BATCH_SIZE], ChMin(BATCH_SIZE, (int)batch_tetra4.size() - ib*BATCH_SIZE));
+
+	nbatches = ((int)batch_hexa8.size() + BATCH_SIZE-1) / BATCH_SIZE;
+	#pragma omp parallel for schedule(static)
+	for (int ib = 0; ib < nbatches; ib++)
+		ChElementHexa_8::UpdateRotationBatch(&batch_hexa8[ib*BATCH_SIZE], ChMin(BATCH_SIZE, (int)batch_hexa8.size() - ib*BATCH_SIZE));
+
+	for (unsigned int ic = 0; ic < element_colors.size(); ic++)
 	{
-			//    - update auxiliary stuff, ex. update element's rotation matrices if corotational..
-		velements[i]->Update();
+		const std::vector<unsigned int>& melements = element_colors[ic];
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < (int)melements.size(); i++)
+		{
+			if (element_batched[melements[i]])
+				continue;
+				//    - update auxiliary stuff, ex. update element's rotation matrices if corotational..
+			velements[melements[i]]->Update();
+		}
 	}
 
 }
 
 
-void ChMesh::LoadFromTetGenFile(const char* filename_node, const char* filename_ele, ChSharedPtr<ChContinuumMaterial> my_material)
+// Reads a whole text file with a single read, and collects the beginning of its
+// lines (leading white space skipped), except empty lines and '#' comments.
+static bool ReadTextLines(const char* filename, std::vector<char>& buffer, std::vector<char*>& lines)
 {
-	int totnodes = 0;
-	int nodes_offset = this->GetNnodes();
-	int added_nodes = 0;
-
-	// Load .node TetGen file
+	FILE* mfile = fopen(filename, "rb");
+	if (!mfile)
+		return false;
+	fseek(mfile, 0, SEEK_END);
+	long msize = ftell(mfile);
+	fseek(mfile, 0, SEEK_SET);
+	buffer.resize(msize > 0 ? msize + 1 : 1);
+	size_t nread = (msize > 0) ? fread(&buffer[0], 1, msize, mfile) : 0;
+	fclose(mfile);
+	buffer[nread] = 0;
+
+	lines.clear();
+	char* mc   = &buffer[0];
+	char* mend = mc + nread;
+	while (mc < mend)
 	{
-		bool parse_header = true;
-		bool parse_nodes = false;
-		
-		fstream fin(filename_node);
-		if (!fin.good())
-			throw ChException("ERROR opening TetGen .node file: " + std::string(filename_node) + "\n");
+		char* mline = mc;
+		while (mc < mend && *mc != '\n')
+			++mc;
+		*mc = 0;
+		++mc;
+		while (isspace((unsigned char)*mline))
+			++mline;
+		if (*mline == 0 || *mline == '#')
+			continue; // skip empty lines and comments
+		lines.push_back(mline);
+	}
+	return true;
+}
 
-		int nnodes = 0;
-		int ndims = 0;
-		int nattrs = 0;
-		int nboundarymark = 0;
+// Parses n integers, then n_double doubles, from a line; returns false if some are missing.
+static bool ParseNumbers(const char* mline, int n_int, long* ivals, int n_double, double* dvals)
+{
+	const char* mc = mline;
+	char* mnext;
+	for (int i = 0; i < n_int; i++)
+	{
+		ivals[i] = strtol(mc, &mnext, 10);
+		if (mnext == mc)
+			return false;
+		mc = mnext;
+	}
+	for (int i = 0; i < n_double; i++)
+	{
+		dvals[i] = strtod(mc, &mnext);
+		if (mnext == mc)
+			return false;
+		mc = mnext;
+	}
+	return true;
+}
 
-		string line;
-		while(getline(fin, line)) 
+// Parses a TetGen .node file into an array of x,y,z coordinates.
+// Lines are parsed in parallel.
+static void ParseTetGenNodes(const char* filename_node, std::vector<double>& coords)
+{
+	std::vector<char> buffer;
+	std::vector<char*> lines;
+	if (!ReadTextLines(filename_node, buffer, lines))
+		throw ChException("ERROR opening TetGen .node file: " + std::string(filename_node) + "\n");
+
+	coords.clear();
+	if (lines.empty())
+		return;
+
+	long header[4] = {0,0,0,0};
+	if (!ParseNumbers(lines[0], 4, header, 0, 0))
+		throw ChException("ERROR in TetGen .node file. Header must have 4 numbers: \n"+ std::string(lines[0]));
+	int nnodes = (int)header[0];
+	if (header[1] != 3)
+		throw ChException("ERROR in TetGen .node file. Only 3 dimensional nodes supported: \n"+ std::string(lines[0]));
+	if (header[2] != 0)
+		throw ChException("ERROR in TetGen .node file. Only nodes with 0 attrs supported: \n"+ std::string(lines[0]));
+	if (header[3] != 0)
+		throw ChException("ERROR in TetGen .node file. Only nodes with 0 markers supported: \n"+ std::string(lines[0]));
+
+	int nlines = (int)lines.size() - 1;
+	coords.resize(3*nlines);
+	int first_error = nlines;
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nlines; i++)
+	{
+		long idnode = 0;
+		bool ok = ParseNumbers(lines[i+1], 1, &idnode, 3, &coords[3*i]);
+		if (!ok || idnode != i+1 || idnode > nnodes)
 		{
-			//trims white space from the beginning of the string
-			line.erase(line.begin(), find_if(line.begin(), line.end(), not1(ptr_fun<int, int>(isspace)))); 
-
-			if(line[0] == '#') continue; // skip comment
-			if(line[0] == 0) continue; // skip empty lines
-
-			if (parse_header)
+			#pragma omp critical
 			{
-				stringstream(line) >> nnodes >> ndims >> nattrs >> nboundarymark;
-				if (ndims != 3)
-					throw ChException("ERROR in TetGen .node file. Only 3 dimensional nodes supported: \n"+ line);
-				if (nattrs != 0)
-					throw ChException("ERROR in TetGen .node file. Only nodes with 0 attrs supported: \n"+ line);
-				if (nboundarymark != 0)
-					throw ChException("ERROR in TetGen .node file. Only nodes with 0 markers supported: \n"+ line);
-				parse_header = false;
-				parse_nodes = true;
-				totnodes = nnodes;
-				continue;
+				if (i < first_error)
+					first_error = i;
 			}
+		}
+	}
 
-			int idnode = 0;
-			double x = -10e30;
-			double y = -10e30;
-			double z = -10e30;
+	if (first_error < nlines)
+	{
+		std::string line(lines[first_error+1]);
+		long idnode = 0;
+		double xyz[3];
+		bool ok = ParseNumbers(lines[first_error+1], 1, &idnode, 3, xyz);
+		if (idnode <= 0 || idnode > nnodes)
+			throw ChException("ERROR in TetGen .node file. Node ID not in range: \n"+ line +"\n");
+		if (idnode != first_error+1)
+			throw ChException("ERROR in TetGen .node file. Nodes IDs must be sequential (1 2 3 ..): \n"+ line+"\n");
+		throw ChException("ERROR in TetGen .node file, in parsing x,y,z coordinates of node: \n"+ line+"\n");
+	}
 
-			if (parse_nodes)
-			{
-				stringstream(line) >> idnode >> x >> y >> z;
-				++added_nodes;
-				if (idnode <= 0 || idnode > nnodes)
-					throw ChException("ERROR in TetGen .node file. Node ID not in range: \n"+ line +"\n");
-				if (idnode != added_nodes)
-					throw ChException("ERROR in TetGen .node file. Nodes IDs must be sequential (1 2 3 ..): \n"+ line+"\n");
-				if (x == -10e30 || y == -10e30 || z == -10e30 )
-					throw ChException("ERROR in TetGen .node file, in parsing x,y,z coordinates of node: \n"+ line+"\n");
-				
-				if (my_material.IsType<ChContinuumElastic>() )
-				{
-					ChSharedPtr<ChNodeFEMxyz> mnode( new ChNodeFEMxyz(ChVector<>(x,y,z)) );
-					this->AddNode(mnode);
-				}
-				else if (my_material.IsType<ChContinuumPoisson3D>() )
-				{
-					ChSharedPtr<ChNodeFEMxyzP> mnode( new ChNodeFEMxyzP(ChVector<>(x,y,z)) );
-					this->AddNode(mnode);
-				}
-				else throw ChException("ERROR in TetGen generation. Material type not supported. \n");
+	// all IDs are in range and sequential, so only a truncated file has fewer lines
+	if (nlines != nnodes)
+		throw ChException("ERROR in TetGen .node file. Fewer nodes than in the header (truncated file?): \n"+ std::string(lines[0])+"\n");
+}
 
+// Parses a TetGen .ele file into an array of 0-based node indexes, four per tetrahedron.
+// Lines are parsed in parallel.
+static void ParseTetGenElements(const char* filename_ele, int totnodes, std::vector<int>& tets)
+{
+	std::vector<char> buffer;
+	std::vector<char*> lines;
+	if (!ReadTextLines(filename_ele, buffer, lines))
+		throw ChException("ERROR opening TetGen .ele file: " + std::string(filename_ele) + "\n");
+
+	tets.clear();
+	if (lines.empty())
+		return;
+
+	long header[3] = {0,0,0};
+	if (!ParseNumbers(lines[0], 3, header, 0, 0))
+		throw ChException("ERROR in TetGen .ele file. Header must have 3 numbers: \n"+ std::string(lines[0])+"\n");
+	int ntets = (int)header[0];
+	if (header[1] != 4)
+		throw ChException("ERROR in TetGen .ele file. Only 4 -nodes per tes supported: \n"+ std::string(lines[0])+"\n");
+	if (header[2] != 0)
+		throw ChException("ERROR in TetGen .ele file. Only tets with 0 attrs supported: \n"+ std::string(lines[0])+"\n");
+
+	int nlines = (int)lines.size() - 1;
+	tets.resize(4*nlines);
+	int first_error = nlines;
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nlines; i++)
+	{
+		long vals[5] = {0,0,0,0,0};
+		bool ok = ParseNumbers(lines[i+1], 5, vals, 0, 0);
+		ok = ok && (vals[0] > 0 && vals[0] <= ntets);
+		for (int in = 1; in < 5; in++)
+		{
+			ok = ok && (vals[in] > 0 && vals[in] <= totnodes);
+			tets[4*i+in-1] = (int)vals[in] - 1;
+		}
+		if (!ok)
+		{
+			#pragma omp critical
+			{
+				if (i < first_error)
+					first_error = i;
 			}
+		}
+	}
 
-		} // end while
-        
-    }// end .node file
+	if (first_error < nlines)
+	{
+		std::string line(lines[first_error+1]);
+		long vals[5] = {0,0,0,0,0};
+		ParseNumbers(lines[first_error+1], 5, vals, 0, 0);
+		if (vals[0] <= 0 || vals[0] > ntets)
+			throw ChException("ERROR in TetGen .ele file. Tetahedron ID not in range: \n"+ line+"\n");
+		const char* which[4] = {"1st","2nd","3rd","4th"};
+		for (int in = 1; in < 5; in++)
+			if (vals[in] <= 0 || vals[in] > totnodes)
+				throw ChException("ERROR in TetGen .ele file, ID of " + std::string(which[in-1]) + " node is out of range: \n"+ line+"\n");
+		throw ChException("ERROR in TetGen .ele file, in parsing tetahedron: \n"+ line+"\n");
+	}
 
-	// Load .ele TetGen file
+	// the IDs of the tetahedrons are only checked to be in range, so count the lines
+	if (nlines != ntets)
+		throw ChException("ERROR in TetGen .ele file. The number of tetahedrons differs from the header: \n"+ std::string(lines[0])+"\n");
+}
+
+// Size and modification time of a file, to check if caches are outdated.
+static void GetFileStamp(const char* filename, double& size, double& mtime)
+{
+	struct stat mstat;
+	if (stat(filename, &mstat) != 0)
 	{
-		bool parse_header = true;
-		bool parse_tet  = false;
+		size  = -1;
+		mtime = -1;
+		return;
+	}
+	size  = (double)mstat.st_size;
+	mtime = (double)mstat.st_mtime;
+}
 
-		fstream fin(filename_ele);
-		if (!fin.good())
-			throw ChException("ERROR opening TetGen .node file: " + std::string(filename_node) + "\n");
 
-		int ntets, nnodespertet, nattrs = 0;
+void ChMesh::AddTetGenMesh(const std::vector<double>& coords, const std::vector<int>& tets, ChSharedPtr<ChContinuumMaterial> my_material)
+{
+	int nnodes = (int)coords.size() / 3;
+	int ntets  = (int)tets.size() / 4;
+	if (nnodes == 0 && ntets == 0)
+		return;
+
+	this->vnodes.reserve(this->vnodes.size() + nnodes);
+	this->velements.reserve(this->velements.size() + ntets);
 
-		string line;
-		while(getline(fin, line)) 
+	if (my_material.IsType<ChContinuumElastic>() )
+	{
+		ChSharedPtr<ChContinuumElastic> mmaterial = my_material.DynamicCastTo<ChContinuumElastic>();
+		std::vector< ChSharedPtr<ChNodeFEMxyz> > mnodes(nnodes);
+		for (int i = 0; i < nnodes; i++)
+		{
+			mnodes[i] = ChSharedPtr<ChNodeFEMxyz>( new ChNodeFEMxyz(ChVector<>(coords[3*i], coords[3*i+1], coords[3*i+2])) );
+			this->AddNode(mnodes[i]);
+		}
+		for (int i = 0; i < ntets; i++)
 		{
-			//trims white space from the beginning of the string
-			line.erase(line.begin(), find_if(line.begin(), line.end(), not1(ptr_fun<int, int>(isspace)))); 
+			ChSharedPtr<ChElementTetra_4> mel( new ChElementTetra_4 );
+			mel->SetNodes(mnodes[tets[4*i]], mnodes[tets[4*i+2]], mnodes[tets[4*i+1]], mnodes[tets[4*i+3]]);
+			mel->SetMaterial(mmaterial);
+			this->AddElement(mel);
+		}
+	}
+	else if (my_material.IsType<ChContinuumPoisson3D>() )
+	{
+		ChSharedPtr<ChContinuumPoisson3D> mmaterial = my_material.DynamicCastTo<ChContinuumPoisson3D>();
+		std::vector< ChSharedPtr<ChNodeFEMxyzP> > mnodes(nnodes);
+		for (int i = 0; i < nnodes; i++)
+		{
+			mnodes[i] = ChSharedPtr<ChNodeFEMxyzP>( new ChNodeFEMxyzP(ChVector<>(coords[3*i], coords[3*i+1], coords[3*i+2])) );
+			this->AddNode(mnodes[i]);
+		}
+		for (int i = 0; i < ntets; i++)
+		{
+			ChSharedPtr<ChElementTetra_4_P> mel( new ChElementTetra_4_P );
+			mel->SetNodes(mnodes[tets[4*i]], mnodes[tets[4*i+2]], mnodes[tets[4*i+1]], mnodes[tets[4*i+3]]);
+			mel->SetMaterial(mmaterial);
+			this->AddElement(mel);
+		}
+	}
+	else throw ChException("ERROR in TetGen generation. Material type not supported. \n");
+}
 
-			if(line[0] == '#') continue; // skip comment
-			if(line[0] == 0) continue; // skip empty lines
 
-			if (parse_header)
-			{
-				stringstream(line) >> ntets >> nnodespertet >> nattrs;
-				if (nnodespertet != 4)
-					throw ChException("ERROR in TetGen .ele file. Only 4 -nodes per tes supported: \n"+ line+"\n");
-				if (nattrs != 0)
-					throw ChException("ERROR in TetGen .ele file. Only tets with 0 attrs supported: \n"+ line+"\n");
-				parse_header = false;
-				parse_tet = true;
-				continue;
-			}
+void ChMesh::LoadFromTetGenFile(const char* filename_node, const char* filename_ele, ChSharedPtr<ChContinuumMaterial> my_material)
+{
+	std::vector<double> coords;
+	std::vector<int> tets;
 
-			int idtet = 0;
-			int n1,n2,n3,n4;
+	ParseTetGenNodes(filename_node, coords);
+	ParseTetGenElements(filename_ele, (int)coords.size()/3, tets);
 
-			if (parse_tet)
+	AddTetGenMesh(coords, tets, my_material);
+}
+
+
+void ChMesh::LoadFromTetGenFileCached(const char* filename_node, const char* filename_ele, ChSharedPtr<ChContinuumMaterial> my_material, const char* filename_cache)
+{
+	double stamp[4];
+	GetFileStamp(filename_node, stamp[0], stamp[1]);
+	GetFileStamp(filename_ele,  stamp[2], stamp[3]);
+
+	std::vector<double> coords;
+	std::vector<int> tets;
+
+	// Try to load from the cache file, if already existing and not outdated
+	if (std::ifstream(filename_cache).good())
+	{
+		try
+		{
+			ChStreamInBinaryFile mstream(filename_cache);
+			std::string tag;
+			mstream >> tag;
+			if (tag == "chmesh_tetgen_binary" && mstream.VersionRead() == 1)
 			{
-				stringstream(line) >> idtet >> n1 >> n2 >> n3 >> n4;
-				if (idtet <= 0 || idtet > ntets)
-					throw ChException("ERROR in TetGen .node file. Tetahedron ID not in range: \n"+ line+"\n");
-				if (n1 > totnodes)
-					throw ChException("ERROR in TetGen .node file, ID of 1st node is out of range: \n"+ line+"\n");
-				if (n2 > totnodes)
-					throw ChException("ERROR in TetGen .node file, ID of 2nd node is out of range: \n"+ line+"\n");
-				if (n3 > totnodes)
-					throw ChException("ERROR in TetGen .node file, ID of 3rd node is out of range: \n"+ line+"\n");
-				if (n4 > totnodes)
-					throw ChException("ERROR in TetGen .node file, ID of 4th node is out of range: \n"+ line+"\n");
-				
-				if (my_material.IsType<ChContinuumElastic>() )
+				double cache_stamp[4];
+				mstream.ArrayBinaryInput(cache_stamp, 4);
+				if (cache_stamp[0] == stamp[0] && cache_stamp[1] == stamp[1] && 
+					cache_stamp[2] == stamp[2] && cache_stamp[3] == stamp[3])
 				{
-					ChSharedPtr<ChElementTetra_4> mel( new ChElementTetra_4 );
-					mel->SetNodes(
-						this->GetNode(nodes_offset + n1-1).DynamicCastTo<ChNodeFEMxyz>(), 
-						this->GetNode(nodes_offset + n3-1).DynamicCastTo<ChNodeFEMxyz>(), 
-						this->GetNode(nodes_offset + n2-1).DynamicCastTo<ChNodeFEMxyz>(), 
-						this->GetNode(nodes_offset + n4-1).DynamicCastTo<ChNodeFEMxyz>() );
-					mel->SetMaterial(my_material.DynamicCastTo<ChContinuumElastic>());
-					this->AddElement(mel);
-				} 
-				else if (my_material.IsType<ChContinuumPoisson3D>() )
-				{
-					ChSharedPtr<ChElementTetra_4_P> mel( new ChElementTetra_4_P );
-					mel->SetNodes(
-						this->GetNode(nodes_offset + n1-1).DynamicCastTo<ChNodeFEMxyzP>(), 
-						this->GetNode(nodes_offset + n3-1).DynamicCastTo<ChNodeFEMxyzP>(), 
-						this->GetNode(nodes_offset + n2-1).DynamicCastTo<ChNodeFEMxyzP>(), 
-						this->GetNode(nodes_offset + n4-1).DynamicCastTo<ChNodeFEMxyzP>() );
-					mel->SetMaterial(my_material.DynamicCastTo<ChContinuumPoisson3D>());
-					this->AddElement(mel);
+					unsigned int ncoords, ntetindexes;
+					mstream >> ncoords;
+					coords.resize(ncoords);
+					if (ncoords)
+						mstream.ArrayBinaryInput(&coords[0], ncoords);
+					mstream >> ntetindexes;
+					tets.resize(ntetindexes);
+					if (ntetindexes)
+						mstream.ArrayBinaryInput(&tets[0], ntetindexes);
+
+					// a corrupted cache is parsed again, as an outdated one
+					bool ok = (ncoords % 3 == 0) && (ntetindexes % 4 == 0);
+					for (unsigned int i = 0; ok && i < ntetindexes; i++)
+						ok = (tets[i] >= 0 && tets[i] < (int)ncoords / 3);
+					if (ok)
+					{
+						AddTetGenMesh(coords, tets, my_material);
+						return;
+					}
 				}
-				else throw ChException("ERROR in TetGen generation. Material type not supported. \n");
-
 			}
+		}
+		catch (const ChException&)
+		{
+			GetLog() << "Cannot load mesh from " << filename_cache << ", parsing TetGen files.\n";
+		}
+	}
 
-		} // end while
-        
-    }// end .ele file
+	// Not in cache, or outdated: parse and store
+	ParseTetGenNodes(filename_node, coords);
+	ParseTetGenElements(filename_ele, (int)coords.size()/3, tets);
+
+	try
+	{
+		ChStreamOutBinaryFile mstream(filename_cache);
+		std::string tag("chmesh_tetgen_binary");
+		mstream << tag;
+		mstream.VersionWrite(1);
+		mstream.ArrayBinaryOutput(stamp, 4);
+		mstream << (unsigned int)coords.size();
+		if (coords.size())
+			mstream.ArrayBinaryOutput(&coords[0], coords.size());
+		mstream << (unsigned int)tets.size();
+		if (tets.size())
+			mstream.ArrayBinaryOutput(&tets[0], tets.size());
+	}
+	catch (const ChException&)
+	{
+		GetLog() << "Cannot save mesh into " << filename_cache << "\n";
+	}
+
+	AddTetGenMesh(coords, tets, my_material);
 }
 
 
@@ -497,14 +1299,44 @@ void ChMesh::LoadFromAbaqusFile(const char* filename,
 
 void ChMesh::InjectKRMmatrices(ChLcpSystemDescriptor& mdescriptor) 
 {
+	// explicit integration: masses are lumped in the nodes, no stiffness blocks
+	if (explicit_integration)
+		return;
+
 	for (unsigned int ie = 0; ie < this->velements.size(); ie++)
 		this->velements[ie]->InjectKRMmatrices(mdescriptor);
 }
 
 void ChMesh::KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor)
 {
-	for (unsigned int ie = 0; ie < this->velements.size(); ie++)
-		this->velements[ie]->KRMmatricesLoad(Kfactor, Rfactor, Mfactor);
+	if (explicit_integration)
+		return;
+
+	if (!colors_valid)
+	{
+		for (unsigned int ie = 0; ie < this->velements.size(); ie++)
+			this->velements[ie]->KRMmatricesLoad(Kfactor, Rfactor, Mfactor);
+		return;
+	}
+
+	int nbatches = ((int)batch_tetra4.size() + BATCH_SIZE-1) / BATCH_SIZE;
+	#pragma omp parallel for schedule(static)
+	for (int ib = 0; ib < nbatches; ib++)
+		ChElementTetra_4::KRMmatricesLoadBatch(&batch_tetra4[ib*BATCH_SIZE], ChMin(BATCH_SIZE, (int)batch_tetra4.size() - ib*BATCH_SIZE), Kfactor, Rfactor, Mfactor);
+
+	nbatches = ((int)batch_hexa8.size() + BATCH_SIZE-1) / BATCH_SIZE;
+	#pragma omp parallel for schedule(static)
+	for (int ib = 0; ib < nbatches; ib++)
+		ChElementHexa_8::KRMmatricesLoadBatch(&batch_hexa8[ib*BATCH_SIZE], ChMin(BATCH_SIZE, (int)batch_hexa8.size() - ib*BATCH_SIZE), Kfactor, Rfactor, Mfactor);
+
+	for (unsigned int ic = 0; ic < element_colors.size(); ic++)
+	{
+		const std::vector<unsigned int>& melements = element_colors[ic];
+		#pragma omp parallel for schedule(static)
+		for (int ie = 0; ie < (int)melements.size(); ie++)
+			if (!element_batched[melements[ie]])
+				this->velements[melements[ie]]->KRMmatricesLoad(Kfactor, Rfactor, Mfactor);
+	}
 }
 
 void ChMesh::VariablesFbReset()
@@ -520,8 +1352,41 @@ void ChMesh::VariablesFbLoadForces(double factor)
 		this->vnodes[in]->VariablesFbLoadForces(factor);
 
 	// internal forces
-	for (unsigned int ie = 0; ie < this->velements.size(); ie++)
-		this->velements[ie]->VariablesFbLoadInternalForces(factor);
+	if (!colors_valid)
+	{
+		for (unsigned int ie = 0; ie < this->velements.size(); ie++)
+			this->velements[ie]->VariablesFbLoadInternalForces(factor);
+	}
+	else
+	{
+		// elements of the same color do not share nodes, so they can
+		// add to the nodal 'fb' in parallel
+		for (unsigned int ic = 0; ic < element_colors.size(); ic++)
+		{
+			const std::vector<unsigned int>& melements = element_colors[ic];
+			#pragma omp parallel for schedule(static)
+			for (int ie = 0; ie < (int)melements.size(); ie++)
+				this->velements[melements[ie]]->VariablesFbLoadInternalForces(factor);
+		}
+	}
+
+	// the subcycled nodes, if any, are advanced by VariablesFbLoadSubsteps(),
+	// called only in dynamic steps
+	subcycled = false;
+}
+
+void ChMesh::VariablesFbLoadSubsteps(double step)
+{
+	// explicit integration with subcycling: the nodes of the smallest elements
+	// are advanced with substeps
+	subcycled = false;
+	if (explicit_integration && explicit_max_levels > 0 && step > 0)
+	{
+		if (step != subcycling_step)
+			SetupSubcycling(step);
+		if (!fast_nodes.empty())
+			ExplicitSubcycle(step);
+	}
 }
 
 void ChMesh::VariablesQbLoadSpeed() 
@@ -536,9 +1401,25 @@ void ChMesh::VariablesFbIncrementMq()
 	for (unsigned int ie = 0; ie < this->vnodes.size(); ie++)
 		this->vnodes[ie]->VariablesFbIncrementMq();
 
+	// explicit integration: element masses are already lumped in the nodes
+	if (explicit_integration)
+		return;
+
 	// internal masses
-	for (unsigned int ie = 0; ie < this->velements.size(); ie++)
-		this->velements[ie]->VariablesFbIncrementMq();
+	if (!colors_valid)
+	{
+		for (unsigned int ie = 0; ie < this->velements.size(); ie++)
+			this->velements[ie]->VariablesFbIncrementMq();
+		return;
+	}
+
+	for (unsigned int ic = 0; ic < element_colors.size(); ic++)
+	{
+		const std::vector<unsigned int>& melements = element_colors[ic];
+		#pragma omp parallel for schedule(static)
+		for (int ie = 0; ie < (int)melements.size(); ie++)
+			this->velements[melements[ie]]->VariablesFbIncrementMq();
+	}
 }
 
 void ChMesh::VariablesQbSetSpeed(double step) 
@@ -551,6 +1432,22 @@ void ChMesh::VariablesQbIncrementPosition(double step)
 {
 	for (unsigned int ie = 0; ie < this->vnodes.size(); ie++)
 		this->vnodes[ie]->VariablesQbIncrementPosition(step);
+
+	// subcycled nodes: end positions of the substeps, plus the effect of 
+	// the speed correction given by the solver (ex. by constraints). Nodes
+	// that got a correction are not subcycled in the next step, because
+	// constraint reactions act only once per step.
+	if (subcycled)
+	{
+		for (unsigned int i = 0; i < fast_nodes.size(); i++)
+		{
+			ChVector<> mspeed = fast_nodes[i]->Variables().Get_qb().ClipVector(0,0);
+			ChVector<> mcorrection = mspeed - fast_vel_end[i];
+			fast_nodes[i]->SetPos(fast_pos_end[i] + mcorrection * step);
+			fast_constrained[i] = mcorrection.Length() > 1e-9 * (mspeed.Length() + fast_vel_end[i].Length());
+		}
+		subcycled = false;
+	}
 }
 
 void ChMesh::InjectVariables(ChLcpSystemDescriptor& mdescriptor)
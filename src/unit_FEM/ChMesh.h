@@ -16,9 +16,11 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <map>
 
 #include "physics/ChIndexedNodes.h"
 #include "physics/ChContinuumMaterial.h"
+#include "lcp/ChLcpKblockGeneric.h"
 #include "ChNodeFEMbase.h"
 #include "ChElementBase.h"
 
@@ -29,6 +31,10 @@ namespace chrono
 namespace fem
 {
 
+class ChElementTetra_4;
+class ChElementHexa_8;
+class ChNodeFEMxyz;
+
 
 
 /// Class which defines a mesh of finite elements of class ChFelem,
@@ -39,6 +45,16 @@ class ChApiFem ChMesh : public ChIndexedNodes
 			// Chrono simulation of RTTI, needed for serialization
 	CH_RTTI(ChMesh,ChIndexedNodes);
 
+public:
+				/// Ordering of nodes and elements that can be applied
+				/// by SetupInitial(), see SetNodeOrdering()
+	enum eChNodeOrdering
+	{
+		NODEORDER_NONE = 0,	///< keep the order of insertion
+		NODEORDER_RCM,		///< reverse Cuthill-McKee, minimizes the bandwidth
+		NODEORDER_MORTON	///< Morton (Z-order) curve over node positions
+	};
+
 private:
 
 	std::vector< ChSharedPtr<ChNodeFEMbase> >	 vnodes;	//  nodes
@@ -46,10 +62,53 @@ private:
 
 	unsigned int n_dofs; // total degrees of freedom
 
+	std::vector< std::vector<unsigned int> > element_colors; // element indexes, grouped so that elements with same color do not share nodes
+	bool colors_valid;
+
+	bool use_batches;
+	std::vector< ChElementTetra_4* > batch_tetra4;	// elements updated with batched corotation
+	std::vector< ChElementHexa_8* >  batch_hexa8;
+	std::vector< char > element_batched;			// per element: 1 if in one of the batches above
+
+	eChNodeOrdering node_ordering;
+	ChLcpKblockGeneric::eChKstorage kblock_storage;
+
+	bool explicit_integration;
+	int explicit_max_levels;
+	double explicit_safety;
+	std::vector<double> element_critical_dt;
+	std::map<ChNodeFEMbase*, double> explicit_lumped_mass;	// mass added to each node for explicit integration
+
+		// subcycling of the explicit integration
+	double subcycling_step;
+	int subcycling_levels;
+	bool subcycled;
+	std::vector<ChNodeFEMxyz*> fast_nodes;					// nodes that need substeps
+	std::vector<int> fast_node_level;						// 2^level substeps per step
+	std::vector< std::vector<unsigned int> > level_elements;	// [L]: elements touching nodes with level >= L
+	std::vector< std::vector<int> > element_fast_nodes;		// per element: index in fast_nodes of each node, or -1
+	std::vector< ChVector<> > fast_pos0;
+	std::vector< ChVector<> > fast_vel0;
+	std::vector< ChVector<> > fast_pos_end;
+	std::vector< ChVector<> > fast_vel_end;
+	std::vector< ChVector<> > fast_substep_impulse;			// impulse of the elements in the current substep
+	std::vector< ChVector<> > fast_impulse;
+	std::vector< bool > fast_constrained;	// corrected by the solver in the last step: kept on their speed during substeps
+
+	void SetupExplicitMasses();
+	void SetupSubcycling(double step);
+	void ExplicitSubcycle(double step);
+
+		// Adds nodes and tetahedrons from arrays of x,y,z coordinates and
+		// of 0-based node indexes (4 per tetahedron, in TetGen ordering).
+	void AddTetGenMesh(const std::vector<double>& coords, const std::vector<int>& tets, ChSharedPtr<ChContinuumMaterial> my_material);
+
 
 public:
 
-	ChMesh() { n_dofs = 0;};
+	ChMesh() { n_dofs = 0; colors_valid = false; use_batches = true; node_ordering = NODEORDER_NONE; kblock_storage = ChLcpKblockGeneric::KSTORAGE_FULL;
+			   explicit_integration = false; explicit_max_levels = 0; explicit_safety = 0.9;
+			   subcycling_step = 0; subcycling_levels = 0; subcycled = false;};
 	~ChMesh() {};
 
 	void AddNode    ( ChSharedPtr<ChNodeFEMbase> m_node);
@@ -66,10 +125,95 @@ public:
 	unsigned int GetNelements () {return velements.size();}
 	virtual  int GetDOF () {return n_dofs;}
 
+				/// - Reorders nodes and elements, if enabled with SetNodeOrdering()
+				/// - Sets the storage of element stiffness blocks, see SetKblockStorage()
+				/// - Lumps the element masses into the nodes, if explicit integration is enabled
 				/// - Computes the total number of degrees of freedom
 				/// - Precompute auxiliary data, such as (local) stiffness matrices Kl, if any, for each element.
 	void SetupInitial ();				
 
+				/// Set the ordering of nodes applied by SetupInitial(). Nodes that are
+				/// close in the mesh end up close in memory and in the system descriptor,
+				/// improving the cache use of element loops and reducing the bandwidth
+				/// (hence the fill-in) for direct solvers. Default: NODEORDER_NONE.
+				/// Note that this changes the indexes used by GetNode() and GetElement().
+	void SetNodeOrdering(eChNodeOrdering mord) { node_ordering = mord; }
+	eChNodeOrdering GetNodeOrdering() {return node_ordering;}
+
+				/// Reorders the nodes with the given ordering, then sorts the elements
+				/// by their lowest node index. Called by SetupInitial() if a node
+				/// ordering is set, but can also be called directly.
+	void ReorderNodes (eChNodeOrdering mord);
+
+				/// Computes the ordering of the nodes without applying it:
+				/// new_order[i] is the current index of the node that the ordering
+				/// puts in i-th position. Useful to number the dofs of the mesh in
+				/// algorithms that must not change the mesh (ex. ChReducedMesh).
+	void ComputeNodeOrder (eChNodeOrdering mord, std::vector<unsigned int>& new_order);
+
+				/// Set the storage of the stiffness blocks of the elements (those
+				/// inherited from ChElementGeneric), applied by SetupInitial(). 
+				/// The packed symmetric storages save about half of the memory of
+				/// the Kblocks (three quarters in single precision), and memory
+				/// bandwidth in iterative solvers. Default: KSTORAGE_FULL.
+	void SetKblockStorage(ChLcpKblockGeneric::eChKstorage mstorage) { kblock_storage = mstorage; }
+	ChLcpKblockGeneric::eChKstorage GetKblockStorage() {return kblock_storage;}
+
+				/// Enable the explicit integration of the mesh, applied by SetupInitial().
+				/// The masses of the elements are lumped into the nodes, and the mesh 
+				/// does not inject stiffness blocks: each step only needs the internal 
+				/// forces of the elements (ComputeInternalForces()), and the solver sees
+				/// the mesh as a set of point masses, coupled to rigid bodies through
+				/// ChLinkPointFrame constraints as usual. Any LCP solver can be used,
+				/// not only MINRES. The time step must be smaller than the critical
+				/// time step, see ComputeCriticalTimeStep(), unless subcycling is used.
+				/// Only for meshes with ChNodeFEMxyz nodes. Static analyses are not
+				/// possible in explicit mode (no stiffness blocks). Default: false.
+	void SetExplicitIntegration(bool mexplicit) { explicit_integration = mexplicit; }
+	bool GetExplicitIntegration() {return explicit_integration;}
+
+				/// Enable the subcycling of the explicit integration: nodes of elements
+				/// whose critical time step is smaller than the step of the system are
+				/// advanced by the mesh with 2, 4, 8.. up to 2^max_levels substeps per step,
+				/// using the critical time steps scaled by 'safety'. The other nodes are
+				/// held at their last state during substeps, and get the impulses of the
+				/// elements they share with subcycled nodes, so that the momentum is
+				/// kept across the levels. Constraints act on the 
+				/// subcycled nodes as a velocity correction at the end of the step;
+				/// nodes that got a correction (ex. linked to a body) then move with
+				/// constant speed during the substeps of the next step. Fixed nodes
+				/// are never subcycled. The subcycling acts only in dynamic steps.
+				/// If an element needs more than 2^max_levels substeps, the step
+				/// throws a ChException.
+				/// Use max_levels=0 to disable (default).
+	void SetExplicitSubcycling(int max_levels, double safety = 0.9) { explicit_max_levels = max_levels; explicit_safety = safety; subcycling_step = 0; }
+
+				/// Estimates the critical time step of each element of the explicit
+				/// integration (from a bound of its highest frequency, with the lumped
+				/// nodal masses), and returns the smallest one.
+	double ComputeCriticalTimeStep();
+
+				/// Critical time step of the n-th element, as of the last ComputeCriticalTimeStep()
+	double GetElementCriticalTimeStep(unsigned int n) {return element_critical_dt[n];}
+
+				/// Partitions the elements in 'colors', so that elements with the same
+				/// color do not share nodes. Element loops (Update, KRMmatricesLoad,
+				/// VariablesFbLoadForces, VariablesFbIncrementMq) then run in parallel
+				/// within each color, scattering nodal forces without locks or atomics.
+				/// Called by SetupInitial(); if elements are added later, the loops
+				/// run serially until this is called again.
+	void ComputeElementColors ();
+
+				/// Enable/disable the batched corotation of ChElementTetra_4 and 
+				/// ChElementHexa_8 elements in Update() and KRMmatricesLoad(): rotations
+				/// and corotated stiffness matrices are computed for many elements at
+				/// once, in vectorizable loops. Same results as the per-element code. Default: true.
+	void SetBatchedCorotation(bool mb) { use_batches = mb; if (colors_valid) ComputeElementColors(); }
+	bool GetBatchedCorotation() {return use_batches;}
+
+				/// Number of element colors, see ComputeElementColors()
+	unsigned int GetNelementColors () {return colors_valid ? (unsigned int)element_colors.size() : 0;}
+
 				/// Set reference position of nodes as current position, for all nodes.
 	void Relax ();
 
@@ -95,6 +239,15 @@ public:
 	void LoadFromTetGenFile(const char* filename_node,  ///< name of the .node file
 						    const char* filename_ele,   ///< name of the .ele  file
 							ChSharedPtr<ChContinuumMaterial> my_material); ///< material for the created tetahedrons
+
+				/// As LoadFromTetGenFile(), but the parsed nodes and tetahedrons are also saved
+				/// in a compact binary file 'filename_cache'; later calls load them directly
+				/// from that file, that is much faster, unless the size or the modification
+				/// time of the .node or .ele files changed since the cache was written.
+	void LoadFromTetGenFileCached(const char* filename_node,  ///< name of the .node file
+								  const char* filename_ele,   ///< name of the .ele  file
+								  ChSharedPtr<ChContinuumMaterial> my_material, ///< material for the created tetahedrons
+								  const char* filename_cache); ///< name of the binary cache file
 	
 				/// Load tetahedrons, if any, saved in a .inp file for Abaqus.
 	void LoadFromAbaqusFile(const char* filename, 
@@ -134,6 +287,11 @@ public:
 				/// timestepping schemes that do: M*v_new = M*v_old + forces*dt
 	virtual void VariablesFbIncrementMq();
 
+				/// Advances the subcycled nodes of the explicit integration with
+				/// their substeps, see SetExplicitSubcycling(). Called by the
+				/// time integrators of the ChSystem, with the time step.
+	virtual void VariablesFbLoadSubsteps(double step);
+
 				/// Fetches the item speed (ex. linear and angular vel.in rigid bodies) from the
 				/// 'qb' part of the ChLcpVariables and sets it as the current item speed.
 				/// If 'step' is not 0, also should compute the approximate acceleration of
@@ -122,6 +122,120 @@ double PolarDecomposition::Compute(const double * M, double * Q, double * S, dou
 }
 
 
+// compute the one-norm of LANES 3x3 matrices (row-major, structure-of-arrays)
+void PolarDecomposition::oneNormLanes(const double A[9][LANES], double norm[LANES])
+{
+  for (int l=0; l<LANES; l++)
+    norm[l] = 0.0;
+  for (int i=0; i<3; i++) 
+    for (int l=0; l<LANES; l++)
+    {
+      double columnAbsSum = fabs(A[i + 0][l]) + fabs(A[i + 3][l]) + fabs(A[i + 6][l]);
+      norm[l] = (columnAbsSum > norm[l]) ? columnAbsSum : norm[l];
+    }
+}
+
+// compute the inf-norm of LANES 3x3 matrices (row-major, structure-of-arrays)
+void PolarDecomposition::infNormLanes(const double A[9][LANES], double norm[LANES])
+{
+  for (int l=0; l<LANES; l++)
+    norm[l] = 0.0;
+  for (int i=0; i<3; i++) 
+    for (int l=0; l<LANES; l++)
+    {
+      double rowSum = fabs(A[3 * i + 0][l]) + fabs(A[3 * i + 1][l]) + fabs(A[3 * i + 2][l]);
+      norm[l] = (rowSum > norm[l]) ? rowSum : norm[l];
+    }
+}
+
+
+// Same iteration as Compute(), on LANES matrices at once. Lanes that
+// converged (or that have a zero determinant) are frozen, while the 
+// others keep iterating, so each lane gives the same result as Compute().
+void PolarDecomposition::ComputeLanes(const double M[9][LANES], double Q[9][LANES], double det[LANES], int nlanes, double tolerance)
+{
+  double Mk[9][LANES];
+  double Ek[9][LANES];
+  double MadjTk[9][LANES];
+  double M_oneNorm[LANES], M_infNorm[LANES], E_oneNorm[LANES];
+  double MadjT_one[LANES], MadjT_inf[LANES];
+  bool active[LANES];
+
+  // Mk = M^T  (unused lanes get the identity)
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++)
+      for (int l=0; l<LANES; l++)
+        Mk[3 * i + j][l] = (l < nlanes) ? M[3 * j + i][l] : ((i == j) ? 1.0 : 0.0);
+
+  oneNormLanes(Mk, M_oneNorm);
+  infNormLanes(Mk, M_infNorm);
+
+  int nactive = 0;
+  for (int l=0; l<LANES; l++)
+  {
+    active[l] = (l < nlanes);
+    det[l] = 1.0;
+    if (active[l])
+      ++nactive;
+  }
+
+  while (nactive)
+  {
+    // row 2 x row 3
+    crossProductLanes(&(Mk[3]), &(Mk[6]), &(MadjTk[0])); 
+    // row 3 x row 1
+    crossProductLanes(&(Mk[6]), &(Mk[0]), &(MadjTk[3]));
+    // row 1 x row 2
+    crossProductLanes(&(Mk[0]), &(Mk[3]), &(MadjTk[6]));
+
+    for (int l=0; l<LANES; l++)
+    {
+      double mdet = Mk[0][l] * MadjTk[0][l] + Mk[1][l] * MadjTk[1][l] + Mk[2][l] * MadjTk[2][l];
+      det[l] = active[l] ? mdet : det[l];
+      active[l] = active[l] && (mdet != 0.0);
+    }
+
+    oneNormLanes(MadjTk, MadjT_one);
+    infNormLanes(MadjTk, MadjT_inf);
+
+    double g1[LANES], g2[LANES];
+    for (int l=0; l<LANES; l++)
+    {
+      double gamma = sqrt(sqrt((MadjT_one[l] * MadjT_inf[l]) / (M_oneNorm[l] * M_infNorm[l])) / fabs(det[l]));
+      g1[l] = gamma * 0.5;
+      g2[l] = 0.5 / (gamma * det[l]);
+    }
+
+    for(int i=0; i<9; i++)
+      for (int l=0; l<LANES; l++)
+      {
+        double Mnew = g1[l] * Mk[i][l] + g2[l] * MadjTk[i][l];
+        Ek[i][l] = Mk[i][l];
+        Mk[i][l] = active[l] ? Mnew : Mk[i][l];
+        Ek[i][l] -= Mk[i][l];
+      }
+
+    oneNormLanes(Ek, E_oneNorm);
+    oneNormLanes(Mk, M_oneNorm);
+    infNormLanes(Mk, M_infNorm);
+
+    nactive = 0;
+    for (int l=0; l<LANES; l++)
+    {
+      active[l] = active[l] && ( E_oneNorm[l] > M_oneNorm[l] * tolerance );
+      if (active[l])
+        ++nactive;
+    }
+  }
+
+  // Q = Mk^T 
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++)
+      for (int l=0; l<LANES; l++)
+        Q[3*i+j][l] = Mk[3*j+i][l];
+}
+
+
 } // END_OF_NAMESPACE____
 } // END_OF_NAMESPACE____
 
@@ -64,6 +64,16 @@ public:
   // All matrices are row-major
   static double Compute(const double * M, double * Q, double * S, double tolerance = 1E-6);
 
+  // Number of matrices decomposed at once by ComputeLanes()
+  enum { LANES = 8 };
+
+  // Computes the Polar Decomposition of LANES general 3x3 matrices at once.
+  // Matrices are stored as structure-of-arrays: M[k][l] is the k-th entry
+  // (row-major) of the l-th matrix, so the loops across lanes can be
+  // vectorized by the compiler. Only the first nlanes matrices are used.
+  // Each lane gives the same Q and det as Compute(); S is not computed.
+  static void ComputeLanes(const double M[9][LANES], double Q[9][LANES], double det[LANES], int nlanes, double tolerance = 1E-6);
+
 protected:
 
   // one-norm of a 3 x 3 matrix
@@ -72,6 +82,22 @@ protected:
   // infinity-norm of a 3 x 3 matrix
   static double infNorm(const double * A);
 
+  // one-norm and infinity-norm of LANES 3 x 3 matrices
+  static void oneNormLanes(const double A[9][LANES], double norm[LANES]);
+  static void infNormLanes(const double A[9][LANES], double norm[LANES]);
+
+  // a, b, c are LANES 3-vectors
+  // compute cross products c = a x b
+  inline static void crossProductLanes(const double (*a)[LANES], const double (*b)[LANES], double (*c)[LANES])
+	{
+		for (int l = 0; l < LANES; l++)
+		{
+			c[0][l] = a[1][l] * b[2][l] - a[2][l] * b[1][l];
+			c[1][l] = a[2][l] * b[0][l] - a[0][l] * b[2][l];
+			c[2][l] = a[0][l] * b[1][l] - a[1][l] * b[0][l];
+		}
+	}
+
   // a, b, c are 3-vectors
   // compute cross product c = a x b
   inline static void crossProduct(const double * a, const double * b, double * c)
@@ -113,6 +113,12 @@ void ChProximityContainerMeshless::AddProximity(
 	if (!(mmpaA && mmpaB))
 		return;
 
+	// clusters using the cell list find their near nodes by themselves
+	ChMatterMeshless* mmatA = dynamic_cast<ChMatterMeshless*>(mmpaA->GetNodes());
+	ChMatterMeshless* mmatB = dynamic_cast<ChMatterMeshless*>(mmpaB->GetNodes());
+	if ((mmatA && mmatA->GetUseCellList()) || (mmatB && mmatB->GetUseCellList()))
+		return;
+
 	if ((fixedA && fixedB))
 		return;
 
@@ -0,0 +1,831 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChReducedMesh.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "ChReducedMesh.h"
+#include "ChElementGeneric.h"
+#include "core/ChException.h"
+#include "lcp/ChLcpSystemDescriptor.h"
+
+
+namespace chrono
+{
+namespace fem
+{
+
+
+
+//////////////////////////////////////
+//
+// Sparse matrices for the reduction
+
+
+// Stiffness and mass of the whole mesh, in compressed rows
+struct ChReductionMatrices
+{
+	std::vector<int>	rowptr;
+	std::vector<int>	col;
+	std::vector<double> K;
+	std::vector<double> M;
+	int n;
+};
+
+struct ChReductionEntry
+{
+	int col;
+	double k;
+	double m;
+	bool operator<(const ChReductionEntry& other) const {return col < other.col;}
+};
+
+
+// Cholesky factorization of a sparse symmetric positive definite
+// matrix in skyline (profile) storage: column j holds the rows
+// from first[j] to j of the upper factor U, with A = U'*U.
+class ChSkylineCholesky
+{
+public:
+	std::vector<int>	first;
+	std::vector<size_t> ptr;
+	std::vector<double> U;
+	int n;
+
+	// Takes the upper triangle of the leading n x n block of the matrix
+	void Setup(const ChReductionMatrices& A, int mn)
+	{
+		n = mn;
+		first.resize(n);
+		for (int j = 0; j < n; j++)
+			first[j] = j;
+		for (int r = 0; r < n; r++)
+			for (int k = A.rowptr[r]; k < A.rowptr[r+1]; k++)
+			{
+				int c = A.col[k];
+				if (c > r && c < n)
+					first[c] = ChMin(first[c], r);
+			}
+
+		ptr.resize(n+1);
+		ptr[0] = 0;
+		for (int j = 0; j < n; j++)
+			ptr[j+1] = ptr[j] + (j - first[j] + 1);
+		U.assign(ptr[n], 0.);
+
+		for (int r = 0; r < n; r++)
+			for (int k = A.rowptr[r]; k < A.rowptr[r+1]; k++)
+			{
+				int c = A.col[k];
+				if (c >= r && c < n)
+					U[ptr[c] + (r - first[c])] = A.K[k];
+			}
+	}
+
+	// In place factorization; returns false if not positive definite
+	bool Factorize()
+	{
+		for (int j = 0; j < n; j++)
+		{
+			double* cj = &U[ptr[j]];
+			int fj = first[j];
+			for (int i = fj; i < j; i++)
+			{
+				const double* ci = &U[ptr[i]];
+				int fi = first[i];
+				double s = cj[i-fj];
+				for (int k = ChMax(fi,fj); k < i; k++)
+					s -= ci[k-fi] * cj[k-fj];
+				cj[i-fj] = s / ci[i-fi];
+			}
+			double s = cj[j-fj];
+			for (int k = fj; k < j; k++)
+				s -= cj[k-fj] * cj[k-fj];
+			if (s <= 0)
+				return false;
+			cj[j-fj] = sqrt(s);
+		}
+		return true;
+	}
+
+	// Solves A*x=b, with x=b on input
+	void Solve(double* x) const
+	{
+		for (int j = 0; j < n; j++)
+		{
+			const double* cj = &U[ptr[j]];
+			int fj = first[j];
+			double s = x[j];
+			for (int k = fj; k < j; k++)
+				s -= cj[k-fj] * x[k];
+			x[j] = s / cj[j-fj];
+		}
+		for (int j = n-1; j >= 0; j--)
+		{
+			const double* cj = &U[ptr[j]];
+			int fj = first[j];
+			x[j] /= cj[j-fj];
+			double xj = x[j];
+			for (int k = fj; k < j; k++)
+				x[k] -= cj[k-fj] * xj;
+		}
+	}
+};
+
+
+// y = M*x, for the leading n x n block of the mass matrix
+static void MultiplyMassLeading(const ChReductionMatrices& A, int n, const double* x, double* y)
+{
+	for (int r = 0; r < n; r++)
+	{
+		double s = 0;
+		for (int k = A.rowptr[r]; k < A.rowptr[r+1]; k++)
+			if (A.col[k] < n)
+				s += A.M[k] * x[A.col[k]];
+		y[r] = s;
+	}
+}
+
+
+// Eigenvalues and eigenvectors of a small symmetric matrix, with the cyclic
+// Jacobi method. A is destroyed, the columns of V are the eigenvectors.
+static void JacobiEigenSymmetric(ChMatrixDynamic<>& A, ChMatrixDynamic<>& V, std::vector<double>& d)
+{
+	int n = A.GetRows();
+	V.Reset(n,n);
+	V.FillDiag(1.0);
+
+	for (int sweep = 0; sweep < 100; sweep++)
+	{
+		double off = 0;
+		double diag = 0;
+		for (int p = 0; p < n; p++)
+		{
+			diag += A(p,p)*A(p,p);
+			for (int q = p+1; q < n; q++)
+				off += A(p,q)*A(p,q);
+		}
+		if (off <= 1e-30 * diag)
+			break;
+
+		for (int p = 0; p < n-1; p++)
+			for (int q = p+1; q < n; q++)
+			{
+				if (A(p,q) == 0)
+					continue;
+				double theta = (A(q,q) - A(p,p)) / (2.0 * A(p,q));
+				double t = 1.0 / (fabs(theta) + sqrt(theta*theta + 1.0));
+				if (theta < 0)
+					t = -t;
+				double c = 1.0 / sqrt(t*t + 1.0);
+				double s = t * c;
+				for (int k = 0; k < n; k++)
+				{
+					double akp = A(k,p);
+					double akq = A(k,q);
+					A(k,p) = c*akp - s*akq;
+					A(k,q) = s*akp + c*akq;
+				}
+				for (int k = 0; k < n; k++)
+				{
+					double apk = A(p,k);
+					double aqk = A(q,k);
+					A(p,k) = c*apk - s*aqk;
+					A(q,k) = s*apk + c*aqk;
+				}
+				for (int k = 0; k < n; k++)
+				{
+					double vkp = V(k,p);
+					double vkq = V(k,q);
+					V(k,p) = c*vkp - s*vkq;
+					V(k,q) = s*vkp + c*vkq;
+				}
+			}
+	}
+
+	d.resize(n);
+	for (int i = 0; i < n; i++)
+		d[i] = A(i,i);
+}
+
+
+// Solves the small generalized eigenproblem Kt*Q = Mt*Q*diag(lambda), with
+// Q'*Mt*Q = I, eigenvalues in ascending order.
+static void GeneralizedEigenSymmetric(const ChMatrixDynamic<>& Kt, const ChMatrixDynamic<>& Mt,
+									  std::vector<double>& lambda, ChMatrixDynamic<>& Q)
+{
+	int n = Kt.GetRows();
+
+	// Mt = L*L'
+	ChMatrixDynamic<> L(n,n);
+	for (int j = 0; j < n; j++)
+	{
+		double s = Mt(j,j);
+		for (int k = 0; k < j; k++)
+			s -= L(j,k)*L(j,k);
+		if (s <= 0)
+			throw ChException("Modal reduction: loss of orthogonality in the subspace iteration");
+		L(j,j) = sqrt(s);
+		for (int i = j+1; i < n; i++)
+		{
+			double si = Mt(i,j);
+			for (int k = 0; k < j; k++)
+				si -= L(i,k)*L(j,k);
+			L(i,j) = si / L(j,j);
+		}
+	}
+
+	// C = inv(L)*Kt*inv(L)'
+	ChMatrixDynamic<> W(n,n);	// W = inv(L)*Kt
+	for (int c = 0; c < n; c++)
+		for (int i = 0; i < n; i++)
+		{
+			double s = Kt(i,c);
+			for (int k = 0; k < i; k++)
+				s -= L(i,k)*W(k,c);
+			W(i,c) = s / L(i,i);
+		}
+	ChMatrixDynamic<> C(n,n);	// C = W*inv(L)', that is inv(L)*W'
+	for (int c = 0; c < n; c++)
+		for (int i = 0; i < n; i++)
+		{
+			double s = W(c,i);
+			for (int k = 0; k < i; k++)
+				s -= L(i,k)*C(k,c);
+			C(i,c) = s / L(i,i);
+		}
+
+	ChMatrixDynamic<> V;
+	std::vector<double> d;
+	JacobiEigenSymmetric(C, V, d);
+
+	std::vector< std::pair<double,int> > order(n);
+	for (int i = 0; i < n; i++)
+		order[i] = std::make_pair(d[i], i);
+	std::sort(order.begin(), order.end());
+
+	// Q = inv(L)'*V, sorted
+	lambda.resize(n);
+	Q.Reset(n,n);
+	for (int c = 0; c < n; c++)
+	{
+		lambda[c] = order[c].first;
+		int vc = order[c].second;
+		for (int i = n-1; i >= 0; i--)
+		{
+			double s = V(i,vc);
+			for (int k = i+1; k < n; k++)
+				s -= L(k,i)*Q(k,c);
+			Q(i,c) = s / L(i,i);
+		}
+	}
+}
+
+
+
+//////////////////////////////////////
+//
+// ChReducedMesh
+
+
+// Register into the object factory, to enable run-time
+// dynamic creation and persistence
+ChClassRegister<ChReducedMesh> a_registration_ChReducedMesh;
+
+
+ChReducedMesh::ChReducedMesh()
+{
+	modal_variables = 0;
+	alpha_M = 0;
+	beta_K = 0;
+}
+
+ChReducedMesh::~ChReducedMesh()
+{
+	if (modal_variables) delete modal_variables;
+	modal_variables = 0;
+}
+
+
+void ChReducedMesh::Reduce(ChSharedPtr<ChMesh> mmesh,
+						   std::vector< ChSharedPtr<ChNodeFEMxyz> >& boundary,
+						   int n_modes)
+{
+	if (boundary.empty())
+		throw ChException("Modal reduction: no boundary nodes");
+
+	mesh = mmesh;
+	mesh->SetupInitial();
+	mesh->Update(this->ChTime);
+
+	// Numbering of the dofs: interior nodes first, in reverse Cuthill-McKee order to
+	// reduce the profile of the factorization, then boundary nodes. The nodes of the
+	// mesh are not reordered, so its GetNode() indexes stay those of the caller.
+
+	std::vector<unsigned int> node_order;
+	mesh->ComputeNodeOrder(ChMesh::NODEORDER_RCM, node_order);
+
+	std::map<ChNodeFEMbase*, int> boundary_index;
+	for (unsigned int i = 0; i < boundary.size(); i++)
+		boundary_index[boundary[i].get_ptr()] = i;
+
+	boundary_nodes = boundary;
+	interior_nodes.clear();
+	std::map<ChNodeFEMbase*, int> dof_index;
+	for (unsigned int i = 0; i < node_order.size(); i++)
+	{
+		ChSharedPtr<ChNodeFEMxyz> mnode = mesh->GetNode(node_order[i]).DynamicCastTo<ChNodeFEMxyz>();
+		if (mnode.IsNull())
+			throw ChException("Modal reduction: the mesh must contain ChNodeFEMxyz nodes only");
+		if (boundary_index.find(mnode.get_ptr()) == boundary_index.end())
+		{
+			dof_index[mnode.get_ptr()] = 3 * (int)interior_nodes.size();
+			interior_nodes.push_back(mnode);
+		}
+	}
+	int ni = 3 * (int)interior_nodes.size();
+	int nb = 3 * (int)boundary_nodes.size();
+	int n  = ni + nb;
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+	{
+		if (dof_index.find(boundary_nodes[i].get_ptr()) != dof_index.end())
+			throw ChException("Modal reduction: repeated boundary node");
+		dof_index[boundary_nodes[i].get_ptr()] = ni + 3 * i;
+	}
+	if ((int)dof_index.size() != (int)mesh->GetNnodes())
+		throw ChException("Modal reduction: a boundary node is not in the mesh");
+	if (n_modes > ni)
+		throw ChException("Modal reduction: more modes than interior dofs");
+
+	// Assemble K and M of the mesh, in compressed rows
+
+	std::vector< std::vector<ChReductionEntry> > mrows(n);
+	ChMatrixDynamic<> Ke;
+	ChMatrixDynamic<> Me;
+	std::vector<int> edofs;
+	for (unsigned int ie = 0; ie < mesh->GetNelements(); ie++)
+	{
+		ChSharedPtr<ChElementBase> mel = mesh->GetElement(ie);
+		if (mel.DynamicCastTo<ChElementGeneric>().IsNull())
+			throw ChException("Modal reduction: the mesh must contain elements inherited from ChElementGeneric");
+		int nd = mel->GetNdofs();
+		Ke.Reset(nd, nd);
+		Me.Reset(nd, nd);
+		mel->ComputeKRMmatricesGlobal(Ke, 1.0, 0, 0);
+		mel->ComputeKRMmatricesGlobal(Me, 0, 0, 1.0);
+		edofs.clear();
+		for (int in = 0; in < mel->GetNnodes(); in++)
+		{
+			int d0 = dof_index[mel->GetNodeN(in).get_ptr()];
+			for (int k = 0; k < 3; k++)
+				edofs.push_back(d0 + k);
+		}
+		for (int r = 0; r < nd; r++)
+			for (int c = 0; c < nd; c++)
+			{
+				ChReductionEntry mentry;
+				mentry.col = edofs[c];
+				mentry.k = Ke(r,c);
+				mentry.m = Me(r,c);
+				mrows[edofs[r]].push_back(mentry);
+			}
+	}
+
+	ChReductionMatrices A;
+	A.n = n;
+	A.rowptr.resize(n+1);
+	A.rowptr[0] = 0;
+	for (int r = 0; r < n; r++)
+	{
+		std::vector<ChReductionEntry>& mrow = mrows[r];
+		std::sort(mrow.begin(), mrow.end());
+		for (unsigned int k = 0; k < mrow.size(); k++)
+		{
+			if (k > 0 && mrow[k].col == A.col.back())
+			{
+				A.K.back() += mrow[k].k;
+				A.M.back() += mrow[k].m;
+				continue;
+			}
+			A.col.push_back(mrow[k].col);
+			A.K.push_back(mrow[k].k);
+			A.M.push_back(mrow[k].m);
+		}
+		A.rowptr[r+1] = (int)A.col.size();
+		std::vector<ChReductionEntry>().swap(mrow);
+	}
+
+	// Factorize the interior block Kii
+
+	ChSkylineCholesky Kii;
+	Kii.Setup(A, ni);
+	if (!Kii.Factorize())
+		throw ChException("Modal reduction: singular stiffness of the interior nodes; add boundary nodes to prevent rigid motions");
+
+	// Static constraint modes: Psi = -inv(Kii)*Kib
+
+	Psi.Reset(ni, nb);
+	#pragma omp parallel
+	{
+		std::vector<double> x(ni);
+		#pragma omp for schedule(dynamic)
+		for (int c = 0; c < nb; c++)
+		{
+			std::fill(x.begin(), x.end(), 0.);
+			for (int k = A.rowptr[ni+c]; k < A.rowptr[ni+c+1]; k++)
+				if (A.col[k] < ni)
+					x[A.col[k]] = -A.K[k];
+			Kii.Solve(&x[0]);
+			for (int i = 0; i < ni; i++)
+				Psi(i,c) = x[i];
+		}
+	}
+
+	// Fixed-interface modes: subspace iteration for the lowest eigenpairs of (Kii, Mii)
+
+	int nq = ChMin(ni, ChMax(2*n_modes, n_modes+8));
+	std::vector< std::vector<double> > X(nq, std::vector<double>(ni, 0.));
+	std::vector< std::vector<double> > Xb(nq, std::vector<double>(ni, 0.));
+	std::vector< std::vector<double> > Y(nq, std::vector<double>(ni, 0.));
+	std::vector<double> lambda, lambda_old;
+	ChMatrixDynamic<> Kt(nq,nq);
+	ChMatrixDynamic<> Mt(nq,nq);
+	ChMatrixDynamic<> Q;
+
+	if (n_modes > 0)
+	{
+		// starting vectors: the mass diagonal, unit vectors at the dofs with the
+		// largest mass/stiffness ratios, and a pseudo-random vector
+		std::vector< std::pair<double,int> > mratios(ni);
+		for (int r = 0; r < ni; r++)
+		{
+			double mk = 0, mm = 0;
+			for (int k = A.rowptr[r]; k < A.rowptr[r+1]; k++)
+				if (A.col[k] == r)
+				{
+					mk = A.K[k];
+					mm = A.M[k];
+				}
+			X[0][r] = mm;
+			mratios[r] = std::make_pair(-mm / mk, r);
+		}
+		std::sort(mratios.begin(), mratios.end());
+		for (int c = 1; c < nq-1; c++)
+			X[c][mratios[c-1].second] = 1.0;
+		unsigned int mseed = 12345;
+		for (int r = 0; r < ni; r++)
+		{
+			mseed = mseed * 1103515245u + 12345u;
+			X[nq-1][r] = ((mseed >> 8) & 0xffff) / 65536.0 - 0.5;
+		}
+
+		for (int iter = 0; iter < 100; iter++)
+		{
+			#pragma omp parallel for schedule(dynamic)
+			for (int c = 0; c < nq; c++)
+			{
+				MultiplyMassLeading(A, ni, &X[c][0], &Y[c][0]);
+				Xb[c] = Y[c];
+				Kii.Solve(&Xb[c][0]);
+				MultiplyMassLeading(A, ni, &Xb[c][0], &X[c][0]); // X is used as temporary for Mii*Xb
+			}
+
+			// projected matrices, Kt = Xb'*Kii*Xb = Xb'*Y  and  Mt = Xb'*Mii*Xb
+			#pragma omp parallel for schedule(dynamic)
+			for (int a = 0; a < nq; a++)
+				for (int b = a; b < nq; b++)
+				{
+					double sk = 0, sm = 0;
+					for (int r = 0; r < ni; r++)
+					{
+						sk += Xb[a][r] * Y[b][r];
+						sm += Xb[a][r] * X[b][r];
+					}
+					Kt(a,b) = Kt(b,a) = sk;
+					Mt(a,b) = Mt(b,a) = sm;
+				}
+
+			GeneralizedEigenSymmetric(Kt, Mt, lambda, Q);
+
+			// new iteration vectors X = Xb*Q, that are M-orthonormal
+			#pragma omp parallel for schedule(static)
+			for (int r = 0; r < ni; r++)
+			{
+				for (int c = 0; c < nq; c++)
+				{
+					double s = 0;
+					for (int k = 0; k < nq; k++)
+						s += Xb[k][r] * Q(k,c);
+					X[c][r] = s;
+				}
+			}
+
+			bool converged = !lambda_old.empty();
+			for (int c = 0; c < n_modes && converged; c++)
+				if (fabs(lambda[c] - lambda_old[c]) > 1e-10 * fabs(lambda[c]))
+					converged = false;
+			lambda_old = lambda;
+			if (converged)
+				break;
+		}
+	}
+
+	Phi.Reset(ni, n_modes);
+	eigenvalues.Reset(n_modes, 1);
+	for (int c = 0; c < n_modes; c++)
+	{
+		eigenvalues(c) = lambda[c];
+		for (int r = 0; r < ni; r++)
+			Phi(r,c) = X[c][r];
+	}
+
+	// Reduced matrices, for the coordinates (u_boundary, q_modal):
+	//   Kred = [ Kbb + Kbi*Psi        0      ]
+	//          [       0         diag(lambda)]
+	//   Mred = [ Mbb + Mbi*Psi + Psi'*Mib + Psi'*Mii*Psi    (Mbi + Psi'*Mii)*Phi ]
+	//          [          sym.                                    I              ]
+
+	int nr = nb + n_modes;
+	Kred.Reset(nr, nr);
+	Mred.Reset(nr, nr);
+	H.Reset(nr, nr);
+
+	ChMatrixDynamic<> MiiPsi(ni, nb);
+	#pragma omp parallel for schedule(static)
+	for (int r = 0; r < ni; r++)
+		for (int k = A.rowptr[r]; k < A.rowptr[r+1]; k++)
+			if (A.col[k] < ni)
+				for (int c = 0; c < nb; c++)
+					MiiPsi(r,c) += A.M[k] * Psi(A.col[k], c);
+
+	ChMatrixDynamic<> MbiPsi(nb, nb);
+	ChMatrixDynamic<> MbiPhi(nb, n_modes);
+	for (int a = 0; a < nb; a++)
+		for (int k = A.rowptr[ni+a]; k < A.rowptr[ni+a+1]; k++)
+		{
+			int i = A.col[k];
+			if (i < ni)
+			{
+				for (int b = 0; b < nb; b++)
+				{
+					Kred(a,b) += A.K[k] * Psi(i,b);
+					MbiPsi(a,b) += A.M[k] * Psi(i,b);
+				}
+				for (int m = 0; m < n_modes; m++)
+					MbiPhi(a,m) += A.M[k] * Phi(i,m);
+			}
+			else
+			{
+				Kred(a, i-ni) += A.K[k];
+				Mred(a, i-ni) += A.M[k];
+			}
+		}
+
+	#pragma omp parallel for schedule(dynamic)
+	for (int a = 0; a < nb; a++)
+	{
+		for (int b = 0; b < nb; b++)
+		{
+			double s = 0;
+			for (int i = 0; i < ni; i++)
+				s += Psi(i,a) * MiiPsi(i,b);
+			Mred(a,b) += MbiPsi(a,b) + MbiPsi(b,a) + s;
+		}
+		for (int m = 0; m < n_modes; m++)
+		{
+			double s = 0;
+			for (int i = 0; i < ni; i++)
+				s += MiiPsi(i,a) * Phi(i,m);
+			Mred(a, nb+m) = Mred(nb+m, a) = MbiPhi(a,m) + s;
+		}
+	}
+
+	// symmetrize the boundary block, that has roundoff errors
+	for (int a = 0; a < nb; a++)
+		for (int b = a+1; b < nb; b++)
+		{
+			Kred(a,b) = Kred(b,a) = 0.5 * (Kred(a,b) + Kred(b,a));
+			Mred(a,b) = Mred(b,a) = 0.5 * (Mred(a,b) + Mred(b,a));
+		}
+	for (int m = 0; m < n_modes; m++)
+		Kred(nb+m, nb+m) = eigenvalues(m);
+
+	// The modal masses, unit because of mass normalization, go in the
+	// modal variables; all the rest of the reduced mass is in the Kblock.
+
+	modal_q.Reset(n_modes, 1);
+	modal_q_dt.Reset(n_modes, 1);
+	modal_q_dtdt.Reset(n_modes, 1);
+
+	if (modal_variables) delete modal_variables;
+	modal_variables = new ChLcpVariablesGeneric(ChMax(n_modes, 1));
+	if (n_modes == 0)
+		modal_variables->SetDisabled(true);
+
+	std::vector<ChLcpVariables*> mvars;
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		mvars.push_back(&boundary_nodes[i]->Variables());
+	if (n_modes > 0)
+		mvars.push_back(modal_variables);
+	Kmatr.SetVariables(mvars);
+}
+
+
+void ChReducedMesh::ComputeReducedDisplacements(ChMatrix<>& mq)
+{
+	int nb = 3 * (int)boundary_nodes.size();
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		mq.PasteVector(boundary_nodes[i]->GetPos() - boundary_nodes[i]->GetX0(), 3*i, 0);
+	for (int m = 0; m < GetNmodes(); m++)
+		mq(nb + m) = modal_q(m);
+}
+
+
+void ChReducedMesh::UpdateMesh()
+{
+	int nb = 3 * (int)boundary_nodes.size();
+	int nr = nb + GetNmodes();
+	ChMatrixDynamic<> mq(nr, 1);
+	ChMatrixDynamic<> mq_dt(nr, 1);
+	ComputeReducedDisplacements(mq);
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		mq_dt.PasteVector(boundary_nodes[i]->GetPos_dt(), 3*i, 0);
+	for (int m = 0; m < GetNmodes(); m++)
+		mq_dt(nb + m) = modal_q_dt(m);
+
+	#pragma omp parallel for schedule(static)
+	for (int in = 0; in < (int)interior_nodes.size(); in++)
+	{
+		double u[3], v[3];
+		for (int k = 0; k < 3; k++)
+		{
+			int r = 3*in + k;
+			double su = 0, sv = 0;
+			for (int c = 0; c < nb; c++)
+			{
+				su += Psi(r,c) * mq(c);
+				sv += Psi(r,c) * mq_dt(c);
+			}
+			for (int m = 0; m < GetNmodes(); m++)
+			{
+				su += Phi(r,m) * mq(nb+m);
+				sv += Phi(r,m) * mq_dt(nb+m);
+			}
+			u[k] = su;
+			v[k] = sv;
+		}
+		ChNodeFEMxyz* mnode = interior_nodes[in].get_ptr();
+		mnode->SetPos(mnode->GetX0() + ChVector<>(u[0], u[1], u[2]));
+		mnode->SetPos_dt(ChVector<>(v[0], v[1], v[2]));
+	}
+
+	mesh->Update(this->ChTime);
+}
+
+
+void ChReducedMesh::SetNoSpeedNoAcceleration()
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->SetNoSpeedNoAcceleration();
+	modal_q_dt.FillElem(0);
+	modal_q_dtdt.FillElem(0);
+}
+
+
+
+//// LCP SYSTEM FUNCTIONS
+
+
+void ChReducedMesh::InjectKRMmatrices(ChLcpSystemDescriptor& mdescriptor)
+{
+	mdescriptor.InsertKblock(&Kmatr);
+}
+
+void ChReducedMesh::KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor)
+{
+	double mkfactor = Kfactor + Rfactor * beta_K;
+	double mmfactor = Mfactor + Rfactor * alpha_M;
+
+	// the unit modal masses are in modal_variables: only the modal damping
+	// coming from them is added here
+	for (int r = 0; r < H.GetRows(); r++)
+		for (int c = 0; c < H.GetColumns(); c++)
+			H(r,c) = mkfactor * Kred(r,c) + mmfactor * Mred(r,c);
+	int nb = 3 * (int)boundary_nodes.size();
+	for (int m = 0; m < GetNmodes(); m++)
+		H(nb+m, nb+m) += Rfactor * alpha_M;
+
+	Kmatr.Set_K(H);
+}
+
+void ChReducedMesh::VariablesFbReset()
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->VariablesFbReset();
+	if (modal_variables)
+		modal_variables->Get_fb().FillElem(0);
+}
+
+void ChReducedMesh::VariablesFbLoadForces(double factor)
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->VariablesFbLoadForces(factor);
+
+	// elastic forces, f = -Kred*q
+	int nb = 3 * (int)boundary_nodes.size();
+	int nr = nb + GetNmodes();
+	ChMatrixDynamic<> mq(nr, 1);
+	ComputeReducedDisplacements(mq);
+	ChMatrixDynamic<> mf(nr, 1);
+	mf.MatrMultiply(Kred, mq);
+	mf.MatrScale(-factor);
+
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->Variables().Get_fb().PasteSumClippedMatrix(&mf, 3*i,0, 3,1, 0,0);
+	for (int m = 0; m < GetNmodes(); m++)
+		modal_variables->Get_fb()(m) += mf(nb+m);
+}
+
+void ChReducedMesh::VariablesQbLoadSpeed()
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->VariablesQbLoadSpeed();
+	for (int m = 0; m < GetNmodes(); m++)
+		modal_variables->Get_qb()(m) = modal_q_dt(m);
+}
+
+void ChReducedMesh::VariablesFbIncrementMq()
+{
+	int nb = 3 * (int)boundary_nodes.size();
+	int nr = nb + GetNmodes();
+	ChMatrixDynamic<> mv(nr, 1);
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		mv.PasteMatrix(&boundary_nodes[i]->Variables().Get_qb(), 3*i, 0);
+	for (int m = 0; m < GetNmodes(); m++)
+		mv(nb+m) = modal_variables->Get_qb()(m);
+
+	ChMatrixDynamic<> mf(nr, 1);
+	mf.MatrMultiply(Mred, mv);
+
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+	{
+		boundary_nodes[i]->VariablesFbIncrementMq();
+		boundary_nodes[i]->Variables().Get_fb().PasteSumClippedMatrix(&mf, 3*i,0, 3,1, 0,0);
+	}
+	for (int m = 0; m < GetNmodes(); m++)
+		modal_variables->Get_fb()(m) += mf(nb+m) + mv(nb+m);
+}
+
+void ChReducedMesh::VariablesQbSetSpeed(double step)
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->VariablesQbSetSpeed(step);
+	for (int m = 0; m < GetNmodes(); m++)
+	{
+		double old_dt = modal_q_dt(m);
+		modal_q_dt(m) = modal_variables->Get_qb()(m);
+		if (step)
+			modal_q_dtdt(m) = (modal_q_dt(m) - old_dt) / step;
+	}
+}
+
+void ChReducedMesh::VariablesQbIncrementPosition(double step)
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		boundary_nodes[i]->VariablesQbIncrementPosition(step);
+	for (int m = 0; m < GetNmodes(); m++)
+		modal_q(m) += modal_variables->Get_qb()(m) * step;
+}
+
+void ChReducedMesh::InjectVariables(ChLcpSystemDescriptor& mdescriptor)
+{
+	for (unsigned int i = 0; i < boundary_nodes.size(); i++)
+		mdescriptor.InsertVariables(&boundary_nodes[i]->Variables());
+	if (GetNmodes() > 0)
+		mdescriptor.InsertVariables(modal_variables);
+}
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
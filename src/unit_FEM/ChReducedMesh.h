@@ -0,0 +1,170 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHREDUCEDMESH_H
+#define CHREDUCEDMESH_H
+
+//////////////////////////////////////////////////
+//
+//   ChReducedMesh.h
+//
+//   Flexible body obtained by modal reduction
+//   (Craig-Bampton) of a FEM mesh.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "ChMesh.h"
+#include "ChNodeFEMxyz.h"
+#include "lcp/ChLcpVariablesGeneric.h"
+#include "lcp/ChLcpKblockGeneric.h"
+
+namespace chrono
+{
+namespace fem
+{
+
+
+
+/// A flexible body obtained from a ChMesh with the Craig-Bampton
+/// method of component mode synthesis.
+/// The motion of the mesh is described by the displacements of a few
+/// 'boundary' nodes, plus the amplitudes of a few fixed-interface
+/// vibration modes; the displacements of all other nodes are
+///   u_interior = Psi * u_boundary + Phi * q_modal
+/// where Psi are the static constraint modes, and Phi the lowest
+/// vibration modes with the boundary nodes clamped.
+/// The boundary nodes are the same ChNodeFEMxyz objects of the mesh, so
+/// they can be used in links, forces etc. as usual. The modal coordinates
+/// are a single ChLcpVariablesGeneric, and the reduced stiffness and mass
+/// are a single ChLcpKblockGeneric, so the solver sees few dozens of unknowns
+/// instead of the whole mesh. Use it instead of the ChMesh, that must not
+/// be added to the ChSystem.
+/// The model is linear: it is meant for small deformations, and the
+/// boundary nodes should not undergo large rotations.
+
+class ChApiFem ChReducedMesh : public ChIndexedNodes
+{
+			// Chrono simulation of RTTI, needed for serialization
+	CH_RTTI(ChReducedMesh,ChIndexedNodes);
+
+private:
+
+	ChSharedPtr<ChMesh> mesh;		// the original mesh, kept for output
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > boundary_nodes;
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > interior_nodes;	// same order of the rows of Psi and Phi
+
+	ChMatrixDynamic<> Psi;			// constraint modes, (3*n.interior nodes, 3*n.boundary nodes)
+	ChMatrixDynamic<> Phi;			// fixed-interface modes, mass-normalized, (3*n.interior nodes, n.modes)
+	ChMatrixDynamic<> eigenvalues;	// squared angular frequencies of the modes, (n.modes, 1)
+
+	ChMatrixDynamic<> Kred;			// reduced stiffness, boundary dofs first, then modal dofs
+	ChMatrixDynamic<> Mred;			// reduced mass, without the unit modal masses that are in modal_variables
+	ChMatrixDynamic<> H;			// K*Kfactor + M*Mfactor, kept to avoid an allocation at each KRMmatricesLoad()
+
+	ChMatrixDynamic<> modal_q;
+	ChMatrixDynamic<> modal_q_dt;
+	ChMatrixDynamic<> modal_q_dtdt;
+
+	ChLcpVariablesGeneric* modal_variables;
+	ChLcpKblockGeneric Kmatr;
+
+	double alpha_M;
+	double beta_K;
+
+	void ComputeReducedDisplacements(ChMatrix<>& mq);	// boundary displacements and modal coords in a vector
+
+public:
+
+	ChReducedMesh();
+	~ChReducedMesh();
+
+				/// Builds the reduced model of the mesh 'mmesh', that must contain
+				/// ChNodeFEMxyz nodes only, and elements inherited from ChElementGeneric.
+				/// The 'boundary' nodes are kept as they are; the other nodes are
+				/// represented by static constraint modes plus the 'n_modes' lowest
+				/// vibration modes with the boundary nodes clamped, computed with a
+				/// subspace iteration and a sparse (skyline) Cholesky factorization.
+				/// The boundary nodes must prevent rigid motions of the rest of the mesh.
+				/// The interior dofs are numbered in reverse Cuthill-McKee order, to reduce
+				/// the profile of the factorization, but the nodes of the mesh are not
+				/// reordered. SetupInitial() of the mesh is called here, so it reorders
+				/// them only if an ordering was set with ChMesh::SetNodeOrdering().
+				/// Throws a ChException if the mesh cannot be reduced.
+	void Reduce(ChSharedPtr<ChMesh> mmesh,
+				std::vector< ChSharedPtr<ChNodeFEMxyz> >& boundary, ///< nodes kept in the reduced model
+				int n_modes);	///< number of fixed-interface modes
+
+				/// Set the Rayleigh damping of the reduced model, R = alpha*M + beta*K.
+	void SetRayleighDamping(double malpha_M, double mbeta_K) { alpha_M = malpha_M; beta_K = mbeta_K; }
+
+				/// Access the original mesh. Call UpdateMesh() before using its
+				/// nodes and elements for output.
+	ChSharedPtr<ChMesh> GetMesh() {return mesh;}
+
+				/// Number of fixed-interface modes
+	int GetNmodes() {return modal_q.GetRows();}
+
+				/// Frequency of the n-th fixed-interface mode, in Hz
+	double GetModeFrequency(int n) {return sqrt(eigenvalues(n)) / CH_C_2PI;}
+
+				/// Access the modal coordinates
+	ChMatrix<>& GetModalCoordinates() {return modal_q;}
+				/// Access the speeds of the modal coordinates
+	ChMatrix<>& GetModalCoordinates_dt() {return modal_q_dt;}
+
+				/// Access the reduced stiffness matrix, boundary dofs first, then modal dofs
+	ChMatrix<>& GetReducedStiffness() {return Kred;}
+
+				/// Recovers the positions and speeds of all the nodes of the original mesh
+				/// from the reduced coordinates, and updates its elements, so that
+				/// their strains and stresses can be used for output.
+	void UpdateMesh();
+
+				/// Number of boundary nodes
+	virtual unsigned int GetNnodes() {return (unsigned int)boundary_nodes.size();}
+				/// Access the N-th boundary node
+	virtual ChSharedPtr<ChNodeBase> GetNode(unsigned int n) {return boundary_nodes[n];}
+
+	virtual int GetDOF () {return 3*GetNnodes() + GetNmodes();}
+
+	virtual void SetNoSpeedNoAcceleration();
+
+
+			//
+			// LCP SYSTEM FUNCTIONS        for interfacing all elements with LCP solver
+			//
+
+	virtual void InjectKRMmatrices(ChLcpSystemDescriptor& mdescriptor);
+	virtual void KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor);
+
+	virtual void VariablesFbReset();
+	virtual void VariablesFbLoadForces(double factor=1.);
+	virtual void VariablesQbLoadSpeed();
+	virtual void VariablesFbIncrementMq();
+	virtual void VariablesQbSetSpeed(double step=0.);
+	virtual void VariablesQbIncrementPosition(double step);
+	virtual void InjectVariables(ChLcpSystemDescriptor& mdescriptor);
+
+};
+
+
+
+} // END_OF_NAMESPACE____
+} // END_OF_NAMESPACE____
+
+#endif
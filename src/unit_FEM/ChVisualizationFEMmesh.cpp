@@ -54,7 +54,12 @@ ChVisualizationFEMmesh::ChVisualizationFEMmesh(ChMesh& mymesh)
 
 	undeformed_reference = false;
 
+	topology_valid = false;
+	topology_smooth = false;
+	topology_empty = false;
+
 	ChSharedPtr<ChTriangleMeshShape> new_mesh_asset(new ChTriangleMeshShape);
+	new_mesh_asset->SetDirtyTracking(true);		// refreshed only by Update()
 	this->AddAsset(new_mesh_asset);
 
 	ChSharedPtr<ChGlyphs> new_glyphs_asset(new ChGlyphs);
@@ -103,7 +108,7 @@ ChVector<float> ChVisualizationFEMmesh::ComputeFalseColor(double mv)
 	return(c);
 }
 
-double ChVisualizationFEMmesh::ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyz> mnode, int nodeID, ChSharedPtr<ChElementBase> melement)
+double ChVisualizationFEMmesh::ComputeScalarOutput( ChNodeFEMxyz* mnode, int nodeID, ChElementBase* melement)
 {
 	switch (this->fem_data_type)
 	{
@@ -134,29 +139,17 @@ double ChVisualizationFEMmesh::ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyz> mn
 	case E_PLOT_NODE_ACCEL_Z:
 		return mnode->GetPos_dtdt().z;
 	case E_PLOT_ELEM_STRAIN_VONMISES:
-		if (melement.IsType<ChElementTetra_4>())
-		{
-			ChSharedPtr<ChElementTetra_4> mytetra ( melement.DynamicCastTo<ChElementTetra_4>() );
+		if (ChElementTetra_4* mytetra = dynamic_cast<ChElementTetra_4*>(melement))
 			return mytetra->GetStrain().GetEquivalentVonMises();
-		}
 	case E_PLOT_ELEM_STRESS_VONMISES:
-		if (melement.IsType<ChElementTetra_4>())
-		{
-			ChSharedPtr<ChElementTetra_4> mytetra ( melement.DynamicCastTo<ChElementTetra_4>() );
+		if (ChElementTetra_4* mytetra = dynamic_cast<ChElementTetra_4*>(melement))
 			return mytetra->GetStress().GetEquivalentVonMises();
-		}
 	case E_PLOT_ELEM_STRAIN_HYDROSTATIC:
-		if (melement.IsType<ChElementTetra_4>())
-		{
-			ChSharedPtr<ChElementTetra_4> mytetra ( melement.DynamicCastTo<ChElementTetra_4>() );
+		if (ChElementTetra_4* mytetra = dynamic_cast<ChElementTetra_4*>(melement))
 			return mytetra->GetStrain().GetEquivalentMeanHydrostatic();
-		}
 	case E_PLOT_ELEM_STRESS_HYDROSTATIC:
-		if (melement.IsType<ChElementTetra_4>())
-		{
-			ChSharedPtr<ChElementTetra_4> mytetra ( melement.DynamicCastTo<ChElementTetra_4>() );
+		if (ChElementTetra_4* mytetra = dynamic_cast<ChElementTetra_4*>(melement))
 			return mytetra->GetStress().GetEquivalentMeanHydrostatic();
-		}
 	default:
 		return 1e30;
 	}
@@ -164,7 +157,7 @@ double ChVisualizationFEMmesh::ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyz> mn
 	return 0;
 }
 
-double ChVisualizationFEMmesh::ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyzP> mnode, int nodeID, ChSharedPtr<ChElementBase> melement)
+double ChVisualizationFEMmesh::ComputeScalarOutput( ChNodeFEMxyzP* mnode, int nodeID, ChElementBase* melement)
 {
 	switch (this->fem_data_type)
 	{
@@ -195,69 +188,45 @@ ChVector<float>& FetchOrAllocate(std::vector< ChVector<float > >& mvector, unsig
 }
 
 
-void TriangleNormalsReset(std::vector< ChVector<> >& normals, std::vector<int>& accumul)
-{
-	for (unsigned int nn = 0; nn< normals.size(); ++nn)
-	{
-		normals[nn] = ChVector<>(0,0,0);
-		accumul[nn] = 0;
-	}
-}
-void TriangleNormalsCompute(ChVector<int> norm_indexes, ChVector<int> vert_indexes, std::vector< ChVector<> >& vertexes, std::vector< ChVector<> >& normals, std::vector<int>& accumul)
-{
-	ChVector<> tnorm = Vcross(vertexes[vert_indexes.y]-vertexes[vert_indexes.x], vertexes[vert_indexes.z]-vertexes[vert_indexes.x]).GetNormalized();
-	normals[norm_indexes.x] += tnorm;
-	normals[norm_indexes.y] += tnorm;
-	normals[norm_indexes.z] += tnorm;
-	accumul[norm_indexes.x] +=1;
-	accumul[norm_indexes.y] +=1;
-	accumul[norm_indexes.z] +=1;
-}
-void TriangleNormalsSmooth(std::vector< ChVector<> >& normals, std::vector<int>& accumul)
+bool ChVisualizationFEMmesh::IsTopologyValid()
 {
-	for (unsigned int nn = 0; nn< normals.size(); ++nn)
+	if (!this->topology_valid)
+		return false;
+	if (this->topology_smooth != this->smooth_faces || 
+		this->topology_empty != (this->fem_data_type == E_PLOT_NONE))
+		return false;
+
+	// elements added, removed or replaced since the faces were built?
+	unsigned int iv = 0;
+	for (unsigned int iel=0; iel < this->FEMmesh->GetNelements(); ++iel)
 	{
-		normals[nn] = normals[nn] * (1.0 / (double)accumul[nn]);
+		ChElementBase* mel = this->FEMmesh->GetElement(iel).get_ptr();
+		if (iv < vis_elements.size() && vis_elements[iv] == mel)
+			++iv;
+		else if (!this->topology_empty && 
+				 (dynamic_cast<ChElementTetra_4*>(mel) || dynamic_cast<ChElementTetra_4_P*>(mel) || 
+				  dynamic_cast<ChElementHexa_8*>(mel)  || dynamic_cast<ChElementBeam*>(mel)))
+			return false;
 	}
+	return (iv == vis_elements.size());
 }
 
-void ChVisualizationFEMmesh::Update ()
-{
-	if (!this->FEMmesh) 
-		return;
-
-	ChSharedPtr<ChTriangleMeshShape> mesh_asset;
-	ChSharedPtr<ChGlyphs>			 glyphs_asset;
-
-	// try to retrieve previously added mesh asset and glyhs asset in sublevel..
-	if (this->GetAssets().size() == 2)
-		if (GetAssets()[0].IsType<ChTriangleMeshShape>() &&
-			GetAssets()[1].IsType<ChGlyphs>() )
-		{
-			mesh_asset   = GetAssets()[0].DynamicCastTo<ChTriangleMeshShape>();
-			glyphs_asset = GetAssets()[1].DynamicCastTo<ChGlyphs>();
-		}
-
-	// if not available, create ...
-	if (mesh_asset.IsNull())
-	{
-		this->GetAssets().resize(0); // this to delete other sub assets that are not in mesh & glyphs, if any
 
-		ChSharedPtr<ChTriangleMeshShape> new_mesh_asset(new ChTriangleMeshShape);
-		this->AddAsset(new_mesh_asset);
-		mesh_asset = new_mesh_asset;
-
-		ChSharedPtr<ChGlyphs> new_glyphs_asset(new ChGlyphs);
-		this->AddAsset(new_glyphs_asset);
-		glyphs_asset = new_glyphs_asset;
-	}
-	geometry::ChTriangleMeshConnected& trianglemesh = mesh_asset->GetMesh();
+void ChVisualizationFEMmesh::UpdateTopology(geometry::ChTriangleMeshConnected& trianglemesh)
+{
+	int beam_resolution = 8;
 
+	this->topology_valid = true;
+	this->topology_smooth = this->smooth_faces;
+	this->topology_empty = (this->fem_data_type == E_PLOT_NONE);
 
-	int beam_resolution = 8;
+	vis_elements.clear();
+	vis_element_types.clear();
+	vis_vertex_offsets.clear();
+	vis_vertex_nodes.clear();
+	vis_beam_thickness.clear();
 
 	unsigned int n_verts = 0;
-	unsigned int n_vcols = 0;
 	unsigned int n_vnorms = 0;
 	unsigned int n_triangles = 0;
 
@@ -265,470 +234,428 @@ void ChVisualizationFEMmesh::Update ()
 	// A - Count the needed vertexes and faces
 	//
 
-	for (unsigned int iel=0; iel < this->FEMmesh->GetNelements(); ++iel)
+	std::vector<unsigned int> vis_normal_offsets;
+
+	if (!this->topology_empty)
+	 for (unsigned int iel=0; iel < this->FEMmesh->GetNelements(); ++iel)
 	{
-		// ELEMENT IS A TETRAHEDRON
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementTetra_4>() )
+		ChSharedPtr<ChElementBase> melement = this->FEMmesh->GetElement(iel);
+		int mtype;
+		unsigned int nv, nn, nt;
+
+		if (melement.IsType<ChElementTetra_4>() )
 		{
-			n_verts +=4;
-			n_vcols +=4;
-			n_vnorms +=4; // flat faces
-			n_triangles +=4; // n. triangle faces
+			mtype = E_VIS_TETRA_4;
+			nv = 4;
+			nn = 4;	// flat faces
+			nt = 4;
 		}
-
-		// ELEMENT IS A TETRAHEDRON for scalar field
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementTetra_4_P>() )
+		else if (melement.IsType<ChElementTetra_4_P>() )
 		{
-			n_verts +=4;
-			n_vcols +=4;
-			n_vnorms +=4; // flat faces
-			n_triangles +=4; // n. triangle faces
+			mtype = E_VIS_TETRA_4_P;
+			nv = 4;
+			nn = 4;	// flat faces
+			nt = 4;
 		}
-
-		// ELEMENT IS A HEXAEDRON
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementHexa_8>() )
+		else if (melement.IsType<ChElementHexa_8>() )
 		{
-			n_verts +=8;
-			n_vcols +=8;
-			n_vnorms +=24;
-			n_triangles +=12; // n. triangle faces
+			mtype = E_VIS_HEXA_8;
+			nv = 8;
+			nn = 24;
+			nt = 12;
 		}
-
-		// ELEMENT IS A BEAM
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementBeamEuler>() )
+		else if (melement.IsType<ChElementBeam>() )
 		{
-			n_verts +=4*beam_resolution;
-			n_vcols +=4*beam_resolution;
-			n_vnorms +=8*beam_resolution;
-			n_triangles +=8*(beam_resolution-1); // n. triangle faces
+			mtype = E_VIS_BEAM;
+			nv = 4*beam_resolution;
+			nn = 8*beam_resolution;
+			nt = 8*(beam_resolution-1);
 		}
+		else
+			continue; //***TO DO*** other types of elements...
 
-		//***TO DO*** other types of elements...
+		vis_elements.push_back(melement.get_ptr());
+		vis_element_types.push_back(mtype);
+		vis_vertex_offsets.push_back(n_verts);
+		vis_normal_offsets.push_back(n_vnorms);
 
-	}
+		ChVector<> mthickness(0.01, 0.01, 0.01); // line thickness default value
+		if (mtype == E_VIS_BEAM)
+		{
+			ChSharedPtr<ChElementBeamEuler> mybeameuler ( melement.DynamicCastTo<ChElementBeamEuler>() );
+			if (!mybeameuler.IsNull())
+			{
+				// if the beam has a section info, use section specific thickness for drawing
+				mthickness.y = mybeameuler->GetSection()->GetDrawThicknessY();
+				mthickness.z = mybeameuler->GetSection()->GetDrawThicknessZ();
+			}
+			for (unsigned int in = 0; in < nv; ++in)
+				vis_vertex_nodes.push_back(0);
+		}
+		else
+		{
+			for (unsigned int in = 0; in < nv; ++in)
+				vis_vertex_nodes.push_back(melement->GetNodeN(in).get_ptr());
+		}
+		vis_beam_thickness.push_back(mthickness * 0.5);
 
-	if (this->fem_data_type == E_PLOT_NONE)
-	{
-		n_verts =0;
-		n_vcols =0;
-		n_vnorms =0;
-		n_triangles =0;
+		n_verts += nv;
+		n_vnorms += nn;
+		n_triangles += nt;
 	}
 
-
 	//
-	// B - resize mesh buffers if needed
+	// B - resize mesh buffers
 	//
 
-	if (trianglemesh.getCoordsVertices().size() != n_verts)
-		trianglemesh.getCoordsVertices().resize(n_verts);
-	if (trianglemesh.getCoordsColors().size() != n_vcols)
-		trianglemesh.getCoordsColors().resize(n_vcols);
-	if (trianglemesh.getIndicesVertexes().size() != n_triangles)
-		trianglemesh.getIndicesVertexes().resize(n_triangles);
-
-	if (this->smooth_faces)
+	trianglemesh.getCoordsVertices().resize(n_verts);
+	trianglemesh.getCoordsColors().resize(n_verts);
+	trianglemesh.getIndicesVertexes().resize(n_triangles);
+	if (this->topology_smooth)
+	{
+		trianglemesh.getCoordsNormals().resize(n_vnorms);
+		trianglemesh.getIndicesNormals().resize(n_triangles);
+	}
+	else
 	{
-		if (trianglemesh.getCoordsNormals().size() != n_vnorms)
-			trianglemesh.getCoordsNormals().resize(n_vnorms);
-		if (trianglemesh.getIndicesNormals().size() != n_triangles)
-			trianglemesh.getIndicesNormals().resize(n_triangles);
-		if (normal_accumulators.size() != n_vnorms)
-			normal_accumulators.resize(n_vnorms);
-			
-		TriangleNormalsReset(trianglemesh.getCoordsNormals(), normal_accumulators); 
+		trianglemesh.getCoordsNormals().resize(0);
+		trianglemesh.getIndicesNormals().resize(0);
 	}
 
 	//
-	// C - update mesh buffers 
+	// C - faces, and normal indexes (if not defaulting to flat triangles)
 	//
 
-	unsigned int i_verts = 0;
-	unsigned int i_vcols = 0;
-	unsigned int i_vnorms = 0;
+	std::vector< ChVector<int> >& vindexes = trianglemesh.getIndicesVertexes();
+	std::vector< ChVector<int> >& nindexes = trianglemesh.getIndicesNormals();
 	unsigned int i_triindex = 0;
-	unsigned int i_normindex = 0;
 
-	if (this->fem_data_type != E_PLOT_NONE)
-	 for (unsigned int iel=0; iel < this->FEMmesh->GetNelements(); ++iel)
+	for (unsigned int ie = 0; ie < vis_elements.size(); ++ie)
 	{
-		// ------------ELEMENT IS A TETRAHEDRON 4 NODES?
-		
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementTetra_4>() )
+		int ivert_el = vis_vertex_offsets[ie];
+		int inorm_el = vis_normal_offsets[ie];
+		ChVector<int> ivert_offset(ivert_el,ivert_el,ivert_el);
+		ChVector<int> inorm_offset(inorm_el,inorm_el,inorm_el);
+
+		switch (vis_element_types[ie])
 		{
-			// downcasting 
-			ChSharedPtr<ChElementTetra_4> mytetra ( this->FEMmesh->GetElement(iel).DynamicCastTo<ChElementTetra_4>() );
-			ChSharedPtr<ChNodeFEMxyz> node0( mytetra->GetNodeN(0).DynamicCastTo<ChNodeFEMxyz>() ); 
-			ChSharedPtr<ChNodeFEMxyz> node1( mytetra->GetNodeN(1).DynamicCastTo<ChNodeFEMxyz>() );
-			ChSharedPtr<ChNodeFEMxyz> node2( mytetra->GetNodeN(2).DynamicCastTo<ChNodeFEMxyz>() );
-			ChSharedPtr<ChNodeFEMxyz> node3( mytetra->GetNodeN(3).DynamicCastTo<ChNodeFEMxyz>() );
-
-			unsigned int ivert_el = i_verts;
-			unsigned int inorm_el = i_vnorms;
-
-			// vertexes
-			ChVector<> p0 = node0->GetPos();
-			ChVector<> p1 = node1->GetPos();
-			ChVector<> p2 = node2->GetPos();
-			ChVector<> p3 = node3->GetPos();
-			if (undeformed_reference)
+		case E_VIS_TETRA_4:
+		case E_VIS_TETRA_4_P:
+			vindexes[i_triindex  ] = ChVector<int> (0,1,2) +  ivert_offset;
+			vindexes[i_triindex+1] = ChVector<int> (1,3,2) +  ivert_offset;
+			vindexes[i_triindex+2] = ChVector<int> (2,3,0) +  ivert_offset;
+			vindexes[i_triindex+3] = ChVector<int> (3,1,0) +  ivert_offset;
+			if (this->topology_smooth)
 			{
-				p0 = node0->GetX0();
-				p1 = node1->GetX0();
-				p2 = node2->GetX0();
-				p3 = node3->GetX0();
+				nindexes[i_triindex  ] = ChVector<int> (0,0,0) + inorm_offset;
+				nindexes[i_triindex+1] = ChVector<int> (1,1,1) + inorm_offset;
+				nindexes[i_triindex+2] = ChVector<int> (2,2,2) + inorm_offset;
+				nindexes[i_triindex+3] = ChVector<int> (3,3,3) + inorm_offset;
 			}
- 
-			if (this->shrink_elements)
+			i_triindex += 4;
+			break;
+
+		case E_VIS_HEXA_8:
+			vindexes[i_triindex   ] = ChVector<int> (0,2,1) +  ivert_offset;
+			vindexes[i_triindex+ 1] = ChVector<int> (0,3,2) +  ivert_offset;
+			vindexes[i_triindex+ 2] = ChVector<int> (4,5,6) +  ivert_offset;
+			vindexes[i_triindex+ 3] = ChVector<int> (4,6,7) +  ivert_offset;
+			vindexes[i_triindex+ 4] = ChVector<int> (0,7,3) +  ivert_offset;
+			vindexes[i_triindex+ 5] = ChVector<int> (0,4,7) +  ivert_offset;
+			vindexes[i_triindex+ 6] = ChVector<int> (0,5,4) +  ivert_offset;
+			vindexes[i_triindex+ 7] = ChVector<int> (0,1,5) +  ivert_offset;
+			vindexes[i_triindex+ 8] = ChVector<int> (3,7,6) +  ivert_offset;
+			vindexes[i_triindex+ 9] = ChVector<int> (3,6,2) +  ivert_offset;
+			vindexes[i_triindex+10] = ChVector<int> (2,5,1) +  ivert_offset;
+			vindexes[i_triindex+11] = ChVector<int> (2,6,5) +  ivert_offset;
+			if (this->topology_smooth)
 			{
-				ChVector<> vc = (p0+p1+p2+p3)*(0.25);
-				p0 = vc + this->shrink_factor*(p0-vc);
-				p1 = vc + this->shrink_factor*(p1-vc);
-				p2 = vc + this->shrink_factor*(p2-vc);
-				p3 = vc + this->shrink_factor*(p3-vc);
+				nindexes[i_triindex   ] = ChVector<int> (0,2,1)+inorm_offset;
+				nindexes[i_triindex+ 1] = ChVector<int> (0,3,2)+inorm_offset;
+				nindexes[i_triindex+ 2] = ChVector<int> (4,5,6)+inorm_offset;
+				nindexes[i_triindex+ 3] = ChVector<int> (4,6,7)+inorm_offset;
+				nindexes[i_triindex+ 4] = ChVector<int> (8,  9,10)+inorm_offset;
+				nindexes[i_triindex+ 5] = ChVector<int> (8, 11, 9)+inorm_offset;
+				nindexes[i_triindex+ 6] = ChVector<int> (12, 13, 14)+inorm_offset;
+				nindexes[i_triindex+ 7] = ChVector<int> (12, 15, 13)+inorm_offset;
+				nindexes[i_triindex+ 8] = ChVector<int> (16, 18, 17)+inorm_offset;
+				nindexes[i_triindex+ 9] = ChVector<int> (16, 17, 19)+inorm_offset;
+				nindexes[i_triindex+10] = ChVector<int> (20, 21, 23)+inorm_offset;
+				nindexes[i_triindex+11] = ChVector<int> (20, 22, 21)+inorm_offset;
 			}
-			trianglemesh.getCoordsVertices()[i_verts] = p0; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p1; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p2; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p3; 
-			++i_verts;
-
-			// colour
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node0, 0, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node1, 1, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node2, 2, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node3, 3, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-
-			// faces indexes
-			ChVector<int> ivert_offset(ivert_el,ivert_el,ivert_el);
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,1,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (1,3,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (2,3,0) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (3,1,0) +  ivert_offset;
-			++i_triindex;
-
-			// normals indices (if not defaulting to flat triangles)
-			if (this->smooth_faces)
+			i_triindex += 12;
+			break;
+
+		case E_VIS_BEAM:
+			for (int in= 1; in < beam_resolution; ++in)
 			{
-				ChVector<int> inorm_offset = ChVector<int> (inorm_el,inorm_el,inorm_el);
-				trianglemesh.getIndicesNormals()[i_triindex-4] = ChVector<int> (0,0,0) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-3] = ChVector<int> (1,1,1) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-2] = ChVector<int> (2,2,2) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-1] = ChVector<int> (3,3,3) + inorm_offset;
-				i_vnorms +=4;
+				ChVector<int> islice_offset((in-1)*4,(in-1)*4,(in-1)*4);
+				vindexes[i_triindex  ] = ChVector<int> (4, 0, 1) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+1] = ChVector<int> (4, 1, 5) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+2] = ChVector<int> (5, 1, 2) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+3] = ChVector<int> (5, 2, 6) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+4] = ChVector<int> (6, 2, 3) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+5] = ChVector<int> (6, 3, 7) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+6] = ChVector<int> (7, 3, 0) +  islice_offset + ivert_offset;
+				vindexes[i_triindex+7] = ChVector<int> (7, 0, 4) +  islice_offset + ivert_offset;
+				if (this->topology_smooth)
+				{
+					ChVector<int> islice_normoffset((in-1)*8,(in-1)*8,(in-1)*8); //***TO DO*** fix errors in normals
+					nindexes[i_triindex  ] = ChVector<int> (8, 0, 1) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+1] = ChVector<int> (8, 1, 9) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+2] = ChVector<int> (9+4, 1+4, 2+4) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+3] = ChVector<int> (9+4, 2+4, 10+4) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+4] = ChVector<int> (10, 2, 3) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+5] = ChVector<int> (10, 3, 11) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+6] = ChVector<int> (11+4, 3+4, 0+4) +  islice_normoffset + inorm_offset;
+					nindexes[i_triindex+7] = ChVector<int> (11+4, 0+4, 8+4) +  islice_normoffset + inorm_offset;
+				}
+				i_triindex += 8;
 			}
+			break;
 		}
+	}
 
+	//
+	// D - for smoothing, the triangles that touch each normal, so that 
+	// normals can be averaged in parallel without scattering
+	//
 
-		// ------------ELEMENT IS A TETRAHEDRON 4 NODES -for SCALAR field- ?
-		
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementTetra_4_P>() )
+	vis_normal_starts.assign(this->topology_smooth ? n_vnorms+1 : 0, 0);
+	vis_normal_triangles.clear();
+	vis_face_normals.resize(this->topology_smooth ? n_triangles : 0);
+	if (this->topology_smooth)
+	{
+		for (unsigned int itri = 0; itri < n_triangles; ++itri)
 		{
-			// downcasting 
-			ChSharedPtr<ChElementTetra_4_P> mytetra ( this->FEMmesh->GetElement(iel).DynamicCastTo<ChElementTetra_4_P>() );
-			ChSharedPtr<ChNodeFEMxyzP> node0( mytetra->GetNodeN(0).DynamicCastTo<ChNodeFEMxyzP>() ); 
-			ChSharedPtr<ChNodeFEMxyzP> node1( mytetra->GetNodeN(1).DynamicCastTo<ChNodeFEMxyzP>() );
-			ChSharedPtr<ChNodeFEMxyzP> node2( mytetra->GetNodeN(2).DynamicCastTo<ChNodeFEMxyzP>() );
-			ChSharedPtr<ChNodeFEMxyzP> node3( mytetra->GetNodeN(3).DynamicCastTo<ChNodeFEMxyzP>() );
-
-			unsigned int ivert_el = i_verts;
-			unsigned int inorm_el = i_vnorms;
-
-			// vertexes
-			ChVector<> p0 = node0->GetPos();
-			ChVector<> p1 = node1->GetPos();
-			ChVector<> p2 = node2->GetPos();
-			ChVector<> p3 = node3->GetPos();
- 
-			if (this->shrink_elements)
-			{
-				ChVector<> vc = (p0+p1+p2+p3)*(0.25);
-				p0 = vc + this->shrink_factor*(p0-vc);
-				p1 = vc + this->shrink_factor*(p1-vc);
-				p2 = vc + this->shrink_factor*(p2-vc);
-				p3 = vc + this->shrink_factor*(p3-vc);
-			}
-			trianglemesh.getCoordsVertices()[i_verts] = p0; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p1; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p2; 
-			++i_verts;
-			trianglemesh.getCoordsVertices()[i_verts] = p3; 
-			++i_verts;
-
-			// colour
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node0, 0, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node1, 1, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node2, 2, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-			trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( node3, 3, this->FEMmesh->GetElement(iel) ) );
-			++i_vcols;
-
-			// faces indexes
-			ChVector<int> ivert_offset(ivert_el,ivert_el,ivert_el);
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,1,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (1,3,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (2,3,0) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (3,1,0) +  ivert_offset;
-			++i_triindex;
-
-			// normals indices (if not defaulting to flat triangles)
-			if (this->smooth_faces)
-			{
-				ChVector<int> inorm_offset = ChVector<int> (inorm_el,inorm_el,inorm_el);
-				trianglemesh.getIndicesNormals()[i_triindex-4] = ChVector<int> (0,0,0) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-3] = ChVector<int> (1,1,1) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-2] = ChVector<int> (2,2,2) + inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-1] = ChVector<int> (3,3,3) + inorm_offset;
-				i_vnorms +=4;
-			}
+			++vis_normal_starts[nindexes[itri].x + 1];
+			++vis_normal_starts[nindexes[itri].y + 1];
+			++vis_normal_starts[nindexes[itri].z + 1];
+		}
+		for (unsigned int nn = 0; nn < n_vnorms; ++nn)
+			vis_normal_starts[nn+1] += vis_normal_starts[nn];
+		vis_normal_triangles.resize(vis_normal_starts[n_vnorms]);
+		std::vector<unsigned int> mfill(vis_normal_starts.begin(), vis_normal_starts.end()-1);
+		for (unsigned int itri = 0; itri < n_triangles; ++itri)
+		{
+			vis_normal_triangles[mfill[nindexes[itri].x]++] = itri;
+			vis_normal_triangles[mfill[nindexes[itri].y]++] = itri;
+			vis_normal_triangles[mfill[nindexes[itri].z]++] = itri;
 		}
+	}
+}
 
 
-		// ------------ELEMENT IS A HEXAHEDRON 8 NODES?
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementHexa_8>() )
-		{
-			// downcasting 
-			ChSharedPtr<ChElementHexa_8> mytetra ( this->FEMmesh->GetElement(iel).DynamicCastTo<ChElementHexa_8>() );
+void ChVisualizationFEMmesh::UpdateBeamVertexes(unsigned int ie, geometry::ChTriangleMeshConnected& trianglemesh)
+{
+	int beam_resolution = 8;
 
-			unsigned int ivert_el = i_verts;
-			unsigned int inorm_el = i_vnorms;
+	ChElementBeam* mybeam = (ChElementBeam*)vis_elements[ie];
 
-			ChSharedPtr<ChNodeFEMxyz> nodes[8];
-			ChVector<> pt[8];
+	double y_thick = vis_beam_thickness[ie].y;
+	double z_thick = vis_beam_thickness[ie].z;
 
-			for (int in= 0; in <8; ++in)
-			{
-				nodes[in]= mytetra->GetNodeN(in).DynamicCastTo<ChNodeFEMxyz>();
-				if (!undeformed_reference)
-					pt[in] = nodes[in]->GetPos();
-				else
-					pt[in] = nodes[in]->GetX0();
-			}
+	unsigned int i_verts = vis_vertex_offsets[ie];
 
-			// vertexes
+	// displacements & rotations state of the nodes:
+	ChMatrixDynamic<> displ(mybeam->GetNdofs(),1);
+	mybeam->GetField(displ); // for field of corotated element, u_displ will be always 0 at ends
 
-			if (this->shrink_elements)
-			{
-				ChVector<> vc(0,0,0);
-				for (int in= 0; in <8; ++in)
-					vc += pt[in];
-				vc = vc*(1.0/8.0); // average, center of element
-				for (int in= 0; in <8; ++in)
-					pt[in] = vc + this->shrink_factor*(pt[in]-vc);
-			}
+	for (int in= 0; in < beam_resolution; ++in)
+	{
+		double eta = -1.0+(2.0*in/(beam_resolution-1));
+		
+		ChVector<> P;
+		ChQuaternion<> msectionrot;
+		mybeam->EvaluateSectionFrame(eta, displ, P, msectionrot);  // compute abs. pos and rot of section plane
+
+		ChVector<> vresult;
+		ChVector<> vresultB;
+		double sresult = 0;
+		switch(this->fem_data_type)
+		{
+			case E_PLOT_ELEM_BEAM_MX:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresultB.x; 
+				break;
+			case E_PLOT_ELEM_BEAM_MY:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresultB.y; 
+				break;
+			case E_PLOT_ELEM_BEAM_MZ:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresultB.z; 
+				break;
+			case E_PLOT_ELEM_BEAM_TX:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresult.x; 
+				break;
+			case E_PLOT_ELEM_BEAM_TY:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresult.y; 
+				break;
+			case E_PLOT_ELEM_BEAM_TZ:
+				mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
+				sresult = vresult.z; 
+				break;
+		}
+		ChVector<float> mcol = ComputeFalseColor(sresult);
 
-			for (int in= 0; in <8; ++in)
-			{
-				trianglemesh.getCoordsVertices()[i_verts] = pt[in]; 
-				++i_verts;
-			}
+		trianglemesh.getCoordsVertices()[i_verts  ] = P + msectionrot.Rotate(ChVector<>(0,-y_thick,-z_thick) ); 
+		trianglemesh.getCoordsVertices()[i_verts+1] = P + msectionrot.Rotate(ChVector<>(0, y_thick,-z_thick) ); 
+		trianglemesh.getCoordsVertices()[i_verts+2] = P + msectionrot.Rotate(ChVector<>(0, y_thick, z_thick) ); 
+		trianglemesh.getCoordsVertices()[i_verts+3] = P + msectionrot.Rotate(ChVector<>(0,-y_thick, z_thick) ); 
 
-			// colours and colours indexes
-			for (int in= 0; in <8; ++in)
-			{
-				trianglemesh.getCoordsColors()[i_vcols] =  ComputeFalseColor( ComputeScalarOutput ( nodes[in], in, this->FEMmesh->GetElement(iel) ) );
-				++i_vcols;
-			}
+		for (int ic = 0; ic < 4; ++ic)
+			trianglemesh.getCoordsColors()[i_verts+ic] = mcol; 
+
+		i_verts += 4;
+	}
+}
 
-			// faces indexes
-			ChVector<int> ivert_offset(ivert_el,ivert_el,ivert_el);
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,2,1) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,3,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (4,5,6) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (4,6,7) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,7,3) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,4,7) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,5,4) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (0,1,5) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (3,7,6) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (3,6,2) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (2,5,1) +  ivert_offset;
-			++i_triindex;
-			trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (2,6,5) +  ivert_offset;
-			++i_triindex;
-
-			// normals indices (if not defaulting to flat triangles)
-			if (this->smooth_faces)
-			{
-				ChVector<int> inorm_offset = ChVector<int> (inorm_el,inorm_el,inorm_el);
-				trianglemesh.getIndicesNormals()[i_triindex-12] = ChVector<int> (0,2,1)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-11] = ChVector<int> (0,3,2)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex-10] = ChVector<int> (4,5,6)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 9] = ChVector<int> (4,6,7)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 8] = ChVector<int> (8,  9,10)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 7] = ChVector<int> (8, 11, 9)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 6] = ChVector<int> (12, 13, 14)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 5] = ChVector<int> (12, 15, 13)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 4] = ChVector<int> (16, 18, 17)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 3] = ChVector<int> (16, 17, 19)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 2] = ChVector<int> (20, 21, 23)+inorm_offset;
-				trianglemesh.getIndicesNormals()[i_triindex- 1] = ChVector<int> (20, 22, 21)+inorm_offset;
-				i_vnorms +=24;
-			}		
-		}
 
+void ChVisualizationFEMmesh::Update ()
+{
+	if (!this->FEMmesh) 
+		return;
 
-		// ------------ELEMENT IS A BEAM?
-		if (this->FEMmesh->GetElement(iel).IsType<ChElementBeam>() )
+	ChSharedPtr<ChTriangleMeshShape> mesh_asset;
+	ChSharedPtr<ChGlyphs>			 glyphs_asset;
+
+	// try to retrieve previously added mesh asset and glyhs asset in sublevel..
+	if (this->GetAssets().size() == 2)
+		if (GetAssets()[0].IsType<ChTriangleMeshShape>() &&
+			GetAssets()[1].IsType<ChGlyphs>() )
 		{
-			// downcasting 
-			ChSharedPtr<ChElementBeam> mybeam ( this->FEMmesh->GetElement(iel).DynamicCastTo<ChElementBeam>() );
+			mesh_asset   = GetAssets()[0].DynamicCastTo<ChTriangleMeshShape>();
+			glyphs_asset = GetAssets()[1].DynamicCastTo<ChGlyphs>();
+		}
 
-			double y_thick = 0.01; // line thickness default value
-			double z_thick = 0.01; 
+	// if not available, create ...
+	if (mesh_asset.IsNull())
+	{
+		this->GetAssets().resize(0); // this to delete other sub assets that are not in mesh & glyphs, if any
 
-			ChSharedPtr<ChElementBeamEuler> mybeameuler ( mybeam.DynamicCastTo<ChElementBeamEuler>() );
-			if (!mybeameuler.IsNull())
-			{
-				// if the beam has a section info, use section specific thickness for drawing
-				y_thick = 0.5*mybeameuler->GetSection()->GetDrawThicknessY();
-				z_thick = 0.5*mybeameuler->GetSection()->GetDrawThicknessZ();
-			}
+		ChSharedPtr<ChTriangleMeshShape> new_mesh_asset(new ChTriangleMeshShape);
+		new_mesh_asset->SetDirtyTracking(true);
+		this->AddAsset(new_mesh_asset);
+		mesh_asset = new_mesh_asset;
+
+		ChSharedPtr<ChGlyphs> new_glyphs_asset(new ChGlyphs);
+		this->AddAsset(new_glyphs_asset);
+		glyphs_asset = new_glyphs_asset;
+
+		this->topology_valid = false;
+	}
+	geometry::ChTriangleMeshConnected& trianglemesh = mesh_asset->GetMesh();
+
+	//
+	// A - build the faces, only if the elements changed
+	//
 
-			unsigned int ivert_el = i_verts;
-			unsigned int inorm_el = i_vnorms;
+	bool new_topology = !IsTopologyValid();
+	if (new_topology)
+		UpdateTopology(trianglemesh);
 
-			// displacements & rotations state of the nodes:
-			ChMatrixDynamic<> displ(mybeam->GetNdofs(),1);
-			mybeam->GetField(displ); // for field of corotated element, u_displ will be always 0 at ends
+	//
+	// B - update vertexes and colours. Each element writes its own vertexes, 
+	// so this can run in parallel; beams are evaluated serially, afterwards.
+	//
+
+	std::vector< ChVector<> >&      vertexes = trianglemesh.getCoordsVertices();
+	std::vector< ChVector<float> >& colours  = trianglemesh.getCoordsColors();
+
+	// values per element (ex. stresses) are computed once, not per vertex
+	bool element_scalar = (this->fem_data_type >= E_PLOT_ELEM_STRAIN_VONMISES && 
+						   this->fem_data_type <= E_PLOT_ELEM_STRESS_HYDROSTATIC);
+
+	#pragma omp parallel for schedule(static)
+	for (int ie = 0; ie < (int)vis_elements.size(); ++ie)
+	{
+		unsigned int ivert_el = vis_vertex_offsets[ie];
+		ChVector<> pt[8];
+		int nv = 0;
 
-			for (int in= 0; in < beam_resolution; ++in)
+		switch (vis_element_types[ie])
+		{
+		case E_VIS_TETRA_4:
+		case E_VIS_HEXA_8:
+			nv = (vis_element_types[ie] == E_VIS_TETRA_4) ? 4 : 8;
+			for (int in = 0; in < nv; ++in)
 			{
-				double eta = -1.0+(2.0*in/(beam_resolution-1));
-				
-				ChVector<> P;
-				ChQuaternion<> msectionrot;
-				mybeam->EvaluateSectionFrame(eta, displ, P, msectionrot);  // compute abs. pos and rot of section plane
-
-				ChVector<> vresult;
-				ChVector<> vresultB;
-				double sresult = 0;
-				switch(this->fem_data_type)
-				{
-					case E_PLOT_ELEM_BEAM_MX:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresultB.x; 
-						break;
-					case E_PLOT_ELEM_BEAM_MY:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresultB.y; 
-						break;
-					case E_PLOT_ELEM_BEAM_MZ:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresultB.z; 
-						break;
-					case E_PLOT_ELEM_BEAM_TX:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresult.x; 
-						break;
-					case E_PLOT_ELEM_BEAM_TY:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresult.y; 
-						break;
-					case E_PLOT_ELEM_BEAM_TZ:
-						mybeam->EvaluateSectionForceTorque(eta, displ, vresult, vresultB);
-						sresult = vresult.z; 
-						break;
-				}
-				ChVector<float> mcol = ComputeFalseColor(sresult);
-
-				trianglemesh.getCoordsVertices()[i_verts] = P + msectionrot.Rotate(ChVector<>(0,-y_thick,-z_thick) ); 
-				++i_verts;
-				trianglemesh.getCoordsVertices()[i_verts] = P + msectionrot.Rotate(ChVector<>(0, y_thick,-z_thick) ) ; 
-				++i_verts;
-				trianglemesh.getCoordsVertices()[i_verts] = P + msectionrot.Rotate(ChVector<>(0, y_thick, z_thick) ) ; 
-				++i_verts;
-				trianglemesh.getCoordsVertices()[i_verts] = P + msectionrot.Rotate(ChVector<>(0,-y_thick, z_thick) ) ; 
-				++i_verts;
-
-				trianglemesh.getCoordsColors()[i_vcols] =  mcol; 
-				++i_vcols;
-				trianglemesh.getCoordsColors()[i_vcols] =  mcol; 
-				++i_vcols;
-				trianglemesh.getCoordsColors()[i_vcols] =  mcol; 
-				++i_vcols;
-				trianglemesh.getCoordsColors()[i_vcols] =  mcol; 
-				++i_vcols;
-
-				if (in>0)
-				{
-					ChVector<int> ivert_offset(ivert_el,ivert_el,ivert_el);
-					ChVector<int> islice_offset((in-1)*4,(in-1)*4,(in-1)*4);
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (4, 0, 1) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (4, 1, 5) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (5, 1, 2) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (5, 2, 6) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (6, 2, 3) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (6, 3, 7) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (7, 3, 0) +  islice_offset + ivert_offset;
-					++i_triindex;
-					trianglemesh.getIndicesVertexes()[i_triindex] = ChVector<int> (7, 0, 4) +  islice_offset + ivert_offset;
-					++i_triindex;
-					if (this->smooth_faces)
-					{
-						ChVector<int> islice_normoffset((in-1)*8,(in-1)*8,(in-1)*8); //***TO DO*** fix errors in normals
-						ChVector<int> inorm_offset = ChVector<int> (inorm_el,inorm_el,inorm_el);
-						trianglemesh.getIndicesNormals()[i_triindex- 8] = ChVector<int> (8, 0, 1) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 7] = ChVector<int> (8, 1, 9) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 6] = ChVector<int> (9+4, 1+4, 2+4) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 5] = ChVector<int> (9+4, 2+4, 10+4) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 4] = ChVector<int> (10, 2, 3) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 3] = ChVector<int> (10, 3, 11) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 2] = ChVector<int> (11+4, 3+4, 0+4) +  islice_normoffset + inorm_offset;
-						trianglemesh.getIndicesNormals()[i_triindex- 1] = ChVector<int> (11+4, 0+4, 8+4) +  islice_normoffset + inorm_offset;
-						i_vnorms +=8;
-					}				
-				}
-			}		
+				ChNodeFEMxyz* mnode = (ChNodeFEMxyz*)vis_vertex_nodes[ivert_el+in];
+				if (!undeformed_reference)
+					pt[in] = mnode->GetPos();
+				else
+					pt[in] = mnode->GetX0();
+				if (in == 0 || !element_scalar)
+					colours[ivert_el+in] = ComputeFalseColor( ComputeScalarOutput ( mnode, in, vis_elements[ie] ) );
+				else
+					colours[ivert_el+in] = colours[ivert_el];
+			}
+			break;
+		case E_VIS_TETRA_4_P:
+			nv = 4;
+			for (int in = 0; in < nv; ++in)
+			{
+				ChNodeFEMxyzP* mnode = (ChNodeFEMxyzP*)vis_vertex_nodes[ivert_el+in];
+				pt[in] = mnode->GetPos();
+				colours[ivert_el+in] = ComputeFalseColor( ComputeScalarOutput ( mnode, in, vis_elements[ie] ) );
+			}
+			break;
+		default:
+			continue;
 		}
 
+		if (this->shrink_elements)
+		{
+			ChVector<> vc(0,0,0);
+			for (int in= 0; in < nv; ++in)
+				vc += pt[in];
+			vc = vc*(1.0/(double)nv); // average, center of element
+			for (int in= 0; in < nv; ++in)
+				pt[in] = vc + this->shrink_factor*(pt[in]-vc);
+		}
 
-		// ------------***TO DO*** other types of elements...
-
+		for (int in= 0; in < nv; ++in)
+			vertexes[ivert_el+in] = pt[in];
 	}
 
+	for (unsigned int ie = 0; ie < vis_elements.size(); ++ie)
+		if (vis_element_types[ie] == E_VIS_BEAM)
+			UpdateBeamVertexes(ie, trianglemesh);
+
+	//
+	// C - smoothed normals: average of the normals of the triangles
+	// that touch each normal
+	//
 
-	if (this->smooth_faces)
+	if (this->topology_smooth)
 	{
-		for (unsigned int itri = 0; itri < trianglemesh.getIndicesVertexes().size(); ++itri)
-			TriangleNormalsCompute(trianglemesh.getIndicesNormals()[itri], trianglemesh.getIndicesVertexes()[itri], trianglemesh.getCoordsVertices(), trianglemesh.getCoordsNormals(), normal_accumulators);
+		std::vector< ChVector<int> >& vindexes = trianglemesh.getIndicesVertexes();
+		std::vector< ChVector<> >& normals = trianglemesh.getCoordsNormals();
+
+		#pragma omp parallel for schedule(static)
+		for (int itri = 0; itri < (int)vis_face_normals.size(); ++itri)
+			vis_face_normals[itri] = Vcross(vertexes[vindexes[itri].y]-vertexes[vindexes[itri].x], 
+											vertexes[vindexes[itri].z]-vertexes[vindexes[itri].x]).GetNormalized();
 
-		TriangleNormalsSmooth( trianglemesh.getCoordsNormals(), normal_accumulators);
+		#pragma omp parallel for schedule(static)
+		for (int nn = 0; nn < (int)normals.size(); ++nn)
+		{
+			ChVector<> mnormal(0,0,0);
+			unsigned int nstart = vis_normal_starts[nn];
+			unsigned int nend   = vis_normal_starts[nn+1];
+			for (unsigned int k = nstart; k < nend; ++k)
+				mnormal += vis_face_normals[vis_normal_triangles[k]];
+			if (nend > nstart)
+				mnormal = mnormal * (1.0 / (double)(nend - nstart));
+			normals[nn] = mnormal;
+		}
 	}
 
+	mesh_asset->SetDirty(new_topology);
+
 	// other flags
 	mesh_asset->SetWireframe( this->wireframe );
 
@@ -105,7 +105,25 @@ class ChApiFem ChVisualizationFEMmesh: public ChAssetLevel
 		ChColor meshcolor;
 		ChColor symbolscolor;
 
-		std::vector<int> normal_accumulators;
+		// Topology of the triangle mesh, built once by UpdateTopology() and
+		// reused by Update(), that only refreshes vertexes, normals and colors.
+		enum eChVisElementType {
+				E_VIS_TETRA_4,
+				E_VIS_TETRA_4_P,
+				E_VIS_HEXA_8,
+				E_VIS_BEAM,
+		};
+		std::vector<ChElementBase*>  vis_elements;			// the elements that have triangles, in vertex order
+		std::vector<int>             vis_element_types;
+		std::vector<unsigned int>    vis_vertex_offsets;	// first vertex of each element
+		std::vector<ChNodeFEMbase*>  vis_vertex_nodes;		// node of each vertex (NULL for beams)
+		std::vector< ChVector<> >    vis_beam_thickness;	// half thickness (y,z) of beam sections
+		std::vector<unsigned int>    vis_normal_starts;		// triangles touching each normal, compressed rows
+		std::vector<unsigned int>    vis_normal_triangles;
+		std::vector< ChVector<> >    vis_face_normals;
+		bool topology_valid;
+		bool topology_smooth;
+		bool topology_empty;
 
 	public:
 
@@ -182,11 +200,22 @@ class ChApiFem ChVisualizationFEMmesh: public ChAssetLevel
 
 			// Updates the triangle visualization mesh so that it matches with the
 			// FEM mesh (ex. tetrahedrons are converted in 4 surfaces, etc.
+			// The faces are built only the first time, or when the elements of the 
+			// mesh changed; then only vertexes, normals and colors are refreshed,
+			// in parallel, and the ChTriangleMeshShape is flagged as dirty.
 		virtual void Update ();
 
+			// Forces the faces of the triangle mesh to be rebuilt at the next Update().
+			// Not needed if elements are added or removed, since this is detected.
+		void ResetTopology() {this->topology_valid = false;}
+
 private:
-		double	ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyz> mnode, int nodeID, ChSharedPtr<ChElementBase> melement);
-		double	ComputeScalarOutput( ChSharedPtr<ChNodeFEMxyzP> mnode, int nodeID, ChSharedPtr<ChElementBase> melement);
+		bool	IsTopologyValid();
+		void	UpdateTopology(geometry::ChTriangleMeshConnected& trianglemesh);
+		void	UpdateBeamVertexes(unsigned int ie, geometry::ChTriangleMeshConnected& trianglemesh);
+
+		double	ComputeScalarOutput( ChNodeFEMxyz* mnode, int nodeID, ChElementBase* melement);
+		double	ComputeScalarOutput( ChNodeFEMxyzP* mnode, int nodeID, ChElementBase* melement);
 		ChVector<float> ComputeFalseColor(double in);
 		ChColor			ComputeFalseColor2(double in);
 
@@ -174,6 +174,7 @@ bool ChIrrAppEventReceiver::OnEvent(const SEvent& event)
         case 6: app->GetSystem()->SetLcpSolverType(chrono::ChSystem::LCP_ITERATIVE_PMINRES); break;
         case 7: app->GetSystem()->SetLcpSolverType(chrono::ChSystem::LCP_ITERATIVE_APGD); break;
         case 8: app->GetSystem()->SetLcpSolverType(chrono::ChSystem::LCP_ITERATIVE_MINRES); break;
+        case 9: app->GetSystem()->SetLcpSolverType(chrono::ChSystem::LCP_ITERATIVE_AMG); break;
         }
         break;
       }
@@ -344,6 +345,7 @@ ChIrrAppInterface::ChIrrAppInterface(
   gad_ccpsolver->addItem(L"Projected MINRES");
   gad_ccpsolver->addItem(L"APGD");
   gad_ccpsolver->addItem(L"MINRES");
+  gad_ccpsolver->addItem(L"AMG (FEM)");
   gad_ccpsolver->addItem(L" ");
   gad_ccpsolver->setSelected(5);
 
@@ -602,7 +604,8 @@ void ChIrrAppInterface::DrawAll()
     case chrono::ChSystem::LCP_ITERATIVE_PMINRES:           gad_ccpsolver->setSelected(6); break;
     case chrono::ChSystem::LCP_ITERATIVE_APGD:              gad_ccpsolver->setSelected(7); break;
     case chrono::ChSystem::LCP_ITERATIVE_MINRES:            gad_ccpsolver->setSelected(8); break;
-    default:                                                gad_ccpsolver->setSelected(9); break;
+    case chrono::ChSystem::LCP_ITERATIVE_AMG:               gad_ccpsolver->setSelected(9); break;
+    default:                                                gad_ccpsolver->setSelected(10); break;
     }
 
     switch(GetSystem()->GetIntegrationType())
@@ -82,6 +82,12 @@ void ChIrrNodeProxyToAsset::Update()
     if (amesh->getMeshBufferCount() == 0)
       return;
 
+    meshnode->setMaterialFlag(video::EMF_WIREFRAME,         trianglemesh->IsWireframe() );
+    meshnode->setMaterialFlag(video::EMF_LIGHTING,          !trianglemesh->IsWireframe() ); // avoid shading for wireframes
+    meshnode->setMaterialFlag(video::EMF_BACK_FACE_CULLING, trianglemesh->IsBackfaceCull() );
+
+    meshnode->setMaterialFlag(video::EMF_COLOR_MATERIAL, true); // so color shading = vertexes  color
+
     chrono::geometry::ChTriangleMeshConnected* mmesh = &trianglemesh->GetMesh();
     unsigned int ntriangles = mmesh->getIndicesVertexes().size();
     unsigned int nvertexes = ntriangles * 3; // this is suboptimal because some vertexes might be shared, but easier now..
@@ -89,6 +95,14 @@ void ChIrrNodeProxyToAsset::Update()
     //SMeshBuffer* irrmesh = (SMeshBuffer*)amesh->getMeshBuffer(0);
     CDynamicMeshBuffer* irrmesh = (CDynamicMeshBuffer*)amesh->getMeshBuffer(0);
 
+    // nothing changed since the last conversion: keep the buffers (only if
+    // the mesh tells when it changes, otherwise always convert it)
+    bool tracking = trianglemesh->IsDirtyTracking();
+    if (tracking && !trianglemesh->IsDirty() && irrmesh->getVertexBuffer().size() == nvertexes)
+      return;
+
+    bool refill_indexes = !tracking || trianglemesh->IsTopologyDirty() || irrmesh->getIndexBuffer().size() != ntriangles*3;
+
     // smart inflating of allocated buffers, only if necessary, and once in a while shrinking
     if (irrmesh->getIndexBuffer().allocated_size() > (ntriangles*3) * 1.5)
       irrmesh->getIndexBuffer().reallocate(0);//clear();
@@ -163,21 +177,19 @@ void ChIrrNodeProxyToAsset::Update()
                          video::SColor(255, (u32)(col3.x*255), (u32)(col3.y*255), (u32)(col3.z*255)),
                          (f32)uv3.x, (f32)uv3.y);
 
-      irrmesh->getIndexBuffer().setValue(0+itri*3, 0+itri*3);
-      irrmesh->getIndexBuffer().setValue(1+itri*3, 1+itri*3);
-      irrmesh->getIndexBuffer().setValue(2+itri*3, 2+itri*3);
+      if (refill_indexes)
+      {
+        irrmesh->getIndexBuffer().setValue(0+itri*3, 0+itri*3);
+        irrmesh->getIndexBuffer().setValue(1+itri*3, 1+itri*3);
+        irrmesh->getIndexBuffer().setValue(2+itri*3, 2+itri*3);
+      }
     }
 
     irrmesh->setDirty(); // to force update of hardware buffers
     irrmesh->setHardwareMappingHint(EHM_DYNAMIC);//EHM_NEVER); //EHM_DYNAMIC for faster hw mapping
     irrmesh->recalculateBoundingBox();
 
-    meshnode->setMaterialFlag(video::EMF_WIREFRAME,         trianglemesh->IsWireframe() );
-    meshnode->setMaterialFlag(video::EMF_LIGHTING,          !trianglemesh->IsWireframe() ); // avoid shading for wireframes
-    meshnode->setMaterialFlag(video::EMF_BACK_FACE_CULLING, trianglemesh->IsBackfaceCull() );
-
-    meshnode->setMaterialFlag(video::EMF_COLOR_MATERIAL, true); // so color shading = vertexes  color
-
+    trianglemesh->ClearDirty();
   }
 
   if (visualization_asset.IsType<chrono::ChGlyphs>())
@@ -0,0 +1,99 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChDomainManagerMPI.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include "unit_MPI/ChDomainManagerMPI.h"
+#include "core/ChException.h"
+
+#include "core/ChMemory.h" // must be last include (memory leak debugger). In .cpp only.
+
+
+namespace chrono
+{
+
+
+
+ChDomainManagerMPI::ChDomainManagerMPI(MPI_Comm mcomm)
+{
+	comm = mcomm;
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_size(comm, &nprocesses);
+}
+
+
+void ChDomainManagerMPI::Initialize()
+{
+	if (nprocesses != grid.GetNdomains())
+		throw ChException("The number of MPI processes must be the number of domains");
+
+	ChDomainManagerDEM::Initialize();
+
+	sendcounts.resize(nprocesses);
+	senddispls.resize(nprocesses);
+	recvcounts.resize(nprocesses);
+	recvdispls.resize(nprocesses);
+}
+
+
+int ChDomainManagerMPI::GetNtotalBodies()
+{
+	int nlocal = GetNlocalBodies();
+	int ntotal = 0;
+	MPI_Allreduce(&nlocal, &ntotal, 1, MPI_INT, MPI_SUM, comm);
+	return ntotal;
+}
+
+
+void ChDomainManagerMPI::Exchange(std::vector< std::vector< std::vector<ChDomainBodyState> > >& outgoing,
+								  std::vector< std::vector<ChDomainBodyState> >& incoming)
+{
+	// The states are plain data, sent as bytes (all processes
+	// run the same executable on the same kind of machine)
+	const int statesize = (int)sizeof(ChDomainBodyState);
+	std::vector< std::vector<ChDomainBodyState> >& mout = outgoing[0];
+
+	sendbuffer.clear();
+	for (int d = 0; d < nprocesses; ++d)
+	{
+		senddispls[d] = (int)sendbuffer.size() * statesize;
+		sendcounts[d] = (int)mout[d].size() * statesize;
+		sendbuffer.insert(sendbuffer.end(), mout[d].begin(), mout[d].end());
+	}
+
+	MPI_Alltoall(&sendcounts[0], 1, MPI_INT, &recvcounts[0], 1, MPI_INT, comm);
+
+	int nreceived = 0;
+	for (int d = 0; d < nprocesses; ++d)
+	{
+		recvdispls[d] = nreceived;
+		nreceived += recvcounts[d];
+	}
+	incoming[0].resize(nreceived / statesize);
+
+	MPI_Alltoallv(sendbuffer.empty() ? 0 : &sendbuffer[0], &sendcounts[0], &senddispls[0], MPI_BYTE,
+				  incoming[0].empty() ? 0 : &incoming[0][0], &recvcounts[0], &recvdispls[0], MPI_BYTE,
+				  comm);
+}
+
+
+
+} // END_OF_NAMESPACE____
+
+
@@ -0,0 +1,89 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHDOMAINMANAGERMPI_H
+#define CHDOMAINMANAGERMPI_H
+
+//////////////////////////////////////////////////
+//
+//   ChDomainManagerMPI.h
+//
+//   Domain decomposition of DEM systems, with a
+//   MPI process per domain.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+
+#include <mpi.h>
+#include "unit_MPI/ChApiMPI.h"
+#include "physics/ChDomainManagerDEM.h"
+
+
+namespace chrono
+{
+
+
+///
+/// Domain decomposition of a DEM system, with a MPI process per domain:
+/// the process of rank r has the node of domain r, and the bodies are
+/// exchanged with MPI messages. Run it with as many processes as domains,
+/// ex. 'mpirun -np 8' for a 2x2x2 grid, also on a single machine.
+/// Each process must call MPI_Init() before using it, and MPI_Finalize()
+/// at the end. Bodies can be added by all processes in the same order
+/// (each keeps only those in its domain), so that no body states have to
+/// be sent at the beginning.
+///
+
+class ChApiMPI ChDomainManagerMPI : public ChDomainManagerDEM
+{
+public:
+	ChDomainManagerMPI(MPI_Comm mcomm = MPI_COMM_WORLD);
+
+			/// Create the node of the domain of this process. Throws an
+			/// exception if the number of processes is not the number of domains.
+	virtual void Initialize();
+
+			/// Rank of this process, that is also its domain.
+	int GetRank() const {return rank;}
+			/// Number of processes.
+	int GetNprocesses() const {return nprocesses;}
+
+			/// Number of bodies of all the domains (all processes must call it).
+	virtual int GetNtotalBodies();
+
+protected:
+	virtual bool IsLocalDomain(int mdomain) {return mdomain == rank;}
+
+	virtual void Exchange(std::vector< std::vector< std::vector<ChDomainBodyState> > >& outgoing,
+						  std::vector< std::vector<ChDomainBodyState> >& incoming);
+
+	MPI_Comm comm;
+	int rank;
+	int nprocesses;
+
+	std::vector<ChDomainBodyState> sendbuffer;
+	std::vector<int> sendcounts;
+	std::vector<int> senddispls;
+	std::vector<int> recvcounts;
+	std::vector<int> recvdispls;
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
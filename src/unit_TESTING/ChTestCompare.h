@@ -0,0 +1,149 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+//////////////////////////////////////////////////
+//
+//   ChTestCompare.h
+//
+//   Driver for the tests that run the same model
+//   with a feature and with the reference path it
+//   replaces, and compare the results.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#ifndef CHTESTCOMPARE_H
+#define CHTESTCOMPARE_H
+
+#include <math.h>
+#include <vector>
+
+#include "core/ChLog.h"
+#include "core/ChMathematics.h"
+#include "core/ChVector.h"
+
+namespace chrono
+{
+
+
+///
+/// Results of a run of a test: vectors (ex. positions, speeds, forces)
+/// that must match those of the other run within a tolerance, and
+/// counts (ex. pairs, removed bodies) that must be equal.
+///
+
+class ChTestRun
+{
+public:
+			/// Add a vector, that can differ by 'mtolerance' from the other run.
+	void AddVector(const ChVector<>& mvector, double mtolerance)
+		{
+			vectors.push_back(mvector);
+			tolerances.push_back(mtolerance);
+		}
+
+			/// Add a scalar, that can differ by 'mtolerance' from the other run.
+	void AddScalar(double mvalue, double mtolerance) {AddVector(ChVector<>(mvalue, 0, 0), mtolerance);}
+
+			/// Add a count, that must be equal in the other run.
+	void AddCount(int mcount) {counts.push_back(mcount);}
+
+	void Clear()
+		{
+			vectors.clear();
+			tolerances.clear();
+			counts.clear();
+		}
+
+	std::vector< ChVector<> > vectors;
+	std::vector<double> tolerances;
+	std::vector<int> counts;
+};
+
+
+///
+/// Base class for the tests of a feature that must give the same results
+/// of a reference path (ex. a cell list instead of the collision engine,
+/// four domains instead of one): Simulate() runs the same model with one
+/// path or the other, and Compare() checks that the results match.
+/// The checks specific to each test (ex. that the model did move, that
+/// the feature was really used) are done by the test itself, with data
+/// that Simulate() can keep in the inherited class.
+///
+
+class ChTestCompare
+{
+public:
+	ChTestCompare() : maxdiff(0), maxratio(0) {}
+	virtual ~ChTestCompare() {}
+
+			/// Run the model with the reference path, if 'feature' is false,
+			/// or with the feature under test, and put the results in 'run'.
+	virtual void Simulate(bool feature, ChTestRun& run) = 0;
+
+			/// Run the model with both paths, print the differences and
+			/// return true if the results match. 'mname' is the name of the
+			/// feature, for the messages.
+	bool Compare(const char* mname)
+		{
+			reference.Clear();
+			tested.Clear();
+			Simulate(false, reference);
+			Simulate(true, tested);
+
+			bool match = !reference.vectors.empty() &&
+						 reference.vectors.size() == tested.vectors.size() &&
+						 reference.counts == tested.counts;
+
+			maxdiff = 0;
+			maxratio = 0;
+			for (unsigned int i = 0; match && i < reference.vectors.size(); ++i)
+			{
+				double diff = (reference.vectors[i] - tested.vectors[i]).Length();
+				maxdiff = ChMax(maxdiff, diff);
+				maxratio = ChMax(maxratio, diff / reference.tolerances[i]);
+			}
+			match = match && maxratio <= 1;
+
+			GetLog() << mname << ": " << (int)tested.vectors.size() << " vectors";
+			if (!tested.counts.empty())
+			{
+				GetLog() << ", counts";
+				for (unsigned int i = 0; i < tested.counts.size(); ++i)
+				{
+					GetLog() << " " << tested.counts[i];
+					if (i < reference.counts.size() && reference.counts[i] != tested.counts[i])
+						GetLog() << " (reference " << reference.counts[i] << ")";
+				}
+			}
+			GetLog() << ", max difference " << maxdiff << " (" << maxratio << " of the tolerance)\n";
+
+			if (!match)
+				GetLog() << "Error: " << mname << " does not match the reference path.\n";
+			return match;
+		}
+
+	ChTestRun reference;
+	ChTestRun tested;
+	double maxdiff;		// largest difference of the vectors
+	double maxratio;	// largest difference of the vectors, relative to the tolerance
+};
+
+
+
+} // END_OF_NAMESPACE____
+
+#endif
@@ -0,0 +1,103 @@
+#include "../ChTestConfig.h"
+#include "physics/ChSystem.h"
+#include "physics/ChBody.h"
+#include "collision/ChCCollisionSystemBullet.h"
+#include "collision/ChCModelBullet.h"
+#include <iostream>
+using namespace std;
+using namespace chrono;
+using namespace chrono::collision;
+
+// Measures the time spent per step in the broadphase (AABB update and pair finding),
+// and an estimate of broadphase memory, for the available Bullet broadphases,
+// in sparse and dense scenes, with moving and resting bodies.
+
+const int num_bodies = 4000;
+const int num_steps = 20;
+const double time_step = 0.01;
+const unsigned int max_objects = 16000;
+const double scene_size = 500;
+
+double BroadphaseMemory(ChCollisionSystemBullet* collsys) {
+   btBroadphaseInterface* broadphase = collsys->GetBulletCollisionWorld()->getBroadphase();
+   double mem = broadphase->getOverlappingPairCache()->getOverlappingPairArray().capacity() * sizeof(btBroadphasePair);
+
+   if (collsys->GetBroadphaseType() == ChCollisionSystemBullet::BROADPHASE_DBVT) {
+      btDbvtBroadphase* dbvt = (btDbvtBroadphase*) broadphase;
+      for (int i = 0; i < 2; i++)
+         if (dbvt->m_sets[i].m_leaves)
+            mem += (2 * dbvt->m_sets[i].m_leaves - 1) * sizeof(btDbvtNode);
+      mem += num_bodies * sizeof(btDbvtProxy);
+   } else {
+      // the SAP allocates handles and edges for 'max_objects' up front
+      mem += (max_objects + 1) * sizeof(bt32BitAxisSweep3::Handle);
+      mem += 3 * (2 * max_objects + 2) * sizeof(bt32BitAxisSweep3::Edge);
+   }
+   return mem;
+}
+
+void RunScene(ChCollisionSystemBullet::eCh_broadphase type, const char* type_name, bool sparse, bool moving) {
+   ChCollisionSystemBullet* collsys = new ChCollisionSystemBullet(max_objects, scene_size, type);
+   btCollisionWorld* world = collsys->GetBulletCollisionWorld();
+
+   std::vector<ChSharedBodyPtr> bodies;
+   std::vector<ChVector<> > speeds;
+
+   // sparse: bodies spread in a box much larger than 'scene_size'
+   // dense: bodies in a cubic grid, almost touching
+   int side = (int) ceil(pow((double) num_bodies, 1.0 / 3.0));
+   srand(1);
+   for (int i = 0; i < num_bodies; i++) {
+      ChSharedBodyPtr body(new ChBody());
+      ChVector<> pos;
+      if (sparse)
+         pos = ChVector<>(rand() % 4000 - 2000.0, rand() % 4000 - 2000.0, rand() % 4000 - 2000.0);
+      else
+         pos = ChVector<>((i % side) * 1.05, ((i / side) % side) * 1.05, (i / (side * side)) * 1.05);
+      body->SetPos(pos);
+      body->GetCollisionModel()->ClearModel();
+      body->GetCollisionModel()->AddSphere(0.5);
+      body->GetCollisionModel()->BuildModel();
+      body->GetCollisionModel()->SyncPosition();
+      collsys->Add(body->GetCollisionModel());
+      bodies.push_back(body);
+      speeds.push_back(ChVector<>(rand() % 1000 / 100.0 - 5, rand() % 1000 / 100.0 - 5, rand() % 1000 / 100.0 - 5));
+   }
+
+   ChTimer<double> timer;
+   double time = 0;
+   int pairs = 0;
+   for (int step = 0; step < num_steps; step++) {
+      if (moving) {
+         for (int i = 0; i < num_bodies; i++) {
+            bodies[i]->SetPos(bodies[i]->GetPos() + speeds[i] * time_step);
+            bodies[i]->GetCollisionModel()->SyncPosition();
+         }
+      }
+      timer.start();
+      world->updateAabbs();
+      world->getBroadphase()->calculateOverlappingPairs(world->getDispatcher());
+      timer.stop();
+      time += timer();
+      pairs = world->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+   }
+
+   cout << type_name << (sparse ? " sparse" : " dense ") << (moving ? " moving " : " resting")
+        << "  time/step [ms]: " << 1000 * time / num_steps
+        << "  pairs: " << pairs
+        << "  memory [kB]: " << BroadphaseMemory(collsys) / 1024 << endl;
+
+   for (int i = 0; i < num_bodies; i++)
+      collsys->Remove(bodies[i]->GetCollisionModel());
+   delete collsys;
+}
+
+int main() {
+   for (int sparse = 0; sparse < 2; sparse++) {
+      for (int moving = 0; moving < 2; moving++) {
+         RunScene(ChCollisionSystemBullet::BROADPHASE_SAP, "SAP ", sparse != 0, moving != 0);
+         RunScene(ChCollisionSystemBullet::BROADPHASE_DBVT, "DBVT", sparse != 0, moving != 0);
+      }
+   }
+   return 0;
+}
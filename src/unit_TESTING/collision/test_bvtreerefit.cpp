@@ -0,0 +1,202 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the refit of the AABB and OBB trees
+//   (ChCollisionTree::RefitModel): after the triangles
+//   are moved, the refitted boxes must be those of a
+//   tree built again, when the splits do not change,
+//   and the tree must be rebuilt when the refit would
+//   make it too loose.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include "core/ChLog.h"
+#include "geometry/ChCTriangle.h"
+#include "collision/edgetempest/ChCAABBTree.h"
+#include "collision/edgetempest/ChCOBBTree.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+using namespace chrono::geometry;
+
+
+enum eMotion
+{
+	MOTION_NOISE,		// small random displacements of the vertexes
+	MOTION_SCRAMBLE		// the triangles swap their places
+};
+
+const int ntriangles = 200;
+
+
+// Small triangles at pseudo random places in a unit cube, so that no
+// centroid is at the split planes; they are deleted by the tree.
+
+void add_triangles(ChCollisionTree& mtree, std::vector<ChTriangle*>& mtriangles)
+{
+	mtriangles.clear();
+	for (int i = 0; i < ntriangles; ++i)
+	{
+		ChVector<> center(0.5 + 0.5 * sin(1.3 * i + 0.1), 0.5 + 0.5 * sin(2.7 * i + 0.4), 0.5 + 0.5 * sin(4.1 * i + 0.7));
+		ChTriangle* mtri = new ChTriangle(center + ChVector<>(0.02, 0, 0.003 * sin(1.0 * i)),
+										  center + ChVector<>(0, 0.02, 0.001),
+										  center + ChVector<>(0.005 * cos(1.0 * i), 0, 0.02));
+		mtree.AddGeometry(mtri);
+		mtriangles.push_back(mtri);
+	}
+}
+
+void move_triangles(eMotion mmotion, std::vector<ChTriangle*>& mtriangles)
+{
+	std::vector<ChTriangle> original;
+	for (unsigned int i = 0; i < mtriangles.size(); ++i)
+		original.push_back(*mtriangles[i]);
+
+	for (unsigned int i = 0; i < mtriangles.size(); ++i)
+	{
+		ChTriangle* mtri = mtriangles[i];
+		switch (mmotion)
+		{
+		case MOTION_NOISE:
+			mtri->p1 += 1e-8 * ChVector<>(sin(3.0 * i), cos(5.0 * i), sin(7.0 * i));
+			mtri->p2 += 1e-8 * ChVector<>(cos(3.0 * i), sin(5.0 * i), cos(7.0 * i));
+			mtri->p3 += 1e-8 * ChVector<>(sin(2.0 * i), sin(9.0 * i), cos(4.0 * i));
+			break;
+		case MOTION_SCRAMBLE:
+			{
+				// take the place of another triangle
+				const ChTriangle& mother = original[(i * 37) % mtriangles.size()];
+				ChVector<> shift = mother.p1 - original[i].p1;
+				mtri->p1 += shift;
+				mtri->p2 += shift;
+				mtri->p3 += shift;
+			}
+			break;
+		}
+	}
+}
+
+
+struct BoxList
+{
+	ChTestRun* run;
+	double tolerance;
+};
+
+// Each box as its center and its Rot*diag(d)*Rot', that does not change if
+// the builder flips or swaps the axes of an OBB.
+
+void add_box(ChMatrix33<>& Rot, Vector& Pos, Vector& d, int level, void* userdata)
+{
+	BoxList* mlist = (BoxList*)userdata;
+	mlist->run->AddVector(Pos, mlist->tolerance);
+	for (int i = 0; i < 3; ++i)
+	{
+		ChVector<> mrow;
+		for (int j = 0; j < 3; ++j)
+			mrow(j) = Rot(i, 0) * d.x * Rot(j, 0) + Rot(i, 1) * d.y * Rot(j, 1) + Rot(i, 2) * d.z * Rot(j, 2);
+		mlist->run->AddVector(mrow, mlist->tolerance);
+	}
+}
+
+
+// The tree is built on the triangles at their first places; after they
+// are moved, it is refitted, or else built again.
+
+class TestRefit : public ChTestCompare
+{
+public:
+	TestRefit(bool mobb, eMotion mmotion, double mtolerance, double mthreshold = 1.5)
+		: obb(mobb), motion(mmotion), tolerance(mtolerance), threshold(mthreshold) {}
+
+	virtual void Simulate(bool refit, ChTestRun& run)
+	{
+		CHAABBTree aabbtree;
+		CHOBBTree obbtree;
+		ChCollisionTree& mtree = obb ? (ChCollisionTree&)obbtree : (ChCollisionTree&)aabbtree;
+		mtree.SetRebuildThreshold(threshold);
+
+		std::vector<ChTriangle*> mtriangles;
+		add_triangles(mtree, mtriangles);
+		mtree.BuildModel(0.001);
+		move_triangles(motion, mtriangles);
+
+		if (refit)
+		{
+			mtree.RefitModel(0.001);
+		}
+		else
+		{
+			mtree.build_state = ChCollisionTree::ChC_BUILD_STATE_MODIFIED;
+			mtree.BuildModel(0.001);
+		}
+		cost = mtree.GetTreeCost();
+
+		BoxList mlist = {&run, tolerance};
+		run.AddCount(mtree.TraverseBoundingBoxes(add_box, &mlist));
+	}
+
+	bool obb;
+	eMotion motion;
+	double tolerance;
+	double threshold;
+	double cost;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		bool obb = (i == 1);
+
+		// bottom-up refit after small displacements: the AABBs are those of
+		// the build, the OBBs keep their orientations, while a build turns
+		// them a little, so their tolerance is larger than the displacements
+		TestRefit mtest_refit(obb, MOTION_NOISE, obb ? 1e-6 : 1e-12);
+		if (!mtest_refit.Compare(obb ? "OBB refit" : "AABB refit"))
+			ok = false;
+
+		// the scrambled triangles make the refitted tree too loose, so it must
+		// be rebuilt, as the reference
+		TestRefit mtest_rebuild(obb, MOTION_SCRAMBLE, 1e-12);
+		if (!mtest_rebuild.Compare(obb ? "OBB rebuild" : "AABB rebuild"))
+			ok = false;
+
+		// without the rebuild, the refitted tree would be much worse
+		TestRefit mtest_loose(obb, MOTION_SCRAMBLE, 1e-12, 1e30);
+		ChTestRun mrun;
+		mtest_loose.Simulate(true, mrun);
+		GetLog() << "cost of the scrambled tree " << mtest_loose.cost << ", rebuilt " << mtest_rebuild.cost << "\n";
+		if (mtest_loose.cost < 1.5 * mtest_rebuild.cost)
+		{
+			GetLog() << "Error: the scrambled tree is not loose, the rebuild was not tested.\n";
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
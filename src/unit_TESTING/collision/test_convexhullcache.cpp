@@ -0,0 +1,178 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the cache of convex decompositions
+//   (ChConvexDecomposition::ComputeConvexDecompositionCached):
+//   the hulls loaded from the binary file must be
+//   the computed ones, and the file must be ignored
+//   if the parameters or the version are different.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <vector>
+
+#include "core/ChLog.h"
+#include "core/ChStream.h"
+#include "collision/ChCConvexDecomposition.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+
+const char* cachefile = "test_convexhullcache.chulls";
+
+
+// A L-shaped prism, that is not convex: the 6 vertexes of the
+// section, counterclockwise, extruded along z. The HACD wrapper does
+// not merge the vertexes of the triangles, so it gives many small
+// hulls: enough for the cache, that must store them all.
+
+void add_prism(ChConvexDecompositionHACD& mdecomposition)
+{
+	double sx[6] = {0, 2, 2, 1, 1, 0};
+	double sy[6] = {0, 0, 1, 1, 2, 2};
+	std::vector< ChVector<> > bottom, top;
+	for (int i = 0; i < 6; ++i)
+	{
+		bottom.push_back(ChVector<>(sx[i], sy[i], 0));
+		top.push_back(ChVector<>(sx[i], sy[i], 1));
+	}
+
+	// the section as a fan from the first vertex, that sees all the others
+	for (int i = 1; i < 5; ++i)
+	{
+		mdecomposition.AddTriangle(top[0], top[i], top[i + 1]);
+		mdecomposition.AddTriangle(bottom[0], bottom[i + 1], bottom[i]);
+	}
+	for (int i = 0; i < 6; ++i)
+	{
+		int j = (i + 1) % 6;
+		mdecomposition.AddTriangle(bottom[i], bottom[j], top[j]);
+		mdecomposition.AddTriangle(bottom[i], top[j], top[i]);
+	}
+}
+
+
+// The vertexes of all the hulls, and the number of triangles of each hull
+
+void get_hulls(ChConvexDecomposition& mdecomposition, std::vector< ChVector<> >& mpoints, std::vector<int>& mtriangles)
+{
+	mpoints.clear();
+	mtriangles.clear();
+	for (unsigned int ih = 0; ih < mdecomposition.GetHullCount(); ++ih)
+	{
+		std::vector< ChVector<> > mhull;
+		mdecomposition.GetConvexHullResult(ih, mhull);
+		mpoints.insert(mpoints.end(), mhull.begin(), mhull.end());
+
+		geometry::ChTriangleMeshSoup mtrimesh;
+		mdecomposition.GetConvexHullResult(ih, mtrimesh);
+		mtriangles.push_back(mtrimesh.getNumTriangles());
+	}
+}
+
+
+bool same_hulls(ChConvexDecomposition& ma, ChConvexDecomposition& mb)
+{
+	std::vector< ChVector<> > apoints, bpoints;
+	std::vector<int> atriangles, btriangles;
+	get_hulls(ma, apoints, atriangles);
+	get_hulls(mb, bpoints, btriangles);
+	if (apoints.size() != bpoints.size() || atriangles != btriangles)
+		return false;
+	for (unsigned int i = 0; i < apoints.size(); ++i)
+		if (!apoints[i].Equals(bpoints[i]))
+			return false;
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+	remove(cachefile);
+
+	// Computed, and written to the cache
+	ChConvexDecompositionHACD computed;
+	add_prism(computed);
+	computed.SetParameters(2);
+	int nhulls = computed.ComputeConvexDecompositionCached(cachefile);
+	GetLog() << "computed " << nhulls << " hulls\n";
+	if (nhulls < 2 || computed.IsLoadedFromFile())
+		ok = false;
+
+	// The same decomposition, computed again: the parallel loops must not
+	// change the hulls from a run to another
+	ChConvexDecompositionHACD again;
+	add_prism(again);
+	again.SetParameters(2);
+	again.ComputeConvexDecomposition();
+	if (!same_hulls(computed, again))
+	{
+		GetLog() << "Error: two computations gave different hulls.\n";
+		ok = false;
+	}
+
+	// Same mesh and parameters: loaded from the cache, the same hulls
+	ChConvexDecompositionHACD loaded;
+	add_prism(loaded);
+	loaded.SetParameters(2);
+	loaded.ComputeConvexDecompositionCached(cachefile);
+	GetLog() << "loaded " << (int)loaded.GetHullCount() << " hulls, from the file: " << loaded.IsLoadedFromFile() << "\n";
+	if (!loaded.IsLoadedFromFile() || !same_hulls(computed, loaded))
+	{
+		GetLog() << "Error: the cached hulls are not the computed ones.\n";
+		ok = false;
+	}
+
+	// Other parameters: the cache must be ignored
+	ChConvexDecompositionHACD other;
+	add_prism(other);
+	other.SetParameters(3);
+	other.ComputeConvexDecompositionCached(cachefile);
+	if (other.IsLoadedFromFile())
+	{
+		GetLog() << "Error: the cache was used with other parameters.\n";
+		ok = false;
+	}
+
+	// A file of another version of the format must be rejected
+	{
+		ChStreamOutBinaryFile mstream(cachefile);
+		std::string tag("chulls_binary");
+		mstream << tag;
+		mstream.VersionWrite(2);
+		mstream << computed.GetInputHash();
+		mstream << (unsigned int)0;
+	}
+	ChConvexDecompositionHACD newversion;
+	add_prism(newversion);
+	newversion.SetParameters(2);
+	newversion.ComputeConvexDecompositionCached(cachefile);
+	if (newversion.IsLoadedFromFile() || !same_hulls(computed, newversion))
+	{
+		GetLog() << "Error: a file of another version was used.\n";
+		ok = false;
+	}
+
+	remove(cachefile);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the periodic domains: grains in a box
+//   that is periodic along x must move as the grains
+//   of the middle copy of a non periodic system that
+//   has three copies of them, side by side along x.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace collision;
+
+
+const double box_length = 0.5;		// of the periodic box, along x
+const double prad = 0.02;
+
+
+// Grains that collide across the periodic faces, grains that cross them,
+// and grains that collide inside the box. Returns the positions of the
+// grains of the middle copy, moved into the box.
+
+void simulate(int ncopies, bool periodic, ChTestRun& run)
+{
+	ChSystemDEM msystem;
+	msystem.Set_G_acc(ChVector<>(0, -9.81, 0));
+
+	ChPeriodicDomain mdomain;
+	mdomain.Set(ChVector<>(-0.5 * box_length, -1, -1), ChVector<>(0.5 * box_length, 1, 1), true, false, false);
+	if (periodic)
+		msystem.SetPeriodicDomain(mdomain);
+
+	ChSharedPtr<ChMaterialSurfaceDEM> mat(new ChMaterialSurfaceDEM);
+	mat->SetYoungModulus(1e7);
+	mat->SetFriction(0.2);
+	mat->SetRestitution(0.5);
+
+	// the floor is larger than half the box, so it is not periodic
+	ChSharedPtr<ChBodyDEM> floor(new ChBodyDEM);
+	floor->SetBodyFixed(true);
+	floor->SetMaterialSurfaceDEM(mat);
+	floor->GetCollisionModel()->ClearModel();
+	floor->GetCollisionModel()->AddBox(1.0, 0.1, 0.5, ChVector<>(0, -0.1, 0));
+	floor->GetCollisionModel()->BuildModel();
+	floor->SetCollide(true);
+	msystem.AddBody(floor);
+
+	double mx[]  = { 0.22, -0.22,  0.10, -0.10,  0.10, -0.05};
+	double mz[]  = { 0.00,  0.005, 0.10,  0.10, -0.10, -0.10};
+	double mvx[] = { 0.50, -0.30,  0.80,  0.00, -0.40,  0.20};
+	int ngrains = 6;
+
+	double mass = 2500 * (4.0/3.0) * CH_C_PI * pow(prad, 3);
+	std::vector< ChSharedPtr<ChBody> > middle;
+	for (int copy = 0; copy < ncopies; ++copy)
+	{
+		double shift = (copy - ncopies / 2) * box_length;
+		for (int i = 0; i < ngrains; ++i)
+		{
+			ChSharedPtr<ChBodyDEM> mgrain(new ChBodyDEM);
+			mgrain->SetMass(mass);
+			mgrain->SetInertiaXX(0.4 * mass * prad * prad * ChVector<>(1, 1, 1));
+			mgrain->SetPos(ChVector<>(mx[i] + shift, prad + 0.001, mz[i]));
+			mgrain->SetPos_dt(ChVector<>(mvx[i], 0, 0));
+			mgrain->SetMaterialSurfaceDEM(mat);
+			mgrain->GetCollisionModel()->ClearModel();
+			mgrain->GetCollisionModel()->AddSphere(prad);
+			mgrain->GetCollisionModel()->BuildModel();
+			mgrain->SetCollide(true);
+			msystem.AddBody(mgrain);
+			if (shift == 0)
+				middle.push_back(mgrain);
+		}
+	}
+
+	for (int step = 0; step < 5000; ++step)
+		msystem.DoStepDynamics(1e-4);
+
+	// the contacts across the faces are computed by Bullet in single
+	// precision at the other face, so the contact forces differ by roundoff:
+	// allow for it, but not for an error of 0.1 mm in the shift of the images
+	for (unsigned int i = 0; i < middle.size(); ++i)
+	{
+		ChVector<> mp = middle[i]->GetPos();
+		mdomain.Wrap(mp);
+		run.AddVector(mp, 2e-4);
+	}
+}
+
+
+// The reference are three copies side by side of the grains, in a non
+// periodic system.
+
+class TestPeriodicDomain : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool periodic, ChTestRun& run)
+	{
+		if (periodic)
+			simulate(1, true, run);
+		else
+			simulate(3, false, run);
+	}
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestPeriodicDomain mtest;
+	if (!mtest.Compare("periodic domain"))
+		return 1;
+
+	// the periodic faces must make a difference
+	ChTestRun single;
+	simulate(1, false, single);
+	double maxdiff_single = 0;
+	for (unsigned int i = 0; i < single.vectors.size(); ++i)
+		maxdiff_single = ChMax(maxdiff_single, (mtest.tested.vectors[i] - single.vectors[i]).Length());
+	GetLog() << "max difference from the non periodic box " << maxdiff_single << "\n";
+	if (maxdiff_single < 0.01)
+	{
+		GetLog() << "Error: the periodic faces had no effect.\n";
+		return 1;
+	}
+	return 0;
+}
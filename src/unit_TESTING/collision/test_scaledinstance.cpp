@@ -0,0 +1,144 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the scaled instances of shared shapes
+//   (ChModelBullet::AddShapeInstance): a scaled
+//   sphere resting on a box must report the same
+//   contact distance as a plain sphere.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChContactContainerBase.h"
+#include "collision/ChCModelBullet.h"
+#include "collision/bullet/btBulletCollisionCommon.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+
+// Stores the smallest contact distance
+
+class MyReportContacts : public ChReportContactCallback
+{
+public:
+	MyReportContacts() : ncontacts(0), mindist(1e30) {}
+
+	virtual bool ReportContactCallback (const ChVector<>& pA, const ChVector<>& pB,
+										const ChMatrix33<>& plane_coord, const double& distance,
+										const float& mfriction, const ChVector<>& react_forces,
+										const ChVector<>& react_torques,
+										ChCollisionModel* modA, ChCollisionModel* modB)
+	{
+		++ncontacts;
+		if (distance < mindist)
+		{
+			mindist = distance;
+			pointA = pA;
+			pointB = pB;
+		}
+		return true;
+	}
+
+	int ncontacts;
+	double mindist;
+	ChVector<> pointA;
+	ChVector<> pointB;
+};
+
+
+// Drop a sphere of radius 'radius' built as an instance of a sphere of
+// radius 0.5 scaled by 'scale', with its bottom at 'gap' over the top
+// of a box; returns false if the reported distance is not 'gap'.
+
+bool test_sphere(double scale, double gap, double envelope)
+{
+	double radius = 0.5 * scale;
+
+	ChSystem mysystem;
+
+	ChSharedPtr<ChBody> ground(new ChBody);
+	ground->SetBodyFixed(true);
+	ground->GetCollisionModel()->ClearModel();
+	ground->GetCollisionModel()->SetEnvelope(envelope);
+	ground->GetCollisionModel()->AddBox(2, 0.5, 2, ChVector<>(0, -0.5, 0));
+	ground->GetCollisionModel()->BuildModel();
+	ground->SetCollide(true);
+	mysystem.AddBody(ground);
+
+	// The shared shape, as a library would store it: radius and
+	// margin include the envelope.
+	btSphereShape* msphere = new btSphereShape((btScalar)(0.5 + envelope));
+	msphere->setMargin((btScalar)(0.5 + envelope));
+	smartptrshapes mshared(msphere);
+
+	ChSharedPtr<ChBody> ball(new ChBody);
+	ball->SetPos(ChVector<>(0, radius + gap, 0));
+	ball->GetCollisionModel()->ClearModel();
+	ball->GetCollisionModel()->SetEnvelope(envelope);
+	((ChModelBullet*)ball->GetCollisionModel())->AddShapeInstance(mshared, ChVector<>(), ChMatrix33<>(1), scale);
+	ball->GetCollisionModel()->BuildModel();
+	ball->SetCollide(true);
+	mysystem.AddBody(ball);
+
+	mysystem.Setup();
+	mysystem.Update();
+	mysystem.ComputeCollisions();
+
+	MyReportContacts mreporter;
+	mysystem.GetContactContainer()->ReportAllContacts(&mreporter);
+
+	GetLog() << "scale " << scale << "  gap " << gap << "  contacts " << mreporter.ncontacts 
+			 << "  distance " << mreporter.mindist << "\n";
+
+	if (mreporter.ncontacts == 0)
+		return false;
+	if (fabs(mreporter.mindist - gap) > 1e-4)
+		return false;
+	// the points must be on the surfaces of the sphere and of the box
+	if (fabs((mreporter.pointA - ball->GetPos()).Length() - radius) > 1e-4 &&
+		fabs((mreporter.pointB - ball->GetPos()).Length() - radius) > 1e-4)
+		return false;
+	if (fabs(mreporter.pointA.y) > 1e-4 && fabs(mreporter.pointB.y) > 1e-4)
+		return false;
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	ok &= test_sphere(1.0, 0.0,  0.03);
+	ok &= test_sphere(2.0, 0.0,  0.03);
+	ok &= test_sphere(4.0, 0.01, 0.03);
+	ok &= test_sphere(0.5, 0.0,  0.03);
+	ok &= test_sphere(0.2, 0.01, 0.03);
+
+	if (!ok)
+	{
+		GetLog() << "Error: wrong contact distance with scaled shapes.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,134 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the Verlet lists of the Bullet collision
+//   system: DEM grains bouncing in a box must have
+//   the contacts and the motion they have with the
+//   usual broadphase at each step, while the pairs
+//   are rebuilt only at some steps.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "collision/ChCCollisionSystemBullet.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace collision;
+
+
+// DEM grains bouncing in a box. The contacts found at each step are
+// counted too, because the Verlet lists must give all the contacts of
+// the broadphase, also at the steps where the lists are not rebuilt.
+
+class TestVerletLists : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool verlet, ChTestRun& run)
+	{
+		ChSystemDEM msystem;
+		msystem.Set_G_acc(ChVector<>(0, -9.81, 0));
+		ChCollisionSystemBullet* mcollisions = (ChCollisionSystemBullet*)msystem.GetCollisionSystem();
+		if (verlet)
+			mcollisions->SetVerletLists(true, 0.01);
+
+		ChSharedPtr<ChMaterialSurfaceDEM> mat(new ChMaterialSurfaceDEM);
+		mat->SetYoungModulus(1e7);
+		mat->SetFriction(0.4);
+		mat->SetRestitution(0.5);
+
+		// the box
+		double box_dim = 0.3;
+		double thick = 0.1;
+		ChSharedPtr<ChBodyDEM> container(new ChBodyDEM);
+		container->SetBodyFixed(true);
+		container->SetMaterialSurfaceDEM(mat);
+		container->GetCollisionModel()->ClearModel();
+		container->GetCollisionModel()->AddBox(box_dim, thick, box_dim, ChVector<>(0, -thick, 0));
+		container->GetCollisionModel()->AddBox(thick, box_dim, box_dim, ChVector<>(-box_dim-thick, box_dim, 0));
+		container->GetCollisionModel()->AddBox(thick, box_dim, box_dim, ChVector<>( box_dim+thick, box_dim, 0));
+		container->GetCollisionModel()->AddBox(box_dim, box_dim, thick, ChVector<>(0, box_dim, -box_dim-thick));
+		container->GetCollisionModel()->AddBox(box_dim, box_dim, thick, ChVector<>(0, box_dim,  box_dim+thick));
+		container->GetCollisionModel()->BuildModel();
+		container->SetCollide(true);
+		msystem.AddBody(container);
+
+		// a sparse gas of grains, with speeds in all directions
+		std::vector< ChSharedPtr<ChBodyDEM> > grains;
+		double prad = 0.03;
+		ChSetRandomSeed(123);
+		for (int ix = 0; ix < 4; ++ix)
+			for (int iy = 0; iy < 3; ++iy)
+				for (int iz = 0; iz < 4; ++iz)
+				{
+					double mass = 2500 * (4.0/3.0) * CH_C_PI * pow(prad, 3);
+					ChSharedPtr<ChBodyDEM> mgrain(new ChBodyDEM);
+					mgrain->SetMass(mass);
+					mgrain->SetInertiaXX(0.4 * mass * prad * prad * ChVector<>(1, 1, 1));
+					mgrain->SetPos(ChVector<>(-0.2 + ix * 0.13, 0.1 + iy * 0.13, -0.2 + iz * 0.13));
+					mgrain->SetPos_dt(ChVector<>(ChRandom() - 0.5, ChRandom() - 0.5, ChRandom() - 0.5));
+					mgrain->SetMaterialSurfaceDEM(mat);
+					mgrain->GetCollisionModel()->ClearModel();
+					mgrain->GetCollisionModel()->AddSphere(prad);
+					mgrain->GetCollisionModel()->BuildModel();
+					mgrain->SetCollide(true);
+					msystem.AddBody(mgrain);
+					grains.push_back(mgrain);
+				}
+
+		int ncontacts = 0;
+		for (int step = 0; step < 2000; ++step)
+		{
+			msystem.DoStepDynamics(1e-4);
+			ncontacts += msystem.GetNcontacts();
+		}
+
+		for (unsigned int i = 0; i < grains.size(); ++i)
+		{
+			run.AddVector(grains[i]->GetPos(), 1e-6);
+			run.AddVector(grains[i]->GetPos_dt(), 1e-4);
+		}
+		run.AddCount(ncontacts);
+		nrebuilds = mcollisions->GetNverletRebuilds();
+	}
+
+	int nrebuilds;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestVerletLists mtest;
+	if (!mtest.Compare("Verlet lists"))
+		return 1;
+
+	// the lists must be kept for some steps
+	GetLog() << "rebuilds " << mtest.nrebuilds << " in 2000 steps\n";
+	if (mtest.nrebuilds < 1 || mtest.nrebuilds > 1000)
+	{
+		GetLog() << "Error: the Verlet lists are not kept for some steps.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,172 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChSystem::AddBodies(): grains added in
+//   a batch to a system that already has grains must
+//   have the same broadphase proxies and pairs, and
+//   move as grains added one by one with AddBody().
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "collision/ChCCollisionSystemBullet.h"
+#include "collision/bullet/btBulletCollisionCommon.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace collision;
+
+
+// A layer of grains, above the floor at height 'y', shifted by 'shift'
+// along x and z
+
+void create_layer(ChSharedPtr<ChMaterialSurfaceDEM>& mat, double y, double shift, std::vector< ChSharedPtr<ChBody> >& mbodies)
+{
+	double prad = 0.02;
+	double mass = 2500 * (4.0/3.0) * CH_C_PI * pow(prad, 3);
+	mbodies.clear();
+	for (int ix = 0; ix < 6; ++ix)
+		for (int iz = 0; iz < 6; ++iz)
+		{
+			ChSharedPtr<ChBodyDEM> mgrain(new ChBodyDEM);
+			mgrain->SetMass(mass);
+			mgrain->SetInertiaXX(0.4 * mass * prad * prad * ChVector<>(1, 1, 1));
+			mgrain->SetPos(ChVector<>(-0.2 + shift + ix * 0.05 + 0.004 * (iz % 3), y, -0.2 + shift + iz * 0.05 + 0.003 * (ix % 2)));
+			mgrain->SetMaterialSurfaceDEM(mat);
+			mgrain->GetCollisionModel()->ClearModel();
+			mgrain->GetCollisionModel()->AddSphere(prad);
+			mgrain->GetCollisionModel()->BuildModel();
+			mgrain->SetCollide(true);
+			mbodies.push_back(mgrain);
+		}
+}
+
+
+// The second layer of grains is added one by one (the reference) or in
+// a batch. The batch creates the proxies of the SAP broadphase by itself,
+// so their bounding boxes are checked right after the insertion. The
+// number of broadphase pairs is summed over all the steps, and the final
+// positions are compared.
+
+class TestAddBodies : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool batch, ChTestRun& run)
+	{
+		ChSystemDEM msystem;
+		msystem.Set_G_acc(ChVector<>(0, -9.81, 0));
+
+		ChSharedPtr<ChMaterialSurfaceDEM> mat(new ChMaterialSurfaceDEM);
+		mat->SetYoungModulus(1e7);
+		mat->SetFriction(0.4);
+		mat->SetRestitution(0.2);
+
+		ChSharedPtr<ChBodyDEM> floor(new ChBodyDEM);
+		floor->SetBodyFixed(true);
+		floor->SetMaterialSurfaceDEM(mat);
+		floor->GetCollisionModel()->ClearModel();
+		floor->GetCollisionModel()->AddBox(0.5, 0.1, 0.5, ChVector<>(0, -0.1, 0));
+		floor->GetCollisionModel()->BuildModel();
+		floor->SetCollide(true);
+		msystem.AddBody(floor);
+
+		// the first layer is always added one by one, and falls on the floor
+		std::vector< ChSharedPtr<ChBody> > first, second;
+		create_layer(mat, 0.021, 0, first);
+		for (unsigned int i = 0; i < first.size(); ++i)
+			msystem.AddBody(first[i]);
+		for (int step = 0; step < 500; ++step)
+			msystem.DoStepDynamics(1e-4);
+
+		// the second layer falls in the hollows of the first one
+		create_layer(mat, 0.062, 0.025, second);
+		if (batch)
+			msystem.AddBodies(second);
+		else
+			for (unsigned int i = 0; i < second.size(); ++i)
+				msystem.AddBody(second[i]);
+
+		// the proxies created by the batch must have the bounding boxes of
+		// the models (the proxies added one by one get them at the next step)
+		ChCollisionSystemBullet* mcollisions = (ChCollisionSystemBullet*)msystem.GetCollisionSystem();
+		btBroadphaseInterface* mbroadphase = mcollisions->GetBulletCollisionWorld()->getBroadphase();
+		if (batch)
+		{
+			maxaabberror = 0;
+			for (unsigned int i = 0; i < second.size(); ++i)
+			{
+				btCollisionObject* mobject = ((ChModelBullet*)second[i]->GetCollisionModel())->GetBulletModel();
+				btVector3 aabbMin, aabbMax, proxyMin, proxyMax;
+				mobject->getCollisionShape()->getAabb(mobject->getWorldTransform(), aabbMin, aabbMax);
+				mbroadphase->getAabb(mobject->getBroadphaseHandle(), proxyMin, proxyMax);
+				maxaabberror = ChMax(maxaabberror, (double)(proxyMin - aabbMin).length());
+				maxaabberror = ChMax(maxaabberror, (double)(proxyMax - aabbMax).length());
+			}
+		}
+
+		int npairs = 0;
+		for (int step = 0; step < 1000; ++step)
+		{
+			msystem.DoStepDynamics(1e-4);
+			npairs += mbroadphase->getOverlappingPairCache()->getNumOverlappingPairs();
+		}
+		run.AddCount(npairs);
+
+		maxheight = 0;
+		for (unsigned int i = 0; i < first.size(); ++i)
+			run.AddVector(first[i]->GetPos(), 1e-9);
+		for (unsigned int i = 0; i < second.size(); ++i)
+		{
+			run.AddVector(second[i]->GetPos(), 1e-9);
+			maxheight = ChMax(maxheight, second[i]->GetPos().y);
+		}
+	}
+
+	double maxheight;
+	double maxaabberror;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestAddBodies mtest;
+	if (!mtest.Compare("batched insertion"))
+		return 1;
+
+	GetLog() << "bounding box error of the new proxies " << mtest.maxaabberror << "\n";
+	if (mtest.maxaabberror > 0)
+	{
+		GetLog() << "Error: the proxies created in a batch do not have the bounding boxes of the models.\n";
+		return 1;
+	}
+
+	// the second layer must have fallen in the hollows
+	GetLog() << "max height " << mtest.maxheight << "\n";
+	if (mtest.maxheight > 0.055)
+	{
+		GetLog() << "Error: the second layer did not fall on the first one.\n";
+		return 1;
+	}
+	return 0;
+}
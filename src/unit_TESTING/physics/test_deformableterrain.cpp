@@ -0,0 +1,133 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChDeformableTerrain: a box resting on
+//   the soil must be carried by it, and a sliding
+//   box must not be affected by the footprint of
+//   another body that does not touch the soil.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChDeformableTerrain.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+ChSharedPtr<ChBody> create_box(ChSystem& msystem, const ChVector<>& size, const ChVector<>& pos, double mass)
+{
+	ChSharedPtr<ChBody> mbody(new ChBody);
+	mbody->SetPos(pos);
+	mbody->SetMass(mass);
+	mbody->SetInertiaXX(ChVector<>(size.y*size.y + size.z*size.z,
+								   size.x*size.x + size.z*size.z,
+								   size.x*size.x + size.y*size.y) * (mass / 3.0));
+	mbody->GetCollisionModel()->ClearModel();
+	mbody->GetCollisionModel()->AddBox(size.x, size.y, size.z);
+	mbody->GetCollisionModel()->BuildModel();
+	mbody->SetCollide(false);	// only the soil acts on it
+	msystem.AddBody(mbody);
+	return mbody;
+}
+
+
+// A box of 40 kg on the soil, with an initial horizontal speed; if 
+// 'hovering', a large fixed body hangs over it, with a footprint that 
+// covers the box but without touching the soil.
+
+void simulate(bool hovering, double speed, double mtime, ChVector<>& pos, ChVector<>& soilforce, double& sinkage)
+{
+	ChSystem msystem;
+
+	ChSharedPtr<ChDeformableTerrain> terrain(new ChDeformableTerrain);
+	terrain->Initialize(0, 0.02);
+	msystem.Add(terrain);
+
+	ChSharedPtr<ChBody> box = create_box(msystem, ChVector<>(0.2, 0.1, 0.2), ChVector<>(0, 0.1, 0), 40);
+	box->SetPos_dt(ChVector<>(speed, 0, 0));
+	terrain->AddBody(box);
+
+	if (hovering)
+	{
+		ChSharedPtr<ChBody> roof = create_box(msystem, ChVector<>(0.5, 0.1, 0.5), ChVector<>(0, 1, 0), 100);
+		roof->SetBodyFixed(true);
+		terrain->AddBody(roof);
+	}
+
+	double dt = 1e-3;
+	while (msystem.GetChTime() < mtime - dt * 0.5)
+		msystem.DoStepDynamics(dt);
+
+	pos = box->GetPos();
+	soilforce = terrain->GetBodyForce(0);
+	sinkage = terrain->GetSinkage(0, 0);
+}
+
+
+// Sliding, with or without a body that does not touch the soil: same
+// motion and same soil force.
+
+class TestHovering : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool hovering, ChTestRun& run)
+	{
+		ChVector<> force;
+		double sinkage;
+		simulate(hovering, 1.0, 0.2, pos, force, sinkage);
+		run.AddVector(pos, 1e-9);
+		run.AddVector(force, 1e-6);
+		run.AddScalar(sinkage, 1e-9);
+	}
+
+	ChVector<> pos;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+	ChVector<> pos, force;
+	double sinkage;
+
+	// At rest, the soil carries the weight, and is compacted
+	simulate(false, 0, 0.5, pos, force, sinkage);
+	GetLog() << "rest: soil force " << force.y << " N (weight " << 40 * 9.81 << " N), sinkage " << sinkage << "\n";
+	if (fabs(force.y - 40 * 9.81) > 0.02 * 40 * 9.81 || sinkage <= 0)
+		ok = false;
+
+	TestHovering mtest;
+	if (!mtest.Compare("body over the sliding box"))
+		ok = false;
+	GetLog() << "sliding: x " << mtest.pos.x << "\n";
+	if (mtest.pos.x <= 0)
+		ok = false;
+
+	if (!ok)
+	{
+		GetLog() << "Error: wrong results of the deformable terrain.\n";
+		return 1;
+	}
+	return 0;
+}
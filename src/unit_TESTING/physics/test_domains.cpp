@@ -0,0 +1,158 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the domain decomposition of DEM systems:
+//   grains that cross the borders of four domains
+//   must move as in a single domain.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+#include <map>
+
+#include "core/ChLog.h"
+#include "physics/ChDomainManagerDEM.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+// Grains on a floor, split in nx*nz domains; returns the final states
+// of the grains, by identifier, and how many changed domain.
+
+void simulate(int nx, int nz, std::map<int, ChDomainBodyState>& mstates, int& nmigrated)
+{
+	double box_dim = 0.4;
+	double prad = 0.04;
+
+	ChDomainManagerThreadsDEM manager;
+	manager.SetGrid(ChVector<>(-box_dim, 0, -box_dim), ChVector<>(box_dim, box_dim, box_dim), nx, 1, nz);
+	manager.SetGhostWidth(2 * prad + 0.01);
+	manager.Initialize();
+
+	ChMaterialSurfaceDEM mat;
+	mat.SetYoungModulus(1e7);
+	mat.SetFriction(0.4);
+	mat.SetRestitution(0.2);
+
+	// the floor, in each domain, with its own material
+	for (int i = 0; i < manager.GetNlocalNodes(); ++i)
+	{
+		ChSystemDEM* system = manager.GetLocalNode(i)->GetSystem();
+		system->Set_G_acc(ChVector<>(0, -9.81, 0));
+		ChSharedPtr<ChBodyDEM> floor(new ChBodyDEM);
+		floor->SetIdentifier(-1);
+		floor->SetBodyFixed(true);
+		floor->SetMaterialSurfaceDEM(ChSharedPtr<ChMaterialSurfaceDEM>(new ChMaterialSurfaceDEM(mat)));
+		floor->GetCollisionModel()->ClearModel();
+		floor->GetCollisionModel()->AddBox(box_dim, 0.1, box_dim, ChVector<>(0, -0.1, 0));
+		floor->GetCollisionModel()->BuildModel();
+		floor->SetCollide(true);
+		system->AddBody(floor);
+	}
+
+	// Grains rolling across the borders of the domains, and pairs of grains
+	// that collide across a border or after a migration (few contacts, so
+	// that the roundoff of the collision detection is not amplified)
+	double grains[6][5] = {
+		// x,    z,     vx,    vz,  radius
+		{-0.20, -0.10,  1.0,   0.0,  1.00},
+		{ 0.10,  0.20,  0.0,  -1.0,  0.90},
+		{-0.10,  0.15,  0.5,   0.0,  0.95},
+		{ 0.10,  0.13, -0.5,   0.0,  1.00},
+		{-0.20, -0.30,  1.0,   0.0,  0.90},
+		{ 0.05, -0.30,  0.0,   0.0,  1.00}};
+
+	std::map<int, ChVector<> > startpos;
+	for (int i = 0; i < 6; ++i)
+	{
+		ChDomainBodyState state;
+		state.SetSphere(prad * grains[i][4], 2500);
+		state.SetMaterial(mat);
+		state.pos = ChVector<>(grains[i][0], prad * grains[i][4], grains[i][1]);
+		state.pos_dt = ChVector<>(grains[i][2], 0, grains[i][3]);
+		manager.AddBody(state);
+		startpos[state.id] = state.pos;
+	}
+
+	for (int step = 0; step < 3000; ++step)
+		manager.DoStepDynamics(1e-4);
+
+	mstates.clear();
+	nmigrated = 0;
+	for (int i = 0; i < manager.GetNlocalNodes(); ++i)
+	{
+		std::vector<ChDomainBodyState> mowned;
+		manager.GetLocalNode(i)->GetOwnedStates(mowned);
+		for (unsigned int j = 0; j < mowned.size(); ++j)
+		{
+			mstates[mowned[j].id] = mowned[j];
+			if (manager.GetGrid().GetDomain(startpos[mowned[j].id]) != manager.GetLocalNode(i)->GetIndex())
+				++nmigrated;
+		}
+	}
+}
+
+
+// The reference is the single domain. The identifiers of the grains are
+// compared as counts, so that the states are compared grain by grain.
+
+class TestDomains : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool decomposed, ChTestRun& run)
+	{
+		std::map<int, ChDomainBodyState> mstates;
+		if (decomposed)
+			simulate(2, 2, mstates, nmigrated);
+		else
+			simulate(1, 1, mstates, nmigrated);
+
+		// the collision detection is in single precision, and the contacts
+		// are found in a different order: allow for its roundoff
+		for (std::map<int, ChDomainBodyState>::iterator it = mstates.begin(); it != mstates.end(); ++it)
+		{
+			run.AddCount(it->first);
+			run.AddVector(it->second.pos, 1e-5);
+			run.AddVector(it->second.pos_dt, 1e-3);
+		}
+		ngrains = (int)mstates.size();
+	}
+
+	int ngrains;
+	int nmigrated;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestDomains mtest;
+	if (!mtest.Compare("four domains"))
+		return 1;
+
+	// no grain must be lost, and some must have changed domain
+	GetLog() << "grains " << mtest.ngrains << ", migrated " << mtest.nmigrated << "\n";
+	if (mtest.ngrains != 6 || mtest.nmigrated == 0)
+	{
+		GetLog() << "Error: the grains did not migrate between the domains.\n";
+		return 1;
+	}
+	return 0;
+}
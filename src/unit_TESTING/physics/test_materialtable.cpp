@@ -0,0 +1,201 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the table of materials of the contact
+//   containers (ChMaterialPairTable): piles of grains
+//   with the DEM and the DVI contacts must move as
+//   with the composite properties computed at each
+//   contact (SetMaxMaterials(0)), also after a change
+//   of a material during the run, and the materials
+//   of removed bodies must be dropped from the table.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "physics/ChContactContainer.h"
+#include "physics/ChContactContainerDEM.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+// Grains in 3 layers: the first two layers share 3 materials, each grain
+// of the top layer has its own material. At one third of the run the
+// friction of a shared material changes, at two thirds the grains of the
+// top layer are removed.
+
+class TestMaterialTable : public ChTestCompare
+{
+public:
+	TestMaterialTable(bool mdem) : dem(mdem) {}
+
+	virtual void Simulate(bool table, ChTestRun& run)
+	{
+		ChSystem* msystem = dem ? new ChSystemDEM : new ChSystem;
+		msystem->Set_G_acc(ChVector<>(0, -9.81, 0));
+
+		std::vector< ChSharedPtr<ChMaterialSurface> > mats;
+		std::vector< ChSharedPtr<ChMaterialSurfaceDEM> > matsDEM;
+		for (int i = 0; i < 4; ++i)
+		{
+			mats.push_back(ChSharedPtr<ChMaterialSurface>(new ChMaterialSurface));
+			mats[i]->SetFriction(0.2f + 0.1f * i);
+			mats[i]->SetRestitution(0.1f * i);
+			matsDEM.push_back(ChSharedPtr<ChMaterialSurfaceDEM>(new ChMaterialSurfaceDEM));
+			matsDEM[i]->SetYoungModulus(1e7f * (1 + i));
+			matsDEM[i]->SetFriction(0.2f + 0.1f * i);
+			matsDEM[i]->SetRestitution(0.1f + 0.1f * i);
+		}
+
+		// the last material is the one of the floor
+		double prad = 0.02;
+		std::vector< ChSharedPtr<ChBody> > grains, top;
+		for (int ib = 0; ib < 1 + 3 * 16; ++ib)
+		{
+			int layer = (ib - 1) / 16;
+			ChSharedPtr<ChBody> mbody;
+			if (dem)
+			{
+				ChSharedPtr<ChBodyDEM> mbodyDEM(new ChBodyDEM);
+				if (ib == 0)
+					mbodyDEM->SetMaterialSurfaceDEM(matsDEM[3]);
+				else if (layer < 2)
+					mbodyDEM->SetMaterialSurfaceDEM(matsDEM[ib % 3]);
+				else
+				{
+					ChSharedPtr<ChMaterialSurfaceDEM> mown(new ChMaterialSurfaceDEM);
+					mown->SetFriction(0.5f);
+					mbodyDEM->SetMaterialSurfaceDEM(mown);
+				}
+				mbody = mbodyDEM;
+			}
+			else
+			{
+				mbody = ChSharedPtr<ChBody>(new ChBody);
+				if (ib == 0)
+					mbody->SetMaterialSurface(mats[3]);
+				else if (layer < 2)
+					mbody->SetMaterialSurface(mats[ib % 3]);
+				else
+					mbody->GetMaterialSurface()->SetFriction(0.5f);	// the own material of the body
+			}
+
+			mbody->GetCollisionModel()->ClearModel();
+			if (ib == 0)
+			{
+				mbody->SetBodyFixed(true);
+				mbody->GetCollisionModel()->AddBox(0.5, 0.1, 0.5, ChVector<>(0, -0.1, 0));
+			}
+			else
+			{
+				int ix = (ib - 1) % 4, iz = ((ib - 1) / 4) % 4;
+				double mass = 2500 * (4.0/3.0) * CH_C_PI * pow(prad, 3);
+				mbody->SetMass(mass);
+				mbody->SetInertiaXX(0.4 * mass * prad * prad * ChVector<>(1, 1, 1));
+				mbody->SetPos(ChVector<>(-0.06 + ix * 0.041 + 0.004 * (iz % 3), prad + layer * 0.041, -0.06 + iz * 0.041 + 0.003 * (ix % 2)));
+				mbody->SetPos_dt(ChVector<>(0.3 * sin(1.0 * ib), 0, 0.3 * cos(1.0 * ib)));
+				mbody->GetCollisionModel()->AddSphere(prad);
+			}
+			mbody->GetCollisionModel()->BuildModel();
+			mbody->SetCollide(true);
+			msystem->AddBody(mbody);
+			if (ib > 0 && layer < 2)
+				grains.push_back(mbody);
+			else if (ib > 0)
+				top.push_back(mbody);
+		}
+
+		if (dem)
+			((ChContactContainerDEM*)msystem->GetContactContainer())->GetMaterialTable().SetMaxMaterials(table ? 128 : 0);
+		else
+			((ChContactContainer*)msystem->GetContactContainer())->GetMaterialTable().SetMaxMaterials(table ? 128 : 0);
+
+		int nsteps = dem ? 3000 : 150;
+		double step = dem ? 1e-4 : 2e-3;
+		for (int istep = 0; istep < nsteps; ++istep)
+		{
+			if (istep == nsteps / 3)
+			{
+				mats[1]->SetFriction(0.05f);
+				matsDEM[1]->SetFriction(0.05f);
+				matsDEM[1]->SetYoungModulus(5e6f);
+			}
+			if (istep == 2 * nsteps / 3)
+			{
+				nmaterials_before = GetNmaterials(msystem);
+				for (unsigned int i = 0; i < top.size(); ++i)
+					msystem->RemoveBody(top[i]);
+				top.clear();
+			}
+			msystem->DoStepDynamics(step);
+		}
+		nmaterials_after = GetNmaterials(msystem);
+
+		for (unsigned int i = 0; i < grains.size(); ++i)
+		{
+			run.AddVector(grains[i]->GetPos(), 1e-9);
+			run.AddVector(grains[i]->GetPos_dt(), 1e-9);
+		}
+		run.AddCount(msystem->GetNcontacts());
+
+		grains.clear();
+		delete msystem;
+	}
+
+	int GetNmaterials(ChSystem* msystem)
+	{
+		if (dem)
+			return ((ChContactContainerDEM*)msystem->GetContactContainer())->GetMaterialTable().GetNmaterials();
+		return ((ChContactContainer*)msystem->GetContactContainer())->GetMaterialTable().GetNmaterials();
+	}
+
+	bool dem;
+	int nmaterials_before;
+	int nmaterials_after;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		TestMaterialTable mtest(i == 0);
+		if (!mtest.Compare(i == 0 ? "DEM material table" : "DVI material table"))
+			ok = false;
+
+		// the 3 shared materials, the floor and the 16 own materials of the
+		// top layer; only the 4 materials still in use after the removal
+		GetLog() << "materials " << mtest.nmaterials_before << ", after the removal " << mtest.nmaterials_after << "\n";
+		if (mtest.nmaterials_before != 20 || mtest.nmaterials_after != 4)
+		{
+			GetLog() << "Error: the table did not register or drop the materials.\n";
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
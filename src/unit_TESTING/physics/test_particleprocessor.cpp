@@ -0,0 +1,194 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the particle processors with a shared
+//   ChParticleSpatialIndex and a deferred remover,
+//   that removes the particles with a single call
+//   to ChSystem::RemoveBodies(): they must count and
+//   remove the same particles as processors that test
+//   all the particles and remove them one by one with
+//   ChSystem::RemoveBody().
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystemDEM.h"
+#include "physics/ChBodyDEM.h"
+#include "particlefactory/ChParticleProcessor.h"
+#include "collision/ChCCollisionSystemBullet.h"
+#include "collision/bullet/btBulletCollisionCommon.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace chrono::particlefactory;
+using namespace collision;
+
+
+// The reference remover: the particles are removed one by one with
+// RemoveBody(), after the processing.
+
+class RemoveOneByOne : public ChParticleProcessEvent
+{
+public:
+	virtual void ParticleProcessEvent(ChSharedPtr<ChBody> mbody,
+									  ChSystem& msystem,
+									  ChSharedPtr<ChParticleEventTrigger> mprocessor )
+	{
+		to_remove.push_back(mbody);
+	}
+
+	virtual void SetupPostProcess(ChSystem& msystem)
+	{
+		for (unsigned int i = 0; i < to_remove.size(); ++i)
+			msystem.RemoveBody(to_remove[i]);
+		to_remove.clear();
+	}
+
+private:
+	std::vector< ChSharedPtr<ChBody> > to_remove;
+};
+
+
+// Grains fall through a rectangle, where they are counted, on a floor
+// whose left half is a removal box. The counted and removed grains and
+// the broadphase pairs, summed over all the steps, must be the same: the
+// pairs show that the batched removal leaves the broadphase as the
+// removals one by one.
+
+class TestParticleProcessor : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool indexed, ChTestRun& run)
+	{
+		ChSystemDEM msystem;
+		msystem.Set_G_acc(ChVector<>(0, -9.81, 0));
+
+		ChSharedPtr<ChMaterialSurfaceDEM> mat(new ChMaterialSurfaceDEM);
+		mat->SetYoungModulus(1e7);
+		mat->SetFriction(0.4);
+		mat->SetRestitution(0.2);
+
+		ChSharedPtr<ChBodyDEM> floor(new ChBodyDEM);
+		floor->SetBodyFixed(true);
+		floor->SetMaterialSurfaceDEM(mat);
+		floor->GetCollisionModel()->ClearModel();
+		floor->GetCollisionModel()->AddBox(0.5, 0.1, 0.5, ChVector<>(0, -0.1, 0));
+		floor->GetCollisionModel()->BuildModel();
+		floor->SetCollide(true);
+		msystem.AddBody(floor);
+
+		// grains at different heights, so that few of them are in contact
+		// at the same time
+		double prad = 0.02;
+		double mass = 2500 * (4.0/3.0) * CH_C_PI * pow(prad, 3);
+		std::vector< ChSharedPtr<ChBody> > grains;
+		for (int ix = 0; ix < 8; ++ix)
+			for (int iz = 0; iz < 6; ++iz)
+			{
+				ChSharedPtr<ChBodyDEM> mgrain(new ChBodyDEM);
+				mgrain->SetMass(mass);
+				mgrain->SetInertiaXX(0.4 * mass * prad * prad * ChVector<>(1, 1, 1));
+				mgrain->SetPos(ChVector<>(-0.35 + ix * 0.1, 0.3 + 0.03 * ((ix + 2 * iz) % 5), -0.25 + iz * 0.1));
+				mgrain->SetPos_dt(ChVector<>(0.3 * ((ix % 3) - 1), 0, 0.2 * ((iz % 2) ? 1 : -1)));
+				mgrain->SetMaterialSurfaceDEM(mat);
+				mgrain->GetCollisionModel()->ClearModel();
+				mgrain->GetCollisionModel()->AddSphere(prad);
+				mgrain->GetCollisionModel()->BuildModel();
+				mgrain->SetCollide(true);
+				msystem.AddBody(mgrain);
+				grains.push_back(mgrain);
+			}
+
+		// count the grains that fall through a horizontal rectangle
+		ChSharedPtr<ChParticleEventFlowInRectangle> rectangleflow(new ChParticleEventFlowInRectangle(0.4, 0.4));
+		rectangleflow->rectangle_csys = ChCoordsys<>(ChVector<>(0.1, 0.2, 0), Q_from_AngAxis(-CH_C_PI_2, VECT_X));
+		rectangleflow->margin = 0.05;
+		ChSharedPtr<ChParticleProcessEventCount> counter(new ChParticleProcessEventCount);
+		ChParticleProcessor processor_flowcount;
+		processor_flowcount.SetEventTrigger(rectangleflow);
+		processor_flowcount.SetParticleEventProcessor(counter);
+
+		// remove the grains on the left half of the floor
+		ChSharedPtr<ChParticleEventTriggerBox> removalbox(new ChParticleEventTriggerBox);
+		removalbox->mbox.Pos = ChVector<>(0.25, -0.05, 0);	// center at (-0.25, 0.05, 0)
+		removalbox->mbox.Size = ChVector<>(0.25, 0.05, 0.5);
+		ChParticleProcessor processor_remove;
+		processor_remove.SetEventTrigger(removalbox);
+
+		ChSharedPtr<ChParticleProcessEventRemove> remover(new ChParticleProcessEventRemove);
+		if (indexed)
+		{
+			ChSharedPtr<ChParticleSpatialIndex> index(new ChParticleSpatialIndex);
+			processor_flowcount.SetSpatialIndex(index);
+			processor_remove.SetSpatialIndex(index);
+			remover->SetDeferred(true);
+			processor_remove.SetParticleEventProcessor(remover);
+		}
+		else
+		{
+			processor_remove.SetParticleEventProcessor(ChSharedPtr<RemoveOneByOne>(new RemoveOneByOne));
+		}
+
+		ChCollisionSystemBullet* mcollisions = (ChCollisionSystemBullet*)msystem.GetCollisionSystem();
+		int npairs = 0;
+		nremoved = 0;
+		for (int step = 0; step < 4000; ++step)
+		{
+			msystem.DoStepDynamics(1e-4);
+			npairs += mcollisions->GetBulletCollisionWorld()->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+
+			processor_flowcount.ProcessParticles(msystem);
+			nremoved += processor_remove.ProcessParticles(msystem);
+			remover->ApplyRemovals(msystem);
+		}
+		ncounted = counter->counter;
+		run.AddCount(ncounted);
+		run.AddCount(nremoved);
+		run.AddCount(npairs);
+
+		// the removed grains are compared with a far point
+		ngrains = (int)grains.size();
+		for (unsigned int i = 0; i < grains.size(); ++i)
+			run.AddVector(grains[i]->GetSystem() ? grains[i]->GetPos() : ChVector<>(1e3, 1e3, 1e3), 1e-9);
+	}
+
+	int ncounted;
+	int nremoved;
+	int ngrains;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestParticleProcessor mtest;
+	if (!mtest.Compare("indexed particle processors"))
+		return 1;
+
+	// some grains, but not all, must have been counted and removed
+	GetLog() << "counted " << mtest.ncounted << ", removed " << mtest.nremoved << " of " << mtest.ngrains << "\n";
+	if (mtest.ncounted == 0 || mtest.nremoved == 0 || mtest.nremoved == mtest.ngrains)
+	{
+		GetLog() << "Error: the processors did not count or remove the grains.\n";
+		return 1;
+	}
+	return 0;
+}
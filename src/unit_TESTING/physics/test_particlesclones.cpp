@@ -0,0 +1,162 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChParticlesClonesSoA: particles sliding,
+//   rolling and colliding on a floor must move as the
+//   same particles in a ChParticlesClones, up to the
+//   roundoff of their angular speeds.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChParticlesClones.h"
+#include "physics/ChParticlesClonesSoA.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+const double prad = 0.05;
+const double pmass = 1.0;
+const int nside = 4;
+const int nsteps = 300;
+
+
+void create_floor(ChSystem& msystem)
+{
+	msystem.SetIterLCPmaxItersSpeed(50);
+
+	ChSharedPtr<ChBody> floor(new ChBody);
+	floor->SetBodyFixed(true);
+	floor->SetFriction(0.3);
+	floor->GetCollisionModel()->ClearModel();
+	floor->GetCollisionModel()->AddBox(1, 0.1, 1, ChVector<>(0, -0.1, 0));
+	floor->GetCollisionModel()->BuildModel();
+	floor->SetCollide(true);
+	msystem.Add(floor);
+}
+
+
+// Initial state of the i-th particle: a layer of particles, each pair
+// sliding one against the other. Particles do not touch many others
+// at once, otherwise the frictional contacts are indeterminate and the
+// solution depends on the order of the contacts.
+ChVector<> initial_pos(int i)
+{
+	int ix = i % nside, iz = i / nside;
+	return ChVector<>(ix * 4 * prad, prad, iz * 4 * prad + 0.2 * prad * (ix % 2));
+}
+
+ChVector<> initial_speed(int i)
+{
+	return ChVector<>((i % 2) ? -0.3 : 0.3, 0, 0);
+}
+
+
+// The same particles, in a ChParticlesClones (the reference) or in a
+// ChParticlesClonesSoA.
+//
+// The two paths are not bit-identical: ChParticlesClones stores the
+// angular speed as the derivative of the quaternion, so it is rounded
+// at each step (1e-18 after two steps), while the SoA stores it as is.
+// The frictional contacts amplify this: after 300 steps the positions
+// differ by 2.2e-8 and the speeds by 7.5e-6. The tolerances are larger,
+// so that the test does not depend on the optimizations of the compiler.
+
+class TestParticlesClonesSoA : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool soa, ChTestRun& run)
+	{
+		ChSystem msystem;
+		create_floor(msystem);
+
+		ChSharedPtr<ChParticlesClones> mclones(new ChParticlesClones);
+		ChSharedPtr<ChParticlesClonesSoA> msoa(new ChParticlesClonesSoA);
+		if (soa)
+		{
+			msoa->SetMass(pmass);
+			msoa->SetInertiaXX(ChVector<>(1, 1, 1) * 0.4 * pmass * prad * prad);
+			msoa->GetMaterialSurface()->SetFriction(0.3);
+			msoa->GetCollisionModel()->ClearModel();
+			msoa->GetCollisionModel()->AddSphere(prad);
+			msoa->GetCollisionModel()->BuildModel();
+			msoa->SetCollide(true);
+			for (int i = 0; i < nside * nside; ++i)
+			{
+				msoa->AddParticle(ChCoordsys<>(initial_pos(i)));
+				msoa->SetParticlePos_dt(i, initial_speed(i));
+			}
+			msystem.Add(msoa);
+		}
+		else
+		{
+			mclones->SetMass(pmass);
+			mclones->SetInertiaXX(ChVector<>(1, 1, 1) * 0.4 * pmass * prad * prad);
+			mclones->GetMaterialSurface()->SetFriction(0.3);
+			mclones->GetCollisionModel()->ClearModel();
+			mclones->GetCollisionModel()->AddSphere(prad);
+			mclones->GetCollisionModel()->BuildModel();
+			mclones->SetCollide(true);
+			for (int i = 0; i < nside * nside; ++i)
+			{
+				mclones->AddParticle(ChCoordsys<>(initial_pos(i)));
+				mclones->GetParticle(i).SetPos_dt(initial_speed(i));
+			}
+			msystem.Add(mclones);
+		}
+
+		for (int step = 0; step < nsteps; ++step)
+			msystem.DoStepDynamics(0.005);
+
+		maxchange = 0;
+		for (int i = 0; i < nside * nside; ++i)
+		{
+			ChVector<> mpos    = soa ? msoa->GetParticlePos(i)    : mclones->GetParticle(i).GetPos();
+			ChVector<> mpos_dt = soa ? msoa->GetParticlePos_dt(i) : mclones->GetParticle(i).GetPos_dt();
+			run.AddVector(mpos, 1e-6);
+			run.AddVector(mpos_dt, 1e-4);
+			maxchange = ChMax(maxchange, (mpos_dt - initial_speed(i)).Length());
+		}
+		run.AddCount(soa ? (int)msoa->GetNparticles() : (int)mclones->GetNparticles());
+	}
+
+	double maxchange;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestParticlesClonesSoA mtest;
+	if (!mtest.Compare("SoA particle clones"))
+		return 1;
+
+	// the collisions must have changed the speeds
+	GetLog() << "speed change " << mtest.maxchange << "\n";
+	if (mtest.maxchange < 0.1)
+	{
+		GetLog() << "Error: the particles did not collide.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,167 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the reordering of the SPH nodes along a
+//   space filling curve (ChMatterSPH::SetReorderInterval):
+//   the nodes must move as without reordering, both
+//   with the proximity container and with the cell
+//   list, and the callback must get the permutations.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChMatterSPH.h"
+#include "physics/ChProximityContainerSPH.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+// Follows the nodes through the reorderings, and checks that each
+// permutation is the one applied to the nodes.
+
+class CheckReorder : public ChReorderCallback
+{
+public:
+	CheckReorder(ChMatterSPH* mfluid) : fluid(mfluid), nreorders(0), nmoved(0), valid(true)
+	{
+		for (unsigned int i = 0; i < fluid->GetNnodes(); ++i)
+			nodes.push_back(fluid->GetNode(i).get_ptr());
+	}
+
+	virtual void OnReorder(ChPhysicsItem* mitem, const std::vector<int>& new_to_old)
+	{
+		++nreorders;
+		if (mitem != fluid || new_to_old.size() != nodes.size())
+		{
+			valid = false;
+			return;
+		}
+		std::vector<ChNodeBase*> old_nodes(nodes);
+		for (unsigned int i = 0; i < nodes.size(); ++i)
+		{
+			nodes[i] = old_nodes[new_to_old[i]];
+			if (nodes[i] != fluid->GetNode(i).get_ptr())
+				valid = false;
+			if (new_to_old[i] != (int)i)
+				++nmoved;
+		}
+	}
+
+	ChMatterSPH* fluid;
+	std::vector<ChNodeBase*> nodes;
+	int nreorders;
+	int nmoved;
+	bool valid;
+};
+
+
+// A block of fluid in a stretching and shearing flow, as in test_sph.
+// The nodes are compared by identity, not by index.
+
+class TestReorder : public ChTestCompare
+{
+public:
+	TestReorder(bool muse_cell_list) : use_cell_list(muse_cell_list) {}
+
+	virtual void Simulate(bool reorder, ChTestRun& run)
+	{
+		ChSystem msystem;
+		msystem.Set_G_acc(VNULL);
+
+		ChSharedPtr<ChMatterSPH> myfluid(new ChMatterSPH);
+		myfluid->FillBox(ChVector<>(0.6, 0.4, 0.6), 0.1, 1000, CSYSNORM, true, 2.2);
+		myfluid->GetMaterial().Set_viscosity(0.05);
+		myfluid->GetMaterial().Set_pressure_stiffness(300);
+		myfluid->SetUseCellList(use_cell_list);
+		myfluid->SetCollide(!use_cell_list);
+		msystem.Add(myfluid);
+
+		if (!use_cell_list)
+		{
+			ChSharedPtr<ChProximityContainerSPH> myproximity(new ChProximityContainerSPH);
+			msystem.Add(myproximity);
+		}
+
+		std::vector< ChSharedPtr<ChNodeSPH> > nodes;
+		for (unsigned int i = 0; i < myfluid->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeSPH> mnode = myfluid->GetNode(i).DynamicCastTo<ChNodeSPH>();
+			mnode->SetPos_dt(ChVector<>(0.5 * mnode->pos.x + 0.3 * mnode->pos.y, 0, -0.2 * mnode->pos.z));
+			nodes.push_back(mnode);
+		}
+
+		CheckReorder mcheck(myfluid.get_ptr());
+		if (reorder)
+		{
+			myfluid->SetReorderInterval(10);
+			myfluid->SetReorderCallback(&mcheck);
+		}
+
+		for (int step = 0; step < 60; ++step)
+			msystem.DoStepDynamics(0.002);
+
+		for (unsigned int i = 0; i < nodes.size(); ++i)
+		{
+			run.AddVector(nodes[i]->GetPos(), 1e-9);
+			run.AddVector(nodes[i]->GetPos_dt(), 1e-9);
+			run.AddScalar(nodes[i]->density, 1e-9 * 1000);
+		}
+
+		if (reorder)
+		{
+			nreorders = mcheck.nreorders;
+			nmoved = mcheck.nmoved;
+			valid = mcheck.valid;
+		}
+	}
+
+	bool use_cell_list;
+	int nreorders;
+	int nmoved;
+	bool valid;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		TestReorder mtest(i == 1);
+		if (!mtest.Compare(i == 1 ? "reordered nodes, cell list" : "reordered nodes, proximity container"))
+			ok = false;
+
+		// a reordering every 10 steps, from the second step, that moves
+		// the nodes of the box to the Morton order
+		GetLog() << "reorders " << mtest.nreorders << ", moved nodes " << mtest.nmoved << "\n";
+		if (mtest.nreorders != 5 || mtest.nmoved == 0 || !mtest.valid)
+		{
+			GetLog() << "Error: the nodes were not reordered as reported by the callback.\n";
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
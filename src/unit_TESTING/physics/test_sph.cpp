@@ -0,0 +1,106 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChMatterSPH: with the cell list, a block
+//   of fluid, stretched and sheared by its initial
+//   speeds, must have the same densities, pressures
+//   and motion as with the collision engine and the
+//   proximity container.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChMatterSPH.h"
+#include "physics/ChProximityContainerSPH.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+
+
+// A block of fluid in a stretching and shearing flow. With the cell
+// list, there is no ChProximityContainerSPH in the system. The
+// densities and pressures of the nodes are compared too, because the
+// cell list sums them per node instead of per pair.
+
+class TestSPH : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool use_cell_list, ChTestRun& run)
+	{
+		ChSystem msystem;
+		msystem.Set_G_acc(VNULL);
+
+		ChSharedPtr<ChMatterSPH> myfluid(new ChMatterSPH);
+		myfluid->FillBox(ChVector<>(0.6, 0.4, 0.6), 0.1, 1000, CSYSNORM, true, 2.2);
+		myfluid->GetMaterial().Set_viscosity(0.05);
+		myfluid->GetMaterial().Set_pressure_stiffness(300);
+		myfluid->SetUseCellList(use_cell_list);
+		myfluid->SetCollide(!use_cell_list);
+		msystem.Add(myfluid);
+
+		if (!use_cell_list)
+		{
+			ChSharedPtr<ChProximityContainerSPH> myproximity(new ChProximityContainerSPH);
+			msystem.Add(myproximity);
+		}
+
+		for (unsigned int i = 0; i < myfluid->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeSPH> mnode = myfluid->GetNode(i).DynamicCastTo<ChNodeSPH>();
+			mnode->SetPos_dt(ChVector<>(0.5 * mnode->pos.x + 0.3 * mnode->pos.y, 0, -0.2 * mnode->pos.z));
+		}
+
+		for (int step = 0; step < 30; ++step)
+			msystem.DoStepDynamics(0.002);
+
+		maxpressure = 0;
+		for (unsigned int i = 0; i < myfluid->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeSPH> mnode = myfluid->GetNode(i).DynamicCastTo<ChNodeSPH>();
+			run.AddVector(mnode->GetPos(), 1e-9);
+			run.AddVector(mnode->GetPos_dt(), 1e-9);
+			run.AddScalar(mnode->density, 1e-9 * 1000);
+			run.AddScalar(mnode->pressure, 1e-9 * 1000);
+			maxpressure = ChMax(maxpressure, fabs(mnode->pressure));
+		}
+	}
+
+	double maxpressure;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestSPH mtest;
+	if (!mtest.Compare("SPH cell list"))
+		return 1;
+
+	// the nodes are not at the reference density, so there must be pressures
+	GetLog() << "max pressure " << mtest.maxpressure << "\n";
+	if (mtest.maxpressure < 1)
+	{
+		GetLog() << "Error: no pressures in the fluid.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,188 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the multigrid solver (ChLcpIterativeAMG):
+//   the temperatures of a thermal tetrahedral mesh,
+//   steady and transient, must be those given by
+//   MINRES, in fewer iterations; with constraints
+//   in the system it must fall back to MINRES.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "physics/ChBody.h"
+#include "physics/ChLinkLock.h"
+#include "lcp/ChLcpIterativeAMG.h"
+#include "unit_FEM/ChContinuumThermal.h"
+#include "unit_FEM/ChElementTetra_4.h"
+#include "unit_FEM/ChNodeFEMxyzP.h"
+#include "unit_FEM/ChMesh.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// A cube of n*n*n cells, each split in 6 tetrahedra along its diagonal,
+// with the base at a fixed temperature and a heat flux into a node of
+// the top face.
+
+void create_cube(ChMesh& mesh, int n)
+{
+	ChSharedPtr<ChContinuumThermal> mmaterial(new ChContinuumThermal);
+	mmaterial->SetMassSpecificHeatCapacity(2);
+	mmaterial->SetThermalConductivityK(200);
+
+	double side = 1.0 / n;
+	std::vector< ChSharedPtr<ChNodeFEMxyzP> > nodes;
+	for (int iz = 0; iz <= n; ++iz)
+		for (int iy = 0; iy <= n; ++iy)
+			for (int ix = 0; ix <= n; ++ix)
+			{
+				ChSharedPtr<ChNodeFEMxyzP> mnode(new ChNodeFEMxyzP(ChVector<>(ix * side, iy * side, iz * side)));
+				if (iy == 0)
+				{
+					mnode->SetFixed(true);
+					mnode->SetP(10);
+				}
+				if (iy == n && ix == n / 2 && iz == n / 3)
+					mnode->SetF(20);
+				mesh.AddNode(mnode);
+				nodes.push_back(mnode);
+			}
+
+	// the 6 paths from the corner 0 to the corner 7 of a cell, along the edges
+	static const int paths[6][2] = {{1,3}, {1,5}, {2,3}, {2,6}, {4,5}, {4,6}};
+	for (int iz = 0; iz < n; ++iz)
+		for (int iy = 0; iy < n; ++iy)
+			for (int ix = 0; ix < n; ++ix)
+			{
+				ChSharedPtr<ChNodeFEMxyzP> corner[8];
+				for (int ic = 0; ic < 8; ++ic)
+					corner[ic] = nodes[(ix + (ic & 1)) + (n + 1) * ((iy + ((ic >> 1) & 1)) + (n + 1) * (iz + (ic >> 2)))];
+				for (int it = 0; it < 6; ++it)
+				{
+					ChSharedPtr<ChElementTetra_4_P> melement(new ChElementTetra_4_P);
+					melement->SetNodes(corner[0], corner[paths[it][0]], corner[paths[it][1]], corner[7]);
+					melement->SetMaterial(mmaterial);
+					mesh.AddElement(melement);
+				}
+			}
+	mesh.SetupInitial();
+}
+
+
+// The steady temperatures, then some steps of the transient from the
+// steady state, with a doubled flux; optionally, with a pendulum linked
+// to the ground in the same system.
+
+class TestAMG : public ChTestCompare
+{
+public:
+	TestAMG(bool mconstrained) : constrained(mconstrained) {}
+
+	virtual void Simulate(bool amg, ChTestRun& run)
+	{
+		ChSystem msystem;
+
+		ChSharedPtr<ChMesh> mesh(new ChMesh);
+		create_cube(*mesh, 8);
+		msystem.Add(mesh);
+
+		ChSharedPtr<ChBody> mpendulum;
+		if (constrained)
+		{
+			ChSharedPtr<ChBody> mground(new ChBody);
+			mground->SetBodyFixed(true);
+			msystem.AddBody(mground);
+			mpendulum = ChSharedPtr<ChBody>(new ChBody);
+			mpendulum->SetPos(ChVector<>(2, 0, 0));
+			msystem.AddBody(mpendulum);
+			ChSharedPtr<ChLinkLockRevolute> mlink(new ChLinkLockRevolute);
+			mlink->Initialize(mground, mpendulum, ChCoordsys<>(ChVector<>(1, 0, 0)));
+			msystem.AddLink(mlink);
+		}
+
+		msystem.SetLcpSolverType(amg ? ChSystem::LCP_ITERATIVE_AMG : ChSystem::LCP_ITERATIVE_MINRES);
+		ChLcpIterativeMINRES* msolver = (ChLcpIterativeMINRES*)msystem.GetLcpSolverSpeed();
+		msolver->SetDiagonalPreconditioning(true);
+		msolver->SetRelTolerance(1e-12);
+		msystem.SetIterLCPwarmStarting(false);
+		msystem.SetIterLCPmaxItersSpeed(2000);
+		msystem.SetTolSpeeds(1e-12);
+
+		msystem.DoStaticLinear();
+		iterations[amg ? 1 : 0] = (int)msolver->GetTotalIterations();
+		if (amg)
+			nlevels = ((ChLcpIterativeAMG*)msolver)->GetNlevels();
+		for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+			run.AddScalar(mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyzP>()->GetP(), 1e-7);
+
+		for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeFEMxyzP> mnode = mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyzP>();
+			if (mnode->GetF())
+				mnode->SetF(2 * mnode->GetF());
+		}
+		for (int istep = 0; istep < 5; ++istep)
+			msystem.DoStepDynamics(0.01);
+		for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+			run.AddScalar(mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyzP>()->GetP(), 1e-7);
+		if (constrained)
+			run.AddVector(mpendulum->GetPos(), 1e-9);
+	}
+
+	bool constrained;
+	int iterations[2];	// of the steady solve, with MINRES and AMG
+	int nlevels;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	// multigrid on the mesh alone: same temperatures, much fewer iterations
+	TestAMG mtest(false);
+	if (!mtest.Compare("AMG thermal mesh"))
+		ok = false;
+	GetLog() << "steady solve: AMG " << mtest.iterations[1] << " iterations, " << mtest.nlevels << " levels, MINRES " << mtest.iterations[0] << " iterations\n";
+	if (mtest.nlevels < 2 || mtest.iterations[1] <= 0 || 4 * mtest.iterations[1] > mtest.iterations[0])
+	{
+		GetLog() << "Error: the multigrid was not used, or did not speed up the solve.\n";
+		ok = false;
+	}
+
+	// a revolute link in the system: MINRES is used, with the same iterations
+	TestAMG mtest_constrained(true);
+	if (!mtest_constrained.Compare("AMG fallback with constraints"))
+		ok = false;
+	GetLog() << "steady solve with constraints: AMG " << mtest_constrained.iterations[1] << " iterations, MINRES " << mtest_constrained.iterations[0] << " iterations\n";
+	if (mtest_constrained.iterations[1] != mtest_constrained.iterations[0])
+	{
+		GetLog() << "Error: the solver did not fall back to MINRES.\n";
+		ok = false;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the element loops of ChMesh, that run in
+//   parallel over the element colors, with or without
+//   the batched corotation: the stiffness
+//   blocks, the internal forces and the M*q terms of
+//   a deformed mesh of hexahedra, tetrahedra and
+//   springs must be those of the elements updated
+//   and loaded one by one.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "lcp/ChLcpSystemDescriptor.h"
+#include "unit_FEM/ChElementHexa_8.h"
+#include "unit_FEM/ChElementTetra_4.h"
+#include "unit_FEM/ChElementSpring.h"
+#include "unit_FEM/ChMesh.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// A block of 3x2x3 hexahedra, a tetrahedron on each cell of the top face,
+// and springs between the tips of the tetrahedra. The nodes are moved from
+// the rest positions, so that the rotations are not unit.
+
+ChSharedPtr<ChMesh> create_mesh()
+{
+	const int nx = 3, ny = 2, nz = 3;
+	double side = 0.01;
+
+	ChSharedPtr<ChMesh> mesh(new ChMesh);
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	mmaterial->Set_E(207e6);
+	mmaterial->Set_v(0.3);
+	mmaterial->Set_RayleighDampingK(0.01);
+
+	ChSharedPtr<ChNodeFEMxyz> grid[nx+1][ny+1][nz+1];
+	for (int ix = 0; ix <= nx; ++ix)
+		for (int iy = 0; iy <= ny; ++iy)
+			for (int iz = 0; iz <= nz; ++iz)
+			{
+				grid[ix][iy][iz] = ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(ix*side, iy*side, iz*side)));
+				mesh->AddNode(grid[ix][iy][iz]);
+			}
+
+	for (int ix = 0; ix < nx; ++ix)
+		for (int iy = 0; iy < ny; ++iy)
+			for (int iz = 0; iz < nz; ++iz)
+			{
+				ChSharedPtr<ChElementHexa_8> melement(new ChElementHexa_8);
+				melement->SetNodes(grid[ix][iy][iz], grid[ix][iy][iz+1], grid[ix+1][iy][iz+1], grid[ix+1][iy][iz],
+								   grid[ix][iy+1][iz], grid[ix][iy+1][iz+1], grid[ix+1][iy+1][iz+1], grid[ix+1][iy+1][iz]);
+				melement->SetMaterial(mmaterial);
+				mesh->AddElement(melement);
+			}
+
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > tips;
+	for (int ix = 0; ix < nx; ++ix)
+		for (int iz = 0; iz < nz; ++iz)
+		{
+			ChSharedPtr<ChNodeFEMxyz> mtip(new ChNodeFEMxyz(ChVector<>((ix+0.3)*side, (ny+1)*side, (iz+0.3)*side)));
+			mesh->AddNode(mtip);
+			ChSharedPtr<ChElementTetra_4> mtetra(new ChElementTetra_4);
+			mtetra->SetNodes(grid[ix][ny][iz], grid[ix+1][ny][iz], grid[ix][ny][iz+1], mtip);
+			mtetra->SetMaterial(mmaterial);
+			mesh->AddElement(mtetra);
+			if (!tips.empty())
+			{
+				ChSharedPtr<ChElementSpring> mspring(new ChElementSpring);
+				mspring->SetNodes(tips.back(), mtip);
+				mspring->SetSpringK(1e5);
+				mspring->SetDamperR(10);
+				mesh->AddElement(mspring);
+			}
+			tips.push_back(mtip);
+		}
+
+	mesh->SetupInitial();
+
+	for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+	{
+		ChSharedPtr<ChNodeFEMxyz> mnode = mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyz>();
+		mnode->SetPos(mnode->GetX0() + 0.05 * side * ChVector<>(sin(1.0 + i), cos(2.0 * i), sin(3.0 * i)));
+	}
+	return mesh;
+}
+
+
+// The reference path updates and loads the elements one by one, with their
+// own methods; the tested path uses the loops of ChMesh.
+
+class TestElementLoops : public ChTestCompare
+{
+public:
+	TestElementLoops(bool mbatched) : batched(mbatched) {}
+
+	virtual void Simulate(bool meshloops, ChTestRun& run)
+	{
+		ChSharedPtr<ChMesh> mesh = create_mesh();
+		mesh->SetBatchedCorotation(batched);
+		ncolors = mesh->GetNelementColors();
+
+		ChLcpSystemDescriptor mdescriptor;
+		mesh->InjectVariables(mdescriptor);
+		mesh->InjectKRMmatrices(mdescriptor);
+		mdescriptor.UpdateCountsAndOffsets();
+		int n = mdescriptor.CountActiveVariables();
+		std::vector<ChLcpVariables*>& mvariables = mdescriptor.GetVariablesList();
+		for (unsigned int iv = 0; iv < mvariables.size(); ++iv)
+			for (int k = 0; k < mvariables[iv]->Get_ndof(); ++k)
+				mvariables[iv]->Get_qb()(k) = sin(0.3 * iv + k);
+
+		// stiffness blocks, multiplied by a vector
+		if (meshloops)
+		{
+			mesh->Update(0);
+			mesh->KRMmatricesLoad(1.0, 0.5, 2.0);
+		}
+		else
+		{
+			for (unsigned int ie = 0; ie < mesh->GetNelements(); ++ie)
+			{
+				mesh->GetElement(ie)->Update();
+				mesh->GetElement(ie)->KRMmatricesLoad(1.0, 0.5, 2.0);
+			}
+		}
+		ChMatrixDynamic<> vect(n, 1);
+		for (int i = 0; i < n; ++i)
+			vect(i) = sin(0.7 * i + 0.3);
+		ChMatrixDynamic<> product(n, 1);
+		std::vector<ChLcpKblock*>& mblocks = mdescriptor.GetKblocksList();
+		for (unsigned int ib = 0; ib < mblocks.size(); ++ib)
+			mblocks[ib]->MultiplyAndAdd(product, vect);
+
+		// tolerances relative to the largest value, as the batched
+		// corotation sums in another order
+		double pmax = 0;
+		for (int i = 0; i < n; ++i)
+			pmax = ChMax(pmax, fabs(product(i)));
+		for (int i = 0; i < n; ++i)
+			run.AddScalar(product(i), 1e-12 * pmax);
+
+		// internal forces, then M*q
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			mesh->VariablesFbReset();
+			if (meshloops && pass == 0)
+				mesh->VariablesFbLoadForces(0.7);
+			else if (meshloops)
+				mesh->VariablesFbIncrementMq();
+			else
+			{
+				for (unsigned int in = 0; in < mesh->GetNnodes(); ++in)
+				{
+					ChNodeFEMxyz* mnode = (ChNodeFEMxyz*)mesh->GetNode(in).get_ptr();
+					if (pass == 0)
+						mnode->VariablesFbLoadForces(0.7);
+					else
+						mnode->VariablesFbIncrementMq();
+				}
+				for (unsigned int ie = 0; ie < mesh->GetNelements(); ++ie)
+				{
+					if (pass == 0)
+						mesh->GetElement(ie)->VariablesFbLoadInternalForces(0.7);
+					else
+						mesh->GetElement(ie)->VariablesFbIncrementMq();
+				}
+			}
+
+			double fmax = 0;
+			for (unsigned int in = 0; in < mesh->GetNnodes(); ++in)
+				fmax = ChMax(fmax, ((ChNodeFEMxyz*)mesh->GetNode(in).get_ptr())->Variables().Get_fb().NormInf());
+			for (unsigned int in = 0; in < mesh->GetNnodes(); ++in)
+			{
+				ChMatrix<>& mfb = ((ChNodeFEMxyz*)mesh->GetNode(in).get_ptr())->Variables().Get_fb();
+				run.AddVector(ChVector<>(mfb(0), mfb(1), mfb(2)), 1e-12 * fmax);
+			}
+		}
+		run.AddCount(n);
+	}
+
+	bool batched;
+	int ncolors;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	// the elements that share nodes must have been split in colors
+	TestElementLoops mtest_colors(false);
+	if (!mtest_colors.Compare("colored element loops"))
+		ok = false;
+	GetLog() << "colors " << mtest_colors.ncolors << "\n";
+	if (mtest_colors.ncolors < 2)
+	{
+		GetLog() << "Error: the elements were not colored.\n";
+		ok = false;
+	}
+
+	// the hexahedra and the tetrahedra are corotated in batches of lanes,
+	// the last lanes partly filled
+	TestElementLoops mtest_batches(true);
+	if (!mtest_batches.Compare("batched corotation"))
+		ok = false;
+
+	return ok ? 0 : 1;
+}
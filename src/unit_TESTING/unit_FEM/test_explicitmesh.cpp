@@ -0,0 +1,185 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the explicit integration of ChMesh: a
+//   cantilever of hexahedra, loaded at the tip, must
+//   bend as with the implicit integration, and as
+//   without subcycling when the thin cell at the tip
+//   is subcycled; too few subcycling levels must be
+//   an error.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "lcp/ChLcpIterativeMINRES.h"
+#include "unit_FEM/ChElementHexa_8.h"
+#include "unit_FEM/ChMesh.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// A vertical beam of 'ncells' cubes and a thin cell at the tip, with
+// the base nodes fixed and a lateral force on the tip nodes, returned
+// in 'tip'.
+
+ChSharedPtr<ChMesh> create_beam(int ncells, bool mexplicit, std::vector< ChSharedPtr<ChNodeFEMxyz> >& tip)
+{
+	double side = 0.01;
+
+	ChSharedPtr<ChMesh> mesh(new ChMesh);
+	mesh->SetExplicitIntegration(mexplicit);
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	mmaterial->Set_E(207e6);
+	mmaterial->Set_v(0.3);
+
+	tip.clear();
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > layer, previous;
+	for (int iy = 0; iy <= ncells + 1; ++iy)
+	{
+		double y = ChMin(iy, ncells) * side + (iy > ncells ? 0.2 * side : 0);
+		layer.clear();
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    y, 0))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    y, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, y, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, y, 0))));
+		for (int k = 0; k < 4; ++k)
+		{
+			mesh->AddNode(layer[k]);
+			if (iy == 0)
+				layer[k]->SetFixed(true);
+			if (iy == ncells + 1)
+			{
+				layer[k]->SetForce(ChVector<>(0.5, 0, 0));
+				tip.push_back(layer[k]);
+			}
+		}
+		if (iy > 0)
+		{
+			ChSharedPtr<ChElementHexa_8> melement(new ChElementHexa_8);
+			melement->SetNodes(previous[0], previous[1], previous[2], previous[3],
+							   layer[0], layer[1], layer[2], layer[3]);
+			melement->SetMaterial(mmaterial);
+			mesh->AddElement(melement);
+		}
+		previous = layer;
+	}
+	mesh->SetupInitial();
+	return mesh;
+}
+
+
+// Average lateral displacement of the tip after the time 'mtime', starting
+// at rest, with steps of 'step'; 'levels' enables the subcycling.
+
+double tip_displacement(bool mexplicit, double mtime, double step, int levels = 0)
+{
+	int ncells = 10;
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > tip;
+	ChSharedPtr<ChMesh> mesh = create_beam(ncells, mexplicit, tip);
+	mesh->SetExplicitSubcycling(levels);
+
+	ChSystem msystem;
+	msystem.Set_G_acc(VNULL);
+	if (!mexplicit)
+	{
+		msystem.SetLcpSolverType(ChSystem::LCP_ITERATIVE_MINRES);
+		chrono::ChLcpIterativeMINRES* msolver = (chrono::ChLcpIterativeMINRES*)msystem.GetLcpSolverSpeed();
+		msolver->SetDiagonalPreconditioning(true);
+		msystem.SetIterLCPmaxItersSpeed(1000);
+		msystem.SetTolSpeeds(1e-12);
+	}
+	msystem.Add(mesh);
+
+	int nsteps = (int)(mtime / step + 0.5);
+	for (int i = 0; i < nsteps; ++i)
+		msystem.DoStepDynamics(step);
+
+	double dx = 0;
+	for (unsigned int i = 0; i < tip.size(); ++i)
+		dx += tip[i]->GetPos().x - tip[i]->GetX0().x;
+	return dx / tip.size();
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	// The thin cell at the tip has the smallest critical time step, and the
+	// masses of the elements are lumped in the nodes
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > tip;
+	ChSharedPtr<ChMesh> mesh = create_beam(10, true, tip);
+	double dt_crit = mesh->ComputeCriticalTimeStep();
+	double dt_cube = mesh->GetElementCriticalTimeStep(0);
+	double mass = 0;
+	for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+		mass += mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyz>()->GetMass();
+	GetLog() << "critical time step " << dt_crit << ", of a cube " << dt_cube << ", lumped mass " << mass << "\n";
+	if (dt_crit != mesh->GetElementCriticalTimeStep(10) || dt_crit > 0.5 * dt_cube || fabs(mass - 1000 * 1.02e-5) > 1e-9)
+	{
+		GetLog() << "Error: wrong critical time steps or lumped masses.\n";
+		ok = false;
+	}
+
+	// Explicit and implicit integration, with the same steps
+	double mtime = 0.005;
+	double step = 0.5 * dt_crit;
+	double implicit = tip_displacement(false, mtime, step);
+	double explicit_full = tip_displacement(true, mtime, step);
+	GetLog() << "tip displacement: implicit " << implicit << ", explicit " << explicit_full << "\n";
+	if (implicit <= 0 || fabs(explicit_full - implicit) > 0.01 * implicit)
+	{
+		GetLog() << "Error: the explicit integration does not match the implicit one.\n";
+		ok = false;
+	}
+
+	// Steps larger than the critical one of the thin cell, but not of the
+	// cubes: only the nodes of the thin cell are subcycled, and the cube
+	// below exchanges the impulses with them
+	double explicit_subcycled = tip_displacement(true, mtime, 0.5 * dt_cube, 3);
+	GetLog() << "tip displacement: subcycled " << explicit_subcycled << "\n";
+	if (fabs(explicit_subcycled - explicit_full) > 0.005 * explicit_full)
+	{
+		GetLog() << "Error: the subcycled integration does not match the one without subcycling.\n";
+		ok = false;
+	}
+
+	// Too few levels for the thin cell
+	bool thrown = false;
+	try
+	{
+		tip_displacement(true, 0.5 * dt_cube, 0.5 * dt_cube, 1);
+	}
+	catch (const ChException&)
+	{
+		thrown = true;
+	}
+	if (!thrown)
+	{
+		GetLog() << "Error: too few subcycling levels were accepted.\n";
+		ok = false;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the packed storages of the stiffness
+//   blocks (ChMesh::SetKblockStorage): the products,
+//   the diagonals and the assembled matrices of a
+//   deformed mesh of hexahedra, tetrahedra and springs
+//   must be those of the full storage.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "core/ChSpmatrix.h"
+#include "lcp/ChLcpSystemDescriptor.h"
+#include "unit_FEM/ChElementHexa_8.h"
+#include "unit_FEM/ChElementTetra_4.h"
+#include "unit_FEM/ChElementSpring.h"
+#include "unit_FEM/ChMesh.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// Two hexahedra stacked along y, a tetrahedron on the top face and a
+// spring along a diagonal: the hexahedra and the tetrahedron go in the
+// batched corotation, the spring in the ChElementGeneric path. The nodes
+// are moved from the rest positions, so that the rotations are not unit.
+
+ChSharedPtr<ChMesh> create_mesh(ChLcpKblockGeneric::eChKstorage mstorage)
+{
+	double side = 0.01;
+
+	ChSharedPtr<ChMesh> mesh(new ChMesh);
+	mesh->SetKblockStorage(mstorage);
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	mmaterial->Set_E(207e6);
+	mmaterial->Set_v(0.3);
+	mmaterial->Set_RayleighDampingK(0.01);
+
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > layer, previous;
+	for (int iy = 0; iy <= 2; ++iy)
+	{
+		layer.clear();
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    iy*side, 0))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    iy*side, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, iy*side, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, iy*side, 0))));
+		for (int k = 0; k < 4; ++k)
+			mesh->AddNode(layer[k]);
+		if (iy > 0)
+		{
+			ChSharedPtr<ChElementHexa_8> melement(new ChElementHexa_8);
+			melement->SetNodes(previous[0], previous[1], previous[2], previous[3],
+							   layer[0], layer[1], layer[2], layer[3]);
+			melement->SetMaterial(mmaterial);
+			mesh->AddElement(melement);
+		}
+		previous = layer;
+	}
+
+	ChSharedPtr<ChNodeFEMxyz> apex(new ChNodeFEMxyz(ChVector<>(0.3*side, 3*side, 0.3*side)));
+	mesh->AddNode(apex);
+	ChSharedPtr<ChElementTetra_4> mtetra(new ChElementTetra_4);
+	mtetra->SetNodes(layer[0], layer[3], layer[1], apex);
+	mtetra->SetMaterial(mmaterial);
+	mesh->AddElement(mtetra);
+
+	ChSharedPtr<ChElementSpring> mspring(new ChElementSpring);
+	mspring->SetNodes(layer[2], apex);
+	mspring->SetSpringK(1e5);
+	mspring->SetDamperR(10);
+	mesh->AddElement(mspring);
+
+	mesh->SetupInitial();
+
+	for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+	{
+		ChSharedPtr<ChNodeFEMxyz> mnode = mesh->GetNode(i).DynamicCastTo<ChNodeFEMxyz>();
+		mnode->SetPos(mnode->GetX0() + 0.05 * side * ChVector<>(sin(1.0 + i), cos(2.0 * i), sin(3.0 * i)));
+	}
+	mesh->Update(0);
+	return mesh;
+}
+
+
+class TestKblockStorage : public ChTestCompare
+{
+public:
+	TestKblockStorage(ChLcpKblockGeneric::eChKstorage mstorage, double mtolerance) : storage(mstorage), tolerance(mtolerance) {}
+
+	virtual void Simulate(bool packed, ChTestRun& run)
+	{
+		ChSharedPtr<ChMesh> mesh = create_mesh(packed ? storage : ChLcpKblockGeneric::KSTORAGE_FULL);
+
+		ChLcpSystemDescriptor mdescriptor;
+		mesh->InjectVariables(mdescriptor);
+		mesh->InjectKRMmatrices(mdescriptor);
+		mdescriptor.UpdateCountsAndOffsets();
+		mesh->KRMmatricesLoad(1.0, 0.5, 2.0);
+
+		int n = mdescriptor.CountActiveVariables();
+		ChMatrixDynamic<> vect(n, 1);
+		for (int i = 0; i < n; ++i)
+			vect(i) = sin(0.7 * i + 0.3);
+		ChMatrixDynamic<> product(n, 1);
+		ChMatrixDynamic<> diagonal(n, 1);
+		ChSparseMatrix assembled(n, n);
+		std::vector<ChLcpKblock*>& mblocks = mdescriptor.GetKblocksList();
+		for (unsigned int ib = 0; ib < mblocks.size(); ++ib)
+		{
+			mblocks[ib]->MultiplyAndAdd(product, vect);
+			mblocks[ib]->DiagonalAdd(diagonal);
+			mblocks[ib]->Build_K(assembled, true);
+		}
+
+		// tolerance relative to the largest stiffness
+		double kmax = 0;
+		for (int i = 0; i < n; ++i)
+			kmax = ChMax(kmax, fabs(diagonal(i)));
+		double mtol = tolerance * kmax;
+		for (int i = 0; i < n; ++i)
+		{
+			run.AddScalar(product(i), n * mtol);
+			run.AddScalar(diagonal(i), mtol);
+			for (int j = 0; j < n; ++j)
+				run.AddScalar(assembled.GetElement(i, j), mtol);
+		}
+		nblocks = (int)mblocks.size();
+		run.AddCount(nblocks);
+		run.AddCount(n);
+	}
+
+	ChLcpKblockGeneric::eChKstorage storage;
+	double tolerance;
+	int nblocks;
+};
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	// the packed double storage keeps the same numbers
+	TestKblockStorage mtest_double(ChLcpKblockGeneric::KSTORAGE_SYMMETRIC, 1e-14);
+	if (!mtest_double.Compare("packed double Kblocks"))
+		ok = false;
+
+	// the single precision storage rounds each entry
+	TestKblockStorage mtest_float(ChLcpKblockGeneric::KSTORAGE_SYMMETRIC_FLOAT, 1e-7);
+	if (!mtest_float.Compare("packed float Kblocks"))
+		ok = false;
+
+	// the elements must have been loaded: the float storage rounds them
+	GetLog() << "Kblocks " << mtest_float.nblocks << ", max difference of the float storage " << mtest_float.maxdiff << "\n";
+	if (mtest_float.nblocks != 4 || mtest_float.maxdiff == 0)
+	{
+		GetLog() << "Error: the Kblocks were not loaded.\n";
+		ok = false;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChMatterMeshless: with the cell list, a
+//   block of meshless matter, stretched and sheared
+//   by its initial speeds, must have the same strains,
+//   stresses and motion as with the collision engine
+//   and the proximity container.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "unit_FEM/ChMatterMeshless.h"
+#include "unit_FEM/ChProximityContainerMeshless.h"
+#include "../ChTestCompare.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// A block of elastoplastic matter in a stretching and shearing flow.
+// With the cell list, there is no ChProximityContainerMeshless in the
+// system. The strains and stresses of the nodes are compared too,
+// because the cell list sums the moment matrix and the deformation
+// gradient of each node over its neighbors instead of per pair.
+
+class TestMeshless : public ChTestCompare
+{
+public:
+	virtual void Simulate(bool use_cell_list, ChTestRun& run)
+	{
+		double E = 30000.0;
+
+		ChSystem msystem;
+		msystem.Set_G_acc(VNULL);
+
+		ChSharedPtr<ChMatterMeshless> mymatter(new ChMatterMeshless);
+		mymatter->FillBox(ChVector<>(0.6, 0.4, 0.6), 0.1, 1000, CSYSNORM, true, 2.1);
+		mymatter->GetMaterial()->Set_E(E);
+		mymatter->GetMaterial()->Set_v(0.35);
+		mymatter->SetViscosity(100);
+		mymatter->SetUseCellList(use_cell_list);
+		mymatter->SetCollide(!use_cell_list);
+		msystem.Add(mymatter);
+
+		if (!use_cell_list)
+		{
+			ChSharedPtr<ChProximityContainerMeshless> myproximity(new ChProximityContainerMeshless);
+			msystem.Add(myproximity);
+		}
+
+		for (unsigned int i = 0; i < mymatter->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeMeshless> mnode = mymatter->GetNode(i).DynamicCastTo<ChNodeMeshless>();
+			mnode->SetPos_dt(ChVector<>(0.5 * mnode->pos.x + 0.3 * mnode->pos.y, 0, -0.2 * mnode->pos.z));
+		}
+
+		for (int step = 0; step < 30; ++step)
+			msystem.DoStepDynamics(0.002);
+
+		maxstress = 0;
+		for (unsigned int i = 0; i < mymatter->GetNnodes(); ++i)
+		{
+			ChSharedPtr<ChNodeMeshless> mnode = mymatter->GetNode(i).DynamicCastTo<ChNodeMeshless>();
+			run.AddVector(mnode->GetPos(), 1e-9);
+			run.AddVector(mnode->GetPos_dt(), 1e-9);
+			const ChStrainTensor<>& mstrain = mnode->e_strain;
+			run.AddVector(ChVector<>(mstrain.XX(), mstrain.YY(), mstrain.ZZ()), 1e-9);
+			run.AddVector(ChVector<>(mstrain.XY(), mstrain.XZ(), mstrain.YZ()), 1e-9);
+			const ChStressTensor<>& mstress = mnode->e_stress;
+			run.AddVector(ChVector<>(mstress.XX(), mstress.YY(), mstress.ZZ()), 1e-9 * E);
+			run.AddVector(ChVector<>(mstress.XY(), mstress.XZ(), mstress.YZ()), 1e-9 * E);
+			maxstress = ChMax(maxstress, mstress.GetEquivalentVonMises());
+		}
+	}
+
+	double maxstress;
+};
+
+
+int main(int argc, char* argv[])
+{
+	TestMeshless mtest;
+	if (!mtest.Compare("meshless cell list"))
+		return 1;
+
+	// the flow is not uniform, so the matter must be strained
+	GetLog() << "max Von Mises stress " << mtest.maxstress << "\n";
+	if (mtest.maxstress < 1)
+	{
+		GetLog() << "Error: no stresses in the matter.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,180 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be 
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChReducedMesh: a cantilever of hexahedra,
+//   loaded at the tip, must bend as the full mesh,
+//   exactly in the static analysis, and closely in
+//   the dynamics.
+//
+//	 CHRONO 
+//   ------
+//   Multibody dinamics engine
+// 
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "core/ChLog.h"
+#include "physics/ChSystem.h"
+#include "lcp/ChLcpIterativeMINRES.h"
+#include "unit_FEM/ChElementHexa_8.h"
+#include "unit_FEM/ChMesh.h"
+#include "unit_FEM/ChReducedMesh.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+// A vertical beam of 'ncells' cubes, with the base nodes fixed and
+// a lateral force on the tip nodes. The base and tip nodes are returned
+// in 'boundary', the tip nodes in 'tip'.
+
+ChSharedPtr<ChMesh> create_beam(int ncells,
+								std::vector< ChSharedPtr<ChNodeFEMxyz> >& boundary,
+								std::vector< ChSharedPtr<ChNodeFEMxyz> >& tip)
+{
+	double side = 0.01;
+
+	ChSharedPtr<ChMesh> mesh(new ChMesh);
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	mmaterial->Set_E(207e6);
+	mmaterial->Set_v(0.3);
+
+	boundary.clear();
+	tip.clear();
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > layer, previous;
+	for (int iy = 0; iy <= ncells; ++iy)
+	{
+		layer.clear();
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    iy*side, 0))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(0,    iy*side, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, iy*side, side))));
+		layer.push_back(ChSharedPtr<ChNodeFEMxyz>(new ChNodeFEMxyz(ChVector<>(side, iy*side, 0))));
+		for (int k = 0; k < 4; ++k)
+		{
+			mesh->AddNode(layer[k]);
+			if (iy == 0)
+				layer[k]->SetFixed(true);
+			if (iy == ncells)
+			{
+				layer[k]->SetForce(ChVector<>(0.5, 0, 0));
+				tip.push_back(layer[k]);
+			}
+			if (iy == 0 || iy == ncells)
+				boundary.push_back(layer[k]);
+		}
+		if (iy > 0)
+		{
+			ChSharedPtr<ChElementHexa_8> melement(new ChElementHexa_8);
+			melement->SetNodes(previous[0], previous[1], previous[2], previous[3],
+							   layer[0], layer[1], layer[2], layer[3]);
+			melement->SetMaterial(mmaterial);
+			mesh->AddElement(melement);
+		}
+		previous = layer;
+	}
+	mesh->SetupInitial();
+	return mesh;
+}
+
+
+void setup_system(ChSystem& msystem)
+{
+	msystem.Set_G_acc(VNULL);
+	msystem.SetLcpSolverType(ChSystem::LCP_ITERATIVE_MINRES);
+	chrono::ChLcpIterativeMINRES* msolver = (chrono::ChLcpIterativeMINRES*)msystem.GetLcpSolverSpeed();
+	msolver->SetDiagonalPreconditioning(true);
+	msystem.SetIterLCPmaxItersSpeed(1000);
+	msystem.SetTolSpeeds(1e-12);
+}
+
+
+// Average lateral displacement of the tip, from the full mesh or from
+// the reduced one, after a static analysis (nsteps = 0) or after some
+// time steps of the dynamics, starting at rest.
+
+double tip_displacement(bool reduced, int nsteps)
+{
+	int ncells = 10;
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > boundary, tip;
+	ChSharedPtr<ChMesh> mesh = create_beam(ncells, boundary, tip);
+
+	ChSystem msystem;
+	setup_system(msystem);
+
+	if (reduced)
+	{
+		ChSharedPtr<ChReducedMesh> mreduced(new ChReducedMesh);
+		mreduced->Reduce(mesh, boundary, 6);
+		msystem.Add(mreduced);
+	}
+	else
+		msystem.Add(mesh);
+
+	if (nsteps == 0)
+		msystem.DoStaticLinear();
+	for (int i = 0; i < nsteps; ++i)
+		msystem.DoStepDynamics(1e-4);
+
+	double dx = 0;
+	for (unsigned int i = 0; i < tip.size(); ++i)
+		dx += tip[i]->GetPos().x - tip[i]->GetX0().x;
+	return dx / tip.size();
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+
+	// The constraint modes are exact for the loads on the boundary nodes
+	double full_static = tip_displacement(false, 0);
+	double reduced_static = tip_displacement(true, 0);
+	GetLog() << "static tip displacement: full " << full_static << ", reduced " << reduced_static << "\n";
+	if (full_static <= 0 || fabs(reduced_static - full_static) > 1e-6 * full_static)
+	{
+		GetLog() << "Error: the static deflection of the reduced mesh is not the one of the full mesh.\n";
+		ok = false;
+	}
+
+	// The lowest modes are enough for the slow response
+	double full_dynamic = tip_displacement(false, 100);
+	double reduced_dynamic = tip_displacement(true, 100);
+	GetLog() << "dynamic tip displacement: full " << full_dynamic << ", reduced " << reduced_dynamic << "\n";
+	if (full_dynamic <= 0 || fabs(reduced_dynamic - full_dynamic) > 0.02 * full_dynamic)
+	{
+		GetLog() << "Error: the dynamics of the reduced mesh does not match the full mesh.\n";
+		ok = false;
+	}
+
+	// The nodes of the mesh of the caller are not renumbered
+	std::vector< ChSharedPtr<ChNodeFEMxyz> > boundary, tip;
+	ChSharedPtr<ChMesh> mesh = create_beam(10, boundary, tip);
+	std::vector<ChNodeBase*> order;
+	for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+		order.push_back(mesh->GetNode(i).get_ptr());
+	ChReducedMesh mreduced;
+	mreduced.Reduce(mesh, boundary, 6);
+	for (unsigned int i = 0; i < mesh->GetNnodes(); ++i)
+		if (mesh->GetNode(i).get_ptr() != order[i])
+		{
+			GetLog() << "Error: the reduction renumbered the nodes of the mesh.\n";
+			ok = false;
+			break;
+		}
+
+	return ok ? 0 : 1;
+}
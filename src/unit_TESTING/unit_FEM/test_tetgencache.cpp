@@ -0,0 +1,172 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of ChMesh::LoadFromTetGenFileCached: the
+//   cache must give the mesh of the TetGen files,
+//   and must be ignored if their size or their time
+//   change. Truncated TetGen files must be rejected.
+//
+//	 CHRONO
+//   ------
+//   Multibody dinamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+ #include <sys/utime.h>
+#else
+ #include <utime.h>
+#endif
+
+#include "core/ChLog.h"
+#include "unit_FEM/ChMesh.h"
+#include "unit_FEM/ChNodeFEMxyz.h"
+
+using namespace chrono;
+using namespace fem;
+
+
+const char* file_node  = "test_tetgencache.node";
+const char* file_ele   = "test_tetgencache.ele";
+const char* file_cache = "test_tetgencache.cache";
+
+
+// Two tetrahedrons that share a face; 'xtip' is the x of the last node,
+// 'nnodes' and 'ntets' are the counts written in the headers.
+
+void write_tetgen(double xtip, int nnodes, int ntets, const char* comment = "")
+{
+	FILE* fnode = fopen(file_node, "w");
+	fprintf(fnode, "%d 3 0 0\n", nnodes);
+	fprintf(fnode, "1 0 0 0\n2 1 0 0\n3 0 1 0\n4 0 0 1\n5 %.1f 1 1\n%s", xtip, comment);
+	fclose(fnode);
+
+	FILE* fele = fopen(file_ele, "w");
+	fprintf(fele, "%d 4 0\n", ntets);
+	fprintf(fele, "1 1 2 3 4\n2 2 3 4 5\n");
+	fclose(fele);
+}
+
+// Sets the modification time of a file, to make it older or newer
+// than the cache without waiting.
+
+void set_time(const char* filename, time_t mtime)
+{
+	struct utimbuf mtimes;
+	mtimes.actime  = mtime;
+	mtimes.modtime = mtime;
+	utime(filename, &mtimes);
+}
+
+// Loads the mesh with the cache, and returns the x of the last node.
+
+double load_cached(int& nnodes, int& nelements)
+{
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	ChMesh mesh;
+	mesh.LoadFromTetGenFileCached(file_node, file_ele, mmaterial, file_cache);
+	nnodes = mesh.GetNnodes();
+	nelements = mesh.GetNelements();
+	if (nnodes == 0)
+		return 0;
+	return mesh.GetNode(nnodes - 1).DynamicCastTo<ChNodeFEMxyz>()->GetX0().x;
+}
+
+// Returns true if loading the TetGen files throws an exception.
+
+bool load_fails()
+{
+	ChSharedPtr<ChContinuumElastic> mmaterial(new ChContinuumElastic);
+	ChMesh mesh;
+	try
+	{
+		mesh.LoadFromTetGenFile(file_node, file_ele, mmaterial);
+	}
+	catch (const ChException&)
+	{
+		return true;
+	}
+	return false;
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+	int nnodes, nelements;
+	remove(file_cache);
+	time_t mtime = 1000000000;
+
+	// Parsed, and written to the cache
+	write_tetgen(1.0, 5, 2);
+	set_time(file_node, mtime);
+	double x = load_cached(nnodes, nelements);
+	GetLog() << "parsed: " << nnodes << " nodes, " << nelements << " tetrahedrons\n";
+	if (nnodes != 5 || nelements != 2 || x != 1.0)
+		ok = false;
+
+	// Another node position, but same size and time: the cache is used,
+	// so the old position is returned
+	write_tetgen(2.0, 5, 2);
+	set_time(file_node, mtime);
+	x = load_cached(nnodes, nelements);
+	if (x != 1.0 || nnodes != 5 || nelements != 2)
+	{
+		GetLog() << "Error: the cache was not used.\n";
+		ok = false;
+	}
+
+	// Newer file: parsed again
+	set_time(file_node, mtime + 10);
+	x = load_cached(nnodes, nelements);
+	if (x != 2.0)
+	{
+		GetLog() << "Error: the cache was used after a change of the time.\n";
+		ok = false;
+	}
+
+	// Same time, but another size: parsed again
+	write_tetgen(3.0, 5, 2, "# comment\n");
+	set_time(file_node, mtime + 10);
+	x = load_cached(nnodes, nelements);
+	if (x != 3.0)
+	{
+		GetLog() << "Error: the cache was used after a change of the size.\n";
+		ok = false;
+	}
+
+	// Truncated files: more nodes or tetrahedrons in the headers than in the files
+	write_tetgen(1.0, 6, 2);
+	if (!load_fails())
+	{
+		GetLog() << "Error: a truncated .node file was accepted.\n";
+		ok = false;
+	}
+	write_tetgen(1.0, 5, 3);
+	if (!load_fails())
+	{
+		GetLog() << "Error: a truncated .ele file was accepted.\n";
+		ok = false;
+	}
+
+	remove(file_node);
+	remove(file_ele);
+	remove(file_cache);
+	return ok ? 0 : 1;
+}